@@ -0,0 +1,51 @@
+#! /bin/bash
+
+set -euo pipefail
+
+BASE_PATH="$(dirname "$0")/../.."
+cd "$BASE_PATH"
+
+# The approximate size of the generated program, in megabytes.
+MEGABYTES="${1:-16}"
+INPUT="$(mktemp)"
+trap 'rm --force "$INPUT"' EXIT
+
+echo "Generating a program of ~$MEGABYTES MB..."
+
+# A single assignment with a long left-associative sum keeps the Bison stack
+# bounded, while most of the bytes are whitespace and comments (i.e., ignored
+# lexemes). Every line has 8 tokens.
+cat > "$INPUT" <<EOF
+configuration:
+    Height: 10;
+    Width: 10;
+    Frontier: Open;
+    States: {alive, dead};
+    Colors: { #FFFFFF, #000000 };
+
+transition:
+    sum = 0
+EOF
+LINES=$(( MEGABYTES * 1024 * 1024 / 64 ))
+awk -v lines="$LINES" 'BEGIN {
+	for (k = 0; k < lines; ++k) {
+		print "        + 1 + (0, 1)    /* an ignored comment of the benchmark */"
+	}
+}' >> "$INPUT"
+echo "    ;" >> "$INPUT"
+echo "    -> alive" >> "$INPUT"
+
+BYTES=$(stat --format=%s "$INPUT")
+TOKENS=$(( LINES * 8 + 40 ))
+
+echo "Lexing and parsing $BYTES bytes ($TOKENS tokens)..."
+START=$(date +%s.%N)
+LOGGING_LEVEL=ERROR LOG_IGNORED_LEXEMES=false build/Compiler "$INPUT"
+END=$(date +%s.%N)
+
+awk -v start="$START" -v end="$END" -v bytes="$BYTES" -v tokens="$TOKENS" 'BEGIN {
+	seconds = end - start
+	printf "    %.3f s, %.2f MB/s, %.0f tokens/s\n", seconds, bytes / seconds / 1048576, tokens / seconds
+}'
+
+echo "All done."
@@ -14,7 +14,7 @@ echo "Compiler should accept..."
 echo ""
 
 for test in $(ls src/test/c/accept/); do
-	cat "src/test/c/accept/$test" | build/Compiler >/dev/null 2>&1
+	build/Compiler "src/test/c/accept/$test" >/dev/null 2>&1
 	RESULT="$?"
 	if [ "$RESULT" == "0" ]; then
 		echo -e "    $test, ${GREEN}and it does${OFF} (status $RESULT)"
@@ -29,7 +29,7 @@ echo "Compiler should reject..."
 echo ""
 
 for test in $(ls src/test/c/reject/); do
-	cat "src/test/c/reject/$test" | build/Compiler >/dev/null 2>&1
+	build/Compiler "src/test/c/reject/$test" >/dev/null 2>&1
 	RESULT="$?"
 	if [ "$RESULT" != "0" ]; then
 		echo -e "    $test, ${GREEN}and it does${OFF} (status $RESULT)"
@@ -40,5 +40,28 @@ for test in $(ls src/test/c/reject/); do
 done
 echo ""
 
+echo "Compiler should simulate (and validate) the accepted programs with every engine..."
+echo ""
+
+# The stack is limited, so the programs with deep expressions (e.g.,
+# 11-deep-expressions) crash any recursive walk of their trees.
+ENGINES="reference hashlife sparse bit-packed lookup vector native bytecode"
+export NATIVE_CACHE_DIRECTORY="$(mktemp -d)"
+for test in $(ls src/test/c/accept/); do
+	for engine in $ENGINES; do
+		(ulimit -s 128; SIMULATION_ENGINE="$engine" SIMULATION_GENERATIONS=4 SIMULATION_VALIDATE=true \
+			build/Compiler "src/test/c/accept/$test" >/dev/null 2>&1)
+		RESULT="$?"
+		if [ "$RESULT" == "0" ]; then
+			echo -e "    $test with $engine, ${GREEN}and it does${OFF} (status $RESULT)"
+		else
+			STATUS=1
+			echo -e "    $test with $engine, ${RED}but it fails${OFF} (status $RESULT)"
+		fi
+	done
+done
+rm -rf "$NATIVE_CACHE_DIRECTORY"
+echo ""
+
 echo "All done."
 exit $STATUS
@@ -1,72 +1,321 @@
 #include "backend/code-generation/Generator.h"
 #include "backend/domain-specific/Calculator.h"
+#include "backend/simulation/ActiveTiles.h"
+#include "backend/simulation/Automaton.h"
+#include "backend/simulation/BitPackedEngine.h"
+#include "backend/simulation/Bytecode.h"
+#include "backend/simulation/HashLifeEngine.h"
+#include "backend/simulation/Interpreter.h"
+#include "backend/simulation/LookupEngine.h"
+#include "backend/simulation/Optimizer.h"
+#include "backend/simulation/Recorder.h"
+#include "backend/simulation/Simulation.h"
+#include "backend/simulation/SparseEngine.h"
+#include "backend/simulation/VectorProgram.h"
 #include "frontend/lexical-analysis/FlexActions.h"
+#include "frontend/lexical-analysis/SourceCode.h"
 #include "frontend/syntactic-analysis/AbstractSyntaxTree.h"
 #include "frontend/syntactic-analysis/BisonActions.h"
 #include "frontend/syntactic-analysis/SyntacticAnalyzer.h"
+#include "shared/Arena.h"
 #include "shared/CompilerState.h"
 #include "shared/Environment.h"
 #include "shared/Logger.h"
 #include "shared/String.h"
+#include "shared/ThreadPool.h"
+
+#if !defined (_WIN32)
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+/**
+ * A program to compile, and the result of its compilation. In batch mode,
+ * every worker thread owns a compiler state (and its arena), which is reused
+ * for every program it compiles.
+ */
+typedef struct {
+	char * path;
+	CompilerState * compilerStates;
+	Logger * logger;
+	CompilationStatus status;
+} CompilationJob;
+
+/**
+ * A growable list of compilation jobs.
+ */
+typedef struct {
+	CompilationJob * jobs;
+	unsigned int count;
+	unsigned int capacity;
+} CompilationJobList;
+
+/* PRIVATE FUNCTIONS */
+
+static void _addCompilationJob(CompilationJobList * list, const char * path);
+static void _addCompilationJobs(Logger * logger, CompilationJobList * list, const char * path);
+static CompilationStatus _compile(Logger * logger, CompilerState * compilerState, const char * path);
+static void _compileTask(void * argument, const unsigned int worker);
+static CompilerState _createCompilerState(void);
+
+/**
+ * Appends a new compilation job for the specified path.
+ */
+static void _addCompilationJob(CompilationJobList * list, const char * path) {
+	if (list->count == list->capacity) {
+		list->capacity = list->capacity == 0 ? 16 : 2 * list->capacity;
+		list->jobs = realloc(list->jobs, list->capacity * sizeof(CompilationJob));
+	}
+	CompilationJob * job = &list->jobs[list->count++];
+	job->path = concatenate(1, path);
+	job->compilerStates = NULL;
+	job->logger = NULL;
+	job->status = FAILED;
+}
+
+/**
+ * Appends a compilation job for the specified path or, if it's a directory,
+ * one for every program inside it (i.e., every regular and non-hidden file,
+ * in any order).
+ */
+static void _addCompilationJobs(Logger * logger, CompilationJobList * list, const char * path) {
+#if !defined (_WIN32)
+	struct stat status;
+	if (stat(path, &status) == 0 && S_ISDIR(status.st_mode)) {
+		DIR * directory = opendir(path);
+		if (directory == NULL) {
+			logError(logger, "Cannot open the directory: \"%s\".", path);
+			return;
+		}
+		struct dirent * entry;
+		while ((entry = readdir(directory)) != NULL) {
+			if (entry->d_name[0] == '.') {
+				continue;
+			}
+			char * programPath = concatenate(3, path, "/", entry->d_name);
+			if (stat(programPath, &status) == 0 && S_ISREG(status.st_mode)) {
+				_addCompilationJob(list, programPath);
+			}
+			free(programPath);
+		}
+		closedir(directory);
+		return;
+	}
+#endif
+	_addCompilationJob(list, path);
+}
+
+/**
+ * Compiles a single program. The compiler state (and its arena) is reused
+ * across compilations, so it's reset before returning.
+ */
+static CompilationStatus _compile(Logger * logger, CompilerState * compilerState, const char * path) {
+	SourceCode * sourceCode = openSourceCode(path);
+	if (sourceCode == NULL) {
+		return FAILED;
+	}
+	compilerState->abstractSyntaxtTree = NULL;
+	compilerState->succeed = false;
+	compilerState->errors = 0;
+	compilerState->value = 0;
+	const SyntacticAnalysisStatus syntacticAnalysisStatus = parse(compilerState, sourceCode);
+	CompilationStatus compilationStatus = SUCCEED;
+	if (syntacticAnalysisStatus == ACCEPT) {
+		// ----------------------------------------------------------------------------------------
+		// Beginning of the Backend... ------------------------------------------------------------
+		logDebugging(logger, "Building the automaton...");
+		Automaton * automaton = createAutomaton(compilerState);
+		if (automaton == NULL) {
+			logError(logger, "The semantic-analysis phase rejects the input program: \"%s\".", path);
+			compilationStatus = FAILED;
+		}
+		else {
+			const OptimizationResult optimization = optimizeAutomaton(automaton, compilerState->arena);
+			if (0 < optimization.nodes) {
+				logInformation(logger, "Optimized the programs from %u to %u nodes of the AST.", optimization.nodes, optimization.optimizedNodes);
+			}
+			if (foldNeighborhood(automaton)) {
+				logDebugging(logger, "Folded the neighborhood program into %u static neighbors.", automaton->neighborCount);
+			}
+			char * sourcePath = getGeneratorOutput(path);
+			if (sourcePath != NULL) {
+				if (generate(automaton, sourcePath)) {
+					logInformation(logger, "Generated the simulator of the program: \"%s\".", sourcePath);
+				}
+				else {
+					logError(logger, "The code-generation phase failed: \"%s\".", path);
+					compilationStatus = FAILED;
+				}
+				free(sourcePath);
+			}
+			SimulationParameters parameters = getSimulationParameters();
+			char * recordingPath = getRecordingOutput(path);
+			parameters.output = recordingPath;
+			const SimulationResult simulationResult = simulate(automaton, parameters);
+			free(recordingPath);
+			if (!simulationResult.succeed) {
+				logError(logger, "The simulation of the program failed: \"%s\".", path);
+				compilationStatus = FAILED;
+			}
+			destroyAutomaton(automaton);
+		}
+		// ...end of the Backend. -----------------------------------------------------------------
+		// ----------------------------------------------------------------------------------------
+	}
+	else {
+		logError(logger, "The syntactic-analysis phase rejects the input program: \"%s\".", path);
+		compilationStatus = FAILED;
+	}
+
+	logDebugging(logger, "Releasing AST resources...");
+	resetSymbolTable(compilerState->symbolTable);
+	resetArena(compilerState->arena);
+	closeSourceCode(sourceCode);
+	return compilationStatus;
+}
+
+/**
+ * Runs a compilation job inside a worker thread, with the compiler state of
+ * that worker.
+ */
+static void _compileTask(void * argument, const unsigned int worker) {
+	CompilationJob * job = argument;
+	job->status = _compile(job->logger, &job->compilerStates[worker], job->path);
+}
+
+/**
+ * Creates an empty compiler state, with its own arena and symbol table.
+ */
+static CompilerState _createCompilerState(void) {
+	Arena * arena = createArena(ARENA_DEFAULT_CHUNK_SIZE);
+	CompilerState compilerState = {
+		.abstractSyntaxtTree = NULL,
+		.arena = arena,
+		.symbolTable = createSymbolTable(arena),
+		.succeed = false,
+		.errors = 0,
+		.value = 0
+	};
+	return compilerState;
+}
 
 /**
  * The main entry-point of the entire application. If you use "strtok" to
  * parse anything inside this project instead of using Flex and Bison, I will
  * find you, and I will kill you (Bryan Mills; "Taken", 2008).
+ *
+ * Every argument is the path of a program to compile (or "-", for the
+ * standard input), or a directory with programs. Without paths, the standard
+ * input is compiled. The modules are initialized only once for all of them.
+ * With "--jobs N", the programs are compiled concurrently by N threads (or
+ * by one thread per processor, if N is zero).
  */
 const int main(const int count, const char ** arguments) {
 	Logger * logger = createLogger("EntryPoint");
+	initializeSourceCodeModule();
 	initializeFlexActionsModule();
 	initializeBisonActionsModule();
 	initializeSyntacticAnalyzerModule();
 	initializeAbstractSyntaxTreeModule();
+	initializeAutomatonModule();
+	initializeActiveTilesModule();
+	initializeBitPackedEngineModule();
+	initializeBytecodeModule();
+	initializeHashLifeEngineModule();
+	initializeLookupEngineModule();
+	initializeNativeEngineModule();
+	initializeRecorderModule();
+	initializeSparseEngineModule();
+	initializeVectorProgramModule();
+	initializeSimulationModule();
 	//initializeCalculatorModule();
-	//initializeGeneratorModule();
+	initializeGeneratorModule();
 
-	// Logs the arguments of the application.
+	// Logs the arguments of the application, and collects the programs.
+	unsigned int jobs = 1;
+	boolean hasPaths = false;
+	CompilationJobList list = {
+		.jobs = NULL,
+		.count = 0,
+		.capacity = 0
+	};
 	for (int k = 0; k < count; ++k) {
 		logDebugging(logger, "Argument %d: \"%s\"", k, arguments[k]);
+		if (k == 0) {
+			continue;
+		}
+		if ((strcmp(arguments[k], "--jobs") == 0 || strcmp(arguments[k], "-j") == 0) && k + 1 < count) {
+			const int requestedJobs = atoi(arguments[++k]);
+			jobs = requestedJobs < 1 ? availableProcessors() : (unsigned int) requestedJobs;
+		}
+		else {
+			_addCompilationJobs(logger, &list, arguments[k]);
+			hasPaths = true;
+		}
+	}
+	if (!hasPaths) {
+		_addCompilationJob(&list, STANDARD_INPUT_PATH);
+	}
+	if (list.count < jobs) {
+		jobs = list.count < 1 ? 1 : list.count;
 	}
 
 	// Begin compilation process.
-	CompilerState compilerState = {
-		.abstractSyntaxtTree = NULL,
-		.succeed = false,
-		.value = 0
-	};
-	const SyntacticAnalysisStatus syntacticAnalysisStatus = parse(&compilerState);
 	CompilationStatus compilationStatus = SUCCEED;
-	if (syntacticAnalysisStatus == ACCEPT) {
-		// ----------------------------------------------------------------------------------------
-		// Beginning of the Backend... ------------------------------------------------------------
-		// logDebugging(logger, "Computing expression value...");
-		// Program * program = compilerState.abstractSyntaxtTree;
-		// ComputationResult computationResult = computeExpression(program->expression);
-		// if (computationResult.succeed) {
-		// 	compilerState.value = computationResult.value;
-		// 	generate(&compilerState);
-		// }
-		// else {
-		// 	logError(logger, "The computation phase rejects the input program.");
-		// 	compilationStatus = FAILED;
-		// }
-		// ...end of the Backend. -----------------------------------------------------------------
-		// ----------------------------------------------------------------------------------------
-		// logDebugging(logger, "Releasing AST resources...");
-		// releaseProgram(program);
+	CompilerState * compilerStates = calloc(jobs, sizeof(CompilerState));
+	for (unsigned int k = 0; k < jobs; ++k) {
+		compilerStates[k] = _createCompilerState();
+	}
+	for (unsigned int k = 0; k < list.count; ++k) {
+		list.jobs[k].compilerStates = compilerStates;
+		list.jobs[k].logger = logger;
+	}
+	if (jobs == 1) {
+		for (unsigned int k = 0; k < list.count; ++k) {
+			_compileTask(&list.jobs[k], 0);
+		}
 	}
 	else {
-		logError(logger, "The syntactic-analysis phase rejects the input program.");
-		compilationStatus = FAILED;
+		logDebugging(logger, "Compiling %u programs with %u threads...", list.count, jobs);
+		ThreadPool * threadPool = createThreadPool(jobs);
+		for (unsigned int k = 0; k < list.count; ++k) {
+			submitToThreadPool(threadPool, _compileTask, &list.jobs[k]);
+		}
+		waitForThreadPool(threadPool);
+		destroyThreadPool(threadPool);
+	}
+	for (unsigned int k = 0; k < list.count; ++k) {
+		if (list.jobs[k].status == FAILED) {
+			compilationStatus = FAILED;
+		}
+		free(list.jobs[k].path);
+	}
+	for (unsigned int k = 0; k < jobs; ++k) {
+		destroySymbolTable(compilerStates[k].symbolTable);
+		destroyArena(compilerStates[k].arena);
 	}
+	free(compilerStates);
+	free(list.jobs);
 
 	logDebugging(logger, "Releasing modules resources...");
-	//shutdownGeneratorModule();
+	shutdownGeneratorModule();
 	//shutdownCalculatorModule();
+	shutdownSimulationModule();
+	shutdownVectorProgramModule();
+	shutdownSparseEngineModule();
+	shutdownRecorderModule();
+	shutdownNativeEngineModule();
+	shutdownLookupEngineModule();
+	shutdownHashLifeEngineModule();
+	shutdownBytecodeModule();
+	shutdownBitPackedEngineModule();
+	shutdownActiveTilesModule();
+	shutdownAutomatonModule();
 	shutdownAbstractSyntaxTreeModule();
 	shutdownSyntacticAnalyzerModule();
 	shutdownBisonActionsModule();
 	shutdownFlexActionsModule();
+	shutdownSourceCodeModule();
 	logDebugging(logger, "Compilation is done.");
 	destroyLogger(logger);
 	return compilationStatus;
@@ -2,8 +2,8 @@
 
 /* MODULE INTERNAL STATE */
 
-const char _indentationCharacter = ' ';
-const char _indentationSize = 4;
+const char _indentationCharacter = '\t';
+const char _indentationSize = 1;
 static Logger * _logger = NULL;
 
 void initializeGeneratorModule() {
@@ -16,76 +16,1303 @@ void shutdownGeneratorModule() {
 	}
 }
 
+/**
+ * An expression on the work stack of a generation, that resumes at its next
+ * stage once an operand is generated (or, while accumulating, a long chain
+ * of operations, generated at stage 1). An operand of a logical operator is
+ * generated as a condition.
+ */
+typedef struct {
+	ArithmeticExpression * expression;
+	unsigned int stage;
+	boolean isCondition;
+} GenerationFrame;
+
+/**
+ * A chain of operations already computed into the temporary
+ * "accumulator<name>".
+ */
+typedef struct {
+	ArithmeticExpression * expression;
+	unsigned int name;
+} Accumulator;
+
+/**
+ * The state of a generation. The static offsets are the ones read by the
+ * function being generated (its cell at offset "k" is "c<k>"), and their
+ * bounding box is the one of every function, so it sizes the halo.
+ */
+typedef struct {
+	const Automaton * automaton;
+	FILE * file;
+
+	// Whether a kernel is generated, instead of a standalone simulator.
+	boolean isKernel;
+
+	Offset * offsets;
+	unsigned int offsetCount;
+	unsigned int offsetCapacity;
+	Offset minimum;
+	Offset maximum;
+
+	// The amount of temporaries (i.e., guards, loops and accumulators) so
+	// far, to name the next one.
+	unsigned int names;
+
+	GenerationFrame * frames;
+	unsigned int frameCount;
+	unsigned int frameCapacity;
+
+	// The accumulators of the statement being generated, sorted by the
+	// address of their expressions.
+	Accumulator * accumulators;
+	unsigned int accumulatorCount;
+	unsigned int accumulatorCapacity;
+} Generation;
+
 /** PRIVATE FUNCTIONS */
 
-static const char _expressionTypeToCharacter(const ExpressionType type);
-static void _generateConstant(const unsigned int indentationLevel, Constant * constant);
-static void _generateEpilogue(const int value);
-static void _generateExpression(const unsigned int indentationLevel, Expression * expression);
-static void _generateFactor(const unsigned int indentationLevel, Factor * factor);
-static void _generateProgram(Program * program);
-static void _generatePrologue(void);
+static void _accumulateExpression(Generation * generation, const unsigned int level, ArithmeticExpression * expression);
+static void _addAccumulator(Generation * generation, ArithmeticExpression * expression, const unsigned int name);
+static int _addOffset(Generation * generation, const Offset offset);
+static unsigned int _chainLength(ArithmeticExpression * expression);
+static void _collectCell(Generation * generation, Cell * cell);
+static void _collectConstant(Generation * generation, Constant * constant);
+static void _collectExpression(Generation * generation, ArithmeticExpression * expression);
+static void _collectNeighborhoodSequence(Generation * generation, NeighborhoodSequence * sequence);
+static void _collectRange(Generation * generation, Range * range);
+static void _collectTransitionSequence(Generation * generation, TransitionSequence * sequence);
+static boolean _constantValue(Generation * generation, Constant * constant, int * value);
+static boolean _findAccumulator(Generation * generation, ArithmeticExpression * expression, unsigned int * name);
+static void _generateAccumulator(Generation * generation, const unsigned int level, ArithmeticExpression * expression);
+static void _generateCell(Generation * generation, Cell * cell);
+static void _generateCondition(Generation * generation, ArithmeticExpression * expression);
+static void _generateConstant(Generation * generation, Constant * constant);
+static void _generateCoordinate(Generation * generation, Cell * cell, const boolean isRow);
+static void _generateEvolution(Generation * generation);
+static void _generateExpression(Generation * generation, ArithmeticExpression * expression);
+static boolean _generateFile(const Automaton * automaton, const char * path, const boolean isKernel);
+static void _generateGrid(Generation * generation);
+static void _generateInteger(Generation * generation, const int value);
+static void _generateMain(Generation * generation);
+static void _generateNeighborhood(Generation * generation);
+static void _generateNeighborhoodSequence(Generation * generation, const unsigned int level, NeighborhoodSequence * sequence);
+static void _generateNeighbors(Generation * generation, const unsigned int level, CellList * cellList, const boolean isAddition);
+static void _generatePrologue(Generation * generation);
+static void _generateQuantifier(Generation * generation, ArithmeticExpression * expression);
+static void _generateReads(Generation * generation);
+static void _generateStep(Generation * generation);
+static void _generateTransition(Generation * generation);
+static void _generateTransitionSequence(Generation * generation, const unsigned int level, TransitionSequence * sequence, const char * guard);
+static void _generateVariables(Generation * generation);
 static char * _indentation(const unsigned int indentationLevel);
-static void _output(const unsigned int indentationLevel, const char * const format, ...);
+static boolean _isBoolean(ArithmeticExpression * expression);
+static boolean _isOperation(ArithmeticExpression * expression);
+static void _operation(ArithmeticExpression * expression, const char ** open, const char ** middle);
+static void _output(Generation * generation, const unsigned int indentationLevel, const char * const format, ...);
+static void _popFrame(Generation * generation);
+static void _pushFrame(Generation * generation, ArithmeticExpression * expression, const boolean isCondition);
+
+/**
+ * Generates the accumulators of the long chains of operations of an
+ * expression (e.g., a sum of many terms), as statements right before the
+ * one that uses it, so the C compiler never parses a deeply nested
+ * expression. The inner chains (i.e., in the operands of a chain) are
+ * accumulated first. Every operation is total and has no side effects, so
+ * computing it before its statement (even if a condition wouldn't evaluate
+ * it) doesn't change the result.
+ */
+static void _accumulateExpression(Generation * generation, const unsigned int level, ArithmeticExpression * expression) {
+	generation->accumulatorCount = 0;
+	const unsigned int base = generation->frameCount;
+	_pushFrame(generation, expression, false);
+	while (base < generation->frameCount) {
+		const GenerationFrame frame = generation->frames[--generation->frameCount];
+		expression = frame.expression;
+		if (frame.stage == 1) {
+			_generateAccumulator(generation, level, expression);
+			continue;
+		}
+		switch (expression->type) {
+			case CONSTANT:
+			case ALL_ARE:
+			case ANY_ARE:
+			case AT_LEAST_ARE:
+				break;
+			case FACTOR:
+			case LOGIC_NOT:
+				_pushFrame(generation, expression->expression, false);
+				break;
+			default:
+				if (_chainLength(expression) < MAXIMUM_NESTED_OPERATIONS) {
+					_pushFrame(generation, expression->rightExpression, false);
+					_pushFrame(generation, expression->leftExpression, false);
+					break;
+				}
+				_pushFrame(generation, expression, false);
+				generation->frames[generation->frameCount - 1].stage = 1;
+				while (_isOperation(expression)) {
+					_pushFrame(generation, expression->rightExpression, false);
+					expression = expression->leftExpression;
+					while (expression->type == FACTOR) {
+						expression = expression->expression;
+					}
+				}
+				_pushFrame(generation, expression, false);
+				break;
+		}
+	}
+}
+
+/**
+ * Registers the accumulator of a chain, keeping them sorted.
+ */
+static void _addAccumulator(Generation * generation, ArithmeticExpression * expression, const unsigned int name) {
+	if (generation->accumulatorCount == generation->accumulatorCapacity) {
+		generation->accumulatorCapacity = generation->accumulatorCapacity == 0 ? 16 : 2 * generation->accumulatorCapacity;
+		generation->accumulators = realloc(generation->accumulators, generation->accumulatorCapacity * sizeof(Accumulator));
+	}
+	unsigned int k = generation->accumulatorCount++;
+	for (; 0 < k && (uintptr_t) expression < (uintptr_t) generation->accumulators[k - 1].expression; --k) {
+		generation->accumulators[k] = generation->accumulators[k - 1];
+	}
+	generation->accumulators[k] = (Accumulator) {
+		.expression = expression,
+		.name = name
+	};
+}
+
+/**
+ * Returns the index of a static offset, adding it if it's new.
+ */
+static int _addOffset(Generation * generation, const Offset offset) {
+	for (unsigned int k = 0; k < generation->offsetCount; ++k) {
+		if (generation->offsets[k].x == offset.x && generation->offsets[k].y == offset.y) {
+			return (int) k;
+		}
+	}
+	if (generation->offsetCount == generation->offsetCapacity) {
+		generation->offsetCapacity = generation->offsetCapacity == 0 ? 16 : 2 * generation->offsetCapacity;
+		generation->offsets = realloc(generation->offsets, generation->offsetCapacity * sizeof(Offset));
+	}
+	generation->offsets[generation->offsetCount] = offset;
+	generation->minimum.x = offset.x < generation->minimum.x ? offset.x : generation->minimum.x;
+	generation->minimum.y = offset.y < generation->minimum.y ? offset.y : generation->minimum.y;
+	generation->maximum.x = generation->maximum.x < offset.x ? offset.x : generation->maximum.x;
+	generation->maximum.y = generation->maximum.y < offset.y ? offset.y : generation->maximum.y;
+	return (int) generation->offsetCount++;
+}
+
+/**
+ * The length of the chain of operations of an expression: its operation,
+ * the one of its left operand, and so on (up to MAXIMUM_NESTED_OPERATIONS,
+ * since a longer one is accumulated anyway).
+ */
+static unsigned int _chainLength(ArithmeticExpression * expression) {
+	unsigned int length = 0;
+	while (length < MAXIMUM_NESTED_OPERATIONS && _isOperation(expression)) {
+		++length;
+		expression = expression->leftExpression;
+		while (expression->type == FACTOR) {
+			expression = expression->expression;
+		}
+	}
+	return length;
+}
+
+/**
+ * Registers the static offset of a cell that is read (or the cells that
+ * its coordinates read, if it's dynamic).
+ */
+static void _collectCell(Generation * generation, Cell * cell) {
+	Offset offset;
+	if (resolveStaticOffset(generation->automaton, cell, &offset)) {
+		_addOffset(generation, offset);
+	}
+	else if (cell->isSingleCoordenate) {
+		_collectConstant(generation, cell->displacement);
+	}
+	else {
+		_collectConstant(generation, cell->x);
+		_collectConstant(generation, cell->y);
+	}
+}
+
+static void _collectConstant(Generation * generation, Constant * constant) {
+	if (constant->type == CELL_C) {
+		_collectCell(generation, constant->cell);
+	}
+}
+
+/**
+ * Registers the cells that an expression reads, from left to right.
+ */
+static void _collectExpression(Generation * generation, ArithmeticExpression * expression) {
+	const unsigned int base = generation->frameCount;
+	_pushFrame(generation, expression, false);
+	while (base < generation->frameCount) {
+		expression = generation->frames[--generation->frameCount].expression;
+		switch (expression->type) {
+			case CONSTANT:
+				_collectConstant(generation, expression->constant);
+				break;
+			case FACTOR:
+			case LOGIC_NOT:
+				_pushFrame(generation, expression->expression, false);
+				break;
+			case ALL_ARE:
+			case ANY_ARE:
+			case AT_LEAST_ARE:
+				for (unsigned int k = 0; k < expression->cellList->count; ++k) {
+					_collectCell(generation, expression->cellList->cells[k]);
+				}
+				break;
+			default:
+				_pushFrame(generation, expression->rightExpression, false);
+				_pushFrame(generation, expression->leftExpression, false);
+				break;
+		}
+	}
+}
+
+/**
+ * Registers the cells that a neighborhood program reads. The cells that it
+ * adds or removes aren't read, but their coordinates can be.
+ */
+static void _collectNeighborhoodSequence(Generation * generation, NeighborhoodSequence * sequence) {
+	for (unsigned int k = 0; k < sequence->count; ++k) {
+		NeighborhoodExpression * expression = sequence->expressions[k];
+		CellList * cellList = NULL;
+		switch (expression->type) {
+			case NEIGHBORHOOD_ASSIGNMENT:
+				_collectExpression(generation, expression->assignment);
+				break;
+			case NEIGHBORHOOD_FOR_LOOP:
+				_collectRange(generation, expression->range);
+				_collectNeighborhoodSequence(generation, expression->forBody);
+				break;
+			case NEIGHBORHOOD_IF:
+				_collectExpression(generation, expression->ifCondition);
+				_collectNeighborhoodSequence(generation, expression->ifBody);
+				break;
+			case NEIGHBORHOOD_IF_ELSE:
+				_collectExpression(generation, expression->ifElseCondition);
+				_collectNeighborhoodSequence(generation, expression->ifElseIfBody);
+				_collectNeighborhoodSequence(generation, expression->ifElseElseBody);
+				break;
+			case ADD_CELL_EXP:
+				cellList = expression->toAddList;
+				break;
+			case REMOVE_CELL_EXP:
+				cellList = expression->toRemoveList;
+				break;
+		}
+		for (unsigned int j = 0; cellList != NULL && j < cellList->count; ++j) {
+			Cell * cell = cellList->cells[j];
+			Offset offset;
+			if (!resolveStaticOffset(generation->automaton, cell, &offset)) {
+				_collectCell(generation, cell);
+			}
+		}
+	}
+}
+
+static void _collectRange(Generation * generation, Range * range) {
+	if (range->type == ARRAY) {
+		for (unsigned int k = 0; k < range->array->count; ++k) {
+			_collectConstant(generation, range->array->values[k]);
+		}
+	}
+	else {
+		_collectConstant(generation, range->start);
+		_collectConstant(generation, range->end);
+	}
+}
+
+static void _collectTransitionSequence(Generation * generation, TransitionSequence * sequence) {
+	for (unsigned int k = 0; k < sequence->count; ++k) {
+		TransitionExpression * expression = sequence->expressions[k];
+		switch (expression->type) {
+			case TRANSITION_ASSIGNMENT:
+				_collectExpression(generation, expression->assignment);
+				break;
+			case TRANSITION_FOR_LOOP:
+				_collectRange(generation, expression->range);
+				_collectTransitionSequence(generation, expression->forBody);
+				break;
+			case TRANSITION_IF:
+				_collectExpression(generation, expression->ifCondition);
+				_collectTransitionSequence(generation, expression->ifBody);
+				break;
+			case TRANSITION_IF_ELSE:
+				_collectExpression(generation, expression->ifElseCondition);
+				_collectTransitionSequence(generation, expression->ifElseIfBody);
+				_collectTransitionSequence(generation, expression->ifElseElseBody);
+				break;
+			case RETURN_VALUE:
+				_collectExpression(generation, expression->returnValue);
+				break;
+		}
+	}
+}
+
+/**
+ * Whether a constant is known at compile time (an integer or a state).
+ */
+static boolean _constantValue(Generation * generation, Constant * constant, int * value) {
+	if (constant->type == INTEGER_C) {
+		*value = constant->value;
+		return true;
+	}
+	if (constant->type == STRING_C && generation->automaton->symbolStates[constant->symbol] != NO_STATE) {
+		*value = generation->automaton->symbolStates[constant->symbol];
+		return true;
+	}
+	return false;
+}
 
 /**
- * Converts and expression type to the proper character of the operation
- * involved, or returns '\0' if that's not possible.
+ * Finds the accumulator of an expression, if it's the chain of one.
  */
-static const char _expressionTypeToCharacter(const ExpressionType type) {
-	switch (type) {
-		case ADDITION: return '+';
-		case DIVISION: return '/';
-		case MULTIPLICATION: return '*';
-		case SUBTRACTION: return '-';
+static boolean _findAccumulator(Generation * generation, ArithmeticExpression * expression, unsigned int * name) {
+	unsigned int low = 0;
+	unsigned int high = generation->accumulatorCount;
+	while (low < high) {
+		const unsigned int middle = low + (high - low) / 2;
+		if (generation->accumulators[middle].expression == expression) {
+			*name = generation->accumulators[middle].name;
+			return true;
+		}
+		if ((uintptr_t) generation->accumulators[middle].expression < (uintptr_t) expression) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return false;
+}
+
+/**
+ * Generates the accumulator of a long chain of operations: it starts at the
+ * innermost left operand, and every statement applies the next operation
+ * to it (from the innermost one to the expression itself).
+ */
+static void _generateAccumulator(Generation * generation, const unsigned int level, ArithmeticExpression * expression) {
+	const unsigned int base = generation->frameCount;
+	ArithmeticExpression * chain = expression;
+	while (_isOperation(chain)) {
+		_pushFrame(generation, chain, false);
+		chain = chain->leftExpression;
+		while (chain->type == FACTOR) {
+			chain = chain->expression;
+		}
+	}
+	const unsigned int name = generation->names++;
+	_output(generation, level, "int accumulator%u = ", name);
+	_generateExpression(generation, chain);
+	_output(generation, 0, "%s", ";\n");
+	while (base < generation->frameCount) {
+		ArithmeticExpression * operation = generation->frames[--generation->frameCount].expression;
+		const boolean isLogic = operation->type == LOGIC_AND || operation->type == LOGIC_OR;
+		const char * open = NULL;
+		const char * middle = NULL;
+		_operation(operation, &open, &middle);
+		_output(generation, level, "accumulator%u = %s", name, open);
+		_output(generation, 0, isLogic && !_isBoolean(operation->leftExpression) ? "(accumulator%u != 0)" : "accumulator%u", name);
+		_output(generation, 0, "%s", middle);
+		if (isLogic) {
+			_generateCondition(generation, operation->rightExpression);
+		}
+		else {
+			_generateExpression(generation, operation->rightExpression);
+		}
+		_output(generation, 0, "%s", ");\n");
+	}
+	_addAccumulator(generation, expression, name);
+}
+
+/**
+ * Generates the read of a cell: a static one was loaded at the start of the
+ * function, and a dynamic one resolves the frontier.
+ */
+static void _generateCell(Generation * generation, Cell * cell) {
+	Offset offset;
+	if (resolveStaticOffset(generation->automaton, cell, &offset)) {
+		_output(generation, 0, "c%d", _addOffset(generation, offset));
+		return;
+	}
+	_output(generation, 0, "%s", "_read(grid, _add(x, ");
+	_generateCoordinate(generation, cell, false);
+	_output(generation, 0, "%s", "), _add(y, ");
+	_generateCoordinate(generation, cell, true);
+	_output(generation, 0, "%s", "))");
+}
+
+/**
+ * Generates an expression as a condition (i.e., zero or one).
+ */
+static void _generateCondition(Generation * generation, ArithmeticExpression * expression) {
+	if (_isBoolean(expression)) {
+		_generateExpression(generation, expression);
+		return;
+	}
+	_output(generation, 0, "%s", "(");
+	_generateExpression(generation, expression);
+	_output(generation, 0, "%s", " != 0)");
+}
+
+static void _generateConstant(Generation * generation, Constant * constant) {
+	int value = 0;
+	if (_constantValue(generation, constant, &value)) {
+		_generateInteger(generation, value);
+	}
+	else if (constant->type == STRING_C) {
+		_output(generation, 0, "variable%u", constant->symbol);
+	}
+	else {
+		_generateCell(generation, constant->cell);
+	}
+}
+
+/**
+ * Generates the column (or the row) of the offset of a dynamic cell.
+ */
+static void _generateCoordinate(Generation * generation, Cell * cell, const boolean isRow) {
+	if (!cell->isSingleCoordenate) {
+		_generateConstant(generation, isRow ? cell->y : cell->x);
+		return;
+	}
+	switch (cell->displacementType) {
+		case HORIZONTAL_D:
+			if (isRow) {
+				_output(generation, 0, "%s", "0");
+				return;
+			}
+			break;
+		case VERTICAL_D:
+			if (!isRow) {
+				_output(generation, 0, "%s", "0");
+				return;
+			}
+			break;
+		case DIAGONAL_ASC_D:
+			if (isRow) {
+				_output(generation, 0, "%s", "_subtract(0, ");
+				_generateConstant(generation, cell->displacement);
+				_output(generation, 0, "%s", ")");
+				return;
+			}
+			break;
+		case DIAGONAL_DESC_D:
 		default:
-			logError(_logger, "The specified expression type cannot be converted into character: %d", type);
-			return '\0';
+			break;
+	}
+	_generateConstant(generation, cell->displacement);
+}
+
+/**
+ * Generates the evolution of a cell: the alive neighbors are counted at
+ * their constant displacements (or in the neighborhood built by the
+ * program), and the rule is a pair of bit masks (or of tables, if it's too
+ * big).
+ */
+static void _generateEvolution(Generation * generation) {
+	const Automaton * automaton = generation->automaton;
+	const boolean isMask = automaton->ruleSize <= 32;
+	if (isMask) {
+		unsigned long survives = 0, born = 0;
+		for (unsigned int k = 0; k < automaton->ruleSize; ++k) {
+			survives |= (unsigned long) automaton->survives[k] << k;
+			born |= (unsigned long) automaton->born[k] << k;
+		}
+		_output(generation, 0, "#define SURVIVES 0x%08lxu\n", survives);
+		_output(generation, 0, "#define BORN 0x%08lxu\n\n", born);
+	}
+	else {
+		_output(generation, 0, "%s", "static const uint8_t SURVIVES[RULE_SIZE] = {");
+		for (unsigned int k = 0; k < automaton->ruleSize; ++k) {
+			_output(generation, 0, k == 0 ? "%d" : ", %d", automaton->survives[k]);
+		}
+		_output(generation, 0, "%s", "};\n");
+		_output(generation, 0, "%s", "static const uint8_t BORN[RULE_SIZE] = {");
+		for (unsigned int k = 0; k < automaton->ruleSize; ++k) {
+			_output(generation, 0, k == 0 ? "%d" : ", %d", automaton->born[k]);
+		}
+		_output(generation, 0, "%s", "};\n\n");
+	}
+	if (automaton->neighborhoodProgram != NULL) {
+		_generateNeighborhood(generation);
+	}
+	_output(generation, 0, "%s",
+		"/**\n"
+		" * The next state of a cell, by the amount of its alive neighbors.\n"
+		" */\n"
+		"static inline uint8_t _evolve(const uint8_t * grid, const uint8_t * cell, const int x, const int y");
+	if (automaton->neighborhoodProgram != NULL) {
+		_output(generation, 0, "%s", ", Neighborhood * neighborhood) {\n");
+		_output(generation, 1, "%s", "_neighborhood(grid, cell, x, y, neighborhood);\n");
+		_output(generation, 1, "%s", "unsigned int alive = 0;\n");
+		_output(generation, 1, "%s", "for (unsigned int k = 0; k < neighborhood->count; ++k) {\n");
+		_output(generation, 2, "%s", "alive += _read(grid, _add(x, neighborhood->offsets[k].x), _add(y, neighborhood->offsets[k].y)) == ALIVE_STATE;\n");
+		_output(generation, 1, "%s", "}\n");
+	}
+	else {
+		_output(generation, 0, "%s", ") {\n");
+		_output(generation, 1, "%s", "(void) grid;\n");
+		_output(generation, 1, "%s", "(void) x;\n");
+		_output(generation, 1, "%s", "(void) y;\n");
+		_output(generation, 1, "%s", "const unsigned int alive = 0");
+		for (unsigned int k = 0; k < automaton->neighborCount; ++k) {
+			_output(generation, 0, "\n");
+			_output(generation, 2, "+ (cell[%d * STRIDE + %d] == ALIVE_STATE)", automaton->neighbors[k].y, automaton->neighbors[k].x);
+		}
+		_output(generation, 0, "%s", ";\n");
+	}
+	if (isMask) {
+		_output(generation, 1, "%s", "const uint32_t rule = cell[0] == ALIVE_STATE ? SURVIVES : BORN;\n");
+		_output(generation, 1, "%s", "return alive < RULE_SIZE && ((rule >> alive) & 1u) ? ALIVE_STATE : DEAD_STATE;\n");
+	}
+	else {
+		_output(generation, 1, "%s", "const uint8_t * rule = cell[0] == ALIVE_STATE ? SURVIVES : BORN;\n");
+		_output(generation, 1, "%s", "return alive < RULE_SIZE && rule[alive] ? ALIVE_STATE : DEAD_STATE;\n");
+	}
+	_output(generation, 0, "%s", "}\n\n");
+}
+
+/**
+ * Generates an expression, with the semantics of the interpreter (see
+ * "Interpreter.h"). The arithmetic wraps around, and the logical operators
+ * evaluate both operands (the expressions never have side effects), so the
+ * result never branches.
+ */
+/**
+ * Generates an expression with a work stack, where every frame outputs the
+ * text around its operands while it resumes. A chain that was accumulated
+ * is its accumulator.
+ */
+static void _generateExpression(Generation * generation, ArithmeticExpression * expression) {
+	const unsigned int base = generation->frameCount;
+	_pushFrame(generation, expression, false);
+	while (base < generation->frameCount) {
+		GenerationFrame * frame = &generation->frames[generation->frameCount - 1];
+		expression = frame->expression;
+		const boolean isLogic = expression->type == LOGIC_AND || expression->type == LOGIC_OR;
+		const char * open = NULL;
+		const char * middle = NULL;
+		unsigned int name = 0;
+		if (frame->stage == 0 && _findAccumulator(generation, expression, &name)) {
+			_output(generation, 0, "accumulator%u", name);
+			_popFrame(generation);
+			continue;
+		}
+		switch (expression->type) {
+			case LOGIC_NOT:
+				if (frame->stage++ == 0) {
+					_output(generation, 0, "%s", "(");
+					_pushFrame(generation, expression->expression, false);
+				}
+				else {
+					_output(generation, 0, "%s", " == 0)");
+					_popFrame(generation);
+				}
+				break;
+			case ALL_ARE:
+			case ANY_ARE:
+			case AT_LEAST_ARE:
+				_generateQuantifier(generation, expression);
+				_popFrame(generation);
+				break;
+			case FACTOR:
+				if (frame->stage++ == 0) {
+					_pushFrame(generation, expression->expression, false);
+				}
+				else {
+					_popFrame(generation);
+				}
+				break;
+			case CONSTANT:
+				_generateConstant(generation, expression->constant);
+				_popFrame(generation);
+				break;
+			default:
+				_operation(expression, &open, &middle);
+				switch (frame->stage++) {
+					case 0:
+						_output(generation, 0, "%s", open);
+						_pushFrame(generation, expression->leftExpression, isLogic);
+						break;
+					case 1:
+						_output(generation, 0, "%s", middle);
+						_pushFrame(generation, expression->rightExpression, isLogic);
+						break;
+					default:
+						_output(generation, 0, "%s", ")");
+						_popFrame(generation);
+						break;
+				}
+				break;
+		}
+	}
+}
+
+/**
+ * Generates a standalone simulator (or a kernel) into a file.
+ */
+static boolean _generateFile(const Automaton * automaton, const char * path, const boolean isKernel) {
+	FILE * file = fopen(path, "w");
+	if (file == NULL) {
+		logError(_logger, "Cannot write the generated source: \"%s\".", path);
+		return false;
+	}
+	Generation generation = {
+		.automaton = automaton,
+		.file = file,
+		.isKernel = isKernel
+	};
+	// The halo is sized by the reads of both programs, and by the neighbors.
+	for (unsigned int k = 0; k < automaton->neighborCount; ++k) {
+		_addOffset(&generation, automaton->neighbors[k]);
+	}
+	if (automaton->neighborhoodProgram != NULL) {
+		_collectNeighborhoodSequence(&generation, automaton->neighborhoodProgram);
+	}
+	if (automaton->rule == TRANSITION_RULE) {
+		_collectTransitionSequence(&generation, automaton->transitionProgram);
+	}
+	_generatePrologue(&generation);
+	if (!isKernel) {
+		_generateGrid(&generation);
+	}
+	if (automaton->rule == TRANSITION_RULE) {
+		_generateTransition(&generation);
+	}
+	else if (automaton->rule == EVOLUTION_RULE) {
+		_generateEvolution(&generation);
+	}
+	_generateStep(&generation);
+	if (!isKernel) {
+		_generateMain(&generation);
+	}
+	const boolean isWritten = ferror(file) == 0;
+	fclose(file);
+	free(generation.offsets);
+	free(generation.frames);
+	free(generation.accumulators);
+	logDebugging(_logger, "Generated a %s of %ux%u cells into \"%s\".", isKernel ? "kernel" : "simulator", automaton->width, automaton->height, path);
+	return isWritten;
+}
+
+/**
+ * Generates the helpers of a standalone simulator: the halo, and the random
+ * grid and its hash (the same ones of the simulation engines).
+ */
+static void _generateGrid(Generation * generation) {
+	_output(generation, 0, "%s",
+		"/**\n"
+		" * Refills the halo from the cells of the grid, according to the frontier.\n"
+		" */\n"
+		"static void _fillHalo(uint8_t * grid) {\n"
+		"\tif (HALO == 0) {\n"
+		"\t\treturn;\n"
+		"\t}\n"
+		"\tfor (int y = -HALO; y < HEIGHT + HALO; ++y) {\n"
+		"\t\tconst int row = _resolve(y, HEIGHT);\n"
+		"\t\tconst int isInside = 0 <= y && y < HEIGHT;\n"
+		"\t\tfor (int x = -HALO; x < WIDTH + HALO; x = isInside && x == -1 ? WIDTH : x + 1) {\n"
+		"\t\t\tconst int column = _resolve(x, WIDTH);\n"
+		"\t\t\tgrid[(ptrdiff_t) y * STRIDE + x] = row < 0 || column < 0 ? OUTSIDE_CELL : grid[(ptrdiff_t) row * STRIDE + column];\n"
+		"\t\t}\n"
+		"\t}\n"
+		"}\n"
+		"\n"
+		"/**\n"
+		" * The finalizer of SplitMix64 (the same of the simulation engines).\n"
+		" */\n"
+		"static uint64_t _mix(uint64_t value) {\n"
+		"\tvalue += 0x9E3779B97F4A7C15ull;\n"
+		"\tvalue = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;\n"
+		"\tvalue = (value ^ (value >> 27)) * 0x94D049BB133111EBull;\n"
+		"\treturn value ^ (value >> 31);\n"
+		"}\n"
+		"\n"
+		"/**\n"
+		" * Fills the grid with the random states of the simulation engines, and\n"
+		" * thins it to a density.\n"
+		" */\n"
+		"static void _randomize(uint8_t * grid, const uint64_t seed, const double density) {\n"
+		"\tconst uint64_t base = _mix(seed);\n"
+		"\tconst uint64_t thinBase = _mix(~seed);\n"
+		"\tfor (int y = 0; y < HEIGHT; ++y) {\n"
+		"\t\tfor (int x = 0; x < WIDTH; ++x) {\n"
+		"\t\t\tconst uint64_t k = (uint64_t) y * WIDTH + x;\n"
+		"\t\t\tuint8_t cell = (uint8_t) (_mix(base ^ k) % STATES);\n"
+		"\t\t\tif (density < 1.0 && density <= (_mix(thinBase ^ k) >> 11) * 0x1.0p-53) {\n"
+		"\t\t\t\tcell = BACKGROUND_STATE;\n"
+		"\t\t\t}\n"
+		"\t\t\tgrid[(ptrdiff_t) y * STRIDE + x] = cell;\n"
+		"\t\t}\n"
+		"\t}\n"
+		"}\n"
+		"\n"
+		"/**\n"
+		" * A 64-bit FNV-1a hash of the cells (the same of the simulation engines).\n"
+		" */\n"
+		"static uint64_t _hash(const uint8_t * grid) {\n"
+		"\tuint64_t hash = 14695981039346656037ull;\n"
+		"\tfor (int y = 0; y < HEIGHT; ++y) {\n"
+		"\t\tfor (int x = 0; x < WIDTH; ++x) {\n"
+		"\t\t\thash ^= grid[(ptrdiff_t) y * STRIDE + x];\n"
+		"\t\t\thash *= 1099511628211ull;\n"
+		"\t\t}\n"
+		"\t}\n"
+		"\treturn hash;\n"
+		"}\n"
+		"\n"
+	);
+}
+
+/**
+ * Generates an integer literal (the minimum one can't be negated).
+ */
+static void _generateInteger(Generation * generation, const int value) {
+	if (value == INT_MIN) {
+		_output(generation, 0, "(%d - 1)", INT_MIN + 1);
+	}
+	else if (value < 0) {
+		_output(generation, 0, "(%d)", value);
+	}
+	else {
+		_output(generation, 0, "%d", value);
+	}
+}
+
+/**
+ * Generates the entry-point of the simulator.
+ */
+static void _generateMain(Generation * generation) {
+	_output(generation, 0, "%s",
+		"/**\n"
+		" * Usage: simulator [generations [seed [density]]]\n"
+		" */\n"
+		"int main(const int count, const char ** arguments) {\n"
+		"\tconst uint64_t generations = 1 < count ? strtoull(arguments[1], NULL, 10) : 100;\n"
+		"\tconst uint64_t seed = 2 < count ? (uint64_t) strtoll(arguments[2], NULL, 10) : 1;\n"
+		"\tconst double density = 3 < count ? strtod(arguments[3], NULL) : 1.0;\n"
+		"\tconst size_t size = (size_t) (HEIGHT + 2 * HALO) * STRIDE;\n"
+		"\tuint8_t * buffers[2] = {calloc(size, 1), calloc(size, 1)};\n"
+		"\tuint8_t * current = buffers[0] + HALO * STRIDE + HALO;\n"
+		"\tuint8_t * next = buffers[1] + HALO * STRIDE + HALO;\n"
+		"\t_randomize(current, seed, density);\n"
+		"\tstruct timespec start, end;\n"
+		"\tclock_gettime(CLOCK_MONOTONIC, &start);\n"
+		"\tfor (uint64_t generation = 0; generation < generations; ++generation) {\n"
+		"\t\t_fillHalo(current);\n"
+		"\t\t_step(current, next);\n"
+		"\t\tuint8_t * swap = current;\n"
+		"\t\tcurrent = next;\n"
+		"\t\tnext = swap;\n"
+		"\t}\n"
+		"\tclock_gettime(CLOCK_MONOTONIC, &end);\n"
+		"\tconst double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;\n"
+		"\tprintf(\"%llu generations of %ux%u cells in %.3f s: %.1f generations/s (%.2f million cells/s), final hash %016llx.\\n\",\n"
+		"\t\t(unsigned long long) generations, WIDTH, HEIGHT, seconds, generations / seconds,\n"
+		"\t\t(double) WIDTH * HEIGHT * generations / seconds / 1e6, (unsigned long long) _hash(current));\n"
+		"\tfree(buffers[0]);\n"
+		"\tfree(buffers[1]);\n"
+		"\treturn 0;\n"
+		"}\n"
+	);
+}
+
+/**
+ * Generates the neighborhood program, as a function that builds the
+ * neighborhood of a cell (with the control flow of the interpreter, since
+ * it can't be vectorized anyway).
+ */
+static void _generateNeighborhood(Generation * generation) {
+	const Automaton * automaton = generation->automaton;
+	generation->offsetCount = 0;
+	_collectNeighborhoodSequence(generation, automaton->neighborhoodProgram);
+	_output(generation, 0, "%s",
+		"typedef struct {\n"
+		"\tint x;\n"
+		"\tint y;\n"
+		"} Offset;\n"
+		"\n"
+		"typedef struct {\n"
+		"\tOffset * offsets;\n"
+		"\tunsigned int count;\n"
+		"\tunsigned int capacity;\n"
+		"} Neighborhood;\n"
+		"\n"
+		"/**\n"
+		" * Adds a neighbor, unless it's already in the neighborhood.\n"
+		" */\n"
+		"static void _addNeighbor(Neighborhood * neighborhood, const int x, const int y) {\n"
+		"\tfor (unsigned int k = 0; k < neighborhood->count; ++k) {\n"
+		"\t\tif (neighborhood->offsets[k].x == x && neighborhood->offsets[k].y == y) {\n"
+		"\t\t\treturn;\n"
+		"\t\t}\n"
+		"\t}\n"
+		"\tif (neighborhood->count == neighborhood->capacity) {\n"
+		"\t\tneighborhood->capacity = neighborhood->capacity == 0 ? 16 : 2 * neighborhood->capacity;\n"
+		"\t\tneighborhood->offsets = realloc(neighborhood->offsets, neighborhood->capacity * sizeof(Offset));\n"
+		"\t}\n"
+		"\tneighborhood->offsets[neighborhood->count++] = (Offset) {x, y};\n"
+		"}\n"
+		"\n"
+		"/**\n"
+		" * Removes a neighbor, if it's in the neighborhood (keeping the order of the\n"
+		" * rest).\n"
+		" */\n"
+		"static void _removeNeighbor(Neighborhood * neighborhood, const int x, const int y) {\n"
+		"\tfor (unsigned int k = 0; k < neighborhood->count; ++k) {\n"
+		"\t\tif (neighborhood->offsets[k].x == x && neighborhood->offsets[k].y == y) {\n"
+		"\t\t\tmemmove(&neighborhood->offsets[k], &neighborhood->offsets[k + 1], (neighborhood->count - k - 1) * sizeof(Offset));\n"
+		"\t\t\t--neighborhood->count;\n"
+		"\t\t\treturn;\n"
+		"\t\t}\n"
+		"\t}\n"
+		"}\n"
+		"\n"
+		"/**\n"
+		" * The neighborhood program: builds the neighborhood of a cell.\n"
+		" */\n"
+		"static void _neighborhood(const uint8_t * grid, const uint8_t * cell, const int x, const int y, Neighborhood * neighborhood) {\n"
+		"\t(void) grid;\n"
+		"\t(void) x;\n"
+		"\t(void) y;\n"
+	);
+	_generateReads(generation);
+	_generateVariables(generation);
+	_output(generation, 1, "%s", "neighborhood->count = 0;\n");
+	_generateNeighborhoodSequence(generation, 1, automaton->neighborhoodProgram);
+	_output(generation, 0, "%s", "}\n\n");
+}
+
+static void _generateNeighborhoodSequence(Generation * generation, const unsigned int level, NeighborhoodSequence * sequence) {
+	for (unsigned int k = 0; k < sequence->count; ++k) {
+		NeighborhoodExpression * expression = sequence->expressions[k];
+		Range * range = expression->range;
+		unsigned int name;
+		switch (expression->type) {
+			case NEIGHBORHOOD_ASSIGNMENT:
+				_accumulateExpression(generation, level, expression->assignment);
+				_output(generation, level, "variable%u = ", expression->variable);
+				_generateExpression(generation, expression->assignment);
+				_output(generation, 0, "%s", ";\n");
+				break;
+			case NEIGHBORHOOD_FOR_LOOP:
+				if (range->type == ARRAY) {
+					for (unsigned int j = 0; j < range->array->count; ++j) {
+						_output(generation, level, "variable%u = ", expression->forVariable);
+						_generateConstant(generation, range->array->values[j]);
+						_output(generation, 0, "%s", ";\n");
+						_generateNeighborhoodSequence(generation, level, expression->forBody);
+					}
+					break;
+				}
+				name = generation->names++;
+				_output(generation, level, "const int start%u = ", name);
+				_generateConstant(generation, range->start);
+				_output(generation, 0, ";\n");
+				_output(generation, level, "const int end%u = ", name);
+				_generateConstant(generation, range->end);
+				_output(generation, 0, ";\n");
+				_output(generation, level, "for (int value%u = start%u; ; value%u += start%u <= end%u ? 1 : -1) {\n", name, name, name, name, name);
+				_output(generation, level + 1, "variable%u = value%u;\n", expression->forVariable, name);
+				_generateNeighborhoodSequence(generation, level + 1, expression->forBody);
+				_output(generation, level + 1, "if (value%u == end%u) {\n", name, name);
+				_output(generation, level + 2, "%s", "break;\n");
+				_output(generation, level + 1, "%s", "}\n");
+				_output(generation, level, "%s", "}\n");
+				break;
+			case NEIGHBORHOOD_IF:
+				_accumulateExpression(generation, level, expression->ifCondition);
+				_output(generation, level, "%s", "if (");
+				_generateExpression(generation, expression->ifCondition);
+				_output(generation, 0, "%s", ") {\n");
+				_generateNeighborhoodSequence(generation, level + 1, expression->ifBody);
+				_output(generation, level, "%s", "}\n");
+				break;
+			case NEIGHBORHOOD_IF_ELSE:
+				_accumulateExpression(generation, level, expression->ifElseCondition);
+				_output(generation, level, "%s", "if (");
+				_generateExpression(generation, expression->ifElseCondition);
+				_output(generation, 0, "%s", ") {\n");
+				_generateNeighborhoodSequence(generation, level + 1, expression->ifElseIfBody);
+				_output(generation, level, "%s", "}\n");
+				_output(generation, level, "%s", "else {\n");
+				_generateNeighborhoodSequence(generation, level + 1, expression->ifElseElseBody);
+				_output(generation, level, "%s", "}\n");
+				break;
+			case ADD_CELL_EXP:
+				_generateNeighbors(generation, level, expression->toAddList, true);
+				break;
+			case REMOVE_CELL_EXP:
+				_generateNeighbors(generation, level, expression->toRemoveList, false);
+				break;
+		}
+	}
+}
+
+/**
+ * Generates the addition (or removal) of every cell of a list.
+ */
+static void _generateNeighbors(Generation * generation, const unsigned int level, CellList * cellList, const boolean isAddition) {
+	for (unsigned int k = 0; k < cellList->count; ++k) {
+		Cell * cell = cellList->cells[k];
+		Offset offset;
+		_output(generation, level, "%s(neighborhood, ", isAddition ? "_addNeighbor" : "_removeNeighbor");
+		if (resolveStaticOffset(generation->automaton, cell, &offset)) {
+			_generateInteger(generation, offset.x);
+			_output(generation, 0, "%s", ", ");
+			_generateInteger(generation, offset.y);
+		}
+		else {
+			_generateCoordinate(generation, cell, false);
+			_output(generation, 0, "%s", ", ");
+			_generateCoordinate(generation, cell, true);
+		}
+		_output(generation, 0, "%s", ");\n");
+	}
+}
+
+/**
+ * Generates the constants of the automaton, and the helpers that every
+ * program needs: the semantics of the operators, and the frontier.
+ */
+static void _generatePrologue(Generation * generation) {
+	const Automaton * automaton = generation->automaton;
+	const char * frontiers[] = {
+		[PERIODIC] = "PERIODIC",
+		[OPEN] = "OPEN",
+		[MIRROR] = "MIRROR"
+	};
+	_output(generation, 0, "%s", generation->isKernel
+		? "/*\n"
+		" * The kernel of a cellular automaton, generated by the compiler, to be\n"
+		" * built as a shared object and loaded by its native engine.\n"
+		" */\n"
+		: "/*\n"
+		" * A standalone simulator of a cellular automaton, generated by the\n"
+		" * compiler. Build it with an optimizing compiler (e.g., \"cc -O3\n"
+		" * -march=native\"), and optionally with OpenMP (\"-fopenmp\").\n"
+		" */\n");
+	_output(generation, 0, "%s",
+		"#define _POSIX_C_SOURCE 199309L\n"
+		"\n"
+		"#include <stddef.h>\n"
+		"#include <stdint.h>\n"
+		"#include <stdio.h>\n"
+		"#include <stdlib.h>\n"
+		"#include <string.h>\n"
+		"#include <time.h>\n"
+		"\n"
+	);
+	_output(generation, 0, "#define WIDTH %u\n", automaton->width);
+	_output(generation, 0, "#define HEIGHT %u\n", automaton->height);
+	_output(generation, 0, "#define STATES %u\n", automaton->states);
+	_output(generation, 0, "#define BACKGROUND_STATE %u\n", getBackgroundState(automaton));
+	_output(generation, 0, "#define ALIVE_STATE %d\n", ALIVE_STATE);
+	_output(generation, 0, "#define DEAD_STATE %d\n", DEAD_STATE);
+	_output(generation, 0, "#define RULE_SIZE %u\n", automaton->ruleSize);
+	_output(generation, 0, "#define OUTSIDE_CELL 0x%02X\n", OUTSIDE_CELL);
+	_output(generation, 0, "#define OUTSIDE_STATE (%d)\n\n", OUTSIDE_STATE);
+	_output(generation, 0, "#define PERIODIC %d\n", PERIODIC);
+	_output(generation, 0, "#define OPEN %d\n", OPEN);
+	_output(generation, 0, "#define MIRROR %d\n", MIRROR);
+	_output(generation, 0, "#define FRONTIER %s\n\n", frontiers[automaton->frontier]);
+	_output(generation, 0, "%s", "// The halo is as wide as the farthest static offset.\n");
+	_output(generation, 0, "#define HALO %u\n", getHaloWidth(generation->minimum, generation->maximum));
+	_output(generation, 0, "%s", "#define STRIDE (WIDTH + 2 * HALO)\n\n");
+	_output(generation, 0, "%s",
+		"/**\n"
+		" * The value if the condition (zero or one) holds, or the other one, without\n"
+		" * branching (a conditional expression may keep the stencil from being\n"
+		" * vectorized).\n"
+		" */\n"
+		"static inline int _select(const int condition, const int value, const int other) {\n"
+		"\treturn other ^ (-condition & (value ^ other));\n"
+		"}\n"
+		"\n"
+		"static inline int _add(const int value, const int other) {\n"
+		"\treturn (int) ((unsigned int) value + (unsigned int) other);\n"
+		"}\n"
+		"\n"
+		"static inline int _subtract(const int value, const int other) {\n"
+		"\treturn (int) ((unsigned int) value - (unsigned int) other);\n"
+		"}\n"
+		"\n"
+		"static inline int _multiply(const int value, const int other) {\n"
+		"\treturn (int) ((unsigned int) value * (unsigned int) other);\n"
+		"}\n"
+		"\n"
+		"static inline int _divide(const int value, const int other) {\n"
+		"\treturn other == 0 ? 0 : other == -1 ? _subtract(0, value) : value / other;\n"
+		"}\n"
+		"\n"
+		"static inline int _modulo(const int value, const int other) {\n"
+		"\treturn other == 0 || other == -1 ? 0 : value % other;\n"
+		"}\n"
+		"\n"
+		"/**\n"
+		" * The value of a padded cell inside a program (OUTSIDE_STATE for an\n"
+		" * OUTSIDE_CELL), without branching.\n"
+		" */\n"
+		"static inline int _value(const uint8_t cell) {\n"
+		"\treturn (int) cell - ((cell == OUTSIDE_CELL) << 8);\n"
+		"}\n"
+		"\n"
+		"/**\n"
+		" * Maps a coordinate into the range [0, size) according to the frontier,\n"
+		" * or returns -1 if it's outside.\n"
+		" */\n"
+		"static inline int _resolve(const int coordinate, const int size) {\n"
+		"\tif (0 <= coordinate && coordinate < size) {\n"
+		"\t\treturn coordinate;\n"
+		"\t}\n"
+		"\tint wrapped;\n"
+		"\tswitch (FRONTIER) {\n"
+		"\t\tcase PERIODIC:\n"
+		"\t\t\twrapped = coordinate % size;\n"
+		"\t\t\treturn wrapped < 0 ? wrapped + size : wrapped;\n"
+		"\t\tcase MIRROR:\n"
+		"\t\t\twrapped = coordinate % (2 * size);\n"
+		"\t\t\tif (wrapped < 0) {\n"
+		"\t\t\t\twrapped += 2 * size;\n"
+		"\t\t\t}\n"
+		"\t\t\treturn wrapped < size ? wrapped : 2 * size - 1 - wrapped;\n"
+		"\t\tdefault:\n"
+		"\t\t\treturn -1;\n"
+		"\t}\n"
+		"}\n"
+		"\n"
+		"/**\n"
+		" * Reads the cell at (x, y), at an offset computed while the program runs.\n"
+		" */\n"
+		"static inline int _read(const uint8_t * grid, const int x, const int y) {\n"
+		"\tconst int column = _resolve(x, WIDTH);\n"
+		"\tconst int row = _resolve(y, HEIGHT);\n"
+		"\treturn column < 0 || row < 0 ? OUTSIDE_STATE : grid[(ptrdiff_t) row * STRIDE + column];\n"
+		"}\n"
+		"\n"
+	);
+}
+
+/**
+ * Generates an "all", "any" or "at_least" predicate, as a sum of
+ * comparisons.
+ */
+static void _generateQuantifier(Generation * generation, ArithmeticExpression * expression) {
+	const int state = generation->automaton->symbolStates[expression->state];
+	_output(generation, 0, "%s", "((0");
+	for (unsigned int k = 0; k < expression->cellList->count; ++k) {
+		_output(generation, 0, "%s", " + (");
+		_generateCell(generation, expression->cellList->cells[k]);
+		_output(generation, 0, " == %d)", state);
+	}
+	if (expression->type == ALL_ARE) {
+		_output(generation, 0, ") == %u)", expression->cellList->count);
+	}
+	else {
+		_output(generation, 0, "%s", ") >= ");
+		_generateInteger(generation, expression->count);
+		_output(generation, 0, "%s", ")");
 	}
 }
 
 /**
- * Generates the output of a constant.
+ * Generates the reads of the static offsets of the current function, once
+ * and before anything else, so every cell is loaded once.
  */
-static void _generateConstant(const unsigned int indentationLevel, Constant * constant) {
-	_output(indentationLevel, "%s", "[ $C$, circle, draw, black!20\n");
-	_output(1 + indentationLevel, "%s%d%s", "[ $", constant->value, "$, circle, draw ]\n");
-	_output(indentationLevel, "%s", "]\n");
+static void _generateReads(Generation * generation) {
+	for (unsigned int k = 0; k < generation->offsetCount; ++k) {
+		_output(generation, 1, "const int c%u = _value(cell[%d * STRIDE + %d]);\n", k, generation->offsets[k].y, generation->offsets[k].x);
+	}
 }
 
 /**
- * Creates the epilogue of the generated output, that is, the final lines that
- * completes a valid Latex document.
+ * Generates a generation of the whole grid (or of a band of rows, in a
+ * kernel): the inner loop runs the transition (or the evolution) of every
+ * cell of a row, at consecutive addresses, so it can be vectorized.
  */
-static void _generateEpilogue(const int value) {
-	_output(0, "%s%d%s",
-		"            [ $", value, "$, circle, draw, blue ]\n"
-		"        ]\n"
-		"    \\end{forest}\n"
-		"\\end{document}\n\n"
+static void _generateStep(Generation * generation) {
+	const Automaton * automaton = generation->automaton;
+	if (generation->isKernel) {
+		_output(generation, 0, "const unsigned int %s = HALO;\n\n", KERNEL_HALO_SYMBOL);
+		_output(generation, 0, "void %s(const uint8_t * restrict grid, uint8_t * restrict next, const int firstRow, const int lastRow) {\n", KERNEL_STEP_SYMBOL);
+		_output(generation, 1, "%s", "for (int y = firstRow; y < lastRow; ++y) {\n");
+	}
+	else {
+		_output(generation, 0, "%s",
+			"static void _step(const uint8_t * restrict grid, uint8_t * restrict next) {\n"
+			"#if defined(_OPENMP)\n"
+			"\t#pragma omp parallel for schedule(static)\n"
+			"#endif\n"
+			"\tfor (int y = 0; y < HEIGHT; ++y) {\n"
+		);
+	}
+	_output(generation, 0, "%s",
+		"\t\tconst uint8_t * row = grid + (ptrdiff_t) y * STRIDE;\n"
+		"\t\tuint8_t * nextRow = next + (ptrdiff_t) y * STRIDE;\n"
 	);
+	switch (automaton->rule) {
+		case TRANSITION_RULE:
+			_output(generation, 2, "%s", "for (int x = 0; x < WIDTH; ++x) {\n");
+			_output(generation, 3, "%s", "nextRow[x] = _transition(grid, row + x, x, y);\n");
+			_output(generation, 2, "%s", "}\n");
+			break;
+		case EVOLUTION_RULE:
+			if (automaton->neighborhoodProgram != NULL) {
+				_output(generation, 2, "%s", "Neighborhood neighborhood = {0};\n");
+				_output(generation, 2, "%s", "for (int x = 0; x < WIDTH; ++x) {\n");
+				_output(generation, 3, "%s", "nextRow[x] = _evolve(grid, row + x, x, y, &neighborhood);\n");
+				_output(generation, 2, "%s", "}\n");
+				_output(generation, 2, "%s", "free(neighborhood.offsets);\n");
+			}
+			else {
+				_output(generation, 2, "%s", "for (int x = 0; x < WIDTH; ++x) {\n");
+				_output(generation, 3, "%s", "nextRow[x] = _evolve(grid, row + x, x, y);\n");
+				_output(generation, 2, "%s", "}\n");
+			}
+			break;
+		case STATIC_RULE:
+		default:
+			_output(generation, 2, "%s", "memcpy(nextRow, row, WIDTH);\n");
+			break;
+	}
+	_output(generation, 0, "%s", "\t}\n}\n\n");
 }
 
-z
-/**
- * Creates the prologue of the generated output, a Latex document that renders
- * a tree thanks to the Forest package.
- *
- * @see https://ctan.dcc.uchile.cl/graphics/pgf/contrib/forest/forest-doc.pdf
- */
-static void _generatePrologue(void) {
-	_output(0, "%s",
-		"\\documentclass{standalone}\n\n"
-		"\\usepackage[utf8]{inputenc}\n"
-		"\\usepackage[T1]{fontenc}\n"
-		"\\usepackage{amsmath}\n"
-		"\\usepackage{forest}\n"
-		"\\usepackage{microtype}\n\n"
-		"\\begin{document}\n"
-		"    \\centering\n"
-		"    \\begin{forest}\n"
-		"        [ \\text{$=$}, circle, draw, purple\n"
+/**
+ * Generates the transition program as a straight-line function: every
+ * statement is predicated by a guard (whether its conditions hold) and by
+ * whether a state was already returned, so nothing branches (but the loops
+ * whose bounds aren't constant, or that are too long to unroll).
+ */
+static void _generateTransition(Generation * generation) {
+	const Automaton * automaton = generation->automaton;
+	generation->offsetCount = 0;
+	_collectTransitionSequence(generation, automaton->transitionProgram);
+	_output(generation, 0, "%s",
+		"/**\n"
+		" * The transition program: the next state of a cell.\n"
+		" */\n"
+		"static inline uint8_t _transition(const uint8_t * grid, const uint8_t * cell, const int x, const int y) {\n"
+		"\t(void) grid;\n"
+		"\t(void) x;\n"
+		"\t(void) y;\n"
 	);
+	_generateReads(generation);
+	_generateVariables(generation);
+	_output(generation, 1, "%s", "int result = OUTSIDE_STATE;\n");
+	_output(generation, 1, "%s", "int done = 0;\n");
+	_generateTransitionSequence(generation, 1, automaton->transitionProgram, "1");
+	_output(generation, 1, "%s", "return (uint8_t) (done && 0 <= result && result < STATES ? result : cell[0]);\n");
+	_output(generation, 0, "%s", "}\n\n");
+}
+
+static void _generateTransitionSequence(Generation * generation, const unsigned int level, TransitionSequence * sequence, const char * guard) {
+	for (unsigned int k = 0; k < sequence->count; ++k) {
+		TransitionExpression * expression = sequence->expressions[k];
+		Range * range = expression->range;
+		char names[2][32];
+		unsigned int name;
+		int start = 0, end = 0;
+		switch (expression->type) {
+			case TRANSITION_ASSIGNMENT:
+				_accumulateExpression(generation, level, expression->assignment);
+				_output(generation, level, "variable%u = _select(%s & !done, ", expression->variable, guard);
+				_generateExpression(generation, expression->assignment);
+				_output(generation, 0, ", variable%u);\n", expression->variable);
+				break;
+			case TRANSITION_FOR_LOOP:
+				if (range->type == ARRAY) {
+					for (unsigned int j = 0; j < range->array->count; ++j) {
+						_output(generation, level, "variable%u = _select(%s & !done, ", expression->forVariable, guard);
+						_generateConstant(generation, range->array->values[j]);
+						_output(generation, 0, ", variable%u);\n", expression->forVariable);
+						_generateTransitionSequence(generation, level, expression->forBody, guard);
+					}
+					break;
+				}
+				if (_constantValue(generation, range->start, &start) && _constantValue(generation, range->end, &end)
+						&& (start <= end ? (long) end - start : (long) start - end) < MAXIMUM_UNROLLED_ITERATIONS) {
+					const int step = start <= end ? 1 : -1;
+					for (int value = start; ; value += step) {
+						_output(generation, level, "variable%u = _select(%s & !done, ", expression->forVariable, guard);
+						_generateInteger(generation, value);
+						_output(generation, 0, ", variable%u);\n", expression->forVariable);
+						_generateTransitionSequence(generation, level, expression->forBody, guard);
+						if (value == end) {
+							break;
+						}
+					}
+					break;
+				}
+				// A loop that isn't unrolled only runs if it's reached.
+				name = generation->names++;
+				_output(generation, level, "if (%s & !done) {\n", guard);
+				_output(generation, level + 1, "const int start%u = ", name);
+				_generateConstant(generation, range->start);
+				_output(generation, 0, ";\n");
+				_output(generation, level + 1, "const int end%u = ", name);
+				_generateConstant(generation, range->end);
+				_output(generation, 0, ";\n");
+				_output(generation, level + 1, "for (int value%u = start%u; ; value%u += start%u <= end%u ? 1 : -1) {\n", name, name, name, name, name);
+				_output(generation, level + 2, "variable%u = value%u;\n", expression->forVariable, name);
+				_generateTransitionSequence(generation, level + 2, expression->forBody, guard);
+				_output(generation, level + 2, "if (done || value%u == end%u) {\n", name, name);
+				_output(generation, level + 3, "%s", "break;\n");
+				_output(generation, level + 2, "%s", "}\n");
+				_output(generation, level + 1, "%s", "}\n");
+				_output(generation, level, "%s", "}\n");
+				break;
+			case TRANSITION_IF:
+				name = generation->names++;
+				snprintf(names[0], sizeof(names[0]), "guard%u", name);
+				_accumulateExpression(generation, level, expression->ifCondition);
+				_output(generation, level, "const int %s = %s & ", names[0], guard);
+				_generateCondition(generation, expression->ifCondition);
+				_output(generation, 0, "%s", ";\n");
+				_generateTransitionSequence(generation, level, expression->ifBody, names[0]);
+				break;
+			case TRANSITION_IF_ELSE:
+				name = generation->names++;
+				snprintf(names[0], sizeof(names[0]), "guard%u", name);
+				snprintf(names[1], sizeof(names[1]), "otherGuard%u", name);
+				_accumulateExpression(generation, level, expression->ifElseCondition);
+				_output(generation, level, "const int condition%u = ", name);
+				_generateCondition(generation, expression->ifElseCondition);
+				_output(generation, 0, "%s", ";\n");
+				_output(generation, level, "const int %s = %s & condition%u;\n", names[0], guard, name);
+				_output(generation, level, "const int %s = %s & !condition%u;\n", names[1], guard, name);
+				_generateTransitionSequence(generation, level, expression->ifElseIfBody, names[0]);
+				_generateTransitionSequence(generation, level, expression->ifElseElseBody, names[1]);
+				break;
+			case RETURN_VALUE:
+				_accumulateExpression(generation, level, expression->returnValue);
+				_output(generation, level, "result = _select(%s & !done, ", guard);
+				_generateExpression(generation, expression->returnValue);
+				_output(generation, 0, "%s", ", result);\n");
+				_output(generation, level, "done |= %s;\n", guard);
+				break;
+		}
+	}
+}
+
+/**
+ * Generates the variables of a program, which start at zero for every cell.
+ */
+static void _generateVariables(Generation * generation) {
+	const Automaton * automaton = generation->automaton;
+	for (unsigned int k = 0; k < automaton->symbols; ++k) {
+		if (automaton->symbolStates[k] == NO_STATE) {
+			_output(generation, 1, "int variable%u = 0;\n", k);
+		}
+	}
 }
 
 /**
@@ -96,28 +1323,140 @@ static char * _indentation(const unsigned int level) {
 }
 
 /**
- * Outputs a formatted string to standard output. The "fflush" instruction
- * allows to see the output even close to a failure, because it drops the
- * buffering.
+ * Whether an expression is always zero or one (i.e., a comparison, a logical
+ * operator or a predicate).
+ */
+static boolean _isBoolean(ArithmeticExpression * expression) {
+	while (expression->type == FACTOR) {
+		expression = expression->expression;
+	}
+	switch (expression->type) {
+		case ADDITION:
+		case DIVISION:
+		case MULTIPLICATION:
+		case SUBTRACTION:
+		case MODULE:
+		case CONSTANT:
+			return false;
+		default:
+			return true;
+	}
+}
+
+/**
+ * Whether an expression is a binary operation (i.e., it has a left and a
+ * right operand).
  */
-static void _output(const unsigned int indentationLevel, const char * const format, ...) {
+static boolean _isOperation(ArithmeticExpression * expression) {
+	switch (expression->type) {
+		case CONSTANT:
+		case FACTOR:
+		case LOGIC_NOT:
+		case ALL_ARE:
+		case ANY_ARE:
+		case AT_LEAST_ARE:
+			return false;
+		default:
+			return true;
+	}
+}
+
+/**
+ * The text of a binary operation before its left operand ("open") and
+ * between its operands ("middle"). It always ends with a parenthesis. The
+ * arithmetic wraps around (and a division by zero is zero), like in the
+ * interpreter, and the operands of a logical operator are conditions.
+ */
+static void _operation(ArithmeticExpression * expression, const char ** open, const char ** middle) {
+	*open = "(";
+	switch (expression->type) {
+		case ADDITION: *open = "_add("; *middle = ", "; break;
+		case SUBTRACTION: *open = "_subtract("; *middle = ", "; break;
+		case MULTIPLICATION: *open = "_multiply("; *middle = ", "; break;
+		case DIVISION: *open = "_divide("; *middle = ", "; break;
+		case MODULE: *open = "_modulo("; *middle = ", "; break;
+		case EQUALS: *middle = " == "; break;
+		case NOT_EQUALS: *middle = " != "; break;
+		case LOWER_THAN: *middle = " < "; break;
+		case LOWER_THAN_OR_EQUAL: *middle = " <= "; break;
+		case GREATER_THAN: *middle = " > "; break;
+		case GREATER_THAN_OR_EQUAL: *middle = " >= "; break;
+		case LOGIC_AND: *middle = " & "; break;
+		case LOGIC_OR:
+		default:
+			*middle = " | ";
+			break;
+	}
+}
+
+/**
+ * Outputs a formatted string to the file of the generation.
+ */
+static void _output(Generation * generation, const unsigned int indentationLevel, const char * const format, ...) {
 	va_list arguments;
 	va_start(arguments, format);
 	char * indentation = _indentation(indentationLevel);
 	char * effectiveFormat = concatenate(2, indentation, format);
-	vfprintf(stdout, effectiveFormat, arguments);
-	fflush(stdout);
+	vfprintf(generation->file, effectiveFormat, arguments);
 	free(effectiveFormat);
 	free(indentation);
 	va_end(arguments);
 }
 
+/**
+ * Pops the frame of a generated expression, closing it if it's a condition.
+ */
+static void _popFrame(Generation * generation) {
+	const GenerationFrame * frame = &generation->frames[--generation->frameCount];
+	if (frame->isCondition && !_isBoolean(frame->expression)) {
+		_output(generation, 0, "%s", " != 0)");
+	}
+}
+
+/**
+ * Pushes an expression onto the work stack, opening it if it's generated as
+ * a condition (that isn't zero or one already).
+ */
+static void _pushFrame(Generation * generation, ArithmeticExpression * expression, const boolean isCondition) {
+	if (generation->frameCount == generation->frameCapacity) {
+		generation->frameCapacity = generation->frameCapacity == 0 ? 64 : 2 * generation->frameCapacity;
+		generation->frames = realloc(generation->frames, generation->frameCapacity * sizeof(GenerationFrame));
+	}
+	generation->frames[generation->frameCount++] = (GenerationFrame) {
+		.expression = expression,
+		.stage = 0,
+		.isCondition = isCondition
+	};
+	if (isCondition && !_isBoolean(expression)) {
+		_output(generation, 0, "%s", "(");
+	}
+}
+
 /** PUBLIC FUNCTIONS */
 
-void generate(CompilerState * compilerState) {
-	logDebugging(_logger, "Generating final output...");
-	_generatePrologue();
-	_generateProgram(compilerState->abstractSyntaxtTree);
-	_generateEpilogue(compilerState->value);
-	logDebugging(_logger, "Generation is done.");
+char * getGeneratorOutput(const char * programPath) {
+	const char * output = getStringOrDefault("GENERATOR_OUTPUT", NULL);
+	if (output == NULL || output[0] == '\0') {
+		return NULL;
+	}
+#if !defined (_WIN32)
+	struct stat status;
+	if (stat(output, &status) == 0 && S_ISDIR(status.st_mode)) {
+		const char * name = strrchr(programPath, '/');
+		name = name == NULL ? programPath : name + 1;
+		if (strcmp(name, "-") == 0) {
+			name = "standard-input";
+		}
+		return concatenate(4, output, "/", name, ".c");
+	}
+#endif
+	return concatenate(1, output);
+}
+
+boolean generate(const Automaton * automaton, const char * path) {
+	return _generateFile(automaton, path, false);
+}
+
+boolean generateKernel(const Automaton * automaton, const char * path) {
+	return _generateFile(automaton, path, true);
 }
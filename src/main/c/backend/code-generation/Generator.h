@@ -2,11 +2,22 @@
 #define GENERATOR_HEADER
 
 #include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
-#include "../../shared/CompilerState.h"
+#include "../../shared/Environment.h"
 #include "../../shared/Logger.h"
 #include "../../shared/String.h"
+#include "../../shared/Type.h"
+#include "../simulation/Automaton.h"
+#include "../simulation/PaddedGrid.h"
+#include <limits.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined (_WIN32)
+#include <sys/stat.h>
+#endif
 
 /** Initialize module's internal state. */
 void initializeGeneratorModule();
@@ -15,8 +26,66 @@ void initializeGeneratorModule();
 void shutdownGeneratorModule();
 
 /**
- * Generates the final output using the current compiler state.
+ * The most iterations of a loop with constant bounds that are unrolled into
+ * the straight-line code of a transition. Longer loops are kept as loops.
+ */
+#define MAXIMUM_UNROLLED_ITERATIONS 64
+
+/**
+ * The longest chain of operations (e.g., a sum of that many terms) that is
+ * generated as a nested expression. A longer one is accumulated in a
+ * temporary, one operation per statement.
+ */
+#define MAXIMUM_NESTED_OPERATIONS 64
+
+/**
+ * The symbols exported by a kernel (see "generateKernel"): the width of the
+ * halo that its grids need, and the function that computes the next
+ * generation of a band of rows.
+ */
+#define KERNEL_HALO_SYMBOL "kernelHalo"
+#define KERNEL_STEP_SYMBOL "stepKernel"
+
+/**
+ * The step of a kernel: computes the rows in [firstRow, lastRow) of the next
+ * generation. Both grids point to the cell at (0, 0) of a padded grid with
+ * the halo of the kernel (see "PaddedGrid.h"), and the halo of the current
+ * one must be filled.
+ */
+typedef void (* KernelStep)(const uint8_t * grid, uint8_t * next, const int firstRow, const int lastRow);
+
+/**
+ * The path of the C source generated for a program, from the
+ * "GENERATOR_OUTPUT" environment variable (undefined by default, that is,
+ * nothing is generated). If it's a directory, the source is generated
+ * inside it, named after the program. Returns NULL if nothing must be
+ * generated, or a path that must be freed.
+ */
+char * getGeneratorOutput(const char * programPath);
+
+/**
+ * Generates a self-contained C translation unit that simulates an
+ * automaton: the size of the grid, the states, the frontier and the static
+ * offsets are compile-time constants, the grid is padded with a halo (so
+ * every neighbor is at a constant displacement), and the transition program
+ * is a straight-line inline function (every statement is predicated instead
+ * of branching), so an optimizing C compiler can vectorize the whole
+ * stencil. A neighborhood program that can't be folded is generated as a
+ * function that builds the neighborhood of every cell.
+ *
+ * The simulator takes the amount of generations, the seed and the density
+ * as arguments, starts from the same random grid as the simulation engines
+ * (see "randomizeGrid"), and prints the hash of the last generation (see
+ * "hashGrid"). Returns false if the file can't be written.
+ */
+boolean generate(const Automaton * automaton, const char * path);
+
+/**
+ * Generates the kernel of an automaton: the same specialized code of its
+ * standalone simulator (see "generate"), but without an entry-point, to be
+ * built as a shared object that exports the step of a band of rows and the
+ * width of its halo. Returns false if the file can't be written.
  */
-void generate(CompilerState * compilerState);
+boolean generateKernel(const Automaton * automaton, const char * path);
 
 #endif
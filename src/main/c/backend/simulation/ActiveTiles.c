@@ -0,0 +1,111 @@
+#include "ActiveTiles.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeActiveTilesModule() {
+	_logger = createLogger("ActiveTiles");
+}
+
+void shutdownActiveTilesModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static boolean _isActive(const ActiveTiles * tiles, const int column, const int row);
+
+/**
+ * Whether a tile reads a tile that changed in the last generation (or a
+ * tile outside the grid that isn't constant).
+ */
+static boolean _isActive(const ActiveTiles * tiles, const int column, const int row) {
+	for (int y = row + tiles->minimum.y; y <= row + tiles->maximum.y; ++y) {
+		for (int x = column + tiles->minimum.x; x <= column + tiles->maximum.x; ++x) {
+			if (x < 0 || (int) tiles->columns <= x || y < 0 || (int) tiles->rows <= y) {
+				if (!tiles->isOpen) {
+					return true;
+				}
+			}
+			else if (tiles->changed[(size_t) y * tiles->columns + x]) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/* PUBLIC FUNCTIONS */
+
+unsigned int getActiveTileSize() {
+	const int size = getIntegerOrDefault("ACTIVE_TILE_SIZE", DEFAULT_ACTIVE_TILE_SIZE);
+	return size < 0 ? 0 : (unsigned int) size;
+}
+
+ActiveTiles * createActiveTiles(const Automaton * automaton, const unsigned int tileWidth, const unsigned int tileHeight, const Offset minimum, const Offset maximum) {
+	ActiveTiles * tiles = calloc(1, sizeof(ActiveTiles));
+	tiles->width = automaton->width;
+	tiles->height = automaton->height;
+	tiles->tileWidth = tileWidth;
+	tiles->tileHeight = tileHeight;
+	tiles->columns = (automaton->width + tileWidth - 1) / tileWidth;
+	tiles->rows = (automaton->height + tileHeight - 1) / tileHeight;
+	// The first and last cells of a tile read up to these tiles (rounding
+	// towards minus infinity).
+	tiles->minimum.x = -(int) ((-minimum.x + tileWidth - 1) / tileWidth);
+	tiles->minimum.y = -(int) ((-minimum.y + tileHeight - 1) / tileHeight);
+	tiles->maximum.x = (int) ((tileWidth - 1 + maximum.x) / tileWidth);
+	tiles->maximum.y = (int) ((tileHeight - 1 + maximum.y) / tileHeight);
+	tiles->isOpen = automaton->frontier == OPEN;
+	tiles->changed = calloc((size_t) tiles->columns * tiles->rows, sizeof(uint8_t));
+	tiles->active = calloc((size_t) tiles->columns * tiles->rows, sizeof(uint8_t));
+	resetActiveTiles(tiles);
+	logDebugging(_logger, "Tracking %ux%u tiles of %ux%u cells.", tiles->columns, tiles->rows, tileWidth, tileHeight);
+	return tiles;
+}
+
+void destroyActiveTiles(ActiveTiles * tiles) {
+	if (tiles != NULL) {
+		free(tiles->changed);
+		free(tiles->active);
+		free(tiles);
+	}
+}
+
+void resetActiveTiles(ActiveTiles * tiles) {
+	memset(tiles->changed, 1, (size_t) tiles->columns * tiles->rows);
+}
+
+void prepareActiveTiles(ActiveTiles * tiles) {
+	tiles->computed = 0;
+	for (unsigned int row = 0; row < tiles->rows; ++row) {
+		for (unsigned int column = 0; column < tiles->columns; ++column) {
+			const boolean isActive = _isActive(tiles, (int) column, (int) row);
+			tiles->active[(size_t) row * tiles->columns + column] = isActive;
+			tiles->computed += isActive;
+		}
+	}
+	memset(tiles->changed, 0, (size_t) tiles->columns * tiles->rows);
+	tiles->skipped = tiles->columns * tiles->rows - tiles->computed;
+	tiles->totalComputed += tiles->computed;
+	tiles->totalSkipped += tiles->skipped;
+	logDebugging(_logger, "Generation %llu: computing %u tiles, and skipping %u.", (unsigned long long) ++tiles->generation, tiles->computed, tiles->skipped);
+}
+
+void runActiveTiles(ActiveTiles * tiles, TileTask task, void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow) {
+	for (unsigned int row = firstRow / tiles->tileHeight; row * tiles->tileHeight < lastRow; ++row) {
+		const unsigned int tileFirstRow = row * tiles->tileHeight;
+		const unsigned int tileLastRow = tileFirstRow + tiles->tileHeight < tiles->height ? tileFirstRow + tiles->tileHeight : tiles->height;
+		for (unsigned int column = 0; column < tiles->columns; ++column) {
+			const size_t tile = (size_t) row * tiles->columns + column;
+			if (tiles->active[tile]) {
+				const unsigned int firstColumn = column * tiles->tileWidth;
+				const unsigned int lastColumn = firstColumn + tiles->tileWidth < tiles->width ? firstColumn + tiles->tileWidth : tiles->width;
+				tiles->changed[tile] = task(context, worker, firstColumn, lastColumn, tileFirstRow, tileLastRow);
+			}
+		}
+	}
+}
@@ -0,0 +1,105 @@
+#ifndef ACTIVE_TILES_HEADER
+#define ACTIVE_TILES_HEADER
+
+#include "../../shared/Environment.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "Automaton.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeActiveTilesModule();
+
+/** Shutdown module's internal state. */
+void shutdownActiveTilesModule();
+
+/**
+ * The default side of a tile (in cells), overridable with the
+ * "ACTIVE_TILE_SIZE" environment variable (where 0 disables the tracking).
+ */
+#define DEFAULT_ACTIVE_TILE_SIZE 64
+
+/**
+ * Computes the next generation of the cells in [firstColumn, lastColumn) x
+ * [firstRow, lastRow) of a grid, on a worker. Returns whether any of them
+ * changed.
+ */
+typedef boolean (* TileTask)(void * context, const unsigned int worker,
+	const unsigned int firstColumn, const unsigned int lastColumn, const unsigned int firstRow, const unsigned int lastRow);
+
+/**
+ * The grid split into tiles, to compute only the ones that can change. The
+ * next generation of a tile only depends on the cells around it, so if none
+ * of them changed in the last generation, neither does the tile, and the
+ * buffer of the next generation (i.e., the one before the last) already has
+ * its cells.
+ *
+ * If the frontier is not open, the tiles on the borders read the cells of
+ * the opposite ones (or themselves), so they are always computed.
+ */
+typedef struct {
+	unsigned int width;
+	unsigned int height;
+	unsigned int tileWidth;
+	unsigned int tileHeight;
+
+	// The amount of tiles in a row, and of rows of tiles.
+	unsigned int columns;
+	unsigned int rows;
+
+	// The tiles read by a tile, relative to it.
+	Offset minimum;
+	Offset maximum;
+	boolean isOpen;
+
+	// Whether each tile changed in the last generation, and whether it has
+	// to be computed in the next one.
+	uint8_t * changed;
+	uint8_t * active;
+
+	// The tiles computed and skipped in the last generation, and in total.
+	uint64_t generation;
+	unsigned int computed;
+	unsigned int skipped;
+	uint64_t totalComputed;
+	uint64_t totalSkipped;
+} ActiveTiles;
+
+/**
+ * The side of the tiles from the environment, or 0 if the tracking is
+ * disabled.
+ */
+unsigned int getActiveTileSize();
+
+/**
+ * Splits the grid of an automaton into tiles. The cells read to compute a
+ * cell are in the bounding box of offsets [minimum, maximum].
+ */
+ActiveTiles * createActiveTiles(const Automaton * automaton, const unsigned int tileWidth, const unsigned int tileHeight, const Offset minimum, const Offset maximum);
+
+/**
+ * Destroys the tiles.
+ */
+void destroyActiveTiles(ActiveTiles * tiles);
+
+/**
+ * Marks every tile as changed (e.g., after a grid is loaded).
+ */
+void resetActiveTiles(ActiveTiles * tiles);
+
+/**
+ * Selects the tiles to compute in the next generation: the ones with a
+ * changed tile around them. Logs the amount of computed and skipped tiles.
+ */
+void prepareActiveTiles(ActiveTiles * tiles);
+
+/**
+ * Runs a task on every selected tile of the rows in [firstRow, lastRow),
+ * which must be the rows of whole tiles (except the last ones of the grid),
+ * and records which tiles changed.
+ */
+void runActiveTiles(ActiveTiles * tiles, TileTask task, void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow);
+
+#endif
@@ -0,0 +1,572 @@
+#include "Automaton.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeAutomatonModule() {
+	_logger = createLogger("Automaton");
+}
+
+void shutdownAutomatonModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static unsigned int _buildEvolution(Automaton * automaton, Evolution * evolution);
+static unsigned int _buildNeighborhood(Automaton * automaton, const boolean hasNeighborhood);
+static unsigned int _buildStates(Automaton * automaton, CompilerState * compilerState, Option * option);
+static unsigned int _collectOptions(Configuration * configuration, Option ** options);
+static unsigned int _countCellExpressions(NeighborhoodSequence * sequence);
+static uint64_t _hashCell(const Automaton * automaton, uint64_t hash, Cell * cell);
+static uint64_t _hashConstant(const Automaton * automaton, uint64_t hash, Constant * constant);
+static uint64_t _hashExpression(const Automaton * automaton, uint64_t hash, ArithmeticExpression * expression);
+static uint64_t _hashNeighborhoodSequence(const Automaton * automaton, uint64_t hash, NeighborhoodSequence * sequence);
+static uint64_t _hashRange(const Automaton * automaton, uint64_t hash, Range * range);
+static uint64_t _hashTransitionSequence(const Automaton * automaton, uint64_t hash, TransitionSequence * sequence);
+static uint64_t _hashValue(uint64_t hash, const int value);
+static const char * _optionName(const OptionType type);
+
+/**
+ * Builds the rule of an evolution, checking that every amount of neighbors
+ * is possible (negative amounts are allowed, but never match). Returns the
+ * amount of errors found.
+ */
+static unsigned int _buildEvolution(Automaton * automaton, Evolution * evolution) {
+	static const int conwaySurvival[] = {2, 3};
+	const int * survival = NULL;
+	unsigned int survivalCount = 0;
+	int birth = 0;
+	if (evolution->isDefault) {
+		if (evolution->evolutionTypes == CONWAY) {
+			survival = conwaySurvival;
+			survivalCount = 2;
+			birth = 3;
+		}
+		else {
+			birth = 2;
+		}
+	}
+	else {
+		survival = evolution->array->values;
+		survivalCount = evolution->array->count;
+		birth = evolution->value;
+	}
+	unsigned int errors = 0;
+	int maximum = birth < 0 ? 0 : birth;
+	for (unsigned int k = 0; k < survivalCount; ++k) {
+		if (maximum < survival[k]) {
+			maximum = survival[k];
+		}
+		if (survival[k] < 0) {
+			logWarning(_logger, "A negative amount of neighbors never matches: %d.", survival[k]);
+		}
+	}
+	if (birth < 0) {
+		logWarning(_logger, "A negative amount of neighbors never matches: %d.", birth);
+	}
+	// A custom neighborhood has no fixed size.
+	if (automaton->neighborhood != CUSTOM && (int) automaton->neighborCount < maximum) {
+		logError(_logger, "The evolution expects %d neighbors, but the neighborhood has only %u.", maximum, automaton->neighborCount);
+		++errors;
+	}
+	if (errors == 0) {
+		automaton->ruleSize = 1 + (unsigned int) maximum;
+		automaton->survives = calloc(automaton->ruleSize, sizeof(boolean));
+		automaton->born = calloc(automaton->ruleSize, sizeof(boolean));
+		for (unsigned int k = 0; k < survivalCount; ++k) {
+			if (0 <= survival[k]) {
+				automaton->survives[survival[k]] = true;
+			}
+		}
+		if (0 <= birth) {
+			automaton->born[birth] = true;
+		}
+	}
+	return errors;
+}
+
+/**
+ * Builds the offsets of a predefined neighborhood (in row-major order), or
+ * checks that a custom one has a program that adds cells. Returns the amount
+ * of errors found.
+ */
+static unsigned int _buildNeighborhood(Automaton * automaton, const boolean hasNeighborhood) {
+	if (automaton->neighborhoodProgram != NULL) {
+		if (hasNeighborhood && automaton->neighborhood != CUSTOM) {
+			logError(_logger, "A neighborhood program requires a CUSTOM neighborhood.");
+			return 1;
+		}
+		automaton->neighborhood = CUSTOM;
+		if (_countCellExpressions(automaton->neighborhoodProgram) == 0) {
+			logError(_logger, "The neighborhood program never adds a cell.");
+			return 1;
+		}
+		return 0;
+	}
+	int radius = 1;
+	switch (automaton->neighborhood) {
+		case CUSTOM:
+			logError(_logger, "A CUSTOM neighborhood requires a neighborhood program.");
+			return 1;
+		case VON_NEUMANN:
+			automaton->neighborCount = 4;
+			automaton->neighbors = calloc(4, sizeof(Offset));
+			automaton->neighbors[0] = (Offset) {0, -1};
+			automaton->neighbors[1] = (Offset) {-1, 0};
+			automaton->neighbors[2] = (Offset) {1, 0};
+			automaton->neighbors[3] = (Offset) {0, 1};
+			return 0;
+		case K_NEIGHBORHOOD:
+			radius = getIntegerOrDefault("K_NEIGHBORHOOD_RADIUS", DEFAULT_K_NEIGHBORHOOD_RADIUS);
+			if (radius < 1 || 64 < radius) {
+				logError(_logger, "The radius of the K_NEIGHBORHOOD must be between 1 and 64, but it's %d.", radius);
+				return 1;
+			}
+		case MOORE:
+		default:
+			automaton->neighborCount = (2 * radius + 1) * (2 * radius + 1) - 1;
+			automaton->neighbors = calloc(automaton->neighborCount, sizeof(Offset));
+			unsigned int index = 0;
+			for (int y = -radius; y <= radius; ++y) {
+				for (int x = -radius; x <= radius; ++x) {
+					if (x != 0 || y != 0) {
+						automaton->neighbors[index++] = (Offset) {x, y};
+					}
+				}
+			}
+			return 0;
+	}
+}
+
+/**
+ * Collects the names of the states (by index), and the state of every
+ * symbol. Returns the amount of errors found.
+ */
+static unsigned int _buildStates(Automaton * automaton, CompilerState * compilerState, Option * option) {
+	if (option == NULL) {
+		logError(_logger, "The States option is required.");
+		return 1;
+	}
+	SymbolTable * symbolTable = compilerState->symbolTable;
+	automaton->states = symbolTable->states;
+	if (MAXIMUM_STATES < automaton->states) {
+		logError(_logger, "An automaton can have up to %d states, but it has %u.", MAXIMUM_STATES, automaton->states);
+		return 1;
+	}
+	automaton->stateNames = calloc(automaton->states, sizeof(char *));
+	automaton->symbols = symbolTable->count;
+	automaton->symbolStates = calloc(1 + automaton->symbols, sizeof(int));
+	for (unsigned int k = 0; k < symbolTable->count; ++k) {
+		Symbol * symbol = getSymbol(symbolTable, k);
+		automaton->symbolStates[k] = symbol->state;
+		if (symbol->state != NO_STATE) {
+			automaton->stateNames[symbol->state] = symbol->name;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Indexes the options by type. Returns the amount of errors found (i.e.,
+ * repeated options).
+ */
+static unsigned int _collectOptions(Configuration * configuration, Option ** options) {
+	unsigned int errors = 0;
+	for (unsigned int k = 0; k < configuration->count; ++k) {
+		Option * option = configuration->options[k];
+		if (options[option->type] != NULL) {
+			logError(_logger, "The %s option is declared more than once.", _optionName(option->type));
+			++errors;
+		}
+		options[option->type] = option;
+	}
+	return errors;
+}
+
+/**
+ * Counts the "add" expressions of a neighborhood program, including the
+ * nested ones.
+ */
+static unsigned int _countCellExpressions(NeighborhoodSequence * sequence) {
+	unsigned int count = 0;
+	for (unsigned int k = 0; k < sequence->count; ++k) {
+		NeighborhoodExpression * expression = sequence->expressions[k];
+		switch (expression->type) {
+			case NEIGHBORHOOD_FOR_LOOP:
+				count += _countCellExpressions(expression->forBody);
+				break;
+			case NEIGHBORHOOD_IF:
+				count += _countCellExpressions(expression->ifBody);
+				break;
+			case NEIGHBORHOOD_IF_ELSE:
+				count += _countCellExpressions(expression->ifElseIfBody);
+				count += _countCellExpressions(expression->ifElseElseBody);
+				break;
+			case ADD_CELL_EXP:
+				++count;
+				break;
+			default:
+				break;
+		}
+	}
+	return count;
+}
+
+/**
+ * Hashes a cell, by its displacement or by its coordinates.
+ */
+static uint64_t _hashCell(const Automaton * automaton, uint64_t hash, Cell * cell) {
+	hash = _hashValue(hash, cell->isSingleCoordenate);
+	if (cell->isSingleCoordenate) {
+		hash = _hashValue(hash, cell->displacementType);
+		return _hashConstant(automaton, hash, cell->displacement);
+	}
+	hash = _hashConstant(automaton, hash, cell->x);
+	return _hashConstant(automaton, hash, cell->y);
+}
+
+/**
+ * Hashes a constant. A state is hashed by its index (not its name), so two
+ * programs that only rename their states hash the same.
+ */
+static uint64_t _hashConstant(const Automaton * automaton, uint64_t hash, Constant * constant) {
+	switch (constant->type) {
+		case INTEGER_C:
+			return _hashValue(_hashValue(hash, INTEGER_C), constant->value);
+		case STRING_C:
+			if (automaton->symbolStates[constant->symbol] != NO_STATE) {
+				return _hashValue(_hashValue(hash, INTEGER_C), automaton->symbolStates[constant->symbol]);
+			}
+			return _hashValue(_hashValue(hash, STRING_C), (int) constant->symbol);
+		case CELL_C:
+		default:
+			return _hashCell(automaton, _hashValue(hash, CELL_C), constant->cell);
+	}
+}
+
+/**
+ * Hashes an expression, with its type and then its operands, in pre-order
+ * from a work stack (so it can nest arbitrarily deep).
+ */
+static uint64_t _hashExpression(const Automaton * automaton, uint64_t hash, ArithmeticExpression * expression) {
+	unsigned int capacity = 64;
+	unsigned int count = 0;
+	ArithmeticExpression ** pending = calloc(capacity, sizeof(ArithmeticExpression *));
+	pending[count++] = expression;
+	while (0 < count) {
+		expression = pending[--count];
+		hash = _hashValue(hash, expression->type);
+		if (capacity < count + 2) {
+			capacity *= 2;
+			pending = realloc(pending, capacity * sizeof(ArithmeticExpression *));
+		}
+		switch (expression->type) {
+			case CONSTANT:
+				hash = _hashConstant(automaton, hash, expression->constant);
+				break;
+			case FACTOR:
+			case LOGIC_NOT:
+				pending[count++] = expression->expression;
+				break;
+			case ALL_ARE:
+			case ANY_ARE:
+			case AT_LEAST_ARE:
+				hash = _hashValue(hash, automaton->symbolStates[expression->state]);
+				hash = _hashValue(hash, expression->type == ALL_ARE ? 0 : expression->count);
+				hash = _hashValue(hash, (int) expression->cellList->count);
+				for (unsigned int k = 0; k < expression->cellList->count; ++k) {
+					hash = _hashCell(automaton, hash, expression->cellList->cells[k]);
+				}
+				break;
+			default:
+				pending[count++] = expression->rightExpression;
+				pending[count++] = expression->leftExpression;
+				break;
+		}
+	}
+	free(pending);
+	return hash;
+}
+
+/**
+ * Hashes a neighborhood sequence, statement by statement.
+ */
+static uint64_t _hashNeighborhoodSequence(const Automaton * automaton, uint64_t hash, NeighborhoodSequence * sequence) {
+	hash = _hashValue(hash, (int) sequence->count);
+	for (unsigned int k = 0; k < sequence->count; ++k) {
+		NeighborhoodExpression * expression = sequence->expressions[k];
+		CellList * cellList = NULL;
+		hash = _hashValue(hash, expression->type);
+		switch (expression->type) {
+			case NEIGHBORHOOD_ASSIGNMENT:
+				hash = _hashValue(hash, (int) expression->variable);
+				hash = _hashExpression(automaton, hash, expression->assignment);
+				break;
+			case NEIGHBORHOOD_FOR_LOOP:
+				hash = _hashValue(hash, (int) expression->forVariable);
+				hash = _hashRange(automaton, hash, expression->range);
+				hash = _hashNeighborhoodSequence(automaton, hash, expression->forBody);
+				break;
+			case NEIGHBORHOOD_IF:
+				hash = _hashExpression(automaton, hash, expression->ifCondition);
+				hash = _hashNeighborhoodSequence(automaton, hash, expression->ifBody);
+				break;
+			case NEIGHBORHOOD_IF_ELSE:
+				hash = _hashExpression(automaton, hash, expression->ifElseCondition);
+				hash = _hashNeighborhoodSequence(automaton, hash, expression->ifElseIfBody);
+				hash = _hashNeighborhoodSequence(automaton, hash, expression->ifElseElseBody);
+				break;
+			case ADD_CELL_EXP:
+				cellList = expression->toAddList;
+				break;
+			case REMOVE_CELL_EXP:
+				cellList = expression->toRemoveList;
+				break;
+		}
+		if (cellList != NULL) {
+			hash = _hashValue(hash, (int) cellList->count);
+			for (unsigned int j = 0; j < cellList->count; ++j) {
+				hash = _hashCell(automaton, hash, cellList->cells[j]);
+			}
+		}
+	}
+	return hash;
+}
+
+/**
+ * Hashes the range of a loop, by its values or by its bounds.
+ */
+static uint64_t _hashRange(const Automaton * automaton, uint64_t hash, Range * range) {
+	hash = _hashValue(hash, range->type);
+	if (range->type == ARRAY) {
+		hash = _hashValue(hash, (int) range->array->count);
+		for (unsigned int k = 0; k < range->array->count; ++k) {
+			hash = _hashConstant(automaton, hash, range->array->values[k]);
+		}
+		return hash;
+	}
+	hash = _hashConstant(automaton, hash, range->start);
+	return _hashConstant(automaton, hash, range->end);
+}
+
+/**
+ * Hashes a transition sequence, statement by statement.
+ */
+static uint64_t _hashTransitionSequence(const Automaton * automaton, uint64_t hash, TransitionSequence * sequence) {
+	hash = _hashValue(hash, (int) sequence->count);
+	for (unsigned int k = 0; k < sequence->count; ++k) {
+		TransitionExpression * expression = sequence->expressions[k];
+		hash = _hashValue(hash, expression->type);
+		switch (expression->type) {
+			case TRANSITION_ASSIGNMENT:
+				hash = _hashValue(hash, (int) expression->variable);
+				hash = _hashExpression(automaton, hash, expression->assignment);
+				break;
+			case TRANSITION_FOR_LOOP:
+				hash = _hashValue(hash, (int) expression->forVariable);
+				hash = _hashRange(automaton, hash, expression->range);
+				hash = _hashTransitionSequence(automaton, hash, expression->forBody);
+				break;
+			case TRANSITION_IF:
+				hash = _hashExpression(automaton, hash, expression->ifCondition);
+				hash = _hashTransitionSequence(automaton, hash, expression->ifBody);
+				break;
+			case TRANSITION_IF_ELSE:
+				hash = _hashExpression(automaton, hash, expression->ifElseCondition);
+				hash = _hashTransitionSequence(automaton, hash, expression->ifElseIfBody);
+				hash = _hashTransitionSequence(automaton, hash, expression->ifElseElseBody);
+				break;
+			case RETURN_VALUE:
+				hash = _hashExpression(automaton, hash, expression->returnValue);
+				break;
+		}
+	}
+	return hash;
+}
+
+/**
+ * Adds a value to a 64-bit FNV-1a hash, byte by byte.
+ */
+static uint64_t _hashValue(uint64_t hash, const int value) {
+	const uint32_t bits = (uint32_t) value;
+	for (unsigned int k = 0; k < 4; ++k) {
+		hash ^= (bits >> (8 * k)) & 0xFF;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+/**
+ * The name of an option, as written in a program.
+ */
+static const char * _optionName(const OptionType type) {
+	switch (type) {
+		case HEIGHT_OPTION: return "Height";
+		case WIDTH_OPTION: return "Width";
+		case FRONTIER_OPTION: return "Frontier";
+		case COLORS_OPTION: return "Colors";
+		case STATES_OPTION: return "States";
+		case NEIGHBORHOOD_OPTION: return "Neighborhood";
+		case EVOLUTION_OPTION: return "Evolution";
+		default: return "unknown";
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+Automaton * createAutomaton(CompilerState * compilerState) {
+	Program * program = compilerState->abstractSyntaxtTree;
+	Automaton * automaton = calloc(1, sizeof(Automaton));
+	Option * options[EVOLUTION_OPTION + 1] = {NULL};
+	unsigned int errors = _collectOptions(program->type == DEFAULT ? program->justConfiguration : program->configuration, options);
+	if (options[HEIGHT_OPTION] == NULL || options[WIDTH_OPTION] == NULL) {
+		logError(_logger, "The Height and Width options are required.");
+		++errors;
+	}
+	else if (options[HEIGHT_OPTION]->value < 1 || options[WIDTH_OPTION]->value < 1
+			|| UINT32_MAX / (unsigned int) options[WIDTH_OPTION]->value < (unsigned int) options[HEIGHT_OPTION]->value) {
+		logError(_logger, "Invalid size of the grid: %dx%d.", options[WIDTH_OPTION]->value, options[HEIGHT_OPTION]->value);
+		++errors;
+	}
+	else {
+		automaton->width = options[WIDTH_OPTION]->value;
+		automaton->height = options[HEIGHT_OPTION]->value;
+	}
+	automaton->frontier = options[FRONTIER_OPTION] == NULL ? PERIODIC : options[FRONTIER_OPTION]->frontierType;
+	errors += _buildStates(automaton, compilerState, options[STATES_OPTION]);
+	if (options[COLORS_OPTION] != NULL) {
+		IntArray * colors = options[COLORS_OPTION]->colors;
+		automaton->colorCount = colors->count;
+		automaton->colors = calloc(colors->count, sizeof(int));
+		memcpy(automaton->colors, colors->values, colors->count * sizeof(int));
+		if (automaton->colorCount < automaton->states) {
+			logWarning(_logger, "There are less colors (%u) than states (%u).", automaton->colorCount, automaton->states);
+		}
+	}
+	automaton->neighborhood = options[NEIGHBORHOOD_OPTION] == NULL ? MOORE : options[NEIGHBORHOOD_OPTION]->neighborhoodEnum;
+	switch (program->type) {
+		case TRANSITION:
+			automaton->rule = TRANSITION_RULE;
+			automaton->transitionProgram = program->transitionSequence;
+			if (options[EVOLUTION_OPTION] != NULL) {
+				logWarning(_logger, "The Evolution option is ignored by a transition program.");
+			}
+			break;
+		case NEIGHBORHOOD_PROGRAM:
+			automaton->neighborhoodProgram = program->neighborhoodSequence;
+			if (options[EVOLUTION_OPTION] == NULL) {
+				logError(_logger, "A neighborhood program requires the Evolution option.");
+				++errors;
+			}
+		default:
+			if (options[EVOLUTION_OPTION] == NULL) {
+				automaton->rule = STATIC_RULE;
+				break;
+			}
+			automaton->rule = EVOLUTION_RULE;
+			if (automaton->states != 2) {
+				logError(_logger, "An evolution requires exactly 2 states (alive and dead), but there are %u.", automaton->states);
+				++errors;
+			}
+			const unsigned int neighborhoodErrors = _buildNeighborhood(automaton, options[NEIGHBORHOOD_OPTION] != NULL);
+			errors += neighborhoodErrors;
+			if (neighborhoodErrors == 0) {
+				errors += _buildEvolution(automaton, options[EVOLUTION_OPTION]->evolution);
+			}
+	}
+	if (0 < errors) {
+		destroyAutomaton(automaton);
+		return NULL;
+	}
+	return automaton;
+}
+
+void destroyAutomaton(Automaton * automaton) {
+	if (automaton != NULL) {
+		free(automaton->stateNames);
+		free(automaton->colors);
+		free(automaton->neighbors);
+		free(automaton->survives);
+		free(automaton->born);
+		free(automaton->symbolStates);
+		free(automaton);
+	}
+}
+
+uint8_t evolve(const Automaton * automaton, const uint8_t state, const unsigned int aliveNeighbors) {
+	if (automaton->ruleSize <= aliveNeighbors) {
+		return DEAD_STATE;
+	}
+	const boolean * rule = state == ALIVE_STATE ? automaton->survives : automaton->born;
+	return rule[aliveNeighbors] ? ALIVE_STATE : DEAD_STATE;
+}
+
+uint8_t getBackgroundState(const Automaton * automaton) {
+	return automaton->rule == EVOLUTION_RULE ? DEAD_STATE : 0;
+}
+
+uint64_t hashAutomaton(const Automaton * automaton) {
+	uint64_t hash = 14695981039346656037ull;
+	hash = _hashValue(hash, (int) automaton->width);
+	hash = _hashValue(hash, (int) automaton->height);
+	hash = _hashValue(hash, automaton->frontier);
+	hash = _hashValue(hash, (int) automaton->states);
+	hash = _hashValue(hash, automaton->rule);
+	if (automaton->rule == TRANSITION_RULE) {
+		return _hashTransitionSequence(automaton, hash, automaton->transitionProgram);
+	}
+	if (automaton->rule == EVOLUTION_RULE) {
+		hash = _hashValue(hash, (int) automaton->ruleSize);
+		for (unsigned int k = 0; k < automaton->ruleSize; ++k) {
+			hash = _hashValue(hash, automaton->survives[k] | automaton->born[k] << 1);
+		}
+		hash = _hashValue(hash, (int) automaton->neighborCount);
+		for (unsigned int k = 0; k < automaton->neighborCount; ++k) {
+			hash = _hashValue(_hashValue(hash, automaton->neighbors[k].x), automaton->neighbors[k].y);
+		}
+		hash = _hashValue(hash, automaton->neighborhoodProgram != NULL);
+		if (automaton->neighborhoodProgram != NULL) {
+			hash = _hashNeighborhoodSequence(automaton, hash, automaton->neighborhoodProgram);
+		}
+	}
+	return hash;
+}
+
+boolean resolveStaticOffset(const Automaton * automaton, Cell * cell, Offset * offset) {
+	Constant * constants[2] = {cell->isSingleCoordenate ? cell->displacement : cell->x, cell->isSingleCoordenate ? NULL : cell->y};
+	int values[2] = {0, 0};
+	for (unsigned int k = 0; k < 2 && constants[k] != NULL; ++k) {
+		if (constants[k]->type == INTEGER_C) {
+			values[k] = constants[k]->value;
+		}
+		else if (constants[k]->type == STRING_C && automaton->symbolStates[constants[k]->symbol] != NO_STATE) {
+			values[k] = automaton->symbolStates[constants[k]->symbol];
+		}
+		else {
+			return false;
+		}
+	}
+	if (!cell->isSingleCoordenate) {
+		*offset = (Offset) {values[0], values[1]};
+		return true;
+	}
+	switch (cell->displacementType) {
+		case HORIZONTAL_D:
+			*offset = (Offset) {values[0], 0};
+			break;
+		case VERTICAL_D:
+			*offset = (Offset) {0, values[0]};
+			break;
+		case DIAGONAL_ASC_D:
+			*offset = (Offset) {values[0], -values[0]};
+			break;
+		case DIAGONAL_DESC_D:
+		default:
+			*offset = (Offset) {values[0], values[0]};
+	}
+	return true;
+}
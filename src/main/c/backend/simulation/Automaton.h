@@ -0,0 +1,149 @@
+#ifndef AUTOMATON_HEADER
+#define AUTOMATON_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/CompilerState.h"
+#include "../../shared/Environment.h"
+#include "../../shared/Logger.h"
+#include "../../shared/SymbolTable.h"
+#include "../../shared/Type.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeAutomatonModule();
+
+/** Shutdown module's internal state. */
+void shutdownAutomatonModule();
+
+/**
+ * The maximum amount of states of an automaton. A cell is stored in a single
+ * byte, and the last value is reserved for the cells outside an open grid.
+ */
+#define MAXIMUM_STATES 255
+
+/**
+ * The byte of a cell outside an open grid.
+ */
+#define OUTSIDE_CELL 0xFF
+
+/**
+ * The value of a cell outside an open grid, inside a program. It's not equal
+ * to any state.
+ */
+#define OUTSIDE_STATE (-1)
+
+/**
+ * The states of an evolution: the first declared state is alive, and the
+ * second one is dead.
+ */
+#define ALIVE_STATE 0
+#define DEAD_STATE 1
+
+/**
+ * The default radius of the K_NEIGHBORHOOD (a Moore neighborhood of radius
+ * K), overridable with the "K_NEIGHBORHOOD_RADIUS" environment variable.
+ */
+#define DEFAULT_K_NEIGHBORHOOD_RADIUS 2
+
+/**
+ * The displacement from a cell to another one, where "x" grows to the right
+ * (i.e., the column) and "y" grows downwards (i.e., the row).
+ */
+typedef struct {
+	int x;
+	int y;
+} Offset;
+
+/**
+ * How the next state of a cell is computed.
+ */
+typedef enum {
+	// Every cell keeps its state.
+	STATIC_RULE,
+	// A life-like rule: birth and survival by the amount of alive neighbors.
+	EVOLUTION_RULE,
+	// The transition program.
+	TRANSITION_RULE
+} RuleType;
+
+/**
+ * A validated automaton, built from the AST (i.e., a DTO of the backend).
+ * The programs still point to the AST, so an automaton is valid until the
+ * arena of its compilation is reset.
+ */
+typedef struct {
+	unsigned int width;
+	unsigned int height;
+	FrontierEnum frontier;
+
+	// The names of the states, by index, and their colors (if any).
+	const char ** stateNames;
+	unsigned int states;
+	int * colors;
+	unsigned int colorCount;
+
+	RuleType rule;
+
+	// The neighborhood of an evolution. A custom neighborhood is computed by
+	// its program (and the offsets are empty), unless the program is folded
+	// into its offsets (see "foldNeighborhood").
+	NeighborhoodEnum neighborhood;
+	Offset * neighbors;
+	unsigned int neighborCount;
+	NeighborhoodSequence * neighborhoodProgram;
+
+	// The rule of an evolution, by amount of alive neighbors (from zero to
+	// the size of the rule, exclusive). Bigger amounts always die.
+	boolean * survives;
+	boolean * born;
+	unsigned int ruleSize;
+
+	TransitionSequence * transitionProgram;
+
+	// The state of every symbol, by identifier (or NO_STATE, if it's a
+	// variable).
+	int * symbolStates;
+	unsigned int symbols;
+} Automaton;
+
+/**
+ * Builds the automaton of the program in the compiler state, validating its
+ * configuration. Returns NULL (after logging every problem) if the program
+ * is not a valid automaton.
+ */
+Automaton * createAutomaton(CompilerState * compilerState);
+
+/**
+ * Destroys an automaton (but not the AST it points to).
+ */
+void destroyAutomaton(Automaton * automaton);
+
+/**
+ * Computes the next state of a cell with an evolution rule, given its state
+ * and the amount of alive neighbors.
+ */
+uint8_t evolve(const Automaton * automaton, const uint8_t state, const unsigned int aliveNeighbors);
+
+/**
+ * The state of the empty space: the dead state of an evolution, or the
+ * first declared state otherwise.
+ */
+uint8_t getBackgroundState(const Automaton * automaton);
+
+/**
+ * A 64-bit hash of everything that determines how the cells of an automaton
+ * evolve (the size of the grid, the frontier, the states and the rule, with
+ * its programs), but not their names or colors. Two automata with the same
+ * hash are simulated alike.
+ */
+uint64_t hashAutomaton(const Automaton * automaton);
+
+/**
+ * Computes the offset of a cell if its coordinates are constant (integers
+ * or states). Returns false otherwise.
+ */
+boolean resolveStaticOffset(const Automaton * automaton, Cell * cell, Offset * offset);
+
+#endif
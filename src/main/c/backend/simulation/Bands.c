@@ -0,0 +1,78 @@
+#include "Bands.h"
+
+/**
+ * The buffers of a copy (see "copyBands").
+ */
+typedef struct {
+	uint8_t * destination;
+	const uint8_t * source;
+	size_t rowSize;
+} BandCopy;
+
+/* PRIVATE FUNCTIONS */
+
+static void _copyBand(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow);
+static void _runBand(void * argument, const unsigned int worker);
+
+static void _copyBand(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow) {
+	BandCopy * copy = context;
+	const size_t offset = firstRow * copy->rowSize;
+	memcpy(copy->destination + offset, copy->source + offset, (lastRow - firstRow) * copy->rowSize);
+}
+
+/**
+ * Runs the current task on the band of a worker.
+ */
+static void _runBand(void * argument, const unsigned int worker) {
+	Bands * bands = argument;
+	const unsigned int units = (bands->rows + bands->granularity - 1) / bands->granularity;
+	const unsigned int firstRow = (unsigned int) ((uint64_t) worker * units / bands->workers) * bands->granularity;
+	const unsigned int lastRow = (unsigned int) ((uint64_t) (worker + 1) * units / bands->workers) * bands->granularity;
+	bands->task(bands->context, worker, firstRow, lastRow < bands->rows ? lastRow : bands->rows);
+}
+
+/* PUBLIC FUNCTIONS */
+
+Bands * createBands(const unsigned int rows, const unsigned int granularity, const unsigned int threads) {
+	Bands * bands = calloc(1, sizeof(Bands));
+	bands->rows = rows;
+	bands->granularity = granularity < 1 ? 1 : granularity;
+	bands->workers = threads == 0 ? availableProcessors() : threads;
+	const unsigned int minimumRows = bands->granularity < MINIMUM_BAND_ROWS ? MINIMUM_BAND_ROWS : bands->granularity;
+	if (rows / minimumRows < bands->workers) {
+		bands->workers = rows / minimumRows;
+	}
+	if (bands->workers < 1) {
+		bands->workers = 1;
+	}
+	if (1 < bands->workers) {
+		bands->threadPool = createThreadPool(bands->workers);
+	}
+	return bands;
+}
+
+void destroyBands(Bands * bands) {
+	if (bands != NULL) {
+		destroyThreadPool(bands->threadPool);
+		free(bands);
+	}
+}
+
+void copyBands(Bands * bands, uint8_t * destination, const uint8_t * source, const size_t rowSize) {
+	BandCopy copy = {
+		.destination = destination,
+		.source = source,
+		.rowSize = rowSize
+	};
+	runBands(bands, _copyBand, &copy);
+}
+
+void runBands(Bands * bands, BandTask task, void * context) {
+	if (bands->threadPool == NULL) {
+		task(context, 0, 0, bands->rows);
+		return;
+	}
+	bands->task = task;
+	bands->context = context;
+	broadcastToThreadPool(bands->threadPool, _runBand, bands);
+}
@@ -0,0 +1,71 @@
+#ifndef BANDS_HEADER
+#define BANDS_HEADER
+
+#include "../../shared/ThreadPool.h"
+#include "../../shared/Type.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The minimum amount of rows of a band, so the workers of a small grid don't
+ * spend more time synchronizing than computing.
+ */
+#define MINIMUM_BAND_ROWS 32
+
+/**
+ * Computes the rows in [firstRow, lastRow) of a grid, on a worker (from zero
+ * to the amount of workers, exclusive).
+ */
+typedef void (* BandTask)(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow);
+
+/**
+ * The rows of a grid split into contiguous bands, one per worker of a
+ * persistent thread pool. A worker always computes the same band, so the
+ * memory of its rows is first touched (i.e., allocated by the operating
+ * system, in the NUMA node of its processor) and then reused by the same
+ * thread, generation after generation. The rows of a band are computed in
+ * order, so the rows around the current one stay in the cache.
+ */
+typedef struct {
+	// The pool of the workers (NULL if there is only one, that runs on the
+	// calling thread).
+	ThreadPool * threadPool;
+	unsigned int workers;
+	unsigned int rows;
+
+	// The first row of every band is a multiple of this amount.
+	unsigned int granularity;
+
+	// The task being run.
+	BandTask task;
+	void * context;
+} Bands;
+
+/**
+ * Splits the rows of a grid into bands, for the specified amount of threads
+ * (or the amount of processors, if zero). The bands start at multiples of
+ * the granularity (e.g., to never split a tile), and there are never more
+ * bands than rows allow (see MINIMUM_BAND_ROWS).
+ */
+Bands * createBands(const unsigned int rows, const unsigned int granularity, const unsigned int threads);
+
+/**
+ * Stops the workers, and destroys the bands.
+ */
+void destroyBands(Bands * bands);
+
+/**
+ * Copies rows of the same size from a buffer into another one, each band on
+ * its own worker (e.g., to load a grid, so every worker first touches the
+ * memory of its band).
+ */
+void copyBands(Bands * bands, uint8_t * destination, const uint8_t * source, const size_t rowSize);
+
+/**
+ * Runs a task on every band, in parallel, and blocks until all of them are
+ * done.
+ */
+void runBands(Bands * bands, BandTask task, void * context);
+
+#endif
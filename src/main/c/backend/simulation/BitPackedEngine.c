@@ -0,0 +1,445 @@
+#include "BitPackedEngine.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeBitPackedEngineModule() {
+	_logger = createLogger("BitPackedEngine");
+}
+
+void shutdownBitPackedEngineModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/**
+ * A vector of 64-bit words, processed as a whole by the kernels (with GCC
+ * vector extensions, so the compiler emits SSE2 or AVX2 instructions
+ * depending on the target of each kernel).
+ */
+typedef uint64_t Lanes __attribute__((vector_size(sizeof(uint64_t) * BIT_PACKED_LANES)));
+
+typedef struct BitPackedEngine BitPackedEngine;
+
+/**
+ * Computes the next generation of the words in [firstWord, lastWord) of the
+ * rows in [firstRow, lastRow), and returns whether any cell changed.
+ */
+typedef boolean (* BitPackedKernel)(const BitPackedEngine * engine,
+	const unsigned int firstRow, const unsigned int lastRow, const unsigned int firstWord, const unsigned int lastWord);
+
+/**
+ * The state of a bit-packed engine. A row has a guard word before its cells,
+ * and it's padded to a multiple of the lanes (plus another guard word), so
+ * the kernels never branch on the borders. The first and last rows are
+ * guards too. Before every step, the guards are filled with the neighbors
+ * of the border cells, according to the frontier.
+ */
+struct BitPackedEngine {
+	unsigned int width;
+	unsigned int height;
+	FrontierEnum frontier;
+	boolean isVonNeumann;
+
+	// The words with cells in a row, and the total words of a row.
+	unsigned int words;
+	unsigned int stride;
+
+	// The bits of the words of a row that are cells (i.e., not guards).
+	uint64_t * masks;
+
+	// The current generation, and the buffer of the next one.
+	uint64_t * current;
+	uint64_t * next;
+
+	// The amounts of alive neighbors that keep a cell alive, or make it
+	// born, as a bitmask.
+	uint32_t survival;
+	uint32_t birth;
+
+	BitPackedKernel kernel;
+	Bands * bands;
+	ActiveTiles * tiles;
+};
+
+/**
+ * A grid being loaded into (or stored from) an engine, by bands.
+ */
+typedef struct {
+	BitPackedEngine * bitPacked;
+	Grid * grid;
+} BitPackedTransfer;
+
+/* PRIVATE FUNCTIONS */
+
+static void _advance(Engine * engine, const uint64_t generations);
+static void _destroy(Engine * engine);
+static uint64_t _getBit(const uint64_t * row, const unsigned int x);
+static void _load(Engine * engine, const Grid * grid);
+static void _loadBand(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow);
+static void _prepareGuards(BitPackedEngine * bitPacked);
+static BitPackedKernel _selectKernel(const char ** name);
+static void _stepBand(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow);
+static inline boolean _stepRows(const BitPackedEngine * engine,
+	const unsigned int firstRow, const unsigned int lastRow, const unsigned int firstWord, const unsigned int lastWord) __attribute__((always_inline));
+static boolean _stepRowsPortable(const BitPackedEngine * engine,
+	const unsigned int firstRow, const unsigned int lastRow, const unsigned int firstWord, const unsigned int lastWord);
+#if defined(__x86_64__) || defined(__i386__)
+static boolean _stepRowsAvx2(const BitPackedEngine * engine,
+	const unsigned int firstRow, const unsigned int lastRow, const unsigned int firstWord, const unsigned int lastWord) __attribute__((target("avx2")));
+static boolean _stepRowsSse2(const BitPackedEngine * engine,
+	const unsigned int firstRow, const unsigned int lastRow, const unsigned int firstWord, const unsigned int lastWord) __attribute__((target("sse2")));
+#endif
+static boolean _stepTile(void * context, const unsigned int worker,
+	const unsigned int firstColumn, const unsigned int lastColumn, const unsigned int firstRow, const unsigned int lastRow);
+static void _store(Engine * engine, Grid * grid);
+static void _storeBand(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow);
+
+static void _advance(Engine * engine, const uint64_t generations) {
+	BitPackedEngine * bitPacked = engine->data;
+	for (uint64_t generation = 0; generation < generations; ++generation) {
+		_prepareGuards(bitPacked);
+		if (bitPacked->tiles != NULL) {
+			prepareActiveTiles(bitPacked->tiles);
+		}
+		runBands(bitPacked->bands, _stepBand, bitPacked);
+		uint64_t * swap = bitPacked->current;
+		bitPacked->current = bitPacked->next;
+		bitPacked->next = swap;
+	}
+}
+
+static void _destroy(Engine * engine) {
+	BitPackedEngine * bitPacked = engine->data;
+	destroyBands(bitPacked->bands);
+	destroyActiveTiles(bitPacked->tiles);
+	free(bitPacked->masks);
+	free(bitPacked->current);
+	free(bitPacked->next);
+	free(bitPacked);
+	free(engine);
+}
+
+/**
+ * The bit of the cell at column "x" of a row (with its guard word).
+ */
+static uint64_t _getBit(const uint64_t * row, const unsigned int x) {
+	return (row[1 + x / 64] >> (x % 64)) & 1;
+}
+
+static void _load(Engine * engine, const Grid * grid) {
+	BitPackedTransfer transfer = {
+		.bitPacked = engine->data,
+		.grid = (Grid *) grid
+	};
+	runBands(transfer.bitPacked->bands, _loadBand, &transfer);
+	if (transfer.bitPacked->tiles != NULL) {
+		resetActiveTiles(transfer.bitPacked->tiles);
+	}
+}
+
+/**
+ * Packs the rows of a band of a grid.
+ */
+static void _loadBand(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow) {
+	BitPackedTransfer * transfer = context;
+	BitPackedEngine * bitPacked = transfer->bitPacked;
+	const Grid * grid = transfer->grid;
+	uint64_t * rows = bitPacked->current + (size_t) (firstRow + 1) * bitPacked->stride;
+	memset(rows, 0, (size_t) (lastRow - firstRow) * bitPacked->stride * sizeof(uint64_t));
+	for (unsigned int y = firstRow; y < lastRow; ++y) {
+		const uint8_t * cells = grid->cells + (size_t) y * grid->width;
+		uint64_t * row = bitPacked->current + (size_t) (y + 1) * bitPacked->stride;
+		for (unsigned int x = 0; x < bitPacked->width; ++x) {
+			row[1 + x / 64] |= (uint64_t) (cells[x] == ALIVE_STATE) << (x % 64);
+		}
+	}
+}
+
+/**
+ * Fills the guards of the current generation: the bits after the last cell
+ * of every row are cleared (except the first one, the eastern neighbor of
+ * the last cell), the last bit of the first guard word is the western
+ * neighbor of the first cell, and the guard rows are copies of the northern
+ * and southern neighbors of the first and last rows (or empty, if the
+ * frontier is open).
+ */
+static void _prepareGuards(BitPackedEngine * bitPacked) {
+	const unsigned int last = 1 + bitPacked->width / 64;
+	const uint64_t used = (UINT64_C(1) << (bitPacked->width % 64)) - 1;
+	for (unsigned int y = 1; y <= bitPacked->height; ++y) {
+		uint64_t * row = bitPacked->current + (size_t) y * bitPacked->stride;
+		uint64_t west = 0;
+		uint64_t east = 0;
+		if (bitPacked->frontier == PERIODIC) {
+			west = _getBit(row, bitPacked->width - 1);
+			east = _getBit(row, 0);
+		}
+		else if (bitPacked->frontier == MIRROR) {
+			west = _getBit(row, 0);
+			east = _getBit(row, bitPacked->width - 1);
+		}
+		row[0] = west << 63;
+		row[last] = (row[last] & used) | (east << (bitPacked->width % 64));
+		for (unsigned int k = last + 1; k < bitPacked->stride; ++k) {
+			row[k] = 0;
+		}
+	}
+	const size_t rowSize = bitPacked->stride * sizeof(uint64_t);
+	uint64_t * north = bitPacked->current;
+	uint64_t * south = bitPacked->current + (size_t) (bitPacked->height + 1) * bitPacked->stride;
+	switch (bitPacked->frontier) {
+		case PERIODIC:
+			memcpy(north, south - bitPacked->stride, rowSize);
+			memcpy(south, north + bitPacked->stride, rowSize);
+			break;
+		case MIRROR:
+			memcpy(north, north + bitPacked->stride, rowSize);
+			memcpy(south, south - bitPacked->stride, rowSize);
+			break;
+		case OPEN:
+		default:
+			memset(north, 0, rowSize);
+			memset(south, 0, rowSize);
+			break;
+	}
+}
+
+/**
+ * Selects the widest kernel supported by the processor, with CPUID.
+ */
+static BitPackedKernel _selectKernel(const char ** name) {
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		*name = "AVX2";
+		return _stepRowsAvx2;
+	}
+	if (__builtin_cpu_supports("sse2")) {
+		*name = "SSE2";
+		return _stepRowsSse2;
+	}
+#endif
+	*name = "portable";
+	return _stepRowsPortable;
+}
+
+/**
+ * Computes the next generation of the rows of a band (only in the active
+ * tiles, if they are tracked).
+ */
+static void _stepBand(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow) {
+	BitPackedEngine * bitPacked = context;
+	if (bitPacked->tiles == NULL) {
+		_stepTile(bitPacked, worker, 0, bitPacked->width, firstRow, lastRow);
+	}
+	else {
+		runActiveTiles(bitPacked->tiles, _stepTile, bitPacked, worker, firstRow, lastRow);
+	}
+}
+
+/**
+ * The body of every kernel. The 8 (or 4) neighbors of each cell are the
+ * rows above, below and itself, shifted one bit to the west and to the east
+ * (carrying the bits of the adjacent words). Their amount is computed with
+ * full and half adders over whole words, as 4 bit-planes (the binary digits
+ * of the amount of every cell), and then compared with the amounts of the
+ * rule.
+ */
+static inline boolean _stepRows(const BitPackedEngine * engine,
+		const unsigned int firstRow, const unsigned int lastRow, const unsigned int firstWord, const unsigned int lastWord) {
+	const size_t stride = engine->stride;
+	const uint32_t survival = engine->survival;
+	const uint32_t birth = engine->birth;
+	const unsigned int maximum = engine->isVonNeumann ? 4 : 8;
+	const Lanes zero = {0};
+	Lanes difference = zero;
+	for (unsigned int y = firstRow; y < lastRow; ++y) {
+		const uint64_t * above = engine->current + (y - 1) * stride;
+		const uint64_t * middle = above + stride;
+		const uint64_t * below = middle + stride;
+		uint64_t * output = engine->next + y * stride;
+		for (unsigned int k = firstWord; k < lastWord; k += BIT_PACKED_LANES) {
+			Lanes north, south, centre, west, east, bit0, bit1, bit2, bit3, previous, following;
+			memcpy(&centre, middle + k, sizeof(Lanes));
+			memcpy(&previous, middle + k - 1, sizeof(Lanes));
+			memcpy(&following, middle + k + 1, sizeof(Lanes));
+			west = (centre << 1) | (previous >> 63);
+			east = (centre >> 1) | (following << 63);
+			memcpy(&north, above + k, sizeof(Lanes));
+			memcpy(&south, below + k, sizeof(Lanes));
+			if (engine->isVonNeumann) {
+				const Lanes sum = north ^ south ^ west;
+				const Lanes carry = (north & south) | (west & (north ^ south));
+				bit0 = sum ^ east;
+				const Lanes carry2 = sum & east;
+				bit1 = carry ^ carry2;
+				bit2 = carry & carry2;
+				bit3 = zero;
+			}
+			else {
+				memcpy(&previous, above + k - 1, sizeof(Lanes));
+				memcpy(&following, above + k + 1, sizeof(Lanes));
+				const Lanes northWest = (north << 1) | (previous >> 63);
+				const Lanes northEast = (north >> 1) | (following << 63);
+				memcpy(&previous, below + k - 1, sizeof(Lanes));
+				memcpy(&following, below + k + 1, sizeof(Lanes));
+				const Lanes southWest = (south << 1) | (previous >> 63);
+				const Lanes southEast = (south >> 1) | (following << 63);
+				// Ones and twos of each row of neighbors.
+				const Lanes northOnes = northWest ^ north ^ northEast;
+				const Lanes northTwos = (northWest & north) | (northEast & (northWest ^ north));
+				const Lanes southOnes = southWest ^ south ^ southEast;
+				const Lanes southTwos = (southWest & south) | (southEast & (southWest ^ south));
+				const Lanes middleOnes = west ^ east;
+				const Lanes middleTwos = west & east;
+				// Sum of the ones, and then of the five twos.
+				bit0 = northOnes ^ southOnes ^ middleOnes;
+				const Lanes onesCarry = (northOnes & southOnes) | (middleOnes & (northOnes ^ southOnes));
+				const Lanes twos = northTwos ^ southTwos ^ middleTwos;
+				const Lanes twosCarry = (northTwos & southTwos) | (middleTwos & (northTwos ^ southTwos));
+				bit1 = twos ^ onesCarry;
+				const Lanes fours = twos & onesCarry;
+				bit2 = twosCarry ^ fours;
+				bit3 = twosCarry & fours;
+			}
+			Lanes result = zero;
+			for (unsigned int count = 0; count <= maximum; ++count) {
+				if (((survival | birth) >> count) & 1) {
+					const Lanes equal = ((count & 1) ? bit0 : ~bit0)
+						& ((count & 2) ? bit1 : ~bit1)
+						& ((count & 4) ? bit2 : ~bit2)
+						& ((count & 8) ? bit3 : ~bit3);
+					if (!((survival >> count) & 1)) {
+						result |= equal & ~centre;
+					}
+					else if (!((birth >> count) & 1)) {
+						result |= equal & centre;
+					}
+					else {
+						result |= equal;
+					}
+				}
+			}
+			memcpy(output + k, &result, sizeof(Lanes));
+			Lanes mask;
+			memcpy(&mask, engine->masks + k, sizeof(Lanes));
+			difference |= (result ^ centre) & mask;
+		}
+	}
+	uint64_t changed = 0;
+	for (unsigned int k = 0; k < BIT_PACKED_LANES; ++k) {
+		changed |= difference[k];
+	}
+	return changed != 0;
+}
+
+static boolean _stepRowsPortable(const BitPackedEngine * engine,
+		const unsigned int firstRow, const unsigned int lastRow, const unsigned int firstWord, const unsigned int lastWord) {
+	return _stepRows(engine, firstRow, lastRow, firstWord, lastWord);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+static boolean _stepRowsAvx2(const BitPackedEngine * engine,
+		const unsigned int firstRow, const unsigned int lastRow, const unsigned int firstWord, const unsigned int lastWord) {
+	return _stepRows(engine, firstRow, lastRow, firstWord, lastWord);
+}
+
+static boolean _stepRowsSse2(const BitPackedEngine * engine,
+		const unsigned int firstRow, const unsigned int lastRow, const unsigned int firstWord, const unsigned int lastWord) {
+	return _stepRows(engine, firstRow, lastRow, firstWord, lastWord);
+}
+
+#endif
+
+/**
+ * Computes the next generation of a rectangle of cells (after the guard
+ * row), whose columns are whole vectors of words (except the last ones of
+ * the grid, that are padded).
+ */
+static boolean _stepTile(void * context, const unsigned int worker,
+		const unsigned int firstColumn, const unsigned int lastColumn, const unsigned int firstRow, const unsigned int lastRow) {
+	BitPackedEngine * bitPacked = context;
+	const unsigned int words = (lastColumn + 63) / 64;
+	const unsigned int lastWord = 1 + BIT_PACKED_LANES * ((words + BIT_PACKED_LANES - 1) / BIT_PACKED_LANES);
+	return bitPacked->kernel(bitPacked, firstRow + 1, lastRow + 1, 1 + firstColumn / 64, lastWord);
+}
+
+static void _store(Engine * engine, Grid * grid) {
+	BitPackedTransfer transfer = {
+		.bitPacked = engine->data,
+		.grid = grid
+	};
+	runBands(transfer.bitPacked->bands, _storeBand, &transfer);
+}
+
+/**
+ * Unpacks the rows of a band into a grid.
+ */
+static void _storeBand(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow) {
+	BitPackedTransfer * transfer = context;
+	const BitPackedEngine * bitPacked = transfer->bitPacked;
+	Grid * grid = transfer->grid;
+	for (unsigned int y = firstRow; y < lastRow; ++y) {
+		uint8_t * cells = grid->cells + (size_t) y * grid->width;
+		const uint64_t * row = bitPacked->current + (size_t) (y + 1) * bitPacked->stride;
+		for (unsigned int x = 0; x < bitPacked->width; ++x) {
+			cells[x] = _getBit(row, x) ? ALIVE_STATE : DEAD_STATE;
+		}
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+boolean isBitPackable(const Automaton * automaton) {
+	return automaton->rule == EVOLUTION_RULE
+		&& automaton->states == 2
+		&& automaton->neighborhoodProgram == NULL
+		&& (automaton->neighborhood == MOORE || automaton->neighborhood == VON_NEUMANN);
+}
+
+Engine * createBitPackedEngine(const Automaton * automaton, const unsigned int threads) {
+	BitPackedEngine * bitPacked = calloc(1, sizeof(BitPackedEngine));
+	bitPacked->width = automaton->width;
+	bitPacked->height = automaton->height;
+	bitPacked->frontier = automaton->frontier;
+	bitPacked->isVonNeumann = automaton->neighborhood == VON_NEUMANN;
+	bitPacked->words = (automaton->width + 63) / 64;
+	bitPacked->stride = BIT_PACKED_LANES * ((bitPacked->words + BIT_PACKED_LANES - 1) / BIT_PACKED_LANES) + 2;
+	const size_t size = (size_t) (automaton->height + 2) * bitPacked->stride;
+	bitPacked->current = calloc(size, sizeof(uint64_t));
+	bitPacked->next = calloc(size, sizeof(uint64_t));
+	bitPacked->masks = calloc(bitPacked->stride, sizeof(uint64_t));
+	for (unsigned int k = 0; k < bitPacked->words; ++k) {
+		const unsigned int cells = automaton->width - 64 * k;
+		bitPacked->masks[1 + k] = cells < 64 ? (UINT64_C(1) << cells) - 1 : ~UINT64_C(0);
+	}
+	for (unsigned int count = 0; count < automaton->ruleSize; ++count) {
+		bitPacked->survival |= (uint32_t) automaton->survives[count] << count;
+		bitPacked->birth |= (uint32_t) automaton->born[count] << count;
+	}
+	const char * kernelName = NULL;
+	bitPacked->kernel = _selectKernel(&kernelName);
+	// A tile is made of whole vectors of words, and every cell only reads
+	// its 8 (or 4) adjacent cells.
+	const unsigned int tileSize = getActiveTileSize();
+	const unsigned int tileWidth = 64 * BIT_PACKED_LANES * ((tileSize + 64 * BIT_PACKED_LANES - 1) / (64 * BIT_PACKED_LANES));
+	if (0 < tileSize) {
+		bitPacked->tiles = createActiveTiles(automaton, tileWidth, tileSize, (Offset) {-1, -1}, (Offset) {1, 1});
+	}
+	bitPacked->bands = createBands(automaton->height, bitPacked->tiles == NULL ? 1 : tileSize, threads);
+	logDebugging(_logger, "Using the %s kernel, with %u words per row, on %u threads.", kernelName, bitPacked->stride, bitPacked->bands->workers);
+	Engine * engine = calloc(1, sizeof(Engine));
+	engine->name = "bit-packed";
+	engine->automaton = automaton;
+	engine->data = bitPacked;
+	engine->tiles = bitPacked->tiles;
+	engine->load = _load;
+	engine->advance = _advance;
+	engine->store = _store;
+	engine->destroy = _destroy;
+	return engine;
+}
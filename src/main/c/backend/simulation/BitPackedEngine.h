@@ -0,0 +1,44 @@
+#ifndef BIT_PACKED_ENGINE_HEADER
+#define BIT_PACKED_ENGINE_HEADER
+
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "ActiveTiles.h"
+#include "Automaton.h"
+#include "Bands.h"
+#include "Engine.h"
+#include "Grid.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeBitPackedEngineModule();
+
+/** Shutdown module's internal state. */
+void shutdownBitPackedEngineModule();
+
+/**
+ * The amount of 64-bit words processed at once by the kernels (i.e., 256
+ * bits, a single AVX2 register, or two SSE2 ones).
+ */
+#define BIT_PACKED_LANES 4
+
+/**
+ * Whether an automaton can run on the bit-packed engine: a life-like
+ * evolution of two states on a MOORE or VON_NEUMANN neighborhood.
+ */
+boolean isBitPackable(const Automaton * automaton);
+
+/**
+ * Creates an engine that stores every cell in a single bit (1 if it's
+ * alive), in rows of 64-bit words. The neighbors of 256 cells are counted at
+ * once with bit-sliced adders, and the rule is applied as a pair of bitmasks
+ * (birth and survival, by amount of alive neighbors). The kernel is selected
+ * at runtime: AVX2 if the processor supports it, or SSE2 otherwise. The
+ * rows are split into bands, for the specified amount of threads (see
+ * "createBands").
+ */
+Engine * createBitPackedEngine(const Automaton * automaton, const unsigned int threads);
+
+#endif
@@ -0,0 +1,1140 @@
+#include "Bytecode.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeBytecodeModule() {
+	_logger = createLogger("Bytecode");
+}
+
+void shutdownBytecodeModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/**
+ * A comparison of the cell at a static offset with a state.
+ */
+typedef struct {
+	int index;
+	int state;
+} Comparison;
+
+/**
+ * The forward jumps to the same (still unknown) target.
+ */
+typedef struct {
+	unsigned int * jumps;
+	unsigned int count;
+	unsigned int capacity;
+} JumpList;
+
+/**
+ * An expression on the work stack of the compiler (the program can nest
+ * them arbitrarily deep, e.g. in a long sum). The frame yields its operands
+ * one at a time, and resumes at its next stage once each one is compiled,
+ * keeping the register of the first one in "operand" (and, for a
+ * short-circuit, its pending jump and the saved availability).
+ */
+typedef struct {
+	ArithmeticExpression * expression;
+	unsigned int stage;
+	unsigned int mark;
+	int operand;
+	unsigned int jump;
+	boolean * isAvailable;
+} ExpressionFrame;
+
+/**
+ * A condition on the work stack of the compiler, that jumps to the target
+ * of "list" if it's equal to "jumpIf". A conjunction (or disjunction) that
+ * jumps past itself after its first operand owns the "fallThrough" list.
+ */
+typedef struct {
+	ArithmeticExpression * expression;
+	boolean jumpIf;
+	JumpList * list;
+	JumpList * fallThrough;
+	boolean * isAvailable;
+	unsigned int stage;
+} BranchFrame;
+
+/**
+ * The state of a compilation. The registers of the variables and of the
+ * values (the cells that are read, and then their comparisons) are
+ * reserved, and the temporaries are allocated as a stack (every register
+ * from "top" on is free). A value is available if it was already computed
+ * on every path to the next instruction, so it's never computed again.
+ */
+typedef struct {
+	const Automaton * automaton;
+	Bytecode * bytecode;
+	unsigned int top;
+
+	Comparison * comparisons;
+	unsigned int comparisonCount;
+	unsigned int comparisonCapacity;
+	boolean * isAvailable;
+
+	ExpressionFrame * frames;
+	unsigned int frameCount;
+	unsigned int frameCapacity;
+	BranchFrame * branches;
+	unsigned int branchCount;
+	unsigned int branchCapacity;
+} BytecodeCompiler;
+
+/* PRIVATE FUNCTIONS */
+
+static void _addComparison(BytecodeCompiler * compiler, ArithmeticExpression * cell, const int state);
+static void _addJump(JumpList * list, const unsigned int jump);
+static int _addOffset(BytecodeCompiler * compiler, const Offset offset);
+static int _allocate(BytecodeCompiler * compiler);
+static void _collectCell(BytecodeCompiler * compiler, Cell * cell, const boolean isRead);
+static void _collectConstant(BytecodeCompiler * compiler, Constant * constant);
+static void _collectExpression(BytecodeCompiler * compiler, ArithmeticExpression * expression);
+static void _collectNeighborhoodSequence(BytecodeCompiler * compiler, NeighborhoodSequence * sequence);
+static void _collectRange(BytecodeCompiler * compiler, Range * range);
+static void _collectTransitionSequence(BytecodeCompiler * compiler, TransitionSequence * sequence);
+static ArithmeticExpression * _compileBinary(BytecodeCompiler * compiler, const Opcode opcode, ExpressionFrame * frame, int * result);
+static void _compileBranch(BytecodeCompiler * compiler, ArithmeticExpression * expression, const boolean jumpIf, JumpList * list);
+static ArithmeticExpression * _compileComparison(BytecodeCompiler * compiler, const boolean isEqual, ExpressionFrame * frame, int * result);
+static int _compileConstant(BytecodeCompiler * compiler, Constant * constant);
+static int _compileExpression(BytecodeCompiler * compiler, ArithmeticExpression * expression);
+static void _compileForLoop(BytecodeCompiler * compiler, const unsigned int variable, Range * range, void * body, const boolean isTransition);
+static ArithmeticExpression * _compileLogic(BytecodeCompiler * compiler, const boolean isAnd, ExpressionFrame * frame, int * result);
+static void _compileNeighborhoodSequence(BytecodeCompiler * compiler, NeighborhoodSequence * sequence);
+static void _compileNeighbors(BytecodeCompiler * compiler, CellList * cellList, const boolean isAddition);
+static int _compileOffset(BytecodeCompiler * compiler, Cell * cell, int * x, int * y);
+static int _compileQuantifier(BytecodeCompiler * compiler, ArithmeticExpression * expression);
+static ArithmeticExpression * _compileStep(BytecodeCompiler * compiler, ExpressionFrame * frame, int * result);
+static void _compileTest(BytecodeCompiler * compiler, ArithmeticExpression * expression, const boolean jumpIf, JumpList * list);
+static void _compileTransitionSequence(BytecodeCompiler * compiler, TransitionSequence * sequence);
+static Bytecode * _createBytecode(const Automaton * automaton, BytecodeCompiler * compiler);
+static void _destroyCompiler(BytecodeCompiler * compiler);
+static unsigned int _emit(BytecodeCompiler * compiler, const Opcode opcode, const int destination, const int a, const int b);
+static boolean _isBoolean(ArithmeticExpression * expression);
+static int _findComparison(BytecodeCompiler * compiler, ArithmeticExpression * cell, const int state);
+static boolean _isImmediate(BytecodeCompiler * compiler, ArithmeticExpression * expression, int * value);
+static int _loadCell(BytecodeCompiler * compiler, const int index);
+static void _move(BytecodeCompiler * compiler, const int destination, const int source);
+static void _patch(BytecodeCompiler * compiler, const unsigned int jump);
+static void _patchAll(BytecodeCompiler * compiler, JumpList * list);
+static void _pushBranch(BytecodeCompiler * compiler, ArithmeticExpression * expression, const boolean jumpIf, JumpList * list);
+static ExpressionFrame * _pushFrame(BytecodeCompiler * compiler, ArithmeticExpression * expression);
+static void _reserveValues(BytecodeCompiler * compiler);
+static void _restoreAvailability(BytecodeCompiler * compiler, boolean * isAvailable);
+static boolean * _saveAvailability(BytecodeCompiler * compiler);
+static int _staticIndex(BytecodeCompiler * compiler, ArithmeticExpression * expression);
+
+/**
+ * Registers the comparison of a static cell with a state, unless it's
+ * already registered (or the expression isn't a static cell).
+ */
+static void _addComparison(BytecodeCompiler * compiler, ArithmeticExpression * cell, const int state) {
+	const int index = _staticIndex(compiler, cell);
+	if (index < 0 || 0 <= _findComparison(compiler, cell, state)) {
+		return;
+	}
+	if (compiler->comparisonCount == compiler->comparisonCapacity) {
+		compiler->comparisonCapacity = compiler->comparisonCapacity == 0 ? 8 : 2 * compiler->comparisonCapacity;
+		compiler->comparisons = realloc(compiler->comparisons, compiler->comparisonCapacity * sizeof(Comparison));
+	}
+	compiler->comparisons[compiler->comparisonCount++] = (Comparison) {
+		.index = index,
+		.state = state
+	};
+}
+
+/**
+ * Appends a jump to a list.
+ */
+static void _addJump(JumpList * list, const unsigned int jump) {
+	if (list->count == list->capacity) {
+		list->capacity = list->capacity == 0 ? 8 : 2 * list->capacity;
+		list->jumps = realloc(list->jumps, list->capacity * sizeof(unsigned int));
+	}
+	list->jumps[list->count++] = jump;
+}
+
+/**
+ * Returns the index of a static offset, adding it if it's new.
+ */
+static int _addOffset(BytecodeCompiler * compiler, const Offset offset) {
+	Bytecode * bytecode = compiler->bytecode;
+	for (unsigned int k = 0; k < bytecode->offsetCount; ++k) {
+		if (bytecode->offsets[k].x == offset.x && bytecode->offsets[k].y == offset.y) {
+			return (int) k;
+		}
+	}
+	if (bytecode->offsetCount == bytecode->offsetCapacity) {
+		bytecode->offsetCapacity = 2 * bytecode->offsetCapacity;
+		bytecode->offsets = realloc(bytecode->offsets, bytecode->offsetCapacity * sizeof(Offset));
+		bytecode->displacements = realloc(bytecode->displacements, bytecode->offsetCapacity * sizeof(ptrdiff_t));
+	}
+	bytecode->offsets[bytecode->offsetCount] = offset;
+	bytecode->displacements[bytecode->offsetCount] = (ptrdiff_t) offset.y * compiler->automaton->width + offset.x;
+	bytecode->minimum.x = offset.x < bytecode->minimum.x ? offset.x : bytecode->minimum.x;
+	bytecode->minimum.y = offset.y < bytecode->minimum.y ? offset.y : bytecode->minimum.y;
+	bytecode->maximum.x = bytecode->maximum.x < offset.x ? offset.x : bytecode->maximum.x;
+	bytecode->maximum.y = bytecode->maximum.y < offset.y ? offset.y : bytecode->maximum.y;
+	return (int) bytecode->offsetCount++;
+}
+
+/**
+ * Allocates a temporary register.
+ */
+static int _allocate(BytecodeCompiler * compiler) {
+	const int result = (int) compiler->top++;
+	if (compiler->bytecode->registers < compiler->top) {
+		compiler->bytecode->registers = compiler->top;
+	}
+	return result;
+}
+
+/**
+ * Registers the static offset of a cell, if the program reads it, before
+ * anything is compiled (so every cell that is read gets one of the first
+ * offsets, and a register). The coordinates of a dynamic cell can read
+ * cells too.
+ */
+static void _collectCell(BytecodeCompiler * compiler, Cell * cell, const boolean isRead) {
+	Offset offset;
+	if (resolveStaticOffset(compiler->automaton, cell, &offset)) {
+		if (isRead) {
+			_addOffset(compiler, offset);
+			compiler->bytecode->readCount = compiler->bytecode->offsetCount;
+		}
+	}
+	else if (cell->isSingleCoordenate) {
+		_collectConstant(compiler, cell->displacement);
+	}
+	else {
+		_collectConstant(compiler, cell->x);
+		_collectConstant(compiler, cell->y);
+	}
+}
+
+static void _collectConstant(BytecodeCompiler * compiler, Constant * constant) {
+	if (constant->type == CELL_C) {
+		_collectCell(compiler, constant->cell, true);
+	}
+}
+
+/**
+ * Registers the cells that an expression reads, and its comparisons of a
+ * static cell with a constant (after both of its operands, so a second
+ * stage of the frame of an equality registers them).
+ */
+static void _collectExpression(BytecodeCompiler * compiler, ArithmeticExpression * expression) {
+	const unsigned int base = compiler->frameCount;
+	_pushFrame(compiler, expression);
+	while (base < compiler->frameCount) {
+		const ExpressionFrame frame = compiler->frames[--compiler->frameCount];
+		expression = frame.expression;
+		int value = 0;
+		if (frame.stage == 1) {
+			if (_isImmediate(compiler, expression->rightExpression, &value)) {
+				_addComparison(compiler, expression->leftExpression, value);
+			}
+			else if (_isImmediate(compiler, expression->leftExpression, &value)) {
+				_addComparison(compiler, expression->rightExpression, value);
+			}
+			continue;
+		}
+		switch (expression->type) {
+			case CONSTANT:
+				_collectConstant(compiler, expression->constant);
+				break;
+			case FACTOR:
+			case LOGIC_NOT:
+				_pushFrame(compiler, expression->expression);
+				break;
+			case ALL_ARE:
+			case ANY_ARE:
+			case AT_LEAST_ARE:
+				for (unsigned int k = 0; k < expression->cellList->count; ++k) {
+					_collectCell(compiler, expression->cellList->cells[k], true);
+				}
+				break;
+			case EQUALS:
+			case NOT_EQUALS:
+				_pushFrame(compiler, expression)->stage = 1;
+				_pushFrame(compiler, expression->rightExpression);
+				_pushFrame(compiler, expression->leftExpression);
+				break;
+			default:
+				_pushFrame(compiler, expression->rightExpression);
+				_pushFrame(compiler, expression->leftExpression);
+				break;
+		}
+	}
+}
+
+static void _collectNeighborhoodSequence(BytecodeCompiler * compiler, NeighborhoodSequence * sequence) {
+	for (unsigned int k = 0; k < sequence->count; ++k) {
+		NeighborhoodExpression * expression = sequence->expressions[k];
+		CellList * cellList = NULL;
+		switch (expression->type) {
+			case NEIGHBORHOOD_ASSIGNMENT:
+				_collectExpression(compiler, expression->assignment);
+				break;
+			case NEIGHBORHOOD_FOR_LOOP:
+				_collectRange(compiler, expression->range);
+				_collectNeighborhoodSequence(compiler, expression->forBody);
+				break;
+			case NEIGHBORHOOD_IF:
+				_collectExpression(compiler, expression->ifCondition);
+				_collectNeighborhoodSequence(compiler, expression->ifBody);
+				break;
+			case NEIGHBORHOOD_IF_ELSE:
+				_collectExpression(compiler, expression->ifElseCondition);
+				_collectNeighborhoodSequence(compiler, expression->ifElseIfBody);
+				_collectNeighborhoodSequence(compiler, expression->ifElseElseBody);
+				break;
+			case ADD_CELL_EXP:
+				cellList = expression->toAddList;
+				break;
+			case REMOVE_CELL_EXP:
+				cellList = expression->toRemoveList;
+				break;
+		}
+		for (unsigned int j = 0; cellList != NULL && j < cellList->count; ++j) {
+			_collectCell(compiler, cellList->cells[j], false);
+		}
+	}
+}
+
+static void _collectRange(BytecodeCompiler * compiler, Range * range) {
+	if (range->type == ARRAY) {
+		for (unsigned int k = 0; k < range->array->count; ++k) {
+			_collectConstant(compiler, range->array->values[k]);
+		}
+	}
+	else {
+		_collectConstant(compiler, range->start);
+		_collectConstant(compiler, range->end);
+	}
+}
+
+static void _collectTransitionSequence(BytecodeCompiler * compiler, TransitionSequence * sequence) {
+	for (unsigned int k = 0; k < sequence->count; ++k) {
+		TransitionExpression * expression = sequence->expressions[k];
+		switch (expression->type) {
+			case TRANSITION_ASSIGNMENT:
+				_collectExpression(compiler, expression->assignment);
+				break;
+			case TRANSITION_FOR_LOOP:
+				_collectRange(compiler, expression->range);
+				_collectTransitionSequence(compiler, expression->forBody);
+				break;
+			case TRANSITION_IF:
+				_collectExpression(compiler, expression->ifCondition);
+				_collectTransitionSequence(compiler, expression->ifBody);
+				break;
+			case TRANSITION_IF_ELSE:
+				_collectExpression(compiler, expression->ifElseCondition);
+				_collectTransitionSequence(compiler, expression->ifElseIfBody);
+				_collectTransitionSequence(compiler, expression->ifElseElseBody);
+				break;
+			case RETURN_VALUE:
+				_collectExpression(compiler, expression->returnValue);
+				break;
+		}
+	}
+}
+
+/**
+ * Compiles a binary operation, whose result replaces the temporaries of its
+ * operands.
+ */
+static ArithmeticExpression * _compileBinary(BytecodeCompiler * compiler, const Opcode opcode, ExpressionFrame * frame, int * result) {
+	switch (frame->stage++) {
+		case 0:
+			return frame->expression->leftExpression;
+		case 1:
+			frame->operand = *result;
+			return frame->expression->rightExpression;
+		default:
+			compiler->top = frame->mark;
+			const int left = frame->operand;
+			const int right = *result;
+			*result = _allocate(compiler);
+			_emit(compiler, opcode, *result, left, right);
+			return NULL;
+	}
+}
+
+/**
+ * Compiles a condition into control flow: the code jumps to the target of
+ * the list if the condition is equal to "jumpIf", and falls through
+ * otherwise. Conjunctions, disjunctions and negations never materialize a
+ * value (and they're resumed from a work stack, so they can nest
+ * arbitrarily deep).
+ */
+static void _compileBranch(BytecodeCompiler * compiler, ArithmeticExpression * expression, const boolean jumpIf, JumpList * list) {
+	const unsigned int base = compiler->branchCount;
+	_pushBranch(compiler, expression, jumpIf, list);
+	while (base < compiler->branchCount) {
+		BranchFrame * frame = &compiler->branches[compiler->branchCount - 1];
+		while (frame->expression->type == FACTOR) {
+			frame->expression = frame->expression->expression;
+		}
+		expression = frame->expression;
+		if (expression->type == LOGIC_NOT) {
+			frame->expression = expression->expression;
+			frame->jumpIf = !frame->jumpIf;
+		}
+		else if (expression->type != LOGIC_AND && expression->type != LOGIC_OR) {
+			--compiler->branchCount;
+			_compileTest(compiler, expression, frame->jumpIf, frame->list);
+		}
+		else if (frame->stage == 0) {
+			// Both operands jump to the target if the first one decides the
+			// result as "jumpIf" (e.g., a false conjunct when jumping if false).
+			frame->stage = 1;
+			if ((expression->type == LOGIC_AND) != frame->jumpIf) {
+				_pushBranch(compiler, expression->leftExpression, frame->jumpIf, frame->list);
+			}
+			else {
+				frame->fallThrough = calloc(1, sizeof(JumpList));
+				_pushBranch(compiler, expression->leftExpression, !frame->jumpIf, frame->fallThrough);
+			}
+		}
+		else if (frame->stage == 1) {
+			// The second operand doesn't always run, so the comparisons that
+			// it computes aren't available after it.
+			frame->stage = 2;
+			frame->isAvailable = _saveAvailability(compiler);
+			_pushBranch(compiler, expression->rightExpression, frame->jumpIf, frame->list);
+		}
+		else {
+			--compiler->branchCount;
+			_restoreAvailability(compiler, frame->isAvailable);
+			if (frame->fallThrough != NULL) {
+				_patchAll(compiler, frame->fallThrough);
+				free(frame->fallThrough);
+			}
+		}
+	}
+}
+
+/**
+ * Compiles an equality (or inequality) with a constant, which uses an
+ * immediate. An equality of a static cell with a constant is computed into
+ * its reserved register, unless it's already available there.
+ */
+static ArithmeticExpression * _compileComparison(BytecodeCompiler * compiler, const boolean isEqual, ExpressionFrame * frame, int * result) {
+	ArithmeticExpression * left = frame->expression->leftExpression;
+	int value = 0;
+	if (!_isImmediate(compiler, frame->expression->rightExpression, &value)) {
+		_isImmediate(compiler, left, &value);
+		left = frame->expression->rightExpression;
+	}
+	if (frame->stage++ == 0) {
+		const int comparison = _findComparison(compiler, left, value);
+		if (!isEqual || comparison < 0) {
+			return left;
+		}
+		const int index = _staticIndex(compiler, left);
+		*result = (int) compiler->bytecode->variables + comparison;
+		if (!compiler->isAvailable[comparison] && compiler->isAvailable[index]) {
+			_emit(compiler, EQUAL_IMMEDIATE_OP, *result, _loadCell(compiler, index), value);
+		}
+		else if (!compiler->isAvailable[comparison]) {
+			_emit(compiler, CELL_EQUAL_OP, *result, index, value);
+		}
+		compiler->isAvailable[comparison] = true;
+		return NULL;
+	}
+	compiler->top = frame->mark;
+	const int operand = *result;
+	*result = _allocate(compiler);
+	_emit(compiler, isEqual ? EQUAL_IMMEDIATE_OP : NOT_EQUAL_IMMEDIATE_OP, *result, operand, value);
+	return NULL;
+}
+
+/**
+ * Compiles a constant. A variable or a static cell is not copied (i.e., its
+ * own register is the result).
+ */
+static int _compileConstant(BytecodeCompiler * compiler, Constant * constant) {
+	const unsigned int mark = compiler->top;
+	int result, x, y, index, state;
+	switch (constant->type) {
+		case STRING_C:
+			state = compiler->automaton->symbolStates[constant->symbol];
+			if (state == NO_STATE) {
+				return (int) constant->symbol;
+			}
+			result = _allocate(compiler);
+			_emit(compiler, LOAD_INTEGER_OP, result, state, 0);
+			return result;
+		case CELL_C:
+			index = _compileOffset(compiler, constant->cell, &x, &y);
+			if (0 <= index) {
+				return _loadCell(compiler, index);
+			}
+			compiler->top = mark;
+			result = _allocate(compiler);
+			_emit(compiler, LOAD_CELL_DYNAMIC_OP, result, x, y);
+			return result;
+		case INTEGER_C:
+		default:
+			result = _allocate(compiler);
+			_emit(compiler, LOAD_INTEGER_OP, result, constant->value, 0);
+			return result;
+	}
+}
+
+/**
+ * Compiles an expression with a work stack, where every frame compiles its
+ * operands before its own instructions. Returns the register of its value.
+ */
+static int _compileExpression(BytecodeCompiler * compiler, ArithmeticExpression * expression) {
+	const unsigned int base = compiler->frameCount;
+	int result = 0;
+	_pushFrame(compiler, expression);
+	while (base < compiler->frameCount) {
+		ArithmeticExpression * operand = _compileStep(compiler, &compiler->frames[compiler->frameCount - 1], &result);
+		if (operand == NULL) {
+			--compiler->frameCount;
+		}
+		else {
+			_pushFrame(compiler, operand);
+		}
+	}
+	return result;
+}
+
+/**
+ * Compiles a loop. An array is unrolled (evaluating every element right
+ * before its iteration), and an interval keeps its counter, its end and its
+ * step in reserved registers, so the body can't change the iterations.
+ */
+static void _compileForLoop(BytecodeCompiler * compiler, const unsigned int variable, Range * range, void * body, const boolean isTransition) {
+	const unsigned int mark = compiler->top;
+	if (range->type == ARRAY) {
+		for (unsigned int k = 0; k < range->array->count; ++k) {
+			_move(compiler, (int) variable, _compileConstant(compiler, range->array->values[k]));
+			compiler->top = mark;
+			if (isTransition) {
+				_compileTransitionSequence(compiler, body);
+			}
+			else {
+				_compileNeighborhoodSequence(compiler, body);
+			}
+		}
+		return;
+	}
+	const int counter = _allocate(compiler);
+	const int end = _allocate(compiler);
+	const int step = _allocate(compiler);
+	_move(compiler, counter, _compileConstant(compiler, range->start));
+	compiler->top = mark + 3;
+	_move(compiler, end, _compileConstant(compiler, range->end));
+	compiler->top = mark + 3;
+	_emit(compiler, LOWER_OR_EQUAL_OP, step, counter, end);
+	_emit(compiler, ADD_OP, step, step, step);
+	_emit(compiler, ADD_IMMEDIATE_OP, step, step, -1);
+	const unsigned int loop = compiler->bytecode->count;
+	_move(compiler, (int) variable, counter);
+	if (isTransition) {
+		_compileTransitionSequence(compiler, body);
+	}
+	else {
+		_compileNeighborhoodSequence(compiler, body);
+	}
+	const int isLast = _allocate(compiler);
+	_emit(compiler, EQUAL_OP, isLast, counter, end);
+	const unsigned int exit = _emit(compiler, JUMP_IF_NOT_ZERO_OP, 0, isLast, 0);
+	_emit(compiler, ADD_OP, counter, counter, step);
+	_emit(compiler, JUMP_OP, (int) loop, 0, 0);
+	_patch(compiler, exit);
+	compiler->top = mark;
+}
+
+/**
+ * Compiles a conjunction (or disjunction), with short-circuit.
+ */
+static ArithmeticExpression * _compileLogic(BytecodeCompiler * compiler, const boolean isAnd, ExpressionFrame * frame, int * result) {
+	ArithmeticExpression * expression = frame->expression;
+	switch (frame->stage++) {
+		case 0:
+			return expression->leftExpression;
+		case 1:
+			compiler->top = frame->mark;
+			frame->operand = _allocate(compiler);
+			if (_isBoolean(expression->leftExpression)) {
+				_move(compiler, frame->operand, *result);
+			}
+			else {
+				_emit(compiler, TEST_OP, frame->operand, *result, 0);
+			}
+			frame->jump = _emit(compiler, isAnd ? JUMP_IF_ZERO_OP : JUMP_IF_NOT_ZERO_OP, 0, frame->operand, 0);
+			frame->isAvailable = _saveAvailability(compiler);
+			return expression->rightExpression;
+		default:
+			if (_isBoolean(expression->rightExpression)) {
+				_move(compiler, frame->operand, *result);
+			}
+			else {
+				_emit(compiler, TEST_OP, frame->operand, *result, 0);
+			}
+			_restoreAvailability(compiler, frame->isAvailable);
+			_patch(compiler, frame->jump);
+			compiler->top = frame->mark + 1;
+			*result = frame->operand;
+			return NULL;
+	}
+}
+
+static void _compileNeighborhoodSequence(BytecodeCompiler * compiler, NeighborhoodSequence * sequence) {
+	for (unsigned int k = 0; k < sequence->count; ++k) {
+		NeighborhoodExpression * expression = sequence->expressions[k];
+		const unsigned int mark = compiler->top;
+		JumpList jumps = {0};
+		boolean * isAvailable = NULL;
+		unsigned int exit;
+		switch (expression->type) {
+			case NEIGHBORHOOD_ASSIGNMENT:
+				_move(compiler, (int) expression->variable, _compileExpression(compiler, expression->assignment));
+				break;
+			case NEIGHBORHOOD_FOR_LOOP:
+				_compileForLoop(compiler, expression->forVariable, expression->range, expression->forBody, false);
+				break;
+			case NEIGHBORHOOD_IF:
+				_compileBranch(compiler, expression->ifCondition, false, &jumps);
+				isAvailable = _saveAvailability(compiler);
+				_compileNeighborhoodSequence(compiler, expression->ifBody);
+				_restoreAvailability(compiler, isAvailable);
+				_patchAll(compiler, &jumps);
+				break;
+			case NEIGHBORHOOD_IF_ELSE:
+				_compileBranch(compiler, expression->ifElseCondition, false, &jumps);
+				isAvailable = _saveAvailability(compiler);
+				_compileNeighborhoodSequence(compiler, expression->ifElseIfBody);
+				_restoreAvailability(compiler, isAvailable);
+				exit = _emit(compiler, JUMP_OP, 0, 0, 0);
+				_patchAll(compiler, &jumps);
+				isAvailable = _saveAvailability(compiler);
+				_compileNeighborhoodSequence(compiler, expression->ifElseElseBody);
+				_restoreAvailability(compiler, isAvailable);
+				_patch(compiler, exit);
+				break;
+			case ADD_CELL_EXP:
+				_compileNeighbors(compiler, expression->toAddList, true);
+				break;
+			case REMOVE_CELL_EXP:
+				_compileNeighbors(compiler, expression->toRemoveList, false);
+				break;
+		}
+		compiler->top = mark;
+	}
+}
+
+/**
+ * Compiles the addition (or removal) of every cell of a list.
+ */
+static void _compileNeighbors(BytecodeCompiler * compiler, CellList * cellList, const boolean isAddition) {
+	const unsigned int mark = compiler->top;
+	for (unsigned int k = 0; k < cellList->count; ++k) {
+		int x, y;
+		const int index = _compileOffset(compiler, cellList->cells[k], &x, &y);
+		if (0 <= index) {
+			_emit(compiler, isAddition ? ADD_NEIGHBOR_OP : REMOVE_NEIGHBOR_OP, 0, index, 0);
+		}
+		else {
+			_emit(compiler, isAddition ? ADD_NEIGHBOR_DYNAMIC_OP : REMOVE_NEIGHBOR_DYNAMIC_OP, 0, x, y);
+		}
+		compiler->top = mark;
+	}
+}
+
+/**
+ * Compiles the offset of a cell. Returns the index of its static offset, or
+ * -1 if it's computed at runtime (into the registers "x" and "y").
+ */
+static int _compileOffset(BytecodeCompiler * compiler, Cell * cell, int * x, int * y) {
+	Offset offset;
+	if (resolveStaticOffset(compiler->automaton, cell, &offset)) {
+		return _addOffset(compiler, offset);
+	}
+	if (!cell->isSingleCoordenate) {
+		*x = _compileConstant(compiler, cell->x);
+		*y = _compileConstant(compiler, cell->y);
+		return -1;
+	}
+	const int displacement = _compileConstant(compiler, cell->displacement);
+	int zero = 0;
+	if (cell->displacementType != DIAGONAL_DESC_D) {
+		zero = _allocate(compiler);
+		_emit(compiler, LOAD_INTEGER_OP, zero, 0, 0);
+	}
+	switch (cell->displacementType) {
+		case HORIZONTAL_D:
+			*x = displacement;
+			*y = zero;
+			break;
+		case VERTICAL_D:
+			*x = zero;
+			*y = displacement;
+			break;
+		case DIAGONAL_ASC_D:
+			*x = displacement;
+			*y = zero;
+			_emit(compiler, SUBTRACT_OP, zero, zero, displacement);
+			break;
+		case DIAGONAL_DESC_D:
+		default:
+			*x = displacement;
+			*y = displacement;
+	}
+	return -1;
+}
+
+/**
+ * Compiles an "all", "any" or "at_least" predicate, counting the cells of
+ * the list in the state.
+ */
+static int _compileQuantifier(BytecodeCompiler * compiler, ArithmeticExpression * expression) {
+	const int state = compiler->automaton->symbolStates[expression->state];
+	const unsigned int mark = compiler->top;
+	const int count = _allocate(compiler);
+	_emit(compiler, LOAD_INTEGER_OP, count, 0, 0);
+	for (unsigned int k = 0; k < expression->cellList->count; ++k) {
+		int x, y;
+		const int index = _compileOffset(compiler, expression->cellList->cells[k], &x, &y);
+		if (0 <= index && compiler->isAvailable[index]) {
+			_emit(compiler, COUNT_EQUAL_IMMEDIATE_OP, count, _loadCell(compiler, index), state);
+		}
+		else if (0 <= index) {
+			_emit(compiler, COUNT_CELL_OP, count, index, state);
+		}
+		else {
+			const int value = _allocate(compiler);
+			_emit(compiler, LOAD_CELL_DYNAMIC_OP, value, x, y);
+			_emit(compiler, COUNT_EQUAL_IMMEDIATE_OP, count, value, state);
+		}
+		compiler->top = mark + 1;
+	}
+	if (expression->type == ALL_ARE) {
+		_emit(compiler, EQUAL_IMMEDIATE_OP, count, count, (int) expression->cellList->count);
+	}
+	else {
+		const int minimum = _allocate(compiler);
+		_emit(compiler, LOAD_INTEGER_OP, minimum, expression->count, 0);
+		_emit(compiler, GREATER_OR_EQUAL_OP, count, count, minimum);
+	}
+	compiler->top = mark + 1;
+	return count;
+}
+
+/**
+ * Advances the frame of an expression by one stage. Returns the next
+ * operand to compile (whose register is in "result" when the frame
+ * resumes), or NULL once the expression is compiled (into "result").
+ */
+static ArithmeticExpression * _compileStep(BytecodeCompiler * compiler, ExpressionFrame * frame, int * result) {
+	ArithmeticExpression * expression = frame->expression;
+	int value = 0;
+	switch (expression->type) {
+		case ADDITION: return _compileBinary(compiler, ADD_OP, frame, result);
+		case SUBTRACTION: return _compileBinary(compiler, SUBTRACT_OP, frame, result);
+		case MULTIPLICATION: return _compileBinary(compiler, MULTIPLY_OP, frame, result);
+		case DIVISION: return _compileBinary(compiler, DIVIDE_OP, frame, result);
+		case MODULE: return _compileBinary(compiler, MODULO_OP, frame, result);
+		case LOWER_THAN: return _compileBinary(compiler, LOWER_OP, frame, result);
+		case LOWER_THAN_OR_EQUAL: return _compileBinary(compiler, LOWER_OR_EQUAL_OP, frame, result);
+		case GREATER_THAN: return _compileBinary(compiler, GREATER_OP, frame, result);
+		case GREATER_THAN_OR_EQUAL: return _compileBinary(compiler, GREATER_OR_EQUAL_OP, frame, result);
+		case EQUALS:
+		case NOT_EQUALS:
+			if (_isImmediate(compiler, expression->rightExpression, &value) || _isImmediate(compiler, expression->leftExpression, &value)) {
+				return _compileComparison(compiler, expression->type == EQUALS, frame, result);
+			}
+			return _compileBinary(compiler, expression->type == EQUALS ? EQUAL_OP : NOT_EQUAL_OP, frame, result);
+		case LOGIC_AND: return _compileLogic(compiler, true, frame, result);
+		case LOGIC_OR: return _compileLogic(compiler, false, frame, result);
+		case ALL_ARE:
+		case ANY_ARE:
+		case AT_LEAST_ARE:
+			*result = _compileQuantifier(compiler, expression);
+			return NULL;
+		case LOGIC_NOT:
+			if (frame->stage++ == 0) {
+				return expression->expression;
+			}
+			compiler->top = frame->mark;
+			value = *result;
+			*result = _allocate(compiler);
+			_emit(compiler, NOT_OP, *result, value, 0);
+			return NULL;
+		case FACTOR:
+			return frame->stage++ == 0 ? expression->expression : NULL;
+		case CONSTANT:
+		default:
+			*result = _compileConstant(compiler, expression->constant);
+			return NULL;
+	}
+}
+
+/**
+ * Compiles a condition that is neither a conjunction, a disjunction nor a
+ * negation into a conditional jump. A comparison with a constant is a
+ * single instruction (that tests the register of the comparison or of the
+ * cell, if it's available).
+ */
+static void _compileTest(BytecodeCompiler * compiler, ArithmeticExpression * expression, const boolean jumpIf, JumpList * list) {
+	const unsigned int mark = compiler->top;
+	ArithmeticExpression * operand = expression->leftExpression;
+	int value = 0, comparison, index, result;
+	boolean isEqual;
+	switch (expression->type) {
+		case EQUALS:
+		case NOT_EQUALS:
+			if (!_isImmediate(compiler, expression->rightExpression, &value)) {
+				operand = expression->rightExpression;
+				if (!_isImmediate(compiler, expression->leftExpression, &value)) {
+					break;
+				}
+			}
+			isEqual = (expression->type == EQUALS) == jumpIf;
+			comparison = _findComparison(compiler, operand, value);
+			index = _staticIndex(compiler, operand);
+			if (0 <= comparison && compiler->isAvailable[comparison]) {
+				_addJump(list, _emit(compiler, isEqual ? JUMP_IF_NOT_ZERO_OP : JUMP_IF_ZERO_OP, 0, (int) compiler->bytecode->variables + comparison, 0));
+			}
+			else if (0 <= index && !compiler->isAvailable[index]) {
+				_addJump(list, _emit(compiler, isEqual ? JUMP_IF_CELL_EQUAL_OP : JUMP_IF_CELL_NOT_EQUAL_OP, 0, index, value));
+			}
+			else {
+				result = _compileExpression(compiler, operand);
+				_addJump(list, _emit(compiler, isEqual ? JUMP_IF_EQUAL_IMMEDIATE_OP : JUMP_IF_NOT_EQUAL_IMMEDIATE_OP, 0, result, value));
+			}
+			compiler->top = mark;
+			return;
+		default:
+			break;
+	}
+	result = _compileExpression(compiler, expression);
+	_addJump(list, _emit(compiler, jumpIf ? JUMP_IF_NOT_ZERO_OP : JUMP_IF_ZERO_OP, 0, result, 0));
+	compiler->top = mark;
+}
+
+static void _compileTransitionSequence(BytecodeCompiler * compiler, TransitionSequence * sequence) {
+	for (unsigned int k = 0; k < sequence->count; ++k) {
+		TransitionExpression * expression = sequence->expressions[k];
+		const unsigned int mark = compiler->top;
+		JumpList jumps = {0};
+		boolean * isAvailable = NULL;
+		unsigned int exit;
+		switch (expression->type) {
+			case TRANSITION_ASSIGNMENT:
+				_move(compiler, (int) expression->variable, _compileExpression(compiler, expression->assignment));
+				break;
+			case TRANSITION_FOR_LOOP:
+				_compileForLoop(compiler, expression->forVariable, expression->range, expression->forBody, true);
+				break;
+			case TRANSITION_IF:
+				_compileBranch(compiler, expression->ifCondition, false, &jumps);
+				isAvailable = _saveAvailability(compiler);
+				_compileTransitionSequence(compiler, expression->ifBody);
+				_restoreAvailability(compiler, isAvailable);
+				_patchAll(compiler, &jumps);
+				break;
+			case TRANSITION_IF_ELSE:
+				_compileBranch(compiler, expression->ifElseCondition, false, &jumps);
+				isAvailable = _saveAvailability(compiler);
+				_compileTransitionSequence(compiler, expression->ifElseIfBody);
+				_restoreAvailability(compiler, isAvailable);
+				exit = _emit(compiler, JUMP_OP, 0, 0, 0);
+				_patchAll(compiler, &jumps);
+				isAvailable = _saveAvailability(compiler);
+				_compileTransitionSequence(compiler, expression->ifElseElseBody);
+				_restoreAvailability(compiler, isAvailable);
+				_patch(compiler, exit);
+				break;
+			case RETURN_VALUE:
+				_emit(compiler, RETURN_OP, 0, _compileExpression(compiler, expression->returnValue), 0);
+				break;
+		}
+		compiler->top = mark;
+	}
+}
+
+/**
+ * Creates an empty program, with a register for every symbol (the states
+ * never use theirs), and the cell itself as the first static offset.
+ */
+static Bytecode * _createBytecode(const Automaton * automaton, BytecodeCompiler * compiler) {
+	Bytecode * bytecode = calloc(1, sizeof(Bytecode));
+	bytecode->capacity = 64;
+	bytecode->code = calloc(bytecode->capacity, sizeof(Instruction));
+	bytecode->variables = automaton->symbols;
+	bytecode->registers = automaton->symbols;
+	bytecode->offsetCapacity = 16;
+	bytecode->offsets = calloc(bytecode->offsetCapacity, sizeof(Offset));
+	bytecode->displacements = calloc(bytecode->offsetCapacity, sizeof(ptrdiff_t));
+	bytecode->offsetCount = 1;
+	*compiler = (BytecodeCompiler) {0};
+	compiler->automaton = automaton;
+	compiler->bytecode = bytecode;
+	compiler->top = automaton->symbols;
+	return bytecode;
+}
+
+static void _destroyCompiler(BytecodeCompiler * compiler) {
+	free(compiler->comparisons);
+	free(compiler->isAvailable);
+	free(compiler->frames);
+	free(compiler->branches);
+}
+
+/**
+ * Appends an instruction, and returns its index.
+ */
+static unsigned int _emit(BytecodeCompiler * compiler, const Opcode opcode, const int destination, const int a, const int b) {
+	Bytecode * bytecode = compiler->bytecode;
+	if (opcode == LOAD_CELL_DYNAMIC_OP || opcode == ADD_NEIGHBOR_DYNAMIC_OP) {
+		bytecode->isDynamic = true;
+	}
+	if (bytecode->count == bytecode->capacity) {
+		bytecode->capacity = 2 * bytecode->capacity;
+		bytecode->code = realloc(bytecode->code, bytecode->capacity * sizeof(Instruction));
+	}
+	bytecode->code[bytecode->count] = (Instruction) {
+		.opcode = opcode,
+		.destination = destination,
+		.a = a,
+		.b = b
+	};
+	return bytecode->count++;
+}
+
+/**
+ * Returns the value of the comparison of a static cell with a state, or -1
+ * if it isn't registered.
+ */
+static int _findComparison(BytecodeCompiler * compiler, ArithmeticExpression * cell, const int state) {
+	const int index = _staticIndex(compiler, cell);
+	for (unsigned int k = 0; 0 <= index && k < compiler->comparisonCount; ++k) {
+		if (compiler->comparisons[k].index == index && compiler->comparisons[k].state == state) {
+			return (int) (compiler->bytecode->readCount + k);
+		}
+	}
+	return -1;
+}
+
+/**
+ * Whether the value of an expression is always 0 or 1.
+ */
+static boolean _isBoolean(ArithmeticExpression * expression) {
+	while (expression->type == FACTOR) {
+		expression = expression->expression;
+	}
+	switch (expression->type) {
+		case LOGIC_AND:
+		case LOGIC_OR:
+		case EQUALS:
+		case NOT_EQUALS:
+		case LOWER_THAN:
+		case LOWER_THAN_OR_EQUAL:
+		case GREATER_THAN:
+		case GREATER_THAN_OR_EQUAL:
+		case LOGIC_NOT:
+		case ALL_ARE:
+		case ANY_ARE:
+		case AT_LEAST_ARE:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/**
+ * Whether an expression is a constant known at compile time (an integer or
+ * a state).
+ */
+static boolean _isImmediate(BytecodeCompiler * compiler, ArithmeticExpression * expression, int * value) {
+	while (expression->type == FACTOR) {
+		expression = expression->expression;
+	}
+	if (expression->type != CONSTANT) {
+		return false;
+	}
+	Constant * constant = expression->constant;
+	if (constant->type == INTEGER_C) {
+		*value = constant->value;
+		return true;
+	}
+	if (constant->type == STRING_C && compiler->automaton->symbolStates[constant->symbol] != NO_STATE) {
+		*value = compiler->automaton->symbolStates[constant->symbol];
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Returns the register of a static cell that is read, loading it unless
+ * it's available.
+ */
+static int _loadCell(BytecodeCompiler * compiler, const int index) {
+	const int result = (int) compiler->bytecode->variables + index;
+	if (!compiler->isAvailable[index]) {
+		_emit(compiler, LOAD_CELL_OP, result, index, 0);
+		compiler->isAvailable[index] = true;
+	}
+	return result;
+}
+
+/**
+ * Copies a register into another one, unless they're the same.
+ */
+static void _move(BytecodeCompiler * compiler, const int destination, const int source) {
+	if (destination != source) {
+		_emit(compiler, MOVE_OP, destination, source, 0);
+	}
+}
+
+/**
+ * Makes a jump land on the next instruction to emit.
+ */
+static void _patch(BytecodeCompiler * compiler, const unsigned int jump) {
+	compiler->bytecode->code[jump].destination = (int) compiler->bytecode->count;
+}
+
+/**
+ * Makes every jump of a list land on the next instruction to emit, and
+ * empties the list.
+ */
+static void _patchAll(BytecodeCompiler * compiler, JumpList * list) {
+	for (unsigned int k = 0; k < list->count; ++k) {
+		_patch(compiler, list->jumps[k]);
+	}
+	free(list->jumps);
+	*list = (JumpList) {0};
+}
+
+/**
+ * Pushes a condition onto the work stack of the conditions.
+ */
+static void _pushBranch(BytecodeCompiler * compiler, ArithmeticExpression * expression, const boolean jumpIf, JumpList * list) {
+	if (compiler->branchCount == compiler->branchCapacity) {
+		compiler->branchCapacity = compiler->branchCapacity == 0 ? 16 : 2 * compiler->branchCapacity;
+		compiler->branches = realloc(compiler->branches, compiler->branchCapacity * sizeof(BranchFrame));
+	}
+	compiler->branches[compiler->branchCount++] = (BranchFrame) {
+		.expression = expression,
+		.jumpIf = jumpIf,
+		.list = list
+	};
+}
+
+/**
+ * Pushes an expression onto the work stack of the expressions, marking the
+ * first free temporary. Returns its frame (valid until the next push).
+ */
+static ExpressionFrame * _pushFrame(BytecodeCompiler * compiler, ArithmeticExpression * expression) {
+	if (compiler->frameCount == compiler->frameCapacity) {
+		compiler->frameCapacity = compiler->frameCapacity == 0 ? 64 : 2 * compiler->frameCapacity;
+		compiler->frames = realloc(compiler->frames, compiler->frameCapacity * sizeof(ExpressionFrame));
+	}
+	compiler->frames[compiler->frameCount] = (ExpressionFrame) {
+		.expression = expression,
+		.mark = compiler->top
+	};
+	return &compiler->frames[compiler->frameCount++];
+}
+
+/**
+ * Reserves the registers of the values after the variables, once they're
+ * collected, and starts with none available.
+ */
+static void _reserveValues(BytecodeCompiler * compiler) {
+	Bytecode * bytecode = compiler->bytecode;
+	const unsigned int values = bytecode->readCount + compiler->comparisonCount;
+	compiler->isAvailable = calloc(values + 1, sizeof(boolean));
+	compiler->top = bytecode->variables + values;
+	bytecode->registers = compiler->top;
+}
+
+/**
+ * Forgets the values computed since their availability was saved.
+ */
+static void _restoreAvailability(BytecodeCompiler * compiler, boolean * isAvailable) {
+	memcpy(compiler->isAvailable, isAvailable, (compiler->bytecode->readCount + compiler->comparisonCount) * sizeof(boolean));
+	free(isAvailable);
+}
+
+/**
+ * Copies the availability of the values, before compiling code that doesn't
+ * always run.
+ */
+static boolean * _saveAvailability(BytecodeCompiler * compiler) {
+	const unsigned int values = compiler->bytecode->readCount + compiler->comparisonCount;
+	boolean * isAvailable = calloc(values + 1, sizeof(boolean));
+	memcpy(isAvailable, compiler->isAvailable, values * sizeof(boolean));
+	return isAvailable;
+}
+
+/**
+ * Returns the index of the static offset of an expression that is a cell,
+ * or -1 if it isn't a static cell.
+ */
+static int _staticIndex(BytecodeCompiler * compiler, ArithmeticExpression * expression) {
+	while (expression->type == FACTOR) {
+		expression = expression->expression;
+	}
+	Offset offset;
+	if (expression->type != CONSTANT || expression->constant->type != CELL_C
+			|| !resolveStaticOffset(compiler->automaton, expression->constant->cell, &offset)) {
+		return -1;
+	}
+	return _addOffset(compiler, offset);
+}
+
+/* PUBLIC FUNCTIONS */
+
+Bytecode * compileTransition(const Automaton * automaton) {
+	BytecodeCompiler compiler;
+	Bytecode * bytecode = _createBytecode(automaton, &compiler);
+	_collectTransitionSequence(&compiler, automaton->transitionProgram);
+	_reserveValues(&compiler);
+	_compileTransitionSequence(&compiler, automaton->transitionProgram);
+	_emit(&compiler, HALT_OP, 0, 0, 0);
+	logDebugging(_logger, "Compiled the transition program into %u instructions, with %u registers, %u static offsets (%u read) and %u shared comparisons.",
+		bytecode->count, bytecode->registers, bytecode->offsetCount, bytecode->readCount, compiler.comparisonCount);
+	_destroyCompiler(&compiler);
+	return bytecode;
+}
+
+Bytecode * compileNeighborhood(const Automaton * automaton) {
+	BytecodeCompiler compiler;
+	Bytecode * bytecode = _createBytecode(automaton, &compiler);
+	_collectNeighborhoodSequence(&compiler, automaton->neighborhoodProgram);
+	_reserveValues(&compiler);
+	_compileNeighborhoodSequence(&compiler, automaton->neighborhoodProgram);
+	_emit(&compiler, HALT_OP, 0, 0, 0);
+	logDebugging(_logger, "Compiled the neighborhood program into %u instructions, with %u registers, %u static offsets (%u read) and %u shared comparisons.",
+		bytecode->count, bytecode->registers, bytecode->offsetCount, bytecode->readCount, compiler.comparisonCount);
+	_destroyCompiler(&compiler);
+	return bytecode;
+}
+
+void destroyBytecode(Bytecode * bytecode) {
+	if (bytecode != NULL) {
+		free(bytecode->code);
+		free(bytecode->offsets);
+		free(bytecode->displacements);
+		free(bytecode);
+	}
+}
+
+void setBytecodeStride(Bytecode * bytecode, const size_t stride) {
+	for (unsigned int k = 0; k < bytecode->offsetCount; ++k) {
+		bytecode->displacements[k] = (ptrdiff_t) bytecode->offsets[k].y * (ptrdiff_t) stride + bytecode->offsets[k].x;
+	}
+}
@@ -0,0 +1,154 @@
+#ifndef BYTECODE_HEADER
+#define BYTECODE_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "Automaton.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeBytecodeModule();
+
+/** Shutdown module's internal state. */
+void shutdownBytecodeModule();
+
+/**
+ * The instructions of the virtual machine. Every instruction has a
+ * destination (a register, or the target of a jump) and two operands ("a"
+ * and "b"), which are registers, immediate values or indices of static
+ * offsets, depending on the opcode:
+ *
+ *	- HALT_OP: ends the program without a result.
+ *	- RETURN_OP: ends the program with the value of register "a".
+ *	- JUMP_OP: jumps to the destination.
+ *	- JUMP_IF_ZERO_OP, JUMP_IF_NOT_ZERO_OP: jumps to the destination if
+ *	  register "a" is (not) zero.
+ *	- JUMP_IF_CELL_EQUAL_OP, JUMP_IF_CELL_NOT_EQUAL_OP: jumps to the
+ *	  destination if the cell at static offset "a" is (not) in state "b".
+ *	- JUMP_IF_EQUAL_IMMEDIATE_OP, JUMP_IF_NOT_EQUAL_IMMEDIATE_OP: jumps to
+ *	  the destination if register "a" is (not) equal to the immediate "b".
+ *	- LOAD_INTEGER_OP: loads the immediate "a".
+ *	- MOVE_OP: copies register "a".
+ *	- LOAD_CELL_OP: loads the state of the cell at static offset "a".
+ *	- LOAD_CELL_DYNAMIC_OP: loads the state of the cell at the offset in
+ *	  registers "a" and "b".
+ *	- CELL_EQUAL_OP: 1 if the cell at static offset "a" is in state "b".
+ *	- COUNT_CELL_OP: adds 1 if the cell at static offset "a" is in state "b".
+ *	- COUNT_EQUAL_IMMEDIATE_OP: adds 1 if register "a" is equal to the
+ *	  immediate "b".
+ *	- ADD_OP to GREATER_OR_EQUAL_OP: binary operations on registers "a" and
+ *	  "b".
+ *	- ADD_IMMEDIATE_OP, EQUAL_IMMEDIATE_OP and NOT_EQUAL_IMMEDIATE_OP: binary
+ *	  operations on register "a" and the immediate "b".
+ *	- NOT_OP, TEST_OP: 1 if register "a" is (not) zero.
+ *	- ADD_NEIGHBOR_OP, REMOVE_NEIGHBOR_OP: adds (or removes) the neighbor at
+ *	  static offset "a".
+ *	- ADD_NEIGHBOR_DYNAMIC_OP, REMOVE_NEIGHBOR_DYNAMIC_OP: adds (or removes)
+ *	  the neighbor at the offset in registers "a" and "b".
+ */
+typedef enum {
+	HALT_OP,
+	RETURN_OP,
+	JUMP_OP,
+	JUMP_IF_ZERO_OP,
+	JUMP_IF_NOT_ZERO_OP,
+	JUMP_IF_CELL_EQUAL_OP,
+	JUMP_IF_CELL_NOT_EQUAL_OP,
+	JUMP_IF_EQUAL_IMMEDIATE_OP,
+	JUMP_IF_NOT_EQUAL_IMMEDIATE_OP,
+	LOAD_INTEGER_OP,
+	MOVE_OP,
+	LOAD_CELL_OP,
+	LOAD_CELL_DYNAMIC_OP,
+	CELL_EQUAL_OP,
+	COUNT_CELL_OP,
+	COUNT_EQUAL_IMMEDIATE_OP,
+	ADD_OP,
+	SUBTRACT_OP,
+	MULTIPLY_OP,
+	DIVIDE_OP,
+	MODULO_OP,
+	EQUAL_OP,
+	NOT_EQUAL_OP,
+	LOWER_OP,
+	LOWER_OR_EQUAL_OP,
+	GREATER_OP,
+	GREATER_OR_EQUAL_OP,
+	ADD_IMMEDIATE_OP,
+	EQUAL_IMMEDIATE_OP,
+	NOT_EQUAL_IMMEDIATE_OP,
+	NOT_OP,
+	TEST_OP,
+	ADD_NEIGHBOR_OP,
+	REMOVE_NEIGHBOR_OP,
+	ADD_NEIGHBOR_DYNAMIC_OP,
+	REMOVE_NEIGHBOR_DYNAMIC_OP,
+	OPCODES
+} Opcode;
+
+typedef struct {
+	Opcode opcode;
+	int32_t destination;
+	int32_t a;
+	int32_t b;
+} Instruction;
+
+/**
+ * A program lowered into instructions. The first registers hold the
+ * variables (by symbol), then the cells that the program reads at static
+ * offsets and their comparisons with states (each one computed at most once
+ * on every path, when it's first needed), and the rest are temporaries. The
+ * static offsets are deduplicated (the ones that are read come first), and
+ * their displacement inside the grid (in cells, in row-major order, with the
+ * width of the automaton as the stride, unless it's changed) is
+ * precomputed.
+ */
+typedef struct {
+	Instruction * code;
+	unsigned int count;
+	unsigned int capacity;
+
+	unsigned int registers;
+	unsigned int variables;
+
+	Offset * offsets;
+	ptrdiff_t * displacements;
+	unsigned int offsetCount;
+	unsigned int offsetCapacity;
+	unsigned int readCount;
+
+	// The bounding box of the static offsets (including the cell itself).
+	Offset minimum;
+	Offset maximum;
+
+	// Whether the program reads (or adds) cells at offsets computed while
+	// it runs, which can be outside of the bounding box.
+	boolean isDynamic;
+} Bytecode;
+
+/**
+ * Lowers the transition program of an automaton into bytecode.
+ */
+Bytecode * compileTransition(const Automaton * automaton);
+
+/**
+ * Lowers the neighborhood program of an automaton into bytecode.
+ */
+Bytecode * compileNeighborhood(const Automaton * automaton);
+
+/**
+ * Destroys a program.
+ */
+void destroyBytecode(Bytecode * bytecode);
+
+/**
+ * Recomputes the displacements of the static offsets for the rows of a grid
+ * with the specified stride (e.g., a padded one).
+ */
+void setBytecodeStride(Bytecode * bytecode, const size_t stride);
+
+#endif
@@ -0,0 +1,210 @@
+#include "BytecodeEngine.h"
+
+/**
+ * The state of a bytecode engine: the compiled programs, a virtual machine
+ * per worker, the current generation and the buffer of the next one, padded
+ * with a halo as wide as the bounding box of the neighborhood (so the static
+ * offsets never resolve the frontier), and the displacements of the fixed
+ * neighbors in them. The bounding box is also used to skip the quiescent
+ * tiles (if the programs read no cells outside of it).
+ */
+typedef struct {
+	const Automaton * automaton;
+	Bytecode * transition;
+	Bytecode * neighborhood;
+	Bands * bands;
+	ActiveTiles * tiles;
+	VirtualMachine ** machines;
+	PaddedGrid * current;
+	PaddedGrid * next;
+	ptrdiff_t * displacements;
+	Offset minimum;
+	Offset maximum;
+} BytecodeEngine;
+
+/* PRIVATE FUNCTIONS */
+
+static void _advance(Engine * engine, const uint64_t generations);
+static unsigned int _countAliveNeighbors(BytecodeEngine * bytecode, VirtualMachine * machine, const int x, const int y);
+static void _destroy(Engine * engine);
+static void _load(Engine * engine, const Grid * grid);
+static void _stepBand(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow);
+static boolean _stepTile(void * context, const unsigned int worker,
+	const unsigned int firstColumn, const unsigned int lastColumn, const unsigned int firstRow, const unsigned int lastRow);
+static void _store(Engine * engine, Grid * grid);
+
+static void _advance(Engine * engine, const uint64_t generations) {
+	BytecodeEngine * bytecode = engine->data;
+	if (bytecode->automaton->rule == STATIC_RULE) {
+		return;
+	}
+	for (uint64_t generation = 0; generation < generations; ++generation) {
+		if (bytecode->tiles != NULL) {
+			prepareActiveTiles(bytecode->tiles);
+		}
+		fillHalo(bytecode->bands, bytecode->current);
+		runBands(bytecode->bands, _stepBand, bytecode);
+		PaddedGrid * swap = bytecode->current;
+		bytecode->current = bytecode->next;
+		bytecode->next = swap;
+	}
+}
+
+/**
+ * Counts the alive neighbors of a cell, in the predefined neighborhood, or
+ * in the one built by the neighborhood program (whose neighbors are inside
+ * the halo, unless they are computed while it runs).
+ */
+static unsigned int _countAliveNeighbors(BytecodeEngine * bytecode, VirtualMachine * machine, const int x, const int y) {
+	const PaddedGrid * grid = bytecode->current;
+	const uint8_t * cell = grid->cells + (size_t) y * grid->stride + x;
+	unsigned int alive = 0;
+	if (bytecode->neighborhood == NULL) {
+		for (unsigned int k = 0; k < bytecode->automaton->neighborCount; ++k) {
+			alive += cell[bytecode->displacements[k]] == ALIVE_STATE;
+		}
+		return alive;
+	}
+	runBytecode(machine, bytecode->neighborhood, grid, x, y);
+	const Offset * neighbors = machine->neighbors;
+	if (bytecode->neighborhood->isDynamic) {
+		for (unsigned int k = 0; k < machine->neighborCount; ++k) {
+			alive += readPaddedCell(grid, x + neighbors[k].x, y + neighbors[k].y) == ALIVE_STATE;
+		}
+		return alive;
+	}
+	for (unsigned int k = 0; k < machine->neighborCount; ++k) {
+		alive += cell[(ptrdiff_t) neighbors[k].y * (ptrdiff_t) grid->stride + neighbors[k].x] == ALIVE_STATE;
+	}
+	return alive;
+}
+
+static void _destroy(Engine * engine) {
+	BytecodeEngine * bytecode = engine->data;
+	destroyBytecode(bytecode->transition);
+	destroyBytecode(bytecode->neighborhood);
+	for (unsigned int k = 0; k < bytecode->bands->workers; ++k) {
+		destroyVirtualMachine(bytecode->machines[k]);
+	}
+	free(bytecode->machines);
+	destroyBands(bytecode->bands);
+	destroyActiveTiles(bytecode->tiles);
+	destroyPaddedGrid(bytecode->current);
+	destroyPaddedGrid(bytecode->next);
+	free(bytecode->displacements);
+	free(bytecode);
+	free(engine);
+}
+
+static void _load(Engine * engine, const Grid * grid) {
+	BytecodeEngine * bytecode = engine->data;
+	loadPaddedGrid(bytecode->bands, bytecode->current, grid);
+	if (bytecode->tiles != NULL) {
+		resetActiveTiles(bytecode->tiles);
+	}
+}
+
+/**
+ * Computes the next generation of the rows of a band (only in the active
+ * tiles, if they are tracked).
+ */
+static void _stepBand(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow) {
+	BytecodeEngine * bytecode = context;
+	if (bytecode->tiles == NULL) {
+		_stepTile(bytecode, worker, 0, bytecode->current->width, firstRow, lastRow);
+	}
+	else {
+		runActiveTiles(bytecode->tiles, _stepTile, bytecode, worker, firstRow, lastRow);
+	}
+}
+
+/**
+ * Computes the next generation of a rectangle of cells.
+ */
+static boolean _stepTile(void * context, const unsigned int worker,
+		const unsigned int firstColumn, const unsigned int lastColumn, const unsigned int firstRow, const unsigned int lastRow) {
+	BytecodeEngine * bytecode = context;
+	const Automaton * automaton = bytecode->automaton;
+	VirtualMachine * machine = bytecode->machines[worker];
+	const PaddedGrid * current = bytecode->current;
+	boolean changed = false;
+	for (unsigned int y = firstRow; y < lastRow; ++y) {
+		const uint8_t * cells = current->cells + (size_t) y * current->stride;
+		uint8_t * output = bytecode->next->cells + (size_t) y * current->stride;
+		for (unsigned int x = firstColumn; x < lastColumn; ++x) {
+			if (automaton->rule == TRANSITION_RULE) {
+				const int state = runBytecode(machine, bytecode->transition, current, x, y);
+				output[x] = 0 <= state && state < (int) automaton->states ? (uint8_t) state : cells[x];
+			}
+			else {
+				output[x] = evolve(automaton, cells[x], _countAliveNeighbors(bytecode, machine, x, y));
+			}
+			changed |= output[x] != cells[x];
+		}
+	}
+	return changed;
+}
+
+static void _store(Engine * engine, Grid * grid) {
+	BytecodeEngine * bytecode = engine->data;
+	storePaddedGrid(bytecode->bands, bytecode->current, grid);
+}
+
+/* PUBLIC FUNCTIONS */
+
+Engine * createBytecodeEngine(const Automaton * automaton, const unsigned int threads) {
+	BytecodeEngine * bytecode = calloc(1, sizeof(BytecodeEngine));
+	bytecode->automaton = automaton;
+	if (automaton->rule == TRANSITION_RULE) {
+		bytecode->transition = compileTransition(automaton);
+		bytecode->minimum = bytecode->transition->minimum;
+		bytecode->maximum = bytecode->transition->maximum;
+	}
+	else if (automaton->neighborhoodProgram != NULL) {
+		bytecode->neighborhood = compileNeighborhood(automaton);
+		bytecode->minimum = bytecode->neighborhood->minimum;
+		bytecode->maximum = bytecode->neighborhood->maximum;
+	}
+	for (unsigned int k = 0; k < automaton->neighborCount; ++k) {
+		const Offset offset = automaton->neighbors[k];
+		bytecode->minimum.x = offset.x < bytecode->minimum.x ? offset.x : bytecode->minimum.x;
+		bytecode->minimum.y = offset.y < bytecode->minimum.y ? offset.y : bytecode->minimum.y;
+		bytecode->maximum.x = bytecode->maximum.x < offset.x ? offset.x : bytecode->maximum.x;
+		bytecode->maximum.y = bytecode->maximum.y < offset.y ? offset.y : bytecode->maximum.y;
+	}
+	const boolean isDynamic = (bytecode->transition != NULL && bytecode->transition->isDynamic)
+		|| (bytecode->neighborhood != NULL && bytecode->neighborhood->isDynamic);
+	const unsigned int tileSize = getActiveTileSize();
+	if (automaton->rule != STATIC_RULE && !isDynamic && 0 < tileSize) {
+		bytecode->tiles = createActiveTiles(automaton, tileSize, tileSize, bytecode->minimum, bytecode->maximum);
+	}
+	bytecode->bands = createBands(automaton->height, bytecode->tiles == NULL ? 1 : tileSize, threads);
+	bytecode->machines = calloc(bytecode->bands->workers, sizeof(VirtualMachine *));
+	for (unsigned int k = 0; k < bytecode->bands->workers; ++k) {
+		bytecode->machines[k] = createVirtualMachine(automaton, bytecode->transition, bytecode->neighborhood);
+	}
+	const unsigned int halo = getHaloWidth(bytecode->minimum, bytecode->maximum);
+	bytecode->current = createPaddedGrid(automaton, halo);
+	bytecode->next = createPaddedGrid(automaton, halo);
+	bytecode->displacements = calloc(automaton->neighborCount + 1, sizeof(ptrdiff_t));
+	for (unsigned int k = 0; k < automaton->neighborCount; ++k) {
+		const Offset offset = automaton->neighbors[k];
+		bytecode->displacements[k] = (ptrdiff_t) offset.y * (ptrdiff_t) bytecode->current->stride + offset.x;
+	}
+	if (bytecode->transition != NULL) {
+		setBytecodeStride(bytecode->transition, bytecode->current->stride);
+	}
+	if (bytecode->neighborhood != NULL) {
+		setBytecodeStride(bytecode->neighborhood, bytecode->current->stride);
+	}
+	Engine * engine = calloc(1, sizeof(Engine));
+	engine->name = "bytecode";
+	engine->automaton = automaton;
+	engine->data = bytecode;
+	engine->tiles = bytecode->tiles;
+	engine->load = _load;
+	engine->advance = _advance;
+	engine->store = _store;
+	engine->destroy = _destroy;
+	return engine;
+}
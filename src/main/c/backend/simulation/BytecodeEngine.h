@@ -0,0 +1,23 @@
+#ifndef BYTECODE_ENGINE_HEADER
+#define BYTECODE_ENGINE_HEADER
+
+#include "ActiveTiles.h"
+#include "Automaton.h"
+#include "Bands.h"
+#include "Bytecode.h"
+#include "Engine.h"
+#include "Grid.h"
+#include "PaddedGrid.h"
+#include "VirtualMachine.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * Creates an engine that runs the programs of the automaton, compiled into
+ * bytecode, on a virtual machine. It supports any automaton, so it's the
+ * fallback of the specialized engines. The rows are split into bands, for
+ * the specified amount of threads (see "createBands").
+ */
+Engine * createBytecodeEngine(const Automaton * automaton, const unsigned int threads);
+
+#endif
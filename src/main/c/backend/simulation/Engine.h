@@ -0,0 +1,35 @@
+#ifndef ENGINE_HEADER
+#define ENGINE_HEADER
+
+#include "ActiveTiles.h"
+#include "Automaton.h"
+#include "Grid.h"
+#include <stdint.h>
+
+typedef struct Engine Engine;
+
+/**
+ * A strategy to simulate an automaton. Every engine keeps the cells in its
+ * own representation: a grid is loaded once, the engine advances it any
+ * amount of generations, and the cells are stored back into a grid (e.g.,
+ * to hash them, or to compare them with another engine).
+ */
+struct Engine {
+	// A short name, for the logs and the SIMULATION_ENGINE variable.
+	const char * name;
+	const Automaton * automaton;
+
+	// The private state of the engine.
+	void * data;
+
+	// The tiles computed and skipped by the engine (NULL if it computes
+	// every cell, in every generation).
+	const ActiveTiles * tiles;
+
+	void (* load)(Engine * engine, const Grid * grid);
+	void (* advance)(Engine * engine, const uint64_t generations);
+	void (* store)(Engine * engine, Grid * grid);
+	void (* destroy)(Engine * engine);
+};
+
+#endif
@@ -0,0 +1,102 @@
+#include "Grid.h"
+
+/* PRIVATE FUNCTIONS */
+
+static uint64_t _mix(uint64_t value);
+
+/**
+ * The finalizer of SplitMix64, a fast and well distributed 64-bit hash.
+ *
+ * @see https://prng.di.unimi.it/splitmix64.c
+ */
+static uint64_t _mix(uint64_t value) {
+	value += 0x9E3779B97F4A7C15ull;
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+	return value ^ (value >> 31);
+}
+
+/* PUBLIC FUNCTIONS */
+
+Grid * createGrid(const unsigned int width, const unsigned int height) {
+	Grid * grid = calloc(1, sizeof(Grid));
+	grid->width = width;
+	grid->height = height;
+	grid->cells = calloc((size_t) width * height, sizeof(uint8_t));
+	return grid;
+}
+
+void destroyGrid(Grid * grid) {
+	if (grid != NULL) {
+		free(grid->cells);
+		free(grid);
+	}
+}
+
+void copyGrid(Grid * destination, const Grid * source) {
+	memcpy(destination->cells, source->cells, (size_t) source->width * source->height);
+}
+
+size_t countCells(const Grid * grid, const uint8_t state) {
+	const size_t size = (size_t) grid->width * grid->height;
+	size_t count = 0;
+	for (size_t k = 0; k < size; ++k) {
+		count += grid->cells[k] == state;
+	}
+	return count;
+}
+
+boolean equalGrids(const Grid * grid, const Grid * otherGrid) {
+	return memcmp(grid->cells, otherGrid->cells, (size_t) grid->width * grid->height) == 0;
+}
+
+uint64_t hashGrid(const Grid * grid) {
+	const size_t size = (size_t) grid->width * grid->height;
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t k = 0; k < size; ++k) {
+		hash ^= grid->cells[k];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+void randomizeGrid(Grid * grid, const unsigned int states, const uint64_t seed) {
+	const size_t size = (size_t) grid->width * grid->height;
+	const uint64_t base = _mix(seed);
+	for (size_t k = 0; k < size; ++k) {
+		grid->cells[k] = (uint8_t) (_mix(base ^ k) % states);
+	}
+}
+
+int resolveCoordinate(const FrontierEnum frontier, const int coordinate, const unsigned int size) {
+	if (0 <= coordinate && coordinate < (int) size) {
+		return coordinate;
+	}
+	const int length = (int) size;
+	int wrapped;
+	switch (frontier) {
+		case PERIODIC:
+			wrapped = coordinate % length;
+			return wrapped < 0 ? wrapped + length : wrapped;
+		case MIRROR:
+			wrapped = coordinate % (2 * length);
+			if (wrapped < 0) {
+				wrapped += 2 * length;
+			}
+			return wrapped < length ? wrapped : 2 * length - 1 - wrapped;
+		case OPEN:
+		default:
+			return -1;
+	}
+}
+
+void thinGrid(Grid * grid, const uint8_t background, const double density, const uint64_t seed) {
+	const size_t size = (size_t) grid->width * grid->height;
+	const uint64_t base = _mix(~seed);
+	for (size_t k = 0; k < size; ++k) {
+		// The 53 most significant bits, as a uniform number in [0, 1).
+		if (density <= (_mix(base ^ k) >> 11) * 0x1.0p-53) {
+			grid->cells[k] = background;
+		}
+	}
+}
@@ -0,0 +1,72 @@
+#ifndef GRID_HEADER
+#define GRID_HEADER
+
+#include "../../shared/Type.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * A rectangular grid of cells, in row-major order, with the state of every
+ * cell in a byte.
+ */
+typedef struct {
+	unsigned int width;
+	unsigned int height;
+	uint8_t * cells;
+} Grid;
+
+/**
+ * Creates a grid with every cell in the first state.
+ */
+Grid * createGrid(const unsigned int width, const unsigned int height);
+
+/**
+ * Destroys a grid.
+ */
+void destroyGrid(Grid * grid);
+
+/**
+ * Copies the cells of a grid into another one, of the same size.
+ */
+void copyGrid(Grid * destination, const Grid * source);
+
+/**
+ * The amount of cells of a grid in a state.
+ */
+size_t countCells(const Grid * grid, const uint8_t state);
+
+/**
+ * Whether two grids of the same size have the same cells.
+ */
+boolean equalGrids(const Grid * grid, const Grid * otherGrid);
+
+/**
+ * A 64-bit FNV-1a hash of the cells of a grid, to compare the results of
+ * different engines (or runs).
+ */
+uint64_t hashGrid(const Grid * grid);
+
+/**
+ * Fills a grid with pseudo-random states (from zero to the amount of states,
+ * exclusive). The state of every cell only depends on the seed and on its
+ * position, so every engine starts from the same grid.
+ */
+void randomizeGrid(Grid * grid, const unsigned int states, const uint64_t seed);
+
+/**
+ * Maps a coordinate (of a row or column) into the range [0, size) according
+ * to a frontier: Periodic wraps around, Mirror reflects (repeating the cells
+ * of the border), and Open leaves it outside. Returns -1 if the coordinate
+ * is outside.
+ */
+int resolveCoordinate(const FrontierEnum frontier, const int coordinate, const unsigned int size);
+
+/**
+ * Replaces cells of a grid with a background state, keeping each one with a
+ * probability (the density), so a random grid can be sparse. Like
+ * "randomizeGrid", a cell only depends on the seed and on its position.
+ */
+void thinGrid(Grid * grid, const uint8_t background, const double density, const uint64_t seed);
+
+#endif
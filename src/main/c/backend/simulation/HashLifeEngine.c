@@ -0,0 +1,672 @@
+#include "HashLifeEngine.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeHashLifeEngineModule() {
+	_logger = createLogger("HashLifeEngine");
+}
+
+void shutdownHashLifeEngineModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/**
+ * The levels of the nodes (a node of level "k" is a square of 2^k cells per
+ * side), enough to advance 2^63 generations.
+ */
+#define HASHLIFE_LEVELS 68
+
+/**
+ * The biggest level of the nodes computed cell by cell (instead of
+ * recursively), and their side.
+ */
+#define HASHLIFE_LEAF_LEVEL 3
+#define HASHLIFE_LEAF_SIDE (1 << HASHLIFE_LEAF_LEVEL)
+
+/**
+ * The nodes allocated at once, when the free list is empty.
+ */
+#define HASHLIFE_BLOCK_NODES 65536
+
+/**
+ * The initial amount of buckets of the node cache (a power of two).
+ */
+#define HASHLIFE_INITIAL_BUCKETS 65536
+
+/**
+ * The state of a cell of the quadtree. An open grid is surrounded by walls:
+ * cells that never change, and count as dead neighbors, so the frontier is
+ * the same on every generation, and the universe is still uniform.
+ */
+typedef enum {
+	DEAD_LEAF = 0,
+	ALIVE_LEAF = 1,
+	WALL_LEAF = 2
+} LeafState;
+
+typedef struct HashLifeNode HashLifeNode;
+
+/**
+ * A square of 2^level cells per side. A cell is a leaf (a node of level 0),
+ * and any other node is made of four quadrants of the level below. Nodes are
+ * unique (i.e., hash-consed), so they are compared by address.
+ */
+struct HashLifeNode {
+	HashLifeNode * nw;
+	HashLifeNode * ne;
+	HashLifeNode * sw;
+	HashLifeNode * se;
+
+	// The center of the node (with half its side) after 2^step generations,
+	// or NULL if it's not computed yet.
+	HashLifeNode * result;
+
+	// The next node of the same bucket (or of the free list).
+	HashLifeNode * next;
+
+	// The last collection that reached the node, and the period (between two
+	// collections) in which its result was last used.
+	uint32_t mark;
+	uint32_t epoch;
+
+	uint8_t level;
+	uint8_t step;
+	uint8_t state;
+};
+
+/**
+ * The state of a HashLife engine: the node cache (a hash table of nodes,
+ * with chaining), the universe, and the nodes that can't be collected
+ * because they are being used by a computation in progress.
+ */
+typedef struct {
+	unsigned int width;
+	unsigned int height;
+	FrontierEnum frontier;
+	boolean isVonNeumann;
+
+	// The amounts of alive neighbors that keep a cell alive, or make it
+	// born, as a bitmask.
+	uint32_t survival;
+	uint32_t birth;
+
+	HashLifeNode ** buckets;
+	size_t bucketCount;
+	size_t nodes;
+	HashLifeNode * free;
+	HashLifeNode ** blocks;
+	size_t blockCount;
+
+	// The amount of nodes that triggers a collection, and the limit of the
+	// memory of the cache (in nodes).
+	size_t threshold;
+	size_t limit;
+	uint32_t collections;
+	uint32_t epoch;
+
+	HashLifeNode leaves[3];
+	HashLifeNode * walls[HASHLIFE_LEVELS];
+
+	HashLifeNode ** stack;
+	size_t stackSize;
+	size_t stackCapacity;
+
+	// The grid: a periodic one is the root itself (the whole torus), and an
+	// open one is centered in the root, surrounded by walls (so its first
+	// cell is at 2^(level - 2) in both axes).
+	HashLifeNode * root;
+} HashLife;
+
+/* PRIVATE FUNCTIONS */
+
+static void _advance(Engine * engine, const uint64_t generations);
+static void _advanceOpen(HashLife * life, const unsigned int step);
+static void _advancePeriodic(HashLife * life, const unsigned int step);
+static HashLifeNode * _allocate(HashLife * life);
+static HashLifeNode * _build(HashLife * life, const Grid * grid, const int64_t x, const int64_t y, const unsigned int level);
+static HashLifeNode * _buildLeaves(HashLife * life, uint8_t cells[][HASHLIFE_LEAF_SIDE], const unsigned int x, const unsigned int y, const unsigned int level);
+static HashLifeNode * _center(HashLife * life, const HashLifeNode * node);
+static void _collect(HashLife * life);
+static void _destroy(Engine * engine);
+static HashLifeNode * _expand(HashLife * life, const HashLifeNode * node);
+static void _extract(const HashLife * life, const HashLifeNode * node, const int64_t x, const int64_t y, Grid * grid);
+static HashLifeNode * _findNode(HashLife * life, HashLifeNode * nw, HashLifeNode * ne, HashLifeNode * sw, HashLifeNode * se);
+static size_t _hash(const HashLifeNode * nw, const HashLifeNode * ne, const HashLifeNode * sw, const HashLifeNode * se);
+static void _load(Engine * engine, const Grid * grid);
+static void _mark(HashLife * life, HashLifeNode * node, const boolean keepResults);
+static HashLifeNode * _push(HashLife * life, HashLifeNode * node);
+static void _readLeaves(const HashLifeNode * node, uint8_t cells[][HASHLIFE_LEAF_SIDE], const unsigned int x, const unsigned int y);
+static void _resize(HashLife * life);
+static HashLifeNode * _result(HashLife * life, HashLifeNode * node, const unsigned int step);
+static HashLifeNode * _stepLeaves(HashLife * life, const HashLifeNode * node, const unsigned int step);
+static void _store(Engine * engine, Grid * grid);
+static void _sweep(HashLife * life);
+
+/**
+ * Advances the universe by every power of two in the amount of generations.
+ */
+static void _advance(Engine * engine, const uint64_t generations) {
+	HashLife * life = engine->data;
+	for (unsigned int step = 0; step < 64; ++step) {
+		if ((generations >> step) & 1) {
+			if (life->frontier == OPEN) {
+				_advanceOpen(life, step);
+			}
+			else {
+				_advancePeriodic(life, step);
+			}
+			logDebugging(_logger, "Advanced 2^%u generations, with %zu nodes in the cache.", step, life->nodes);
+		}
+	}
+}
+
+/**
+ * Advances an open grid by 2^step generations. The root is expanded with
+ * walls until it's big enough for the step (the cells outside it can't
+ * reach the grid in time), and the result is reduced (or expanded) back to
+ * the root, so the grid is always at the same place.
+ */
+static void _advanceOpen(HashLife * life, const unsigned int step) {
+	const size_t stackSize = life->stackSize;
+	const unsigned int level = life->root->level;
+	HashLifeNode * universe = life->root;
+	while (universe->level < step + 2) {
+		universe = _push(life, _expand(life, universe));
+	}
+	HashLifeNode * result = _push(life, _result(life, universe, step));
+	if (result->level < level) {
+		result = _expand(life, result);
+	}
+	while (level < result->level) {
+		result = _center(life, result);
+	}
+	life->root = result;
+	life->stackSize = stackSize;
+}
+
+/**
+ * Advances a periodic grid by 2^step generations. The torus is the tile of
+ * an infinite periodic universe, so the root is tiled in a node big enough
+ * for the step, and the torus is taken back from its result: at a multiple
+ * of its side (any quadrant, then), or at half of it (with the quadrants
+ * swapped diagonally).
+ */
+static void _advancePeriodic(HashLife * life, const unsigned int step) {
+	const size_t stackSize = life->stackSize;
+	const unsigned int level = life->root->level;
+	const unsigned int tiledLevel = level + 1 < step + 2 ? step + 2 : level + 1;
+	HashLifeNode * tiled = life->root;
+	while (tiled->level < tiledLevel) {
+		tiled = _push(life, _findNode(life, tiled, tiled, tiled, tiled));
+	}
+	HashLifeNode * result = _push(life, _result(life, tiled, step));
+	if (level <= tiledLevel - 2) {
+		while (level < result->level) {
+			result = result->nw;
+		}
+	}
+	else {
+		result = _findNode(life, result->se, result->sw, result->ne, result->nw);
+	}
+	life->root = result;
+	life->stackSize = stackSize;
+}
+
+/**
+ * Takes a node from the free list, allocating a new block if it's empty.
+ */
+static HashLifeNode * _allocate(HashLife * life) {
+	if (life->free == NULL) {
+		HashLifeNode * block = calloc(HASHLIFE_BLOCK_NODES, sizeof(HashLifeNode));
+		life->blocks = realloc(life->blocks, (life->blockCount + 1) * sizeof(HashLifeNode *));
+		life->blocks[life->blockCount++] = block;
+		for (size_t k = 0; k < HASHLIFE_BLOCK_NODES; ++k) {
+			block[k].next = life->free;
+			life->free = &block[k];
+		}
+	}
+	HashLifeNode * node = life->free;
+	life->free = node->next;
+	return node;
+}
+
+/**
+ * Builds the node of the square of cells at (x, y) of a grid. The cells
+ * outside the grid are walls.
+ */
+static HashLifeNode * _buildLeaves(HashLife * life, uint8_t cells[][HASHLIFE_LEAF_SIDE], const unsigned int x, const unsigned int y, const unsigned int level);
+static HashLifeNode * _build(HashLife * life, const Grid * grid, const int64_t x, const int64_t y, const unsigned int level) {
+	const int64_t side = INT64_C(1) << level;
+	if (grid->width <= x || grid->height <= y || x + side <= 0 || y + side <= 0) {
+		return life->walls[level];
+	}
+	if (level == 0) {
+		const boolean isAlive = grid->cells[(size_t) y * grid->width + x] == ALIVE_STATE;
+		return &life->leaves[isAlive ? ALIVE_LEAF : DEAD_LEAF];
+	}
+	const size_t stackSize = life->stackSize;
+	const int64_t half = side / 2;
+	HashLifeNode * nw = _push(life, _build(life, grid, x, y, level - 1));
+	HashLifeNode * ne = _push(life, _build(life, grid, x + half, y, level - 1));
+	HashLifeNode * sw = _push(life, _build(life, grid, x, y + half, level - 1));
+	HashLifeNode * se = _build(life, grid, x + half, y + half, level - 1);
+	HashLifeNode * node = _findNode(life, nw, ne, sw, se);
+	life->stackSize = stackSize;
+	return node;
+}
+
+/**
+ * Builds the node of the square of cells at (x, y) of a small square (see
+ * "_stepLeaves").
+ */
+static HashLifeNode * _buildLeaves(HashLife * life, uint8_t cells[][HASHLIFE_LEAF_SIDE], const unsigned int x, const unsigned int y, const unsigned int level) {
+	if (level == 0) {
+		return &life->leaves[cells[y][x]];
+	}
+	const size_t stackSize = life->stackSize;
+	const unsigned int half = 1u << (level - 1);
+	HashLifeNode * nw = _push(life, _buildLeaves(life, cells, x, y, level - 1));
+	HashLifeNode * ne = _push(life, _buildLeaves(life, cells, x + half, y, level - 1));
+	HashLifeNode * sw = _push(life, _buildLeaves(life, cells, x, y + half, level - 1));
+	HashLifeNode * se = _buildLeaves(life, cells, x + half, y + half, level - 1);
+	HashLifeNode * node = _findNode(life, nw, ne, sw, se);
+	life->stackSize = stackSize;
+	return node;
+}
+
+/**
+ * The center of a node (with half its side), at the same generation.
+ */
+static HashLifeNode * _center(HashLife * life, const HashLifeNode * node) {
+	return _findNode(life, node->nw->se, node->ne->sw, node->sw->ne, node->se->nw);
+}
+
+/**
+ * Frees the nodes that aren't reachable from the universe, the walls, or a
+ * computation in progress. The results used since the last collection are
+ * kept (and the nodes they reach); if the cache is still above half its
+ * limit, every result that isn't reachable by itself is dropped too.
+ */
+static void _collect(HashLife * life) {
+	const size_t nodes = life->nodes;
+	for (unsigned int pass = 0; pass < 2; ++pass) {
+		const boolean keepResults = pass == 0;
+		if (!keepResults && life->nodes <= life->limit / 2) {
+			break;
+		}
+		++life->collections;
+		_mark(life, life->root, keepResults);
+		for (unsigned int level = 1; level < HASHLIFE_LEVELS; ++level) {
+			_mark(life, life->walls[level], keepResults);
+		}
+		for (size_t k = 0; k < life->stackSize; ++k) {
+			_mark(life, life->stack[k], keepResults);
+		}
+		_sweep(life);
+	}
+	++life->epoch;
+	life->threshold = life->limit;
+	if (life->limit / 4 * 3 < life->nodes) {
+		logWarning(_logger, "The node cache needs %zu nodes, beyond its limit of %zu (see HASHLIFE_MEMORY_LIMIT).", life->nodes, life->limit);
+		life->threshold = life->nodes + life->limit / 4;
+	}
+	logDebugging(_logger, "Collected %zu of %zu nodes.", nodes - life->nodes, nodes);
+}
+
+static void _destroy(Engine * engine) {
+	HashLife * life = engine->data;
+	for (size_t k = 0; k < life->blockCount; ++k) {
+		free(life->blocks[k]);
+	}
+	free(life->blocks);
+	free(life->buckets);
+	free(life->stack);
+	free(life);
+	free(engine);
+}
+
+/**
+ * Surrounds a node with walls: the node is the center of the result.
+ */
+static HashLifeNode * _expand(HashLife * life, const HashLifeNode * node) {
+	const size_t stackSize = life->stackSize;
+	HashLifeNode * wall = life->walls[node->level - 1];
+	HashLifeNode * nw = _push(life, _findNode(life, wall, wall, wall, node->nw));
+	HashLifeNode * ne = _push(life, _findNode(life, wall, wall, node->ne, wall));
+	HashLifeNode * sw = _push(life, _findNode(life, wall, node->sw, wall, wall));
+	HashLifeNode * se = _findNode(life, node->se, wall, wall, wall);
+	HashLifeNode * expanded = _findNode(life, nw, ne, sw, se);
+	life->stackSize = stackSize;
+	return expanded;
+}
+
+/**
+ * Stores the cells of the square at (x, y) of a grid, skipping the ones
+ * outside it.
+ */
+static void _extract(const HashLife * life, const HashLifeNode * node, const int64_t x, const int64_t y, Grid * grid) {
+	const int64_t side = INT64_C(1) << node->level;
+	if (grid->width <= x || grid->height <= y || x + side <= 0 || y + side <= 0) {
+		return;
+	}
+	if (node->level == 0) {
+		grid->cells[(size_t) y * grid->width + x] = node->state == ALIVE_LEAF ? ALIVE_STATE : DEAD_STATE;
+		return;
+	}
+	const int64_t half = side / 2;
+	_extract(life, node->nw, x, y, grid);
+	_extract(life, node->ne, x + half, y, grid);
+	_extract(life, node->sw, x, y + half, grid);
+	_extract(life, node->se, x + half, y + half, grid);
+}
+
+/**
+ * The unique node with the specified quadrants (created if it isn't in the
+ * cache). The quadrants are protected from the collection that the creation
+ * may trigger.
+ */
+static HashLifeNode * _findNode(HashLife * life, HashLifeNode * nw, HashLifeNode * ne, HashLifeNode * sw, HashLifeNode * se) {
+	const size_t hash = _hash(nw, ne, sw, se);
+	for (HashLifeNode * node = life->buckets[hash & (life->bucketCount - 1)]; node != NULL; node = node->next) {
+		if (node->nw == nw && node->ne == ne && node->sw == sw && node->se == se) {
+			return node;
+		}
+	}
+	if (life->threshold <= life->nodes) {
+		const size_t stackSize = life->stackSize;
+		_push(life, nw);
+		_push(life, ne);
+		_push(life, sw);
+		_push(life, se);
+		_collect(life);
+		life->stackSize = stackSize;
+	}
+	if (life->bucketCount < life->nodes) {
+		_resize(life);
+	}
+	HashLifeNode * node = _allocate(life);
+	*node = (HashLifeNode) {
+		.nw = nw,
+		.ne = ne,
+		.sw = sw,
+		.se = se,
+		.level = nw->level + 1
+	};
+	HashLifeNode ** bucket = &life->buckets[hash & (life->bucketCount - 1)];
+	node->next = *bucket;
+	*bucket = node;
+	++life->nodes;
+	return node;
+}
+
+static size_t _hash(const HashLifeNode * nw, const HashLifeNode * ne, const HashLifeNode * sw, const HashLifeNode * se) {
+	uint64_t hash = (uintptr_t) nw * UINT64_C(0x9E3779B97F4A7C15);
+	hash = (hash ^ (uintptr_t) ne) * UINT64_C(0xBF58476D1CE4E5B9);
+	hash = (hash ^ (uintptr_t) sw) * UINT64_C(0x94D049BB133111EB);
+	hash = (hash ^ (uintptr_t) se) * UINT64_C(0x9E3779B97F4A7C15);
+	return (size_t) (hash ^ (hash >> 32));
+}
+
+static void _load(Engine * engine, const Grid * grid) {
+	HashLife * life = engine->data;
+	if (life->frontier == OPEN) {
+		// The grid fits in the center of the root (of at least level 2, the
+		// smallest one with a result).
+		unsigned int level = 2;
+		while ((UINT64_C(1) << (level - 1)) < grid->width || (UINT64_C(1) << (level - 1)) < grid->height) {
+			++level;
+		}
+		const int64_t origin = INT64_C(1) << (level - 2);
+		life->root = _build(life, grid, -origin, -origin, level);
+	}
+	else {
+		unsigned int level = 0;
+		while ((UINT64_C(1) << level) < grid->width) {
+			++level;
+		}
+		life->root = _build(life, grid, 0, 0, level);
+	}
+	logDebugging(_logger, "Loaded a root of level %u, with %zu nodes in the cache.", life->root->level, life->nodes);
+}
+
+/**
+ * Marks a node and the nodes it reaches (and, optionally, the results used
+ * since the last collection).
+ */
+static void _mark(HashLife * life, HashLifeNode * node, const boolean keepResults) {
+	if (node == NULL || node->level == 0 || node->mark == life->collections) {
+		return;
+	}
+	node->mark = life->collections;
+	_mark(life, node->nw, keepResults);
+	_mark(life, node->ne, keepResults);
+	_mark(life, node->sw, keepResults);
+	_mark(life, node->se, keepResults);
+	if (keepResults && node->result != NULL && node->epoch == life->epoch) {
+		_mark(life, node->result, keepResults);
+	}
+}
+
+/**
+ * Protects a node from collections, until the stack is restored to a
+ * previous size.
+ */
+static HashLifeNode * _push(HashLife * life, HashLifeNode * node) {
+	if (life->stackSize == life->stackCapacity) {
+		life->stackCapacity = life->stackCapacity == 0 ? 256 : 2 * life->stackCapacity;
+		life->stack = realloc(life->stack, life->stackCapacity * sizeof(HashLifeNode *));
+	}
+	life->stack[life->stackSize++] = node;
+	return node;
+}
+
+/**
+ * Reads the cells of a small node into a square, at (x, y).
+ */
+static void _readLeaves(const HashLifeNode * node, uint8_t cells[][HASHLIFE_LEAF_SIDE], const unsigned int x, const unsigned int y) {
+	if (node->level == 0) {
+		cells[y][x] = node->state;
+		return;
+	}
+	const unsigned int half = 1u << (node->level - 1);
+	_readLeaves(node->nw, cells, x, y);
+	_readLeaves(node->ne, cells, x + half, y);
+	_readLeaves(node->sw, cells, x, y + half);
+	_readLeaves(node->se, cells, x + half, y + half);
+}
+
+/**
+ * Doubles the buckets of the cache.
+ */
+static void _resize(HashLife * life) {
+	const size_t bucketCount = 2 * life->bucketCount;
+	HashLifeNode ** buckets = calloc(bucketCount, sizeof(HashLifeNode *));
+	for (size_t k = 0; k < life->bucketCount; ++k) {
+		HashLifeNode * node = life->buckets[k];
+		while (node != NULL) {
+			HashLifeNode * next = node->next;
+			HashLifeNode ** bucket = &buckets[_hash(node->nw, node->ne, node->sw, node->se) & (bucketCount - 1)];
+			node->next = *bucket;
+			*bucket = node;
+			node = next;
+		}
+	}
+	free(life->buckets);
+	life->buckets = buckets;
+	life->bucketCount = bucketCount;
+}
+
+/**
+ * The center of a node (of level 2 or more) after 2^step generations, where
+ * the step is at most the level minus 2 (the farthest a cell can read from
+ * its quadrant without leaving the node). The node is split into 9
+ * overlapping squares of half its side, whose results are combined into 4
+ * squares again, to compute their results (if the step is the maximum, that
+ * is, twice half the step) or just their centers (if it's smaller). Every
+ * result is memoized in the node.
+ */
+static HashLifeNode * _result(HashLife * life, HashLifeNode * node, const unsigned int step) {
+	if (node->result != NULL && node->step == step) {
+		node->epoch = life->epoch;
+		return node->result;
+	}
+	HashLifeNode * result = NULL;
+	if (node->level <= HASHLIFE_LEAF_LEVEL) {
+		result = _stepLeaves(life, node, step);
+	}
+	else {
+		const size_t stackSize = life->stackSize;
+		const boolean isMaximum = step + 2 == node->level;
+		const unsigned int halfStep = isMaximum ? step - 1 : step;
+		// Every new node is protected as soon as it's created (before the next
+		// one, that may trigger a collection).
+		HashLifeNode * parts[9];
+		parts[0] = node->nw;
+		parts[1] = _push(life, _findNode(life, node->nw->ne, node->ne->nw, node->nw->se, node->ne->sw));
+		parts[2] = node->ne;
+		parts[3] = _push(life, _findNode(life, node->nw->sw, node->nw->se, node->sw->nw, node->sw->ne));
+		parts[4] = _push(life, _center(life, node));
+		parts[5] = _push(life, _findNode(life, node->ne->sw, node->ne->se, node->se->nw, node->se->ne));
+		parts[6] = node->sw;
+		parts[7] = _push(life, _findNode(life, node->sw->ne, node->se->nw, node->sw->se, node->se->sw));
+		parts[8] = node->se;
+		for (unsigned int k = 0; k < 9; ++k) {
+			parts[k] = _push(life, _result(life, parts[k], halfStep));
+		}
+		HashLifeNode * quadrants[4];
+		quadrants[0] = _push(life, _findNode(life, parts[0], parts[1], parts[3], parts[4]));
+		quadrants[1] = _push(life, _findNode(life, parts[1], parts[2], parts[4], parts[5]));
+		quadrants[2] = _push(life, _findNode(life, parts[3], parts[4], parts[6], parts[7]));
+		quadrants[3] = _push(life, _findNode(life, parts[4], parts[5], parts[7], parts[8]));
+		for (unsigned int k = 0; k < 4; ++k) {
+			quadrants[k] = _push(life, isMaximum ? _result(life, quadrants[k], halfStep) : _center(life, quadrants[k]));
+		}
+		result = _findNode(life, quadrants[0], quadrants[1], quadrants[2], quadrants[3]);
+		life->stackSize = stackSize;
+	}
+	node->result = result;
+	node->step = (uint8_t) step;
+	node->epoch = life->epoch;
+	return result;
+}
+
+/**
+ * The center of a small node (of level 2 or HASHLIFE_LEAF_LEVEL) after
+ * 2^step generations, computed cell by cell: every generation, the cells
+ * that can still be computed shrink by one on each side.
+ */
+static HashLifeNode * _stepLeaves(HashLife * life, const HashLifeNode * node, const unsigned int step) {
+	uint8_t cells[2][HASHLIFE_LEAF_SIDE][HASHLIFE_LEAF_SIDE];
+	_readLeaves(node, cells[0], 0, 0);
+	const unsigned int side = 1u << node->level;
+	unsigned int current = 0;
+	for (unsigned int generation = 0; generation < (1u << step); ++generation) {
+		for (unsigned int y = generation + 1; y < side - generation - 1; ++y) {
+			for (unsigned int x = generation + 1; x < side - generation - 1; ++x) {
+				const uint8_t (* from)[HASHLIFE_LEAF_SIDE] = cells[current];
+				if (from[y][x] == WALL_LEAF) {
+					cells[current ^ 1][y][x] = WALL_LEAF;
+					continue;
+				}
+				unsigned int alive = (from[y - 1][x] == ALIVE_LEAF) + (from[y + 1][x] == ALIVE_LEAF)
+					+ (from[y][x - 1] == ALIVE_LEAF) + (from[y][x + 1] == ALIVE_LEAF);
+				if (!life->isVonNeumann) {
+					alive += (from[y - 1][x - 1] == ALIVE_LEAF) + (from[y - 1][x + 1] == ALIVE_LEAF)
+						+ (from[y + 1][x - 1] == ALIVE_LEAF) + (from[y + 1][x + 1] == ALIVE_LEAF);
+				}
+				const uint32_t rule = from[y][x] == ALIVE_LEAF ? life->survival : life->birth;
+				cells[current ^ 1][y][x] = (rule >> alive) & 1 ? ALIVE_LEAF : DEAD_LEAF;
+			}
+		}
+		current ^= 1;
+	}
+	return _buildLeaves(life, cells[current], side / 4, side / 4, node->level - 1);
+}
+
+static void _store(Engine * engine, Grid * grid) {
+	HashLife * life = engine->data;
+	int64_t origin = 0;
+	if (life->frontier == OPEN) {
+		origin = INT64_C(1) << (life->root->level - 2);
+	}
+	_extract(life, life->root, -origin, -origin, grid);
+}
+
+/**
+ * Frees the nodes that weren't marked by the last collection, and forgets
+ * the results that were freed.
+ */
+static void _sweep(HashLife * life) {
+	for (size_t k = 0; k < life->bucketCount; ++k) {
+		HashLifeNode ** link = &life->buckets[k];
+		while (*link != NULL) {
+			HashLifeNode * node = *link;
+			if (node->mark == life->collections) {
+				link = &node->next;
+			}
+			else {
+				*link = node->next;
+				node->next = life->free;
+				node->mark = 0;
+				life->free = node;
+				--life->nodes;
+			}
+		}
+	}
+	for (size_t k = 0; k < life->bucketCount; ++k) {
+		for (HashLifeNode * node = life->buckets[k]; node != NULL; node = node->next) {
+			if (node->result != NULL && node->result->mark != life->collections) {
+				node->result = NULL;
+			}
+		}
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+boolean isHashLifeable(const Automaton * automaton) {
+	const boolean isSquare = automaton->width == automaton->height && (automaton->width & (automaton->width - 1)) == 0;
+	return isBitPackable(automaton)
+		&& (automaton->frontier == OPEN || (automaton->frontier == PERIODIC && isSquare));
+}
+
+Engine * createHashLifeEngine(const Automaton * automaton) {
+	HashLife * life = calloc(1, sizeof(HashLife));
+	life->width = automaton->width;
+	life->height = automaton->height;
+	life->frontier = automaton->frontier;
+	life->isVonNeumann = automaton->neighborhood == VON_NEUMANN;
+	for (unsigned int count = 0; count < automaton->ruleSize && count < 32; ++count) {
+		life->survival |= (uint32_t) automaton->survives[count] << count;
+		life->birth |= (uint32_t) automaton->born[count] << count;
+	}
+	const int megabytes = getIntegerOrDefault("HASHLIFE_MEMORY_LIMIT", DEFAULT_HASHLIFE_MEMORY_LIMIT);
+	life->limit = ((size_t) (megabytes < 1 ? 1 : megabytes) << 20) / (sizeof(HashLifeNode) + sizeof(HashLifeNode *));
+	life->threshold = life->limit;
+	life->collections = 1;
+	life->bucketCount = HASHLIFE_INITIAL_BUCKETS;
+	life->buckets = calloc(life->bucketCount, sizeof(HashLifeNode *));
+	for (unsigned int state = DEAD_LEAF; state <= WALL_LEAF; ++state) {
+		life->leaves[state].state = (uint8_t) state;
+	}
+	life->walls[0] = &life->leaves[WALL_LEAF];
+	for (unsigned int level = 1; level < HASHLIFE_LEVELS; ++level) {
+		HashLifeNode * wall = life->walls[level - 1];
+		life->walls[level] = _findNode(life, wall, wall, wall, wall);
+	}
+	logDebugging(_logger, "Caching up to %zu nodes.", life->limit);
+	Engine * engine = calloc(1, sizeof(Engine));
+	engine->name = "hashlife";
+	engine->automaton = automaton;
+	engine->data = life;
+	engine->tiles = NULL;
+	engine->load = _load;
+	engine->advance = _advance;
+	engine->store = _store;
+	engine->destroy = _destroy;
+	return engine;
+}
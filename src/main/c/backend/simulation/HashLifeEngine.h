@@ -0,0 +1,51 @@
+#ifndef HASH_LIFE_ENGINE_HEADER
+#define HASH_LIFE_ENGINE_HEADER
+
+#include "../../shared/Environment.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "Automaton.h"
+#include "BitPackedEngine.h"
+#include "Engine.h"
+#include "Grid.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeHashLifeEngineModule();
+
+/** Shutdown module's internal state. */
+void shutdownHashLifeEngineModule();
+
+/**
+ * The default memory of the node cache (in MiB), overridable with the
+ * "HASHLIFE_MEMORY_LIMIT" environment variable.
+ */
+#define DEFAULT_HASHLIFE_MEMORY_LIMIT 1024
+
+/**
+ * The amount of generations from which the "auto" engine prefers HashLife
+ * over the bit-packed engine.
+ */
+#define HASHLIFE_MINIMUM_GENERATIONS (UINT64_C(1) << 20)
+
+/**
+ * Whether an automaton can run on the HashLife engine: a bit-packable one
+ * (see "isBitPackable") with an open frontier, or a periodic one on a square
+ * grid whose side is a power of two.
+ */
+boolean isHashLifeable(const Automaton * automaton);
+
+/**
+ * Creates an engine that keeps the grid in a quadtree of hash-consed nodes
+ * (i.e., identical squares are the same node, anywhere and at any time), and
+ * memoizes the center of every node after a power of two of generations. A
+ * pattern that repeats itself in space or time is computed once, so an
+ * amount of generations is advanced in time logarithmic to it. The nodes
+ * that aren't reachable from the grid are collected when the cache reaches
+ * its memory limit (see DEFAULT_HASHLIFE_MEMORY_LIMIT).
+ */
+Engine * createHashLifeEngine(const Automaton * automaton);
+
+#endif
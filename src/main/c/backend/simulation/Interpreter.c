@@ -0,0 +1,515 @@
+#include "Interpreter.h"
+
+/* PRIVATE FUNCTIONS */
+
+static void _addNeighbor(Interpreter * interpreter, const Offset offset);
+static boolean _advanceLoop(Interpreter * interpreter, InterpreterBlock * block, const boolean isFirst);
+static int _compareOffsets(const void * offset, const void * otherOffset);
+static int _evaluate(Interpreter * interpreter, ArithmeticExpression * expression);
+static int _evaluateConstant(Interpreter * interpreter, Constant * constant);
+static unsigned int _countStates(Interpreter * interpreter, CellList * cellList, const int state);
+static boolean _executeNeighborhood(Interpreter * interpreter, NeighborhoodSequence * sequence);
+static boolean _executeTransition(Interpreter * interpreter, TransitionSequence * sequence);
+static Offset _offset(Interpreter * interpreter, Cell * cell);
+static int _probeAnyCell(void * context, const Offset offset);
+static void _pushBlock(Interpreter * interpreter, void * sequence, Range * range, const unsigned int variable);
+static void _pushFrame(Interpreter * interpreter, ArithmeticExpression * expression);
+static void _pushValue(Interpreter * interpreter, const int value);
+static int _read(Interpreter * interpreter, const Offset offset);
+static void _removeNeighbor(Interpreter * interpreter, const Offset offset);
+static void _reset(Interpreter * interpreter, const Grid * grid, const int x, const int y);
+
+/**
+ * Adds a neighbor, unless it's already in the neighborhood.
+ */
+static void _addNeighbor(Interpreter * interpreter, const Offset offset) {
+	for (unsigned int k = 0; k < interpreter->neighborCount; ++k) {
+		if (interpreter->neighbors[k].x == offset.x && interpreter->neighbors[k].y == offset.y) {
+			return;
+		}
+	}
+	if (interpreter->neighborCount == interpreter->neighborCapacity) {
+		interpreter->neighborCapacity = interpreter->neighborCapacity == 0 ? 16 : 2 * interpreter->neighborCapacity;
+		interpreter->neighbors = realloc(interpreter->neighbors, interpreter->neighborCapacity * sizeof(Offset));
+	}
+	interpreter->neighbors[interpreter->neighborCount++] = offset;
+}
+
+/**
+ * Moves a loop to its first (or next) iteration, and assigns its variable.
+ * Returns false if there's none.
+ */
+static boolean _advanceLoop(Interpreter * interpreter, InterpreterBlock * block, const boolean isFirst) {
+	if (block->range->type == ARRAY) {
+		ConstantArray * array = block->range->array;
+		if (++block->iteration == (int) array->count) {
+			return false;
+		}
+		interpreter->variables[block->variable] = _evaluateConstant(interpreter, array->values[block->iteration]);
+		return true;
+	}
+	if (isFirst) {
+		block->iteration = _evaluateConstant(interpreter, block->range->start);
+		block->end = _evaluateConstant(interpreter, block->range->end);
+	}
+	else if (block->iteration == block->end) {
+		return false;
+	}
+	else {
+		block->iteration += block->iteration < block->end ? 1 : -1;
+	}
+	interpreter->variables[block->variable] = block->iteration;
+	return true;
+}
+
+/**
+ * Evaluates an expression on the current cell, in post-order with an
+ * explicit stack. The logical operators short-circuit (so the cells of
+ * their second operand are only read if it decides).
+ */
+static int _evaluate(Interpreter * interpreter, ArithmeticExpression * expression) {
+	const unsigned int base = interpreter->frameCount;
+	_pushFrame(interpreter, expression);
+	while (base < interpreter->frameCount) {
+		InterpreterFrame * frame = &interpreter->frames[interpreter->frameCount - 1];
+		ArithmeticExpression * node = frame->expression;
+		// The value of the last evaluated operand (if any).
+		int * top = interpreter->valueCount == 0 ? NULL : &interpreter->values[interpreter->valueCount - 1];
+		switch (node->type) {
+			case LOGIC_NOT:
+			case FACTOR:
+				if (frame->operands++ == 0) {
+					_pushFrame(interpreter, node->expression);
+					continue;
+				}
+				if (node->type == LOGIC_NOT) {
+					*top = !*top;
+				}
+				break;
+			case ALL_ARE:
+				_pushValue(interpreter, _countStates(interpreter, node->cellList, interpreter->automaton->symbolStates[node->state]) == node->cellList->count);
+				break;
+			case ANY_ARE:
+			case AT_LEAST_ARE:
+				_pushValue(interpreter, (int) _countStates(interpreter, node->cellList, interpreter->automaton->symbolStates[node->state]) >= node->count);
+				break;
+			case CONSTANT:
+				_pushValue(interpreter, _evaluateConstant(interpreter, node->constant));
+				break;
+			case LOGIC_AND:
+			case LOGIC_OR:
+				if (frame->operands == 0) {
+					frame->operands = 1;
+					_pushFrame(interpreter, node->leftExpression);
+					continue;
+				}
+				if (frame->operands == 1) {
+					// The left operand decides, unless it's true (false) for an
+					// "and" ("or"). Otherwise, the right one replaces it.
+					const boolean isDecided = node->type == LOGIC_AND ? !*top : *top;
+					if (!isDecided) {
+						frame->operands = 2;
+						--interpreter->valueCount;
+						_pushFrame(interpreter, node->rightExpression);
+						continue;
+					}
+				}
+				*top = *top != 0;
+				break;
+			default:
+				if (frame->operands < 2) {
+					_pushFrame(interpreter, frame->operands++ == 0 ? node->leftExpression : node->rightExpression);
+					continue;
+				}
+				const int right = *top;
+				const int left = *--top;
+				--interpreter->valueCount;
+				switch (node->type) {
+					case ADDITION:
+						*top = left + right;
+						break;
+					case SUBTRACTION:
+						*top = left - right;
+						break;
+					case MULTIPLICATION:
+						*top = left * right;
+						break;
+					case DIVISION:
+						*top = right == 0 ? 0 : left / right;
+						break;
+					case MODULE:
+						*top = right == 0 ? 0 : left % right;
+						break;
+					case EQUALS:
+						*top = left == right;
+						break;
+					case NOT_EQUALS:
+						*top = left != right;
+						break;
+					case LOWER_THAN:
+						*top = left < right;
+						break;
+					case LOWER_THAN_OR_EQUAL:
+						*top = left <= right;
+						break;
+					case GREATER_THAN:
+						*top = left > right;
+						break;
+					case GREATER_THAN_OR_EQUAL:
+						*top = left >= right;
+						break;
+					default:
+						*top = 0;
+						break;
+				}
+				break;
+		}
+		--interpreter->frameCount;
+	}
+	return interpreter->values[--interpreter->valueCount];
+}
+
+/**
+ * Evaluates a constant: an integer, a state (i.e., its index), a variable
+ * or a cell (i.e., its state).
+ */
+static int _evaluateConstant(Interpreter * interpreter, Constant * constant) {
+	switch (constant->type) {
+		case INTEGER_C:
+			return constant->value;
+		case STRING_C: {
+			const int state = interpreter->automaton->symbolStates[constant->symbol];
+			return state == NO_STATE ? interpreter->variables[constant->symbol] : state;
+		}
+		case CELL_C: {
+			return _read(interpreter, _offset(interpreter, constant->cell));
+		}
+		default:
+			return 0;
+	}
+}
+
+/**
+ * Orders the offsets in memory-access order (by row, and then by column).
+ */
+static int _compareOffsets(const void * offset, const void * otherOffset) {
+	const Offset * first = offset;
+	const Offset * second = otherOffset;
+	if (first->y != second->y) {
+		return first->y < second->y ? -1 : 1;
+	}
+	return first->x < second->x ? -1 : first->x > second->x;
+}
+
+/**
+ * Counts the cells of a list that are in the specified state.
+ */
+static unsigned int _countStates(Interpreter * interpreter, CellList * cellList, const int state) {
+	unsigned int count = 0;
+	for (unsigned int k = 0; k < cellList->count; ++k) {
+		if (_read(interpreter, _offset(interpreter, cellList->cells[k])) == state) {
+			++count;
+		}
+	}
+	return count;
+}
+
+/**
+ * Runs a sequence of a neighborhood program, with an explicit stack of the
+ * nested sequences. Neighborhood programs never return, so the result is
+ * always false.
+ */
+static boolean _executeNeighborhood(Interpreter * interpreter, NeighborhoodSequence * sequence) {
+	const unsigned int base = interpreter->blockCount;
+	_pushBlock(interpreter, sequence, NULL, 0);
+	while (base < interpreter->blockCount) {
+		InterpreterBlock * block = &interpreter->blocks[interpreter->blockCount - 1];
+		NeighborhoodSequence * current = block->sequence;
+		if (block->next == current->count) {
+			if (block->range == NULL || !_advanceLoop(interpreter, block, false)) {
+				--interpreter->blockCount;
+				continue;
+			}
+			block->next = 0;
+			if (current->count == 0) {
+				continue;
+			}
+		}
+		NeighborhoodExpression * expression = current->expressions[block->next++];
+		switch (expression->type) {
+			case NEIGHBORHOOD_ASSIGNMENT:
+				interpreter->variables[expression->variable] = _evaluate(interpreter, expression->assignment);
+				break;
+			case NEIGHBORHOOD_FOR_LOOP:
+				_pushBlock(interpreter, expression->forBody, expression->range, expression->forVariable);
+				if (!_advanceLoop(interpreter, &interpreter->blocks[interpreter->blockCount - 1], true)) {
+					--interpreter->blockCount;
+				}
+				break;
+			case NEIGHBORHOOD_IF:
+				if (_evaluate(interpreter, expression->ifCondition)) {
+					_pushBlock(interpreter, expression->ifBody, NULL, 0);
+				}
+				break;
+			case NEIGHBORHOOD_IF_ELSE:
+				_pushBlock(interpreter, _evaluate(interpreter, expression->ifElseCondition)
+					? expression->ifElseIfBody
+					: expression->ifElseElseBody, NULL, 0);
+				break;
+			case ADD_CELL_EXP:
+				for (unsigned int j = 0; j < expression->toAddList->count; ++j) {
+					_addNeighbor(interpreter, _offset(interpreter, expression->toAddList->cells[j]));
+				}
+				break;
+			case REMOVE_CELL_EXP:
+				for (unsigned int j = 0; j < expression->toRemoveList->count; ++j) {
+					_removeNeighbor(interpreter, _offset(interpreter, expression->toRemoveList->cells[j]));
+				}
+				break;
+		}
+	}
+	return false;
+}
+
+/**
+ * Runs a sequence of a transition program, with an explicit stack of the
+ * nested sequences. Returns true if the sequence returned a state (stored
+ * in the interpreter).
+ */
+static boolean _executeTransition(Interpreter * interpreter, TransitionSequence * sequence) {
+	const unsigned int base = interpreter->blockCount;
+	_pushBlock(interpreter, sequence, NULL, 0);
+	while (base < interpreter->blockCount) {
+		InterpreterBlock * block = &interpreter->blocks[interpreter->blockCount - 1];
+		TransitionSequence * current = block->sequence;
+		if (block->next == current->count) {
+			if (block->range == NULL || !_advanceLoop(interpreter, block, false)) {
+				--interpreter->blockCount;
+				continue;
+			}
+			block->next = 0;
+			if (current->count == 0) {
+				continue;
+			}
+		}
+		TransitionExpression * expression = current->expressions[block->next++];
+		switch (expression->type) {
+			case TRANSITION_ASSIGNMENT:
+				interpreter->variables[expression->variable] = _evaluate(interpreter, expression->assignment);
+				break;
+			case TRANSITION_FOR_LOOP:
+				_pushBlock(interpreter, expression->forBody, expression->range, expression->forVariable);
+				if (!_advanceLoop(interpreter, &interpreter->blocks[interpreter->blockCount - 1], true)) {
+					--interpreter->blockCount;
+				}
+				break;
+			case TRANSITION_IF:
+				if (_evaluate(interpreter, expression->ifCondition)) {
+					_pushBlock(interpreter, expression->ifBody, NULL, 0);
+				}
+				break;
+			case TRANSITION_IF_ELSE:
+				_pushBlock(interpreter, _evaluate(interpreter, expression->ifElseCondition)
+					? expression->ifElseIfBody
+					: expression->ifElseElseBody, NULL, 0);
+				break;
+			case RETURN_VALUE:
+				interpreter->result = _evaluate(interpreter, expression->returnValue);
+				interpreter->blockCount = base;
+				return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * The offset of a cell.
+ */
+static Offset _offset(Interpreter * interpreter, Cell * cell) {
+	Offset offset;
+	if (cell->isSingleCoordenate) {
+		const int displacement = _evaluateConstant(interpreter, cell->displacement);
+		switch (cell->displacementType) {
+			case HORIZONTAL_D:
+				offset = (Offset) {displacement, 0};
+				break;
+			case VERTICAL_D:
+				offset = (Offset) {0, displacement};
+				break;
+			case DIAGONAL_ASC_D:
+				offset = (Offset) {displacement, -displacement};
+				break;
+			case DIAGONAL_DESC_D:
+			default:
+				offset = (Offset) {displacement, displacement};
+		}
+	}
+	else {
+		offset.x = _evaluateConstant(interpreter, cell->x);
+		offset.y = _evaluateConstant(interpreter, cell->y);
+	}
+	return offset;
+}
+
+/**
+ * Marks that a program reads a cell, so it's not constant (see
+ * "foldNeighborhood").
+ */
+static int _probeAnyCell(void * context, const Offset offset) {
+	boolean * isReading = context;
+	*isReading = true;
+	return 0;
+}
+
+/**
+ * Pushes a sequence onto the stack of the ones being run: the body of a
+ * loop (over a range, with a variable), or not (if the range is NULL).
+ */
+static void _pushBlock(Interpreter * interpreter, void * sequence, Range * range, const unsigned int variable) {
+	if (interpreter->blockCount == interpreter->blockCapacity) {
+		interpreter->blockCapacity = interpreter->blockCapacity == 0 ? 16 : 2 * interpreter->blockCapacity;
+		interpreter->blocks = realloc(interpreter->blocks, interpreter->blockCapacity * sizeof(InterpreterBlock));
+	}
+	interpreter->blocks[interpreter->blockCount++] = (InterpreterBlock) {
+		.sequence = sequence,
+		.next = 0,
+		.range = range,
+		.variable = variable,
+		.iteration = -1,
+		.end = 0
+	};
+}
+
+/**
+ * Pushes an expression onto the stack of the ones being evaluated.
+ */
+static void _pushFrame(Interpreter * interpreter, ArithmeticExpression * expression) {
+	if (interpreter->frameCount == interpreter->frameCapacity) {
+		interpreter->frameCapacity = interpreter->frameCapacity == 0 ? 64 : 2 * interpreter->frameCapacity;
+		interpreter->frames = realloc(interpreter->frames, interpreter->frameCapacity * sizeof(InterpreterFrame));
+	}
+	interpreter->frames[interpreter->frameCount++] = (InterpreterFrame) {
+		.expression = expression,
+		.operands = 0
+	};
+}
+
+/**
+ * Pushes a value onto the stack of the values of the evaluated expressions.
+ */
+static void _pushValue(Interpreter * interpreter, const int value) {
+	if (interpreter->valueCount == interpreter->valueCapacity) {
+		interpreter->valueCapacity = interpreter->valueCapacity == 0 ? 64 : 2 * interpreter->valueCapacity;
+		interpreter->values = realloc(interpreter->values, interpreter->valueCapacity * sizeof(int));
+	}
+	interpreter->values[interpreter->valueCount++] = value;
+}
+
+/**
+ * Reads the state of the cell at an offset of the current one, from the
+ * probe (if any), or from the grid.
+ */
+static int _read(Interpreter * interpreter, const Offset offset) {
+	if (interpreter->probe != NULL) {
+		return interpreter->probe(interpreter->probeContext, offset);
+	}
+	return readCell(interpreter->automaton, interpreter->grid, interpreter->x + offset.x, interpreter->y + offset.y);
+}
+
+/**
+ * Removes a neighbor, if it's in the neighborhood (keeping the order of the
+ * rest).
+ */
+static void _removeNeighbor(Interpreter * interpreter, const Offset offset) {
+	for (unsigned int k = 0; k < interpreter->neighborCount; ++k) {
+		if (interpreter->neighbors[k].x == offset.x && interpreter->neighbors[k].y == offset.y) {
+			memmove(&interpreter->neighbors[k], &interpreter->neighbors[k + 1], (interpreter->neighborCount - k - 1) * sizeof(Offset));
+			--interpreter->neighborCount;
+			return;
+		}
+	}
+}
+
+/**
+ * Moves the interpreter to a new cell, and clears its variables.
+ */
+static void _reset(Interpreter * interpreter, const Grid * grid, const int x, const int y) {
+	interpreter->grid = grid;
+	interpreter->x = x;
+	interpreter->y = y;
+	interpreter->result = OUTSIDE_STATE;
+	memset(interpreter->variables, 0, (1 + interpreter->automaton->symbols) * sizeof(int));
+}
+
+/* PUBLIC FUNCTIONS */
+
+Interpreter * createInterpreter(const Automaton * automaton) {
+	Interpreter * interpreter = calloc(1, sizeof(Interpreter));
+	interpreter->automaton = automaton;
+	interpreter->variables = calloc(1 + automaton->symbols, sizeof(int));
+	return interpreter;
+}
+
+void destroyInterpreter(Interpreter * interpreter) {
+	if (interpreter != NULL) {
+		free(interpreter->variables);
+		free(interpreter->neighbors);
+		free(interpreter->frames);
+		free(interpreter->values);
+		free(interpreter->blocks);
+		free(interpreter);
+	}
+}
+
+boolean foldNeighborhood(Automaton * automaton) {
+	if (automaton->neighborhoodProgram == NULL) {
+		return false;
+	}
+	boolean isReading = false;
+	Interpreter * interpreter = createInterpreter(automaton);
+	interpreter->probe = _probeAnyCell;
+	interpreter->probeContext = &isReading;
+	const unsigned int count = interpretNeighborhood(interpreter, NULL, 0, 0);
+	if (!isReading) {
+		free(automaton->neighbors);
+		automaton->neighbors = calloc(count + 1, sizeof(Offset));
+		memcpy(automaton->neighbors, interpreter->neighbors, count * sizeof(Offset));
+		qsort(automaton->neighbors, count, sizeof(Offset), _compareOffsets);
+		automaton->neighborCount = count;
+		automaton->neighborhoodProgram = NULL;
+	}
+	destroyInterpreter(interpreter);
+	return !isReading;
+}
+
+int interpretExpression(Interpreter * interpreter, const Grid * grid, const int x, const int y, ArithmeticExpression * expression) {
+	_reset(interpreter, grid, x, y);
+	return _evaluate(interpreter, expression);
+}
+
+unsigned int interpretNeighborhood(Interpreter * interpreter, const Grid * grid, const int x, const int y) {
+	_reset(interpreter, grid, x, y);
+	interpreter->neighborCount = 0;
+	_executeNeighborhood(interpreter, interpreter->automaton->neighborhoodProgram);
+	return interpreter->neighborCount;
+}
+
+uint8_t interpretTransition(Interpreter * interpreter, const Grid * grid, const int x, const int y) {
+	_reset(interpreter, grid, x, y);
+	const uint8_t state = (uint8_t) _read(interpreter, (Offset) {0, 0});
+	if (_executeTransition(interpreter, interpreter->automaton->transitionProgram)) {
+		if (0 <= interpreter->result && interpreter->result < (int) interpreter->automaton->states) {
+			return (uint8_t) interpreter->result;
+		}
+	}
+	return state;
+}
+
+int readCell(const Automaton * automaton, const Grid * grid, const int x, const int y) {
+	const int column = resolveCoordinate(automaton->frontier, x, grid->width);
+	const int row = resolveCoordinate(automaton->frontier, y, grid->height);
+	if (column < 0 || row < 0) {
+		return OUTSIDE_STATE;
+	}
+	return grid->cells[(size_t) row * grid->width + column];
+}
@@ -0,0 +1,131 @@
+#ifndef INTERPRETER_HEADER
+#define INTERPRETER_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Type.h"
+#include "Automaton.h"
+#include "Grid.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * An expression being evaluated, and the amount of its operands already
+ * evaluated (their values are on the stack of values).
+ */
+typedef struct {
+	ArithmeticExpression * expression;
+	unsigned int operands;
+} InterpreterFrame;
+
+/**
+ * A sequence being run, and the next statement to run. If it's the body of
+ * a loop, the range of the loop, its variable, and the current iteration:
+ * the index in the array, or the value (and the last one, evaluated once).
+ */
+typedef struct {
+	void * sequence;
+	unsigned int next;
+	Range * range;
+	unsigned int variable;
+	int iteration;
+	int end;
+} InterpreterBlock;
+
+/**
+ * A tree-walking interpreter of the programs of an automaton, evaluated on a
+ * single cell at a time. It defines the reference semantics of the language:
+ *
+ *	- A cell "(x, y)" is the state of the cell at that offset (or -1, if
+ *	  it's outside an open grid), and "hor(d)", "vert(d)", "diag_asc(d)" and
+ *	  "diag_dec(d)" are the offsets (d, 0), (0, d), (d, -d) and (d, d).
+ *	- A state is its index, and a variable starts at zero for every cell.
+ *	- Relational and logical operators return 0 or 1, and a division (or
+ *	  modulo) by zero returns 0.
+ *	- Ranges "[a, b]" are inclusive, in both directions.
+ *	- A transition returns the state of its first "->". If nothing is
+ *	  returned (or the state doesn't exist), the cell keeps its state.
+ *
+ * The expressions and the sequences are walked with explicit stacks (owned by
+ * the interpreter), so a deep program (e.g., a long left-associative sum)
+ * never overflows the call stack. An interpreter is not thread-safe (i.e.,
+ * use one per thread).
+ */
+typedef struct {
+	const Automaton * automaton;
+	const Grid * grid;
+	int x;
+	int y;
+
+	// The value of every variable, by symbol.
+	int * variables;
+
+	// The neighborhood built by a neighborhood program.
+	Offset * neighbors;
+	unsigned int neighborCount;
+	unsigned int neighborCapacity;
+
+	// The state returned by a transition.
+	int result;
+
+	// If not NULL, the cells are read from this function instead of the grid
+	// (e.g., to evaluate a program on every possible neighborhood).
+	int (* probe)(void * context, const Offset offset);
+	void * probeContext;
+
+	// The stacks of the expressions being evaluated, their values, and the
+	// sequences being run.
+	InterpreterFrame * frames;
+	unsigned int frameCount;
+	unsigned int frameCapacity;
+	int * values;
+	unsigned int valueCount;
+	unsigned int valueCapacity;
+	InterpreterBlock * blocks;
+	unsigned int blockCount;
+	unsigned int blockCapacity;
+} Interpreter;
+
+/**
+ * Creates an interpreter for the programs of an automaton.
+ */
+Interpreter * createInterpreter(const Automaton * automaton);
+
+/**
+ * Destroys an interpreter.
+ */
+void destroyInterpreter(Interpreter * interpreter);
+
+/**
+ * Runs the neighborhood program of an automaton once, at compile time. If
+ * it never reads a cell (i.e., its loops and conditions only depend on
+ * constants), the neighborhood is the same for every cell, so it replaces
+ * the program with its offsets, deduplicated and in memory-access order
+ * (by row, and then by column). Returns whether it was folded.
+ */
+boolean foldNeighborhood(Automaton * automaton);
+
+/**
+ * Evaluates an expression on the cell at (x, y) of a grid.
+ */
+int interpretExpression(Interpreter * interpreter, const Grid * grid, const int x, const int y, ArithmeticExpression * expression);
+
+/**
+ * Runs the neighborhood program on the cell at (x, y) of a grid, and returns
+ * the amount of neighbors it adds (stored in the interpreter, without
+ * duplicates, in order of addition).
+ */
+unsigned int interpretNeighborhood(Interpreter * interpreter, const Grid * grid, const int x, const int y);
+
+/**
+ * Runs the transition program on the cell at (x, y) of a grid, and returns
+ * the next state of the cell.
+ */
+uint8_t interpretTransition(Interpreter * interpreter, const Grid * grid, const int x, const int y);
+
+/**
+ * Reads the state of the cell at (x, y) of a grid, resolving the frontier
+ * of the automaton. Returns OUTSIDE_STATE if it's outside an open grid.
+ */
+int readCell(const Automaton * automaton, const Grid * grid, const int x, const int y);
+
+#endif
@@ -0,0 +1,517 @@
+#include "LookupEngine.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeLookupEngineModule() {
+	_logger = createLogger("LookupEngine");
+}
+
+void shutdownLookupEngineModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/**
+ * The neighborhood on which a program is evaluated while building a table:
+ * the value of every known cell. A cell read by the program that is not
+ * known yet is appended (with the first value), and marked as missing.
+ */
+typedef struct {
+	Offset * offsets;
+	int * values;
+	unsigned int count;
+	unsigned int capacity;
+	boolean isMissing;
+} Probe;
+
+/**
+ * The cells counted by a symmetric program, collected while checking it.
+ */
+typedef struct {
+	const Automaton * automaton;
+	Offset * neighbors;
+	unsigned int count;
+	boolean hasNeighbors;
+} Symmetry;
+
+/**
+ * The state of a lookup engine: the current generation, the buffer of the
+ * next one (both padded with a halo as wide as the cells of the table), and
+ * the linear displacement of every cell of the table. Every worker counts the
+ * values of a totalistic neighborhood in its own row of "counts" (padded to
+ * a cache line, so the workers never write to the same one). The table
+ * reads the same cells for every neighborhood, so the quiescent tiles are
+ * always skipped (if the tracking is enabled).
+ */
+typedef struct {
+	const Automaton * automaton;
+	LookupTable * table;
+	Bands * bands;
+	ActiveTiles * tiles;
+	PaddedGrid * current;
+	PaddedGrid * next;
+	ptrdiff_t * displacements;
+	size_t * weights;
+	unsigned int * counts;
+	unsigned int countStride;
+	Offset minimum;
+	Offset maximum;
+} LookupEngine;
+
+/* PRIVATE FUNCTIONS */
+
+static void _addProbeOffset(Probe * probe, const Offset offset);
+static void _advance(Engine * engine, const uint64_t generations);
+static boolean _buildExact(LookupTable * table, Interpreter * interpreter, Probe * probe, const size_t limit);
+static boolean _buildTotalistic(LookupTable * table, Interpreter * interpreter, Probe * probe, const size_t limit);
+static boolean _checkConstant(Symmetry * symmetry, Constant * constant);
+static boolean _checkExpression(Symmetry * symmetry, ArithmeticExpression * expression);
+static boolean _checkNeighbors(Symmetry * symmetry, CellList * cellList);
+static boolean _checkSequence(Symmetry * symmetry, TransitionSequence * sequence);
+static void _destroy(Engine * engine);
+static size_t _index(const LookupEngine * lookup, unsigned int * counts, const uint8_t * cell);
+static void _load(Engine * engine, const Grid * grid);
+static int _probeCell(void * context, const Offset offset);
+static void _stepBand(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow);
+static boolean _stepTile(void * context, const unsigned int worker,
+	const unsigned int firstColumn, const unsigned int lastColumn, const unsigned int firstRow, const unsigned int lastRow);
+static void _store(Engine * engine, Grid * grid);
+
+/**
+ * Appends a cell to a probe, with the first value.
+ */
+static void _addProbeOffset(Probe * probe, const Offset offset) {
+	if (probe->count == probe->capacity) {
+		probe->capacity = probe->capacity == 0 ? 16 : 2 * probe->capacity;
+		probe->offsets = realloc(probe->offsets, probe->capacity * sizeof(Offset));
+		probe->values = realloc(probe->values, probe->capacity * sizeof(int));
+	}
+	probe->offsets[probe->count] = offset;
+	probe->values[probe->count] = 0;
+	++probe->count;
+}
+
+static void _advance(Engine * engine, const uint64_t generations) {
+	LookupEngine * lookup = engine->data;
+	for (uint64_t generation = 0; generation < generations; ++generation) {
+		if (lookup->tiles != NULL) {
+			prepareActiveTiles(lookup->tiles);
+		}
+		fillHalo(lookup->bands, lookup->current);
+		runBands(lookup->bands, _stepBand, lookup);
+		PaddedGrid * swap = lookup->current;
+		lookup->current = lookup->next;
+		lookup->next = swap;
+	}
+}
+
+/**
+ * Evaluates the program on every possible value of the cells it reads. If
+ * a new cell is read, the evaluation starts over with that cell too, until
+ * every cell is known (or the table is too big).
+ */
+static boolean _buildExact(LookupTable * table, Interpreter * interpreter, Probe * probe, const size_t limit) {
+	probe->count = 0;
+	_addProbeOffset(probe, (Offset) {0, 0});
+	while (true) {
+		size_t size = 1;
+		for (unsigned int k = 0; k < probe->count; ++k) {
+			if (limit / table->base < size) {
+				return false;
+			}
+			size *= table->base;
+		}
+		table->entries = realloc(table->entries, size * sizeof(uint8_t));
+		probe->isMissing = false;
+		for (size_t index = 0; index < size && !probe->isMissing; ++index) {
+			size_t rest = index;
+			for (unsigned int k = 0; k < probe->count; ++k) {
+				probe->values[k] = (int) (rest % table->base) - (int) table->shift;
+				rest /= table->base;
+			}
+			table->entries[index] = interpretTransition(interpreter, NULL, 0, 0);
+		}
+		if (!probe->isMissing) {
+			table->type = EXACT_LOOKUP;
+			table->offsetCount = probe->count;
+			table->offsets = calloc(probe->count, sizeof(Offset));
+			memcpy(table->offsets, probe->offsets, probe->count * sizeof(Offset));
+			table->size = size;
+			return true;
+		}
+	}
+}
+
+/**
+ * Evaluates a symmetric program on every possible value of the cell itself,
+ * and every possible amount of neighbors of each value (the amount of the
+ * last value is implicit). The neighbors are assigned in order, so the
+ * first ones have the first value, and so on.
+ */
+static boolean _buildTotalistic(LookupTable * table, Interpreter * interpreter, Probe * probe, const size_t limit) {
+	const unsigned int neighbors = table->offsetCount;
+	size_t size = table->base;
+	for (unsigned int k = 0; k + 1 < table->base; ++k) {
+		if (limit / (neighbors + 1) < size) {
+			return false;
+		}
+		size *= neighbors + 1;
+	}
+	probe->count = 0;
+	_addProbeOffset(probe, (Offset) {0, 0});
+	for (unsigned int k = 0; k < neighbors; ++k) {
+		_addProbeOffset(probe, table->offsets[k]);
+	}
+	table->entries = realloc(table->entries, size * sizeof(uint8_t));
+	probe->isMissing = false;
+	for (size_t index = 0; index < size; ++index) {
+		probe->values[0] = (int) (index % table->base) - (int) table->shift;
+		size_t rest = index / table->base;
+		unsigned int position = 1;
+		boolean isPossible = true;
+		for (unsigned int value = 0; value + 1 < table->base && isPossible; ++value) {
+			const unsigned int count = rest % (neighbors + 1);
+			rest /= neighbors + 1;
+			isPossible = position + count <= neighbors + 1;
+			for (unsigned int j = 0; j < count && isPossible; ++j) {
+				probe->values[position++] = (int) value - (int) table->shift;
+			}
+		}
+		if (!isPossible) {
+			// There are more neighbors than cells, so it's never looked up.
+			table->entries[index] = 0;
+			continue;
+		}
+		while (position <= neighbors) {
+			probe->values[position++] = (int) (table->base - 1) - (int) table->shift;
+		}
+		table->entries[index] = interpretTransition(interpreter, NULL, 0, 0);
+		if (probe->isMissing) {
+			return false;
+		}
+	}
+	table->type = TOTALISTIC_LOOKUP;
+	table->size = size;
+	return true;
+}
+
+/**
+ * A constant of a symmetric program can only read the cell itself.
+ */
+static boolean _checkConstant(Symmetry * symmetry, Constant * constant) {
+	if (constant->type != CELL_C) {
+		return true;
+	}
+	Offset offset;
+	return resolveStaticOffset(symmetry->automaton, constant->cell, &offset) && offset.x == 0 && offset.y == 0;
+}
+
+/**
+ * Checks every constant and list of cells of an expression, from left to
+ * right with a work stack (so it can nest arbitrarily deep).
+ */
+static boolean _checkExpression(Symmetry * symmetry, ArithmeticExpression * expression) {
+	unsigned int capacity = 64;
+	unsigned int count = 0;
+	ArithmeticExpression ** pending = calloc(capacity, sizeof(ArithmeticExpression *));
+	boolean isSymmetric = true;
+	pending[count++] = expression;
+	while (isSymmetric && 0 < count) {
+		expression = pending[--count];
+		if (capacity < count + 2) {
+			capacity *= 2;
+			pending = realloc(pending, capacity * sizeof(ArithmeticExpression *));
+		}
+		switch (expression->type) {
+			case LOGIC_NOT:
+			case FACTOR:
+				pending[count++] = expression->expression;
+				break;
+			case ALL_ARE:
+			case ANY_ARE:
+			case AT_LEAST_ARE:
+				isSymmetric = _checkNeighbors(symmetry, expression->cellList);
+				break;
+			case CONSTANT:
+				isSymmetric = _checkConstant(symmetry, expression->constant);
+				break;
+			default:
+				pending[count++] = expression->rightExpression;
+				pending[count++] = expression->leftExpression;
+				break;
+		}
+	}
+	free(pending);
+	return isSymmetric;
+}
+
+/**
+ * Every list of cells of a symmetric program has the same cells, without
+ * repetitions, and without the cell itself.
+ */
+static boolean _checkNeighbors(Symmetry * symmetry, CellList * cellList) {
+	Offset * offsets = calloc(cellList->count + 1, sizeof(Offset));
+	boolean isSymmetric = true;
+	for (unsigned int k = 0; k < cellList->count && isSymmetric; ++k) {
+		isSymmetric = resolveStaticOffset(symmetry->automaton, cellList->cells[k], &offsets[k])
+			&& (offsets[k].x != 0 || offsets[k].y != 0);
+		for (unsigned int j = 0; j < k && isSymmetric; ++j) {
+			isSymmetric = offsets[j].x != offsets[k].x || offsets[j].y != offsets[k].y;
+		}
+	}
+	if (isSymmetric && !symmetry->hasNeighbors) {
+		symmetry->hasNeighbors = true;
+		symmetry->neighbors = offsets;
+		symmetry->count = cellList->count;
+		return true;
+	}
+	isSymmetric = isSymmetric && symmetry->count == cellList->count;
+	for (unsigned int k = 0; k < cellList->count && isSymmetric; ++k) {
+		boolean isFound = false;
+		for (unsigned int j = 0; j < symmetry->count && !isFound; ++j) {
+			isFound = offsets[k].x == symmetry->neighbors[j].x && offsets[k].y == symmetry->neighbors[j].y;
+		}
+		isSymmetric = isFound;
+	}
+	free(offsets);
+	return isSymmetric;
+}
+
+static boolean _checkSequence(Symmetry * symmetry, TransitionSequence * sequence) {
+	for (unsigned int k = 0; k < sequence->count; ++k) {
+		TransitionExpression * expression = sequence->expressions[k];
+		boolean isSymmetric = true;
+		switch (expression->type) {
+			case TRANSITION_ASSIGNMENT:
+				isSymmetric = _checkExpression(symmetry, expression->assignment);
+				break;
+			case TRANSITION_FOR_LOOP:
+				if (expression->range->type == ARRAY) {
+					for (unsigned int j = 0; j < expression->range->array->count && isSymmetric; ++j) {
+						isSymmetric = _checkConstant(symmetry, expression->range->array->values[j]);
+					}
+				}
+				else {
+					isSymmetric = _checkConstant(symmetry, expression->range->start)
+						&& _checkConstant(symmetry, expression->range->end);
+				}
+				isSymmetric = isSymmetric && _checkSequence(symmetry, expression->forBody);
+				break;
+			case TRANSITION_IF:
+				isSymmetric = _checkExpression(symmetry, expression->ifCondition)
+					&& _checkSequence(symmetry, expression->ifBody);
+				break;
+			case TRANSITION_IF_ELSE:
+				isSymmetric = _checkExpression(symmetry, expression->ifElseCondition)
+					&& _checkSequence(symmetry, expression->ifElseIfBody)
+					&& _checkSequence(symmetry, expression->ifElseElseBody);
+				break;
+			case RETURN_VALUE:
+				isSymmetric = _checkExpression(symmetry, expression->returnValue);
+				break;
+		}
+		if (!isSymmetric) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void _destroy(Engine * engine) {
+	LookupEngine * lookup = engine->data;
+	destroyLookupTable(lookup->table);
+	destroyBands(lookup->bands);
+	destroyActiveTiles(lookup->tiles);
+	destroyPaddedGrid(lookup->current);
+	destroyPaddedGrid(lookup->next);
+	free(lookup->displacements);
+	free(lookup->weights);
+	free(lookup->counts);
+	free(lookup);
+	free(engine);
+}
+
+/**
+ * The index in the table of the neighborhood of a padded cell. On an open
+ * frontier, the shift (of one) wraps OUTSIDE_CELL around to zero, so the
+ * halo is read like any other cell.
+ */
+static size_t _index(const LookupEngine * lookup, unsigned int * counts, const uint8_t * cell) {
+	const LookupTable * table = lookup->table;
+	if (table->type == EXACT_LOOKUP) {
+		size_t index = 0;
+		for (unsigned int k = 0; k < table->offsetCount; ++k) {
+			const uint8_t value = (uint8_t) (cell[lookup->displacements[k]] + table->shift);
+			index += value * lookup->weights[k];
+		}
+		return index;
+	}
+	memset(counts, 0, table->base * sizeof(unsigned int));
+	for (unsigned int k = 0; k < table->offsetCount; ++k) {
+		++counts[(uint8_t) (cell[lookup->displacements[k]] + table->shift)];
+	}
+	size_t index = 0;
+	for (unsigned int value = table->base - 1; 0 < value; --value) {
+		index = index * (table->offsetCount + 1) + counts[value - 1];
+	}
+	return index * table->base + *cell + table->shift;
+}
+
+static void _load(Engine * engine, const Grid * grid) {
+	LookupEngine * lookup = engine->data;
+	loadPaddedGrid(lookup->bands, lookup->current, grid);
+	if (lookup->tiles != NULL) {
+		resetActiveTiles(lookup->tiles);
+	}
+}
+
+/**
+ * Reads a cell from the probe (see "Probe").
+ */
+static int _probeCell(void * context, const Offset offset) {
+	Probe * probe = context;
+	for (unsigned int k = 0; k < probe->count; ++k) {
+		if (probe->offsets[k].x == offset.x && probe->offsets[k].y == offset.y) {
+			return probe->values[k];
+		}
+	}
+	probe->isMissing = true;
+	_addProbeOffset(probe, offset);
+	return probe->values[probe->count - 1];
+}
+
+/**
+ * Computes the next generation of the rows of a band (only in the active
+ * tiles, if they are tracked).
+ */
+static void _stepBand(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow) {
+	LookupEngine * lookup = context;
+	if (lookup->tiles == NULL) {
+		_stepTile(lookup, worker, 0, lookup->current->width, firstRow, lastRow);
+	}
+	else {
+		runActiveTiles(lookup->tiles, _stepTile, lookup, worker, firstRow, lastRow);
+	}
+}
+
+/**
+ * Computes the next generation of a rectangle of cells.
+ */
+static boolean _stepTile(void * context, const unsigned int worker,
+		const unsigned int firstColumn, const unsigned int lastColumn, const unsigned int firstRow, const unsigned int lastRow) {
+	LookupEngine * lookup = context;
+	const size_t stride = lookup->current->stride;
+	const uint8_t * entries = lookup->table->entries;
+	unsigned int * counts = lookup->counts + (size_t) worker * lookup->countStride;
+	boolean changed = false;
+	for (unsigned int y = firstRow; y < lastRow; ++y) {
+		const uint8_t * cells = lookup->current->cells + y * stride;
+		uint8_t * output = lookup->next->cells + y * stride;
+		for (unsigned int x = firstColumn; x < lastColumn; ++x) {
+			output[x] = entries[_index(lookup, counts, cells + x)];
+			changed |= output[x] != cells[x];
+		}
+	}
+	return changed;
+}
+
+static void _store(Engine * engine, Grid * grid) {
+	LookupEngine * lookup = engine->data;
+	storePaddedGrid(lookup->bands, lookup->current, grid);
+}
+
+/* PUBLIC FUNCTIONS */
+
+LookupTable * createLookupTable(const Automaton * automaton) {
+	if (automaton->rule != TRANSITION_RULE) {
+		return NULL;
+	}
+	const int limit = getIntegerOrDefault("LOOKUP_TABLE_LIMIT", DEFAULT_LOOKUP_TABLE_LIMIT);
+	LookupTable * table = calloc(1, sizeof(LookupTable));
+	table->shift = automaton->frontier == OPEN ? 1 : 0;
+	table->base = automaton->states + table->shift;
+	Probe probe = {0};
+	Interpreter * interpreter = createInterpreter(automaton);
+	interpreter->probe = _probeCell;
+	interpreter->probeContext = &probe;
+	boolean isBuilt = _buildExact(table, interpreter, &probe, limit < 1 ? 1 : (size_t) limit);
+	if (!isBuilt) {
+		Symmetry symmetry = {
+			.automaton = automaton,
+			.neighbors = NULL,
+			.count = 0,
+			.hasNeighbors = false
+		};
+		if (_checkSequence(&symmetry, automaton->transitionProgram)) {
+			table->offsets = symmetry.neighbors;
+			table->offsetCount = symmetry.count;
+			symmetry.neighbors = NULL;
+			isBuilt = _buildTotalistic(table, interpreter, &probe, limit < 1 ? 1 : (size_t) limit);
+		}
+		free(symmetry.neighbors);
+	}
+	destroyInterpreter(interpreter);
+	free(probe.offsets);
+	free(probe.values);
+	if (!isBuilt) {
+		logDebugging(_logger, "The lookup table of the transition program has more than %d entries.", limit);
+		destroyLookupTable(table);
+		return NULL;
+	}
+	logDebugging(_logger, "Built %s lookup table of %zu entries, over %u cells.",
+		table->type == EXACT_LOOKUP ? "an exact" : "a totalistic", table->size, table->offsetCount);
+	return table;
+}
+
+void destroyLookupTable(LookupTable * table) {
+	if (table != NULL) {
+		free(table->offsets);
+		free(table->entries);
+		free(table);
+	}
+}
+
+Engine * createLookupEngine(const Automaton * automaton, LookupTable * table, const unsigned int threads) {
+	LookupEngine * lookup = calloc(1, sizeof(LookupEngine));
+	lookup->automaton = automaton;
+	lookup->table = table;
+	lookup->displacements = calloc(table->offsetCount + 1, sizeof(ptrdiff_t));
+	lookup->weights = calloc(table->offsetCount + 1, sizeof(size_t));
+	size_t weight = 1;
+	for (unsigned int k = 0; k < table->offsetCount; ++k) {
+		const Offset offset = table->offsets[k];
+		lookup->weights[k] = weight;
+		weight *= table->base;
+		lookup->minimum.x = offset.x < lookup->minimum.x ? offset.x : lookup->minimum.x;
+		lookup->minimum.y = offset.y < lookup->minimum.y ? offset.y : lookup->minimum.y;
+		lookup->maximum.x = lookup->maximum.x < offset.x ? offset.x : lookup->maximum.x;
+		lookup->maximum.y = lookup->maximum.y < offset.y ? offset.y : lookup->maximum.y;
+	}
+	const unsigned int halo = getHaloWidth(lookup->minimum, lookup->maximum);
+	lookup->current = createPaddedGrid(automaton, halo);
+	lookup->next = createPaddedGrid(automaton, halo);
+	for (unsigned int k = 0; k < table->offsetCount; ++k) {
+		lookup->displacements[k] = (ptrdiff_t) table->offsets[k].y * (ptrdiff_t) lookup->current->stride + table->offsets[k].x;
+	}
+	logDebugging(_logger, "Padded the grid with a halo of %u cells.", halo);
+	const unsigned int tileSize = getActiveTileSize();
+	if (0 < tileSize) {
+		lookup->tiles = createActiveTiles(automaton, tileSize, tileSize, lookup->minimum, lookup->maximum);
+	}
+	lookup->bands = createBands(automaton->height, lookup->tiles == NULL ? 1 : tileSize, threads);
+	lookup->countStride = (table->base + 15) & ~15u;
+	lookup->counts = calloc((size_t) lookup->bands->workers * lookup->countStride, sizeof(unsigned int));
+	Engine * engine = calloc(1, sizeof(Engine));
+	engine->name = "lookup";
+	engine->automaton = automaton;
+	engine->data = lookup;
+	engine->tiles = lookup->tiles;
+	engine->load = _load;
+	engine->advance = _advance;
+	engine->store = _store;
+	engine->destroy = _destroy;
+	return engine;
+}
@@ -0,0 +1,85 @@
+#ifndef LOOKUP_ENGINE_HEADER
+#define LOOKUP_ENGINE_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Environment.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "ActiveTiles.h"
+#include "Automaton.h"
+#include "Bands.h"
+#include "Engine.h"
+#include "Grid.h"
+#include "Interpreter.h"
+#include "PaddedGrid.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeLookupEngineModule();
+
+/** Shutdown module's internal state. */
+void shutdownLookupEngineModule();
+
+/**
+ * The default maximum amount of entries of a lookup table, overridable with
+ * the "LOOKUP_TABLE_LIMIT" environment variable.
+ */
+#define DEFAULT_LOOKUP_TABLE_LIMIT (1 << 20)
+
+typedef enum {
+	// Indexed by the value of every cell read by the program.
+	EXACT_LOOKUP,
+	// Indexed by the value of the cell itself, and the amount of neighbors
+	// with each value.
+	TOTALISTIC_LOOKUP
+} LookupType;
+
+/**
+ * The transition program of an automaton, evaluated on every possible
+ * neighborhood. The value of a cell is its state, plus one if the frontier
+ * is open (so the outside of the grid is the value zero).
+ */
+typedef struct {
+	LookupType type;
+
+	// An exact table reads these cells (the cell itself is the first one),
+	// and a totalistic one counts them (and the cell itself is not one of
+	// them).
+	Offset * offsets;
+	unsigned int offsetCount;
+
+	// The amount of values of a cell, and the value of the first state.
+	unsigned int base;
+	unsigned int shift;
+
+	// The next state of the cell, by neighborhood.
+	uint8_t * entries;
+	size_t size;
+} LookupTable;
+
+/**
+ * Builds the lookup table of a transition program. The cells read by the
+ * program are discovered while evaluating it, so the table is exact even if
+ * the offsets are computed. If the table is too big, but the program only
+ * reads the cell itself and counts the states of a fixed set of neighbors
+ * (i.e., it's symmetric), builds a totalistic table instead. Returns NULL if
+ * both tables are too big (or the automaton has no transition program).
+ */
+LookupTable * createLookupTable(const Automaton * automaton);
+
+/**
+ * Destroys a lookup table.
+ */
+void destroyLookupTable(LookupTable * table);
+
+/**
+ * Creates an engine that computes the next state of every cell with a
+ * single access to a lookup table (which is destroyed with the engine). The
+ * rows are split into bands, for the specified amount of threads (see
+ * "createBands").
+ */
+Engine * createLookupEngine(const Automaton * automaton, LookupTable * table, const unsigned int threads);
+
+#endif
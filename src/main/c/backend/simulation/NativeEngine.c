@@ -0,0 +1,277 @@
+#include "NativeEngine.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeNativeEngineModule() {
+	_logger = createLogger("NativeEngine");
+}
+
+void shutdownNativeEngineModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/**
+ * The state of a native engine: the loaded kernel, and the current
+ * generation and the buffer of the next one, padded with the halo of the
+ * kernel.
+ */
+typedef struct {
+	const Automaton * automaton;
+	void * library;
+	KernelStep step;
+	Bands * bands;
+	PaddedGrid * current;
+	PaddedGrid * next;
+} NativeEngine;
+
+/* PRIVATE FUNCTIONS */
+
+static void _advance(Engine * engine, const uint64_t generations);
+static char * _buildKernel(const Automaton * automaton, const char * directory, const char * key);
+static char * _createCacheDirectory(void);
+static void _destroy(Engine * engine);
+static uint64_t _hashString(uint64_t hash, const char * string);
+static boolean _isPrivate(const char * path, const boolean isDirectory);
+static void _load(Engine * engine, const Grid * grid);
+static void _stepBand(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow);
+static void _store(Engine * engine, Grid * grid);
+
+static void _advance(Engine * engine, const uint64_t generations) {
+	NativeEngine * native = engine->data;
+	if (native->automaton->rule == STATIC_RULE) {
+		return;
+	}
+	for (uint64_t generation = 0; generation < generations; ++generation) {
+		fillHalo(native->bands, native->current);
+		runBands(native->bands, _stepBand, native);
+		PaddedGrid * swap = native->current;
+		native->current = native->next;
+		native->next = swap;
+	}
+}
+
+#if !defined (_WIN32)
+
+/**
+ * Generates the kernel of an automaton, and builds it into the shared object
+ * of its key in the cache. Both files are written under unique names and
+ * then renamed, so concurrent builds of the same kernel (e.g., by parallel
+ * jobs) never see a partial file. Returns the path of the shared object
+ * (that must be freed), or NULL if it can't be built.
+ */
+static char * _buildKernel(const Automaton * automaton, const char * directory, const char * key) {
+	char * source = concatenate(5, directory, "/", key, "-XXXXXX", ".c");
+	char * temporary = concatenate(5, directory, "/", key, "-XXXXXX", ".so");
+	char * library = NULL;
+	int sourceDescriptor = mkstemps(source, 2);
+	int temporaryDescriptor = mkstemps(temporary, 3);
+	if (sourceDescriptor < 0 || temporaryDescriptor < 0) {
+		logError(_logger, "Cannot create the files of a kernel in the cache: \"%s\".", directory);
+	}
+	else if (generateKernel(automaton, source)) {
+		char * command = concatenate(8, getStringOrDefault("NATIVE_COMPILER", DEFAULT_NATIVE_COMPILER), " ",
+			getStringOrDefault("NATIVE_FLAGS", DEFAULT_NATIVE_FLAGS), " -fPIC -shared -o \"", temporary, "\" \"", source, "\"");
+		logDebugging(_logger, "Building a kernel: %s", command);
+		// The compiler can recreate the output, with the permissions of the
+		// umask (which may let the group write it).
+		if (system(command) == 0 && chmod(temporary, 0700) == 0) {
+			char * name = concatenate(4, directory, "/", key, ".c");
+			library = concatenate(4, directory, "/", key, ".so");
+			if (rename(source, name) != 0 || rename(temporary, library) != 0) {
+				logError(_logger, "Cannot move the kernel into the cache: \"%s\".", library);
+				free(library);
+				library = NULL;
+			}
+			free(name);
+		}
+		else {
+			logError(_logger, "The C compiler can't build the kernel: %s", command);
+		}
+		free(command);
+	}
+	if (0 <= sourceDescriptor) {
+		close(sourceDescriptor);
+		remove(source);
+	}
+	if (0 <= temporaryDescriptor) {
+		close(temporaryDescriptor);
+		remove(temporary);
+	}
+	free(source);
+	free(temporary);
+	return library;
+}
+
+/**
+ * Creates the cache of kernels (and the cache of the user, if it's the
+ * default one), only accessible by the user, unless it exists. Returns its
+ * path (that must be freed), or NULL if it can't be created or trusted.
+ */
+static char * _createCacheDirectory(void) {
+	const char * override = getStringOrDefault("NATIVE_CACHE_DIRECTORY", NULL);
+	char * directory = NULL;
+	if (override != NULL && override[0] != '\0') {
+		directory = concatenate(1, override);
+	}
+	else {
+		const char * cache = getStringOrDefault("XDG_CACHE_HOME", NULL);
+		char * parent = NULL;
+		if (cache != NULL && cache[0] == '/') {
+			parent = concatenate(1, cache);
+		}
+		else {
+			const char * home = getStringOrDefault("HOME", NULL);
+			if (home == NULL || home[0] != '/') {
+				logError(_logger, "Cannot locate the cache of kernels (neither XDG_CACHE_HOME nor HOME is defined).");
+				return NULL;
+			}
+			parent = concatenate(2, home, "/.cache");
+		}
+		if (mkdir(parent, 0700) != 0 && errno != EEXIST) {
+			logError(_logger, "Cannot create the cache of the user: \"%s\".", parent);
+			free(parent);
+			return NULL;
+		}
+		directory = concatenate(3, parent, "/", NATIVE_CACHE_NAME);
+		free(parent);
+	}
+	if (mkdir(directory, 0700) != 0 && errno != EEXIST) {
+		logError(_logger, "Cannot create the cache of kernels: \"%s\".", directory);
+		free(directory);
+		return NULL;
+	}
+	if (!_isPrivate(directory, true)) {
+		logError(_logger, "The cache of kernels isn't a directory owned (and only writable) by the user: \"%s\".", directory);
+		free(directory);
+		return NULL;
+	}
+	return directory;
+}
+
+#endif
+
+static void _destroy(Engine * engine) {
+	NativeEngine * native = engine->data;
+	destroyBands(native->bands);
+	destroyPaddedGrid(native->current);
+	destroyPaddedGrid(native->next);
+#if !defined (_WIN32)
+	dlclose(native->library);
+#endif
+	free(native);
+	free(engine);
+}
+
+/**
+ * Adds a string (and its terminator) to a 64-bit FNV-1a hash.
+ */
+static uint64_t _hashString(uint64_t hash, const char * string) {
+	do {
+		hash ^= (uint8_t) *string;
+		hash *= 1099511628211ull;
+	} while (*string++ != '\0');
+	return hash;
+}
+
+#if !defined (_WIN32)
+
+/**
+ * Whether a file (or a directory) is owned by the user, and neither its
+ * group nor anybody else can write it. A symbolic link never is.
+ */
+static boolean _isPrivate(const char * path, const boolean isDirectory) {
+	struct stat status;
+	if (lstat(path, &status) != 0) {
+		return false;
+	}
+	const boolean isType = isDirectory ? S_ISDIR(status.st_mode) : S_ISREG(status.st_mode);
+	return isType && status.st_uid == getuid() && (status.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+
+#endif
+
+static void _load(Engine * engine, const Grid * grid) {
+	NativeEngine * native = engine->data;
+	loadPaddedGrid(native->bands, native->current, grid);
+}
+
+/**
+ * Computes the next generation of the rows of a band, with the kernel.
+ */
+static void _stepBand(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow) {
+	NativeEngine * native = context;
+	native->step(native->current->cells, native->next->cells, (int) firstRow, (int) lastRow);
+}
+
+static void _store(Engine * engine, Grid * grid) {
+	NativeEngine * native = engine->data;
+	storePaddedGrid(native->bands, native->current, grid);
+}
+
+/* PUBLIC FUNCTIONS */
+
+Engine * createNativeEngine(const Automaton * automaton, const unsigned int threads) {
+#if defined (_WIN32)
+	logWarning(_logger, "The native engine isn't supported on this platform.");
+	return NULL;
+#else
+	char * directory = _createCacheDirectory();
+	if (directory == NULL) {
+		return NULL;
+	}
+	uint64_t hash = hashAutomaton(automaton) ^ NATIVE_KERNEL_VERSION;
+	hash = _hashString(hash, getStringOrDefault("NATIVE_COMPILER", DEFAULT_NATIVE_COMPILER));
+	hash = _hashString(hash, getStringOrDefault("NATIVE_FLAGS", DEFAULT_NATIVE_FLAGS));
+	char key[17];
+	snprintf(key, sizeof(key), "%016llx", (unsigned long long) hash);
+	char * library = concatenate(4, directory, "/", key, ".so");
+	if (_isPrivate(library, false)) {
+		logDebugging(_logger, "Loading the cached kernel \"%s\".", library);
+	}
+	else {
+		if (access(library, F_OK) == 0) {
+			logWarning(_logger, "Rebuilding the cached kernel \"%s\", since it isn't owned (and only writable) by the user.", library);
+		}
+		free(library);
+		library = _buildKernel(automaton, directory, key);
+		if (library == NULL) {
+			free(directory);
+			return NULL;
+		}
+		logDebugging(_logger, "Built the kernel \"%s\".", library);
+	}
+	free(directory);
+	void * handle = dlopen(library, RTLD_NOW | RTLD_LOCAL);
+	const unsigned int * halo = handle == NULL ? NULL : dlsym(handle, KERNEL_HALO_SYMBOL);
+	void * step = handle == NULL ? NULL : dlsym(handle, KERNEL_STEP_SYMBOL);
+	if (halo == NULL || step == NULL) {
+		logError(_logger, "Cannot load the kernel \"%s\": %s", library, dlerror());
+		if (handle != NULL) {
+			dlclose(handle);
+		}
+		free(library);
+		return NULL;
+	}
+	free(library);
+	NativeEngine * native = calloc(1, sizeof(NativeEngine));
+	native->automaton = automaton;
+	native->library = handle;
+	*(void **) &native->step = step;
+	native->bands = createBands(automaton->height, 1, threads);
+	native->current = createPaddedGrid(automaton, *halo);
+	native->next = createPaddedGrid(automaton, *halo);
+	Engine * engine = calloc(1, sizeof(Engine));
+	engine->name = "native";
+	engine->automaton = automaton;
+	engine->data = native;
+	engine->load = _load;
+	engine->advance = _advance;
+	engine->store = _store;
+	engine->destroy = _destroy;
+	return engine;
+#endif
+}
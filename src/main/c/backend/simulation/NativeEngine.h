@@ -0,0 +1,68 @@
+#ifndef NATIVE_ENGINE_HEADER
+#define NATIVE_ENGINE_HEADER
+
+#include "../../shared/Environment.h"
+#include "../../shared/Logger.h"
+#include "../../shared/String.h"
+#include "../../shared/Type.h"
+#include "../code-generation/Generator.h"
+#include "Automaton.h"
+#include "Bands.h"
+#include "Engine.h"
+#include "Grid.h"
+#include "PaddedGrid.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined (_WIN32)
+#include <dlfcn.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/** Initialize module's internal state. */
+void initializeNativeEngineModule();
+
+/** Shutdown module's internal state. */
+void shutdownNativeEngineModule();
+
+/**
+ * The defaults of the native engine, overridable with the
+ * "NATIVE_COMPILER" and "NATIVE_FLAGS" environment variables: the C
+ * compiler (and its flags) that builds the kernels into shared objects.
+ */
+#define DEFAULT_NATIVE_COMPILER "cc"
+#define DEFAULT_NATIVE_FLAGS "-O3 -march=native"
+
+/**
+ * The version of the generated kernels, part of the key of the cache, so the
+ * kernels of an older generator are never loaded.
+ */
+#define NATIVE_KERNEL_VERSION 1
+
+/**
+ * The directory of the cached kernels, inside the cache of the user (i.e.,
+ * "$XDG_CACHE_HOME", or "$HOME/.cache" if it's undefined), unless the
+ * "NATIVE_CACHE_DIRECTORY" environment variable overrides the whole path.
+ */
+#define NATIVE_CACHE_NAME "automaton-kernels"
+
+/**
+ * Creates an engine that runs the kernel of the automaton (see
+ * "generateKernel"), built by the system C compiler into a shared object
+ * and loaded in-process. The kernels are cached on disk, keyed by the hash
+ * of the automaton (see "hashAutomaton"), the compiler and its flags, so
+ * the next simulations of the same automaton skip the generation and the
+ * compilation. Since a cached kernel runs in-process, the cache (and every
+ * kernel in it) is only trusted if it's owned by the user, and nobody else
+ * can write it: a foreign kernel is rebuilt, and a foreign cache is never
+ * used. The rows are split into bands, for the specified amount of
+ * threads (see "createBands"). Returns NULL (after logging why) if the
+ * kernel can't be built or loaded.
+ */
+Engine * createNativeEngine(const Automaton * automaton, const unsigned int threads);
+
+#endif
@@ -0,0 +1,449 @@
+#include "Optimizer.h"
+
+/**
+ * An expression that a traversal still has to visit (or to fold, after its
+ * operands), and where its folded expression goes.
+ */
+typedef struct {
+	ArithmeticExpression ** expression;
+	boolean isExpanded;
+} PendingExpression;
+
+/**
+ * The context of an optimization: the states of the symbols, the arena of
+ * the new nodes, and the stack of the pending expressions of a traversal
+ * (so a deep expression, like a long left-associative sum, never overflows
+ * the call stack).
+ */
+typedef struct {
+	const Automaton * automaton;
+	Arena * arena;
+	PendingExpression * pending;
+	unsigned int pendingCount;
+	unsigned int pendingCapacity;
+} Optimizer;
+
+/* PRIVATE FUNCTIONS */
+
+static int _compute(const ArithmeticExpressionType type, const int left, const int right);
+static unsigned int _countExpressionNodes(Optimizer * optimizer, ArithmeticExpression * expression);
+static unsigned int _countNeighborhoodNodes(Optimizer * optimizer, NeighborhoodSequence * sequence);
+static unsigned int _countTransitionNodes(Optimizer * optimizer, TransitionSequence * sequence);
+static ArithmeticExpression * _createInteger(Optimizer * optimizer, const int value);
+static ArithmeticExpression * _foldExpression(Optimizer * optimizer, ArithmeticExpression * expression);
+static ArithmeticExpression * _foldNode(Optimizer * optimizer, ArithmeticExpression * expression);
+static boolean _isConstant(Optimizer * optimizer, ArithmeticExpression * expression, int * value);
+static void _optimizeNeighborhood(Optimizer * optimizer, NeighborhoodSequence * sequence);
+static void _optimizeTransition(Optimizer * optimizer, TransitionSequence * sequence);
+static void _pushExpression(Optimizer * optimizer, ArithmeticExpression ** expression);
+
+/**
+ * Computes a binary operator like the interpreter does, but wrapping around
+ * on overflow (instead of leaving it undefined).
+ */
+static int _compute(const ArithmeticExpressionType type, const int left, const int right) {
+	switch (type) {
+		case ADDITION:
+			return (int) ((unsigned int) left + (unsigned int) right);
+		case SUBTRACTION:
+			return (int) ((unsigned int) left - (unsigned int) right);
+		case MULTIPLICATION:
+			return (int) ((unsigned int) left * (unsigned int) right);
+		case DIVISION:
+			return right == 0 ? 0 : left / right;
+		case MODULE:
+			return right == 0 ? 0 : left % right;
+		case LOGIC_AND:
+			return left && right;
+		case LOGIC_OR:
+			return left || right;
+		case EQUALS:
+			return left == right;
+		case NOT_EQUALS:
+			return left != right;
+		case LOWER_THAN:
+			return left < right;
+		case LOWER_THAN_OR_EQUAL:
+			return left <= right;
+		case GREATER_THAN:
+			return left > right;
+		case GREATER_THAN_OR_EQUAL:
+			return left >= right;
+		default:
+			return 0;
+	}
+}
+
+/**
+ * Counts the nodes of an expression, with an explicit stack.
+ */
+static unsigned int _countExpressionNodes(Optimizer * optimizer, ArithmeticExpression * expression) {
+	unsigned int nodes = 0;
+	_pushExpression(optimizer, &expression);
+	while (0 < optimizer->pendingCount) {
+		ArithmeticExpression * node = *optimizer->pending[--optimizer->pendingCount].expression;
+		++nodes;
+		switch (node->type) {
+			case LOGIC_NOT:
+			case FACTOR:
+				_pushExpression(optimizer, &node->expression);
+				break;
+			case ALL_ARE:
+			case ANY_ARE:
+			case AT_LEAST_ARE:
+			case CONSTANT:
+				break;
+			default:
+				_pushExpression(optimizer, &node->rightExpression);
+				_pushExpression(optimizer, &node->leftExpression);
+				break;
+		}
+	}
+	return nodes;
+}
+
+static unsigned int _countNeighborhoodNodes(Optimizer * optimizer, NeighborhoodSequence * sequence) {
+	unsigned int nodes = 0;
+	for (unsigned int k = 0; k < sequence->count; ++k) {
+		NeighborhoodExpression * expression = sequence->expressions[k];
+		switch (expression->type) {
+			case NEIGHBORHOOD_ASSIGNMENT:
+				nodes += _countExpressionNodes(optimizer, expression->assignment);
+				break;
+			case NEIGHBORHOOD_FOR_LOOP:
+				nodes += _countNeighborhoodNodes(optimizer, expression->forBody);
+				break;
+			case NEIGHBORHOOD_IF:
+				nodes += _countExpressionNodes(optimizer, expression->ifCondition) + _countNeighborhoodNodes(optimizer, expression->ifBody);
+				break;
+			case NEIGHBORHOOD_IF_ELSE:
+				nodes += _countExpressionNodes(optimizer, expression->ifElseCondition)
+					+ _countNeighborhoodNodes(optimizer, expression->ifElseIfBody) + _countNeighborhoodNodes(optimizer, expression->ifElseElseBody);
+				break;
+			default:
+				break;
+		}
+		++nodes;
+	}
+	return nodes;
+}
+
+static unsigned int _countTransitionNodes(Optimizer * optimizer, TransitionSequence * sequence) {
+	unsigned int nodes = 0;
+	for (unsigned int k = 0; k < sequence->count; ++k) {
+		TransitionExpression * expression = sequence->expressions[k];
+		switch (expression->type) {
+			case TRANSITION_ASSIGNMENT:
+				nodes += _countExpressionNodes(optimizer, expression->assignment);
+				break;
+			case TRANSITION_FOR_LOOP:
+				nodes += _countTransitionNodes(optimizer, expression->forBody);
+				break;
+			case TRANSITION_IF:
+				nodes += _countExpressionNodes(optimizer, expression->ifCondition) + _countTransitionNodes(optimizer, expression->ifBody);
+				break;
+			case TRANSITION_IF_ELSE:
+				nodes += _countExpressionNodes(optimizer, expression->ifElseCondition)
+					+ _countTransitionNodes(optimizer, expression->ifElseIfBody) + _countTransitionNodes(optimizer, expression->ifElseElseBody);
+				break;
+			case RETURN_VALUE:
+				nodes += _countExpressionNodes(optimizer, expression->returnValue);
+				break;
+		}
+		++nodes;
+	}
+	return nodes;
+}
+
+static ArithmeticExpression * _createInteger(Optimizer * optimizer, const int value) {
+	Constant * constant = allocateFromArena(optimizer->arena, sizeof(Constant));
+	constant->type = INTEGER_C;
+	constant->value = value;
+	ArithmeticExpression * expression = allocateFromArena(optimizer->arena, sizeof(ArithmeticExpression));
+	expression->type = CONSTANT;
+	expression->constant = constant;
+	return expression;
+}
+
+/**
+ * Folds the constant subexpressions of an expression, and returns the
+ * folded expression (which can be a new node). Every node is folded after
+ * its operands (in post-order, with an explicit stack), and the folded
+ * operands replace the original ones in place.
+ */
+static ArithmeticExpression * _foldExpression(Optimizer * optimizer, ArithmeticExpression * expression) {
+	_pushExpression(optimizer, &expression);
+	while (0 < optimizer->pendingCount) {
+		PendingExpression * pending = &optimizer->pending[optimizer->pendingCount - 1];
+		ArithmeticExpression * node = *pending->expression;
+		if (pending->isExpanded) {
+			--optimizer->pendingCount;
+			*pending->expression = _foldNode(optimizer, node);
+			continue;
+		}
+		pending->isExpanded = true;
+		switch (node->type) {
+			case FACTOR:
+				// The parentheses are stripped: the inner expression takes
+				// their place, and it's visited next.
+				*pending->expression = node->expression;
+				pending->isExpanded = false;
+				break;
+			case LOGIC_NOT:
+				_pushExpression(optimizer, &node->expression);
+				break;
+			case ALL_ARE:
+			case ANY_ARE:
+			case AT_LEAST_ARE:
+			case CONSTANT:
+				break;
+			default:
+				_pushExpression(optimizer, &node->rightExpression);
+				_pushExpression(optimizer, &node->leftExpression);
+				break;
+		}
+	}
+	return expression;
+}
+
+/**
+ * Folds a node whose operands are already folded, and returns the folded
+ * node (which can be a new one).
+ */
+static ArithmeticExpression * _foldNode(Optimizer * optimizer, ArithmeticExpression * expression) {
+	int left = 0;
+	int right = 0;
+	switch (expression->type) {
+		case LOGIC_NOT:
+			return _isConstant(optimizer, expression->expression, &left) ? _createInteger(optimizer, !left) : expression;
+		case ANY_ARE:
+		case AT_LEAST_ARE:
+			if (expression->count <= 0) {
+				return _createInteger(optimizer, 1);
+			}
+			if ((int) expression->cellList->count < expression->count) {
+				return _createInteger(optimizer, 0);
+			}
+			return expression;
+		case ALL_ARE:
+		case CONSTANT:
+			return expression;
+		default:
+			break;
+	}
+	const boolean isLeftConstant = _isConstant(optimizer, expression->leftExpression, &left);
+	const boolean isRightConstant = _isConstant(optimizer, expression->rightExpression, &right);
+	if (isLeftConstant && isRightConstant) {
+		if ((expression->type == DIVISION || expression->type == MODULE) && left == INT_MIN && right == -1) {
+			// It traps on most processors, so it's left for the engines.
+			return expression;
+		}
+		return _createInteger(optimizer, _compute(expression->type, left, right));
+	}
+	if (expression->type == LOGIC_AND && ((isLeftConstant && !left) || (isRightConstant && !right))) {
+		return _createInteger(optimizer, 0);
+	}
+	if (expression->type == LOGIC_OR && ((isLeftConstant && left) || (isRightConstant && right))) {
+		return _createInteger(optimizer, 1);
+	}
+	return expression;
+}
+
+/**
+ * Whether an expression is an integer or a state (i.e., not a variable).
+ */
+static boolean _isConstant(Optimizer * optimizer, ArithmeticExpression * expression, int * value) {
+	if (expression->type != CONSTANT) {
+		return false;
+	}
+	Constant * constant = expression->constant;
+	if (constant->type == INTEGER_C) {
+		*value = constant->value;
+		return true;
+	}
+	if (constant->type == STRING_C && optimizer->automaton->symbolStates[constant->symbol] != NO_STATE) {
+		*value = optimizer->automaton->symbolStates[constant->symbol];
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Optimizes a neighborhood sequence in place, splicing the taken branches of
+ * the constant conditionals into it.
+ */
+static void _optimizeNeighborhood(Optimizer * optimizer, NeighborhoodSequence * sequence) {
+	NeighborhoodExpression ** expressions = NULL;
+	unsigned int count = 0;
+	unsigned int capacity = 0;
+	for (unsigned int k = 0; k < sequence->count; ++k) {
+		NeighborhoodExpression * expression = sequence->expressions[k];
+		NeighborhoodSequence * taken = NULL;
+		boolean isKept = true;
+		int condition;
+		switch (expression->type) {
+			case NEIGHBORHOOD_ASSIGNMENT:
+				expression->assignment = _foldExpression(optimizer, expression->assignment);
+				break;
+			case NEIGHBORHOOD_FOR_LOOP:
+				_optimizeNeighborhood(optimizer, expression->forBody);
+				break;
+			case NEIGHBORHOOD_IF:
+				expression->ifCondition = _foldExpression(optimizer, expression->ifCondition);
+				_optimizeNeighborhood(optimizer, expression->ifBody);
+				if (_isConstant(optimizer, expression->ifCondition, &condition)) {
+					isKept = false;
+					taken = condition ? expression->ifBody : NULL;
+				}
+				else {
+					isKept = 0 < expression->ifBody->count;
+				}
+				break;
+			case NEIGHBORHOOD_IF_ELSE:
+				expression->ifElseCondition = _foldExpression(optimizer, expression->ifElseCondition);
+				_optimizeNeighborhood(optimizer, expression->ifElseIfBody);
+				_optimizeNeighborhood(optimizer, expression->ifElseElseBody);
+				if (_isConstant(optimizer, expression->ifElseCondition, &condition)) {
+					isKept = false;
+					taken = condition ? expression->ifElseIfBody : expression->ifElseElseBody;
+				}
+				else {
+					isKept = 0 < expression->ifElseIfBody->count || 0 < expression->ifElseElseBody->count;
+				}
+				break;
+			default:
+				break;
+		}
+		const unsigned int added = isKept ? 1 : (taken == NULL ? 0 : taken->count);
+		if (capacity < count + added) {
+			const unsigned int newCapacity = 2 * (count + added);
+			expressions = reallocateInArena(optimizer->arena, expressions,
+				capacity * sizeof(NeighborhoodExpression *), newCapacity * sizeof(NeighborhoodExpression *));
+			capacity = newCapacity;
+		}
+		if (isKept) {
+			expressions[count++] = expression;
+		}
+		else if (taken != NULL) {
+			memcpy(expressions + count, taken->expressions, taken->count * sizeof(NeighborhoodExpression *));
+			count += taken->count;
+		}
+	}
+	if (expressions != NULL) {
+		sequence->expressions = expressions;
+		sequence->capacity = capacity;
+	}
+	sequence->count = count;
+}
+
+/**
+ * Optimizes a transition sequence in place, splicing the taken branches of
+ * the constant conditionals into it, and dropping everything after a return
+ * (even the one of a taken branch).
+ */
+static void _optimizeTransition(Optimizer * optimizer, TransitionSequence * sequence) {
+	TransitionExpression ** expressions = NULL;
+	unsigned int count = 0;
+	unsigned int capacity = 0;
+	boolean isReturning = false;
+	for (unsigned int k = 0; k < sequence->count && !isReturning; ++k) {
+		TransitionExpression * expression = sequence->expressions[k];
+		TransitionSequence * taken = NULL;
+		boolean isKept = true;
+		int condition;
+		switch (expression->type) {
+			case TRANSITION_ASSIGNMENT:
+				expression->assignment = _foldExpression(optimizer, expression->assignment);
+				break;
+			case TRANSITION_FOR_LOOP:
+				_optimizeTransition(optimizer, expression->forBody);
+				break;
+			case TRANSITION_IF:
+				expression->ifCondition = _foldExpression(optimizer, expression->ifCondition);
+				_optimizeTransition(optimizer, expression->ifBody);
+				if (_isConstant(optimizer, expression->ifCondition, &condition)) {
+					isKept = false;
+					taken = condition ? expression->ifBody : NULL;
+				}
+				else {
+					isKept = 0 < expression->ifBody->count;
+				}
+				break;
+			case TRANSITION_IF_ELSE:
+				expression->ifElseCondition = _foldExpression(optimizer, expression->ifElseCondition);
+				_optimizeTransition(optimizer, expression->ifElseIfBody);
+				_optimizeTransition(optimizer, expression->ifElseElseBody);
+				if (_isConstant(optimizer, expression->ifElseCondition, &condition)) {
+					isKept = false;
+					taken = condition ? expression->ifElseIfBody : expression->ifElseElseBody;
+				}
+				else {
+					isKept = 0 < expression->ifElseIfBody->count || 0 < expression->ifElseElseBody->count;
+				}
+				break;
+			case RETURN_VALUE:
+				expression->returnValue = _foldExpression(optimizer, expression->returnValue);
+				isReturning = true;
+				break;
+		}
+		const unsigned int added = isKept ? 1 : (taken == NULL ? 0 : taken->count);
+		if (capacity < count + added) {
+			const unsigned int newCapacity = 2 * (count + added);
+			expressions = reallocateInArena(optimizer->arena, expressions,
+				capacity * sizeof(TransitionExpression *), newCapacity * sizeof(TransitionExpression *));
+			capacity = newCapacity;
+		}
+		if (isKept) {
+			expressions[count++] = expression;
+		}
+		else if (taken != NULL) {
+			memcpy(expressions + count, taken->expressions, taken->count * sizeof(TransitionExpression *));
+			count += taken->count;
+		}
+		// An optimized sequence can only end with a return (if it has one).
+		isReturning = isReturning || (0 < count && expressions[count - 1]->type == RETURN_VALUE);
+	}
+	if (expressions != NULL) {
+		sequence->expressions = expressions;
+		sequence->capacity = capacity;
+	}
+	sequence->count = count;
+}
+
+/**
+ * Pushes an expression onto the stack of the pending ones.
+ */
+static void _pushExpression(Optimizer * optimizer, ArithmeticExpression ** expression) {
+	if (optimizer->pendingCount == optimizer->pendingCapacity) {
+		optimizer->pendingCapacity = optimizer->pendingCapacity == 0 ? 64 : 2 * optimizer->pendingCapacity;
+		optimizer->pending = realloc(optimizer->pending, optimizer->pendingCapacity * sizeof(PendingExpression));
+	}
+	optimizer->pending[optimizer->pendingCount].expression = expression;
+	optimizer->pending[optimizer->pendingCount].isExpanded = false;
+	++optimizer->pendingCount;
+}
+
+/* PUBLIC FUNCTIONS */
+
+OptimizationResult optimizeAutomaton(Automaton * automaton, Arena * arena) {
+	Optimizer optimizer = {
+		.automaton = automaton,
+		.arena = arena,
+		.pending = NULL,
+		.pendingCount = 0,
+		.pendingCapacity = 0
+	};
+	OptimizationResult result = {0};
+	if (automaton->transitionProgram != NULL) {
+		result.nodes += _countTransitionNodes(&optimizer, automaton->transitionProgram);
+		_optimizeTransition(&optimizer, automaton->transitionProgram);
+		result.optimizedNodes += _countTransitionNodes(&optimizer, automaton->transitionProgram);
+	}
+	if (automaton->neighborhoodProgram != NULL) {
+		result.nodes += _countNeighborhoodNodes(&optimizer, automaton->neighborhoodProgram);
+		_optimizeNeighborhood(&optimizer, automaton->neighborhoodProgram);
+		result.optimizedNodes += _countNeighborhoodNodes(&optimizer, automaton->neighborhoodProgram);
+	}
+	free(optimizer.pending);
+	return result;
+}
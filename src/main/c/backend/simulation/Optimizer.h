@@ -0,0 +1,38 @@
+#ifndef OPTIMIZER_HEADER
+#define OPTIMIZER_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Arena.h"
+#include "../../shared/SymbolTable.h"
+#include "../../shared/Type.h"
+#include "Automaton.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The size of the programs of an automaton (in nodes of the AST: every
+ * expression and statement), before and after their optimization.
+ */
+typedef struct {
+	unsigned int nodes;
+	unsigned int optimizedNodes;
+} OptimizationResult;
+
+/**
+ * Simplifies the programs of an automaton before any engine sees them, with
+ * the semantics of the interpreter (see "Interpreter.h"):
+ *
+ *	- The integer constants (and states) are folded, wrapping around on
+ *	  overflow, and the parentheses (i.e., FACTOR nodes) are stripped.
+ *	- A logical operator with a deciding constant operand is folded too,
+ *	  since the expressions never have side effects.
+ *	- A conditional with a constant condition is replaced with its taken
+ *	  branch (if any), and one with empty branches is removed.
+ *	- The statements after a return are removed, since they never run.
+ *
+ * The new nodes are allocated from the arena of the AST.
+ */
+OptimizationResult optimizeAutomaton(Automaton * automaton, Arena * arena);
+
+#endif
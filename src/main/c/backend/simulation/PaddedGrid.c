@@ -0,0 +1,138 @@
+#include "PaddedGrid.h"
+
+/**
+ * The grids of a copy between a padded grid and a plain one (see
+ * "loadPaddedGrid" and "storePaddedGrid").
+ */
+typedef struct {
+	PaddedGrid * padded;
+	Grid * grid;
+	boolean isLoad;
+} PaddedCopy;
+
+/* PRIVATE FUNCTIONS */
+
+static void _copyBand(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow);
+static void _fillColumns(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow);
+
+static void _copyBand(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow) {
+	PaddedCopy * copy = context;
+	const size_t width = copy->grid->width;
+	for (unsigned int y = firstRow; y < lastRow; ++y) {
+		uint8_t * padded = copy->padded->cells + y * copy->padded->stride;
+		uint8_t * row = copy->grid->cells + y * width;
+		if (copy->isLoad) {
+			memcpy(padded, row, width);
+		}
+		else {
+			memcpy(row, padded, width);
+		}
+	}
+}
+
+/**
+ * Fills the halo columns of a band of rows. Every halo cell is copied from
+ * its precomputed column, so the loop is the same on every frontier.
+ */
+static void _fillColumns(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow) {
+	PaddedGrid * grid = context;
+	const int halo = (int) grid->halo;
+	const int width = (int) grid->width;
+	for (unsigned int y = firstRow; y < lastRow; ++y) {
+		uint8_t * row = grid->cells + y * grid->stride;
+		if (grid->frontier == OPEN) {
+			memset(row - halo, OUTSIDE_CELL, halo);
+			memset(row + width, OUTSIDE_CELL, halo);
+			continue;
+		}
+		for (int k = 0; k < halo; ++k) {
+			row[-1 - k] = row[grid->columns[k]];
+			row[width + k] = row[grid->columns[halo + k]];
+		}
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+unsigned int getHaloWidth(const Offset minimum, const Offset maximum) {
+	int halo = 0;
+	halo = halo < -minimum.x ? -minimum.x : halo;
+	halo = halo < -minimum.y ? -minimum.y : halo;
+	halo = halo < maximum.x ? maximum.x : halo;
+	halo = halo < maximum.y ? maximum.y : halo;
+	return (unsigned int) halo;
+}
+
+PaddedGrid * createPaddedGrid(const Automaton * automaton, const unsigned int halo) {
+	PaddedGrid * grid = calloc(1, sizeof(PaddedGrid));
+	grid->width = automaton->width;
+	grid->height = automaton->height;
+	grid->halo = halo;
+	grid->stride = (size_t) automaton->width + 2 * halo;
+	grid->frontier = automaton->frontier;
+	grid->columns = calloc(2 * halo + 1, sizeof(int));
+	for (unsigned int k = 0; k < halo; ++k) {
+		grid->columns[k] = resolveCoordinate(grid->frontier, -1 - (int) k, grid->width);
+		grid->columns[halo + k] = resolveCoordinate(grid->frontier, (int) (grid->width + k), grid->width);
+	}
+	grid->buffer = calloc((grid->height + 2 * (size_t) halo) * grid->stride, sizeof(uint8_t));
+	grid->cells = grid->buffer + halo * grid->stride + halo;
+	return grid;
+}
+
+void destroyPaddedGrid(PaddedGrid * grid) {
+	if (grid != NULL) {
+		free(grid->columns);
+		free(grid->buffer);
+		free(grid);
+	}
+}
+
+void fillHalo(Bands * bands, PaddedGrid * grid) {
+	if (grid->halo == 0 || grid->isHaloFilled) {
+		return;
+	}
+	runBands(bands, _fillColumns, grid);
+	const int halo = (int) grid->halo;
+	for (int k = 0; k < halo; ++k) {
+		uint8_t * above = grid->cells - (ptrdiff_t) (1 + k) * grid->stride - halo;
+		uint8_t * below = grid->cells + (ptrdiff_t) (grid->height + k) * grid->stride - halo;
+		if (grid->frontier == OPEN) {
+			memset(above, OUTSIDE_CELL, grid->stride);
+			memset(below, OUTSIDE_CELL, grid->stride);
+			continue;
+		}
+		const int aboveRow = resolveCoordinate(grid->frontier, -1 - k, grid->height);
+		const int belowRow = resolveCoordinate(grid->frontier, (int) grid->height + k, grid->height);
+		memcpy(above, grid->cells + (ptrdiff_t) aboveRow * grid->stride - halo, grid->stride);
+		memcpy(below, grid->cells + (ptrdiff_t) belowRow * grid->stride - halo, grid->stride);
+	}
+	grid->isHaloFilled = grid->frontier == OPEN;
+}
+
+void loadPaddedGrid(Bands * bands, PaddedGrid * padded, const Grid * grid) {
+	PaddedCopy copy = {
+		.padded = padded,
+		.grid = (Grid *) grid,
+		.isLoad = true
+	};
+	runBands(bands, _copyBand, &copy);
+}
+
+int readPaddedCell(const PaddedGrid * grid, const int x, const int y) {
+	const int column = resolveCoordinate(grid->frontier, x, grid->width);
+	const int row = resolveCoordinate(grid->frontier, y, grid->height);
+	if (column < 0 || row < 0) {
+		return OUTSIDE_STATE;
+	}
+	return grid->cells[(size_t) row * grid->stride + column];
+}
+
+void storePaddedGrid(Bands * bands, const PaddedGrid * padded, Grid * grid) {
+	PaddedCopy copy = {
+		.padded = (PaddedGrid *) padded,
+		.grid = grid,
+		.isLoad = false
+	};
+	runBands(bands, _copyBand, &copy);
+}
@@ -0,0 +1,88 @@
+#ifndef PADDED_GRID_HEADER
+#define PADDED_GRID_HEADER
+
+#include "../../shared/Type.h"
+#include "Automaton.h"
+#include "Bands.h"
+#include "Grid.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The value of a padded cell inside a program, without branching (i.e.,
+ * OUTSIDE_STATE for an OUTSIDE_CELL, and the state for any other one).
+ */
+#define PADDED_VALUE(cell) ((int) (cell) - (((cell) == OUTSIDE_CELL) << 8))
+
+/**
+ * A grid surrounded by a halo of cells as wide as the reach of a stencil, so
+ * the neighborhood of every cell can be read directly (i.e., at a constant
+ * displacement, in row-major order with the stride of the padded rows),
+ * without branching on the frontier. The halo holds the cells that the
+ * frontier maps to (or OUTSIDE_CELL, on an open one), and it must be filled
+ * after the grid changes (see "fillHalo").
+ */
+typedef struct {
+	unsigned int width;
+	unsigned int height;
+	unsigned int halo;
+	size_t stride;
+	FrontierEnum frontier;
+
+	// The interior columns that the frontier maps the halo ones to (left
+	// first, from the nearest one), or -1 on an open frontier.
+	int * columns;
+
+	// The whole buffer, and its cell at (0, 0).
+	uint8_t * buffer;
+	uint8_t * cells;
+
+	// Whether the halo is already filled (an open one never changes).
+	boolean isHaloFilled;
+} PaddedGrid;
+
+/**
+ * The width of the halo that a stencil with the specified bounding box
+ * needs (the farthest coordinate of any of its offsets).
+ */
+unsigned int getHaloWidth(const Offset minimum, const Offset maximum);
+
+/**
+ * Creates a grid of the size of an automaton, with a halo of the specified
+ * width, and every cell in the first state.
+ */
+PaddedGrid * createPaddedGrid(const Automaton * automaton, const unsigned int halo);
+
+/**
+ * Destroys a padded grid.
+ */
+void destroyPaddedGrid(PaddedGrid * grid);
+
+/**
+ * Refills the halo from the cells of the grid, according to its frontier.
+ * The columns are filled by every worker on its own band of rows, and then
+ * the rows above and below, so the corners are filled too.
+ */
+void fillHalo(Bands * bands, PaddedGrid * grid);
+
+/**
+ * Copies the cells of a grid into a padded one of the same size, on the
+ * workers of the bands (see "copyBands").
+ */
+void loadPaddedGrid(Bands * bands, PaddedGrid * padded, const Grid * grid);
+
+/**
+ * Reads the cell at (x, y), resolving the frontier if it's outside the halo
+ * (e.g., at an offset computed by a program). Returns OUTSIDE_STATE if it's
+ * outside an open grid.
+ */
+int readPaddedCell(const PaddedGrid * grid, const int x, const int y);
+
+/**
+ * Copies the cells of a padded grid into a grid of the same size, on the
+ * workers of the bands.
+ */
+void storePaddedGrid(Bands * bands, const PaddedGrid * padded, Grid * grid);
+
+#endif
@@ -0,0 +1,364 @@
+#include "Recorder.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeRecorderModule() {
+	_logger = createLogger("Recorder");
+}
+
+void shutdownRecorderModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static void * _encode(void * argument);
+static void _encodeDelta(RecordingChunk * chunk, const Grid * grid, const Grid * previousGrid);
+static void _encodeFrame(Recorder * recorder, RecordingChunk * chunk, const RecordingFrame * frame);
+static void _encodeKeyframe(RecordingChunk * chunk, const Grid * grid);
+static void _putUnsigned(RecordingChunk * chunk, const uint64_t value, const unsigned int bytes);
+static void _putVarint(RecordingChunk * chunk, uint64_t value);
+static void _reserve(RecordingChunk * chunk, const size_t bytes);
+static RecordingChunk * _send(Recorder * recorder, RecordingChunk * chunk);
+static size_t _skipEqual(const uint8_t * cells, const uint8_t * previous, size_t k, const size_t size);
+static void * _write(void * argument);
+
+/**
+ * The main loop of the encoder thread: encodes every pending frame into the
+ * current chunk, and recycles the previous frame. The chunk is sent to the
+ * writer when it's full, or as soon as no frame is pending (so the bytes are
+ * written while the simulation computes the next frames). A NULL frame ends
+ * the recording.
+ */
+static void * _encode(void * argument) {
+	Recorder * recorder = argument;
+	RecordingChunk * chunk = popRingBuffer(recorder->freeChunks);
+	while (true) {
+		RecordingFrame * frame;
+		if (!tryPopRingBuffer(recorder->pendingFrames, (void **) &frame)) {
+			if (0 < chunk->size) {
+				chunk = _send(recorder, chunk);
+			}
+			frame = popRingBuffer(recorder->pendingFrames);
+		}
+		if (frame == NULL) {
+			break;
+		}
+		if (!__atomic_load_n(&recorder->isFailed, __ATOMIC_RELAXED)) {
+			_encodeFrame(recorder, chunk, frame);
+		}
+		if (recorder->previous != NULL) {
+			pushRingBuffer(recorder->freeFrames, recorder->previous);
+		}
+		recorder->previous = frame;
+		if (RECORDING_BUFFER_SIZE <= chunk->size) {
+			chunk = _send(recorder, chunk);
+		}
+	}
+	if (0 < chunk->size) {
+		pushRingBuffer(recorder->pendingChunks, chunk);
+	}
+	pushRingBuffer(recorder->pendingChunks, NULL);
+	return NULL;
+}
+
+/**
+ * Encodes the runs of cells that changed since the previous frame. A run
+ * ends at the first RECORDING_MINIMUM_SKIP unchanged cells in a row.
+ */
+static void _encodeDelta(RecordingChunk * chunk, const Grid * grid, const Grid * previousGrid) {
+	const uint8_t * cells = grid->cells;
+	const uint8_t * previous = previousGrid->cells;
+	const size_t size = (size_t) grid->width * grid->height;
+	size_t last = 0;
+	size_t k = _skipEqual(cells, previous, 0, size);
+	while (k < size) {
+		const size_t first = k;
+		size_t end = k + 1;
+		for (size_t j = end; j < size && j - end < RECORDING_MINIMUM_SKIP; ++j) {
+			if (cells[j] != previous[j]) {
+				end = j + 1;
+			}
+		}
+		_putVarint(chunk, first - last);
+		_putVarint(chunk, end - first);
+		memcpy(chunk->bytes + chunk->size, cells + first, end - first);
+		chunk->size += end - first;
+		last = end;
+		k = _skipEqual(cells, previous, end, size);
+	}
+}
+
+/**
+ * Appends a frame to a chunk: a keyframe, or the delta from the previous
+ * frame.
+ */
+static void _encodeFrame(Recorder * recorder, RecordingChunk * chunk, const RecordingFrame * frame) {
+	const Grid * grid = frame->grid;
+	const boolean isKeyframe = recorder->encoded % recorder->keyframeInterval == 0;
+	const size_t cells = (size_t) grid->width * grid->height;
+	// The worst case of both encodings is a run of every single cell.
+	_reserve(chunk, 2 * cells + 64);
+	_putUnsigned(chunk, isKeyframe ? RECORDING_KEYFRAME : RECORDING_DELTA, 1);
+	_putUnsigned(chunk, frame->generation, 8);
+	const size_t sizeIndex = chunk->size;
+	chunk->size += 8;
+	if (isKeyframe) {
+		_encodeKeyframe(chunk, grid);
+	}
+	else {
+		_encodeDelta(chunk, grid, recorder->previous->grid);
+	}
+	const uint64_t payload = chunk->size - sizeIndex - 8;
+	for (unsigned int k = 0; k < 8; ++k) {
+		chunk->bytes[sizeIndex + k] = (uint8_t) (payload >> (8 * k));
+	}
+	++recorder->encoded;
+}
+
+/**
+ * Encodes every cell, as runs of the same state.
+ */
+static void _encodeKeyframe(RecordingChunk * chunk, const Grid * grid) {
+	const uint8_t * cells = grid->cells;
+	const size_t size = (size_t) grid->width * grid->height;
+	size_t k = 0;
+	while (k < size) {
+		size_t end = k + 1;
+		while (end < size && cells[end] == cells[k]) {
+			++end;
+		}
+		_putVarint(chunk, end - k);
+		chunk->bytes[chunk->size++] = cells[k];
+		k = end;
+	}
+}
+
+/**
+ * Appends an unsigned integer of the specified amount of bytes, in
+ * little-endian order.
+ */
+static void _putUnsigned(RecordingChunk * chunk, const uint64_t value, const unsigned int bytes) {
+	_reserve(chunk, bytes);
+	for (unsigned int k = 0; k < bytes; ++k) {
+		chunk->bytes[chunk->size++] = (uint8_t) (value >> (8 * k));
+	}
+}
+
+/**
+ * Appends an unsigned LEB128 integer (the space must be reserved).
+ */
+static void _putVarint(RecordingChunk * chunk, uint64_t value) {
+	while (0x80 <= value) {
+		chunk->bytes[chunk->size++] = (uint8_t) (value | 0x80);
+		value >>= 7;
+	}
+	chunk->bytes[chunk->size++] = (uint8_t) value;
+}
+
+/**
+ * Makes room in a chunk for the specified amount of bytes.
+ */
+static void _reserve(RecordingChunk * chunk, const size_t bytes) {
+	if (chunk->capacity < chunk->size + bytes) {
+		while (chunk->capacity < chunk->size + bytes) {
+			chunk->capacity *= 2;
+		}
+		chunk->bytes = realloc(chunk->bytes, chunk->capacity);
+	}
+}
+
+/**
+ * Hands a chunk to the writer, and takes a free one (waiting for the writer,
+ * if every chunk is waiting to be written).
+ */
+static RecordingChunk * _send(Recorder * recorder, RecordingChunk * chunk) {
+	pushRingBuffer(recorder->pendingChunks, chunk);
+	RecordingChunk * next = popRingBuffer(recorder->freeChunks);
+	next->size = 0;
+	return next;
+}
+
+/**
+ * The first cell from the specified one that changed since the previous
+ * frame (or the size, if none did), comparing 8 cells at a time.
+ */
+static size_t _skipEqual(const uint8_t * cells, const uint8_t * previous, size_t k, const size_t size) {
+	while (k + sizeof(uint64_t) <= size) {
+		uint64_t block, previousBlock;
+		memcpy(&block, cells + k, sizeof(uint64_t));
+		memcpy(&previousBlock, previous + k, sizeof(uint64_t));
+		if (block != previousBlock) {
+			break;
+		}
+		k += sizeof(uint64_t);
+	}
+	while (k < size && cells[k] == previous[k]) {
+		++k;
+	}
+	return k;
+}
+
+/**
+ * The main loop of the writer thread: writes every pending chunk with a
+ * single call (the file is unbuffered), and recycles it. A NULL chunk ends
+ * the recording.
+ */
+static void * _write(void * argument) {
+	Recorder * recorder = argument;
+	RecordingChunk * chunk;
+	while ((chunk = popRingBuffer(recorder->pendingChunks)) != NULL) {
+		if (!__atomic_load_n(&recorder->isFailed, __ATOMIC_RELAXED)) {
+			if (fwrite(chunk->bytes, 1, chunk->size, recorder->file) == chunk->size) {
+				recorder->bytes += chunk->size;
+			}
+			else {
+				logError(_logger, "Cannot write the recording \"%s\".", recorder->path);
+				__atomic_store_n(&recorder->isFailed, true, __ATOMIC_RELAXED);
+			}
+		}
+		pushRingBuffer(recorder->freeChunks, chunk);
+	}
+	return NULL;
+}
+
+/* PUBLIC FUNCTIONS */
+
+char * getRecordingOutput(const char * programPath) {
+	const char * output = getStringOrDefault("SIMULATION_OUTPUT", NULL);
+	if (output == NULL || output[0] == '\0') {
+		return NULL;
+	}
+#if !defined (_WIN32)
+	struct stat status;
+	if (stat(output, &status) == 0 && S_ISDIR(status.st_mode)) {
+		const char * name = strrchr(programPath, '/');
+		name = name == NULL ? programPath : name + 1;
+		if (strcmp(name, "-") == 0) {
+			name = "standard-input";
+		}
+		return concatenate(4, output, "/", name, ".frames");
+	}
+#endif
+	return concatenate(1, output);
+}
+
+RecordingFrame * acquireFrame(Recorder * recorder, const boolean isDroppable) {
+	if (recorder->dropsFrames && isDroppable) {
+		RecordingFrame * frame;
+		if (tryPopRingBuffer(recorder->freeFrames, (void **) &frame)) {
+			return frame;
+		}
+		++recorder->dropped;
+		return NULL;
+	}
+	return popRingBuffer(recorder->freeFrames);
+}
+
+Recorder * createRecorder(const Automaton * automaton, const char * path, const uint64_t interval, const unsigned int keyframeInterval,
+		const unsigned int queue, const boolean dropsFrames) {
+	FILE * file = fopen(path, "wb");
+	if (file == NULL) {
+		logError(_logger, "Cannot create the recording \"%s\".", path);
+		return NULL;
+	}
+	// The chunks are already as big as a write should be.
+	setvbuf(file, NULL, _IONBF, 0);
+	Recorder * recorder = calloc(1, sizeof(Recorder));
+	recorder->file = file;
+	recorder->path = concatenate(1, path);
+	recorder->keyframeInterval = keyframeInterval == 0 ? 1 : keyframeInterval;
+	recorder->dropsFrames = dropsFrames;
+	// Besides the queue, a buffer is being stored by the simulation, and
+	// another one is the previous frame of the encoder.
+	recorder->bufferCount = (queue == 0 ? 1 : queue) + 2;
+	recorder->buffers = calloc(recorder->bufferCount, sizeof(RecordingFrame));
+	recorder->freeFrames = createRingBuffer(recorder->bufferCount);
+	recorder->pendingFrames = createRingBuffer(recorder->bufferCount + 1);
+	for (unsigned int k = 0; k < recorder->bufferCount; ++k) {
+		recorder->buffers[k].grid = createGrid(automaton->width, automaton->height);
+		pushRingBuffer(recorder->freeFrames, &recorder->buffers[k]);
+	}
+	recorder->chunks = calloc(RECORDING_BUFFERS, sizeof(RecordingChunk));
+	recorder->freeChunks = createRingBuffer(RECORDING_BUFFERS);
+	recorder->pendingChunks = createRingBuffer(RECORDING_BUFFERS + 1);
+	for (unsigned int k = 0; k < RECORDING_BUFFERS; ++k) {
+		recorder->chunks[k].capacity = RECORDING_BUFFER_SIZE;
+		recorder->chunks[k].bytes = calloc(RECORDING_BUFFER_SIZE, sizeof(uint8_t));
+	}
+	// The header is the first chunk to write.
+	RecordingChunk * header = &recorder->chunks[0];
+	const size_t magic = strlen(RECORDING_MAGIC);
+	memcpy(header->bytes, RECORDING_MAGIC, magic);
+	header->size = magic;
+	_putUnsigned(header, RECORDING_VERSION, 4);
+	_putUnsigned(header, automaton->width, 4);
+	_putUnsigned(header, automaton->height, 4);
+	_putUnsigned(header, interval, 8);
+	_putUnsigned(header, recorder->keyframeInterval, 4);
+	_putUnsigned(header, automaton->states, 4);
+	for (unsigned int k = 0; k < automaton->states; ++k) {
+		const size_t length = strlen(automaton->stateNames[k]);
+		_putUnsigned(header, length, 4);
+		_reserve(header, length);
+		memcpy(header->bytes + header->size, automaton->stateNames[k], length);
+		header->size += length;
+	}
+	_putUnsigned(header, automaton->colorCount, 4);
+	for (unsigned int k = 0; k < automaton->colorCount; ++k) {
+		_putUnsigned(header, (uint32_t) automaton->colors[k], 4);
+	}
+	pushRingBuffer(recorder->pendingChunks, header);
+	for (unsigned int k = 1; k < RECORDING_BUFFERS; ++k) {
+		pushRingBuffer(recorder->freeChunks, &recorder->chunks[k]);
+	}
+	pthread_create(&recorder->encoder, NULL, _encode, recorder);
+	pthread_create(&recorder->writer, NULL, _write, recorder);
+	return recorder;
+}
+
+boolean destroyRecorder(Recorder * recorder) {
+	pushRingBuffer(recorder->pendingFrames, NULL);
+	pthread_join(recorder->encoder, NULL);
+	pthread_join(recorder->writer, NULL);
+	boolean isWritten = !recorder->isFailed;
+	if (fclose(recorder->file) != 0 && isWritten) {
+		logError(_logger, "Cannot write the recording \"%s\".", recorder->path);
+		isWritten = false;
+	}
+	logDebugging(_logger, "Recorded %llu frames into \"%s\" (%llu bytes, %llu frames dropped).",
+		(unsigned long long) recorder->encoded, recorder->path, (unsigned long long) recorder->bytes,
+		(unsigned long long) recorder->dropped);
+	for (unsigned int k = 0; k < recorder->bufferCount; ++k) {
+		destroyGrid(recorder->buffers[k].grid);
+	}
+	for (unsigned int k = 0; k < RECORDING_BUFFERS; ++k) {
+		free(recorder->chunks[k].bytes);
+	}
+	destroyRingBuffer(recorder->freeFrames);
+	destroyRingBuffer(recorder->pendingFrames);
+	destroyRingBuffer(recorder->freeChunks);
+	destroyRingBuffer(recorder->pendingChunks);
+	free(recorder->buffers);
+	free(recorder->chunks);
+	free(recorder->path);
+	free(recorder);
+	return isWritten;
+}
+
+boolean recordFrame(Recorder * recorder, const Grid * grid, const uint64_t generation) {
+	RecordingFrame * frame = acquireFrame(recorder, false);
+	copyGrid(frame->grid, grid);
+	return submitFrame(recorder, frame, generation);
+}
+
+boolean submitFrame(Recorder * recorder, RecordingFrame * frame, const uint64_t generation) {
+	frame->generation = generation;
+	++recorder->frames;
+	pushRingBuffer(recorder->pendingFrames, frame);
+	return !__atomic_load_n(&recorder->isFailed, __ATOMIC_RELAXED);
+}
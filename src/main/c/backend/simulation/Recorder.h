@@ -0,0 +1,196 @@
+#ifndef RECORDER_HEADER
+#define RECORDER_HEADER
+
+#include "../../shared/Environment.h"
+#include "../../shared/Logger.h"
+#include "../../shared/RingBuffer.h"
+#include "../../shared/String.h"
+#include "../../shared/Type.h"
+#include "Automaton.h"
+#include "Grid.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/** Initialize module's internal state. */
+void initializeRecorderModule();
+
+/** Shutdown module's internal state. */
+void shutdownRecorderModule();
+
+/**
+ * The first bytes of a recording, and the version of its format.
+ */
+#define RECORDING_MAGIC "CAFRAMES"
+#define RECORDING_VERSION 1
+
+/**
+ * The types of the frames of a recording.
+ */
+#define RECORDING_KEYFRAME 0
+#define RECORDING_DELTA 1
+
+/**
+ * The amount of encoded bytes buffered before they are written at once, and
+ * the amount of chunks of them (i.e., the one being filled, the one being
+ * written, and the ones waiting to be written).
+ */
+#define RECORDING_BUFFER_SIZE (1 << 20)
+#define RECORDING_BUFFERS 4
+
+/**
+ * The shortest run of unchanged cells that splits the changed cells of a
+ * delta (a shorter one is cheaper to rewrite than to skip).
+ */
+#define RECORDING_MINIMUM_SKIP 3
+
+/**
+ * The default amount of frames from a keyframe to the next one, overridable
+ * with the "SIMULATION_KEYFRAME_INTERVAL" environment variable.
+ */
+#define DEFAULT_RECORDING_KEYFRAME_INTERVAL 64
+
+/**
+ * The default amount of frames that can wait to be encoded, overridable with
+ * the "SIMULATION_OUTPUT_QUEUE" environment variable.
+ */
+#define DEFAULT_RECORDING_QUEUE 8
+
+/**
+ * A buffer of a frame, and its generation.
+ */
+typedef struct {
+	Grid * grid;
+	uint64_t generation;
+} RecordingFrame;
+
+/**
+ * A buffer of encoded bytes, written at once.
+ */
+typedef struct {
+	uint8_t * bytes;
+	size_t size;
+	size_t capacity;
+} RecordingChunk;
+
+/**
+ * A binary recording of the generations of a simulation, streamed into a
+ * file. Every number is little-endian, and a "varint" is an unsigned LEB128
+ * (7 bits per byte, the least significant first). The header is:
+ *
+ *	- The magic bytes (RECORDING_MAGIC), and the version (u32).
+ *	- The width and the height of the grid (u32 each).
+ *	- The generations between frames (u64), and the frames between
+ *	  keyframes (u32).
+ *	- The amount of states (u32), and the name of each one (its length in
+ *	  bytes as a u32, and then the bytes).
+ *	- The amount of colors (u32), and each color (i32).
+ *
+ * And then every frame: its type (u8), its generation (u64), the size of
+ * its payload in bytes (u64), and the payload:
+ *
+ *	- RECORDING_KEYFRAME: every cell, in row-major order, as runs of the
+ *	  same state (a varint with the length of the run, and the state as a
+ *	  u8).
+ *	- RECORDING_DELTA: the cells that changed since the previous frame, as
+ *	  runs (a varint with the amount of unchanged cells skipped, a varint
+ *	  with the length of the run, and the state of every cell of the run as a
+ *	  u8). The cells after the last run are unchanged.
+ *
+ * The recorder is a pipeline, so the simulation is never slowed down by the
+ * encoding or the disk: the simulation stores every frame into a free
+ * buffer, and hands it to an encoder thread, that appends it to a chunk, and
+ * hands the chunk to a writer thread. Every buffer and chunk is recycled,
+ * through lock-free rings (see "RingBuffer") from each stage to the next one
+ * and back. If the queue of frames to encode is full, the simulation waits,
+ * or the frame is dropped. There is a single encoder, since every delta
+ * depends on the previous frame (and the chunks must be written in order), so
+ * more encoders would only wait for each other.
+ */
+typedef struct {
+	FILE * file;
+	char * path;
+	unsigned int keyframeInterval;
+	boolean dropsFrames;
+
+	// Every frame buffer, the free ones (back from the encoder), and the ones
+	// to encode (from the simulation).
+	RecordingFrame * buffers;
+	unsigned int bufferCount;
+	RingBuffer * freeFrames;
+	RingBuffer * pendingFrames;
+
+	// Every chunk, the free ones (back from the writer), and the ones to
+	// write (from the encoder).
+	RecordingChunk * chunks;
+	RingBuffer * freeChunks;
+	RingBuffer * pendingChunks;
+
+	pthread_t encoder;
+	pthread_t writer;
+
+	// The frames recorded and dropped (by the simulation).
+	uint64_t frames;
+	uint64_t dropped;
+
+	// The previous frame, and the amount of frames encoded (by the encoder).
+	RecordingFrame * previous;
+	uint64_t encoded;
+
+	// The bytes written (by the writer), and whether a write failed (and
+	// every frame since then was dropped).
+	uint64_t bytes;
+	boolean isFailed;
+} Recorder;
+
+/**
+ * The path of the recording of a program, from the "SIMULATION_OUTPUT"
+ * environment variable (undefined by default, that is, nothing is
+ * recorded). If it's a directory, the recording is created inside it,
+ * named after the program. Returns NULL if nothing must be recorded, or a
+ * path that must be freed.
+ */
+char * getRecordingOutput(const char * programPath);
+
+/**
+ * Takes a free frame buffer to store a generation into (that must be
+ * submitted). If every buffer is waiting to be encoded, waits for one, or
+ * returns NULL (and the frame is dropped) if the recorder drops frames and
+ * "isDroppable".
+ */
+RecordingFrame * acquireFrame(Recorder * recorder, const boolean isDroppable);
+
+/**
+ * Creates a recording of an automaton, writes its header, and starts its
+ * encoder and writer threads. The frames are recorded every "interval"
+ * generations (only to describe them in the header), and every
+ * "keyframeInterval" frames is a keyframe. Up to "queue" frames can wait to
+ * be encoded, and then the simulation waits (or if "dropsFrames", they are
+ * dropped). Returns NULL (after logging why) if the file can't be created.
+ */
+Recorder * createRecorder(const Automaton * automaton, const char * path, const uint64_t interval, const unsigned int keyframeInterval,
+	const unsigned int queue, const boolean dropsFrames);
+
+/**
+ * Waits for the pending frames to be written, closes the recording, and
+ * destroys the recorder. Returns false if any frame couldn't be written.
+ */
+boolean destroyRecorder(Recorder * recorder);
+
+/**
+ * Records a copy of a generation (waiting for a free buffer, if necessary).
+ * Returns false if the recording failed.
+ */
+boolean recordFrame(Recorder * recorder, const Grid * grid, const uint64_t generation);
+
+/**
+ * Hands an acquired frame buffer (with a generation stored into it) to the
+ * encoder: it becomes a keyframe, or the delta from the previous frame.
+ * Returns false if the recording failed.
+ */
+boolean submitFrame(Recorder * recorder, RecordingFrame * frame, const uint64_t generation);
+
+#endif
@@ -0,0 +1,106 @@
+#include "ReferenceEngine.h"
+
+/**
+ * The state of a reference engine: the current generation, and the buffer of
+ * the next one (swapped after every step).
+ */
+typedef struct {
+	Interpreter * interpreter;
+	Grid * current;
+	Grid * next;
+} ReferenceEngine;
+
+/* PRIVATE FUNCTIONS */
+
+static void _advance(Engine * engine, const uint64_t generations);
+static unsigned int _countAliveNeighbors(Interpreter * interpreter, const Grid * grid, const int x, const int y);
+static void _destroy(Engine * engine);
+static void _load(Engine * engine, const Grid * grid);
+static void _store(Engine * engine, Grid * grid);
+
+static void _advance(Engine * engine, const uint64_t generations) {
+	ReferenceEngine * reference = engine->data;
+	for (uint64_t generation = 0; generation < generations; ++generation) {
+		stepReference(reference->interpreter, reference->current, reference->next);
+		Grid * swap = reference->current;
+		reference->current = reference->next;
+		reference->next = swap;
+	}
+}
+
+/**
+ * Counts the alive neighbors of a cell, in a predefined neighborhood or in
+ * the one computed by the neighborhood program for that cell.
+ */
+static unsigned int _countAliveNeighbors(Interpreter * interpreter, const Grid * grid, const int x, const int y) {
+	const Automaton * automaton = interpreter->automaton;
+	const Offset * neighbors = automaton->neighbors;
+	unsigned int neighborCount = automaton->neighborCount;
+	if (automaton->neighborhoodProgram != NULL) {
+		neighborCount = interpretNeighborhood(interpreter, grid, x, y);
+		neighbors = interpreter->neighbors;
+	}
+	unsigned int alive = 0;
+	for (unsigned int k = 0; k < neighborCount; ++k) {
+		if (readCell(automaton, grid, x + neighbors[k].x, y + neighbors[k].y) == ALIVE_STATE) {
+			++alive;
+		}
+	}
+	return alive;
+}
+
+static void _destroy(Engine * engine) {
+	ReferenceEngine * reference = engine->data;
+	destroyInterpreter(reference->interpreter);
+	destroyGrid(reference->current);
+	destroyGrid(reference->next);
+	free(reference);
+	free(engine);
+}
+
+static void _load(Engine * engine, const Grid * grid) {
+	ReferenceEngine * reference = engine->data;
+	copyGrid(reference->current, grid);
+}
+
+static void _store(Engine * engine, Grid * grid) {
+	ReferenceEngine * reference = engine->data;
+	copyGrid(grid, reference->current);
+}
+
+/* PUBLIC FUNCTIONS */
+
+Engine * createReferenceEngine(const Automaton * automaton) {
+	ReferenceEngine * reference = calloc(1, sizeof(ReferenceEngine));
+	reference->interpreter = createInterpreter(automaton);
+	reference->current = createGrid(automaton->width, automaton->height);
+	reference->next = createGrid(automaton->width, automaton->height);
+	Engine * engine = calloc(1, sizeof(Engine));
+	engine->name = "reference";
+	engine->automaton = automaton;
+	engine->data = reference;
+	engine->load = _load;
+	engine->advance = _advance;
+	engine->store = _store;
+	engine->destroy = _destroy;
+	return engine;
+}
+
+void stepReference(Interpreter * interpreter, const Grid * current, Grid * next) {
+	const Automaton * automaton = interpreter->automaton;
+	if (automaton->rule == STATIC_RULE) {
+		copyGrid(next, current);
+		return;
+	}
+	for (unsigned int y = 0; y < current->height; ++y) {
+		for (unsigned int x = 0; x < current->width; ++x) {
+			const size_t index = (size_t) y * current->width + x;
+			if (automaton->rule == TRANSITION_RULE) {
+				next->cells[index] = interpretTransition(interpreter, current, x, y);
+			}
+			else {
+				next->cells[index] = evolve(automaton, current->cells[index], _countAliveNeighbors(interpreter, current, x, y));
+			}
+		}
+	}
+}
@@ -0,0 +1,24 @@
+#ifndef REFERENCE_ENGINE_HEADER
+#define REFERENCE_ENGINE_HEADER
+
+#include "Automaton.h"
+#include "Engine.h"
+#include "Grid.h"
+#include "Interpreter.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * Creates an engine that computes every generation cell by cell, with the
+ * interpreter. It's the slowest engine, but also the simplest one, so every
+ * other engine is validated against it. It supports any automaton.
+ */
+Engine * createReferenceEngine(const Automaton * automaton);
+
+/**
+ * Computes the next generation of a grid, cell by cell, interpreting the
+ * programs of the automaton directly.
+ */
+void stepReference(Interpreter * interpreter, const Grid * current, Grid * next);
+
+#endif
@@ -0,0 +1,222 @@
+#include "Simulation.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeSimulationModule() {
+	_logger = createLogger("Simulation");
+}
+
+void shutdownSimulationModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static Engine * _createEngine(const Automaton * automaton, const SimulationParameters parameters, const Grid * grid);
+static double _now(void);
+static boolean _record(Engine * engine, const SimulationParameters parameters, const Grid * initial);
+static boolean _validate(const Automaton * automaton, const SimulationParameters parameters, const Grid * initial, const Grid * last);
+
+/**
+ * Creates the engine with the specified name ("auto" selects the fastest one
+ * that supports the automaton, and the sparse engine if the density of the
+ * initial grid is below its threshold). If it doesn't exist, or it doesn't
+ * support the automaton, creates the reference engine.
+ */
+static Engine * _createEngine(const Automaton * automaton, const SimulationParameters parameters, const Grid * grid) {
+	const char * name = parameters.engine;
+	const boolean isAutomatic = strcmp(name, "auto") == 0;
+	if (strcmp(name, "reference") == 0) {
+		return createReferenceEngine(automaton);
+	}
+	const boolean isLong = HASHLIFE_MINIMUM_GENERATIONS <= parameters.generations;
+	if (((isAutomatic && isLong) || strcmp(name, "hashlife") == 0) && isHashLifeable(automaton) && !parameters.unbounded) {
+		return createHashLifeEngine(automaton);
+	}
+	if ((isAutomatic || parameters.unbounded || strcmp(name, "sparse") == 0) && isSparse(automaton)) {
+		const size_t cells = (size_t) grid->width * grid->height;
+		const double density = (double) (cells - countCells(grid, getBackgroundState(automaton))) / cells;
+		if (!isAutomatic || parameters.unbounded || density < getSparseDensityThreshold()) {
+			return createSparseEngine(automaton, parameters.unbounded);
+		}
+	}
+	if ((isAutomatic || strcmp(name, "bit-packed") == 0) && isBitPackable(automaton)) {
+		return createBitPackedEngine(automaton, parameters.threads);
+	}
+	if (isAutomatic || strcmp(name, "lookup") == 0) {
+		LookupTable * table = createLookupTable(automaton);
+		if (table != NULL) {
+			return createLookupEngine(automaton, table, parameters.threads);
+		}
+	}
+	if (isAutomatic || strcmp(name, "vector") == 0) {
+		VectorProgram * program = compileVectorProgram(automaton);
+		if (program != NULL) {
+			return createVectorEngine(automaton, program, parameters.threads);
+		}
+	}
+	if (strcmp(name, "native") == 0) {
+		Engine * native = createNativeEngine(automaton, parameters.threads);
+		if (native != NULL) {
+			return native;
+		}
+		logWarning(_logger, "The native engine is unavailable, so the bytecode engine is used instead.");
+	}
+	if (isAutomatic || strcmp(name, "bytecode") == 0 || strcmp(name, "native") == 0) {
+		return createBytecodeEngine(automaton, parameters.threads);
+	}
+	logWarning(_logger, "The engine \"%s\" doesn't exist, or it doesn't support this automaton.", name);
+	return createReferenceEngine(automaton);
+}
+
+/**
+ * The current time of a monotonic clock, in seconds.
+ */
+static double _now(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/**
+ * Advances an engine from the initial grid, recording every frame (and the
+ * last generation, even if it's not a multiple of the interval). Every frame
+ * is stored straight into a buffer of the recorder, and then encoded and
+ * written by its threads, while the engine advances. Returns false if the
+ * recording failed.
+ */
+static boolean _record(Engine * engine, const SimulationParameters parameters, const Grid * initial) {
+	const Automaton * automaton = engine->automaton;
+	Recorder * recorder = createRecorder(automaton, parameters.output, parameters.outputInterval, parameters.keyframeInterval,
+		parameters.outputQueue, parameters.outputDrops);
+	if (recorder == NULL) {
+		engine->advance(engine, parameters.generations);
+		return false;
+	}
+	boolean isRecorded = recordFrame(recorder, initial, 0);
+	for (uint64_t generation = 0; generation < parameters.generations; ) {
+		const uint64_t remaining = parameters.generations - generation;
+		const uint64_t step = parameters.outputInterval < remaining ? parameters.outputInterval : remaining;
+		engine->advance(engine, step);
+		generation += step;
+		RecordingFrame * frame = acquireFrame(recorder, generation < parameters.generations);
+		if (frame != NULL) {
+			engine->store(engine, frame->grid);
+			isRecorded &= submitFrame(recorder, frame, generation);
+		}
+	}
+	const uint64_t frames = recorder->frames;
+	const uint64_t dropped = recorder->dropped;
+	isRecorded &= destroyRecorder(recorder);
+	if (isRecorded) {
+		logInformation(_logger, "Recorded %llu frames into \"%s\".", (unsigned long long) frames, parameters.output);
+	}
+	if (0 < dropped) {
+		logWarning(_logger, "Dropped %llu frames, since the recording couldn't keep up (see SIMULATION_OUTPUT_QUEUE).",
+			(unsigned long long) dropped);
+	}
+	return isRecorded;
+}
+
+/**
+ * Runs the reference engine from the initial grid, and compares its last
+ * generation with the one of another engine.
+ */
+static boolean _validate(const Automaton * automaton, const SimulationParameters parameters, const Grid * initial, const Grid * last) {
+	Engine * reference = createReferenceEngine(automaton);
+	Grid * expected = createGrid(automaton->width, automaton->height);
+	reference->load(reference, initial);
+	reference->advance(reference, parameters.generations);
+	reference->store(reference, expected);
+	const boolean isValid = equalGrids(expected, last);
+	if (isValid) {
+		logInformation(_logger, "The last generation matches the one of the reference engine.");
+	}
+	else {
+		logError(_logger, "The last generation differs from the one of the reference engine (hash %016llx).",
+			(unsigned long long) hashGrid(expected));
+	}
+	destroyGrid(expected);
+	reference->destroy(reference);
+	return isValid;
+}
+
+/* PUBLIC FUNCTIONS */
+
+SimulationParameters getSimulationParameters() {
+	const int threads = getIntegerOrDefault("SIMULATION_THREADS", 0);
+	const uint64_t outputInterval = getUnsignedLongOrDefault("SIMULATION_OUTPUT_INTERVAL", 1);
+	const int keyframeInterval = getIntegerOrDefault("SIMULATION_KEYFRAME_INTERVAL", DEFAULT_RECORDING_KEYFRAME_INTERVAL);
+	const int outputQueue = getIntegerOrDefault("SIMULATION_OUTPUT_QUEUE", DEFAULT_RECORDING_QUEUE);
+	SimulationParameters parameters = {
+		.generations = getUnsignedLongOrDefault("SIMULATION_GENERATIONS", 0),
+		.seed = (uint64_t) getIntegerOrDefault("SIMULATION_SEED", 1),
+		.engine = getStringOrDefault("SIMULATION_ENGINE", "auto"),
+		.validate = getBooleanOrDefault("SIMULATION_VALIDATE", false),
+		.threads = threads < 0 ? 0 : (unsigned int) threads,
+		.density = getDoubleOrDefault("SIMULATION_DENSITY", 1.0),
+		.unbounded = getBooleanOrDefault("SIMULATION_UNBOUNDED", false),
+		.output = NULL,
+		.outputInterval = outputInterval == 0 ? 1 : outputInterval,
+		.keyframeInterval = keyframeInterval < 1 ? 1 : (unsigned int) keyframeInterval,
+		.outputQueue = outputQueue < 1 ? 1 : (unsigned int) outputQueue,
+		.outputDrops = getBooleanOrDefault("SIMULATION_OUTPUT_DROP", false)
+	};
+	return parameters;
+}
+
+SimulationResult simulate(const Automaton * automaton, const SimulationParameters parameters) {
+	SimulationResult result = {
+		.succeed = true,
+		.generations = parameters.generations,
+		.seconds = 0,
+		.hash = 0
+	};
+	if (parameters.generations == 0) {
+		return result;
+	}
+	Grid * grid = createGrid(automaton->width, automaton->height);
+	randomizeGrid(grid, automaton->states, parameters.seed);
+	if (parameters.density < 1.0) {
+		thinGrid(grid, getBackgroundState(automaton), parameters.density, parameters.seed);
+	}
+	Engine * engine = _createEngine(automaton, parameters, grid);
+	engine->load(engine, grid);
+	logDebugging(_logger, "Simulating %llu generations of %ux%u cells on the %s engine...",
+		(unsigned long long) parameters.generations, automaton->width, automaton->height, engine->name);
+	const double start = _now();
+	if (parameters.output == NULL) {
+		engine->advance(engine, parameters.generations);
+	}
+	else {
+		result.succeed = _record(engine, parameters, grid);
+	}
+	result.seconds = _now() - start;
+	Grid * last = createGrid(automaton->width, automaton->height);
+	engine->store(engine, last);
+	result.hash = hashGrid(last);
+	const double cells = (double) automaton->width * automaton->height * parameters.generations;
+	logInformation(_logger, "%llu generations of %ux%u cells on the %s engine in %.3f s: %.1f generations/s (%.2f million cells/s), final hash %016llx.",
+		(unsigned long long) parameters.generations, automaton->width, automaton->height, engine->name, result.seconds,
+		parameters.generations / result.seconds, cells / result.seconds / 1e6, (unsigned long long) result.hash);
+	if (engine->tiles != NULL) {
+		const uint64_t tiles = engine->tiles->totalComputed + engine->tiles->totalSkipped;
+		logInformation(_logger, "Computed %llu tiles, and skipped %llu (%.1f%%).",
+			(unsigned long long) engine->tiles->totalComputed, (unsigned long long) engine->tiles->totalSkipped,
+			tiles == 0 ? 0.0 : 100.0 * engine->tiles->totalSkipped / tiles);
+	}
+	if (parameters.validate && parameters.unbounded) {
+		logWarning(_logger, "An unbounded universe can't be validated against the reference engine.");
+	}
+	else if (parameters.validate && strcmp(engine->name, "reference") != 0) {
+		result.succeed &= _validate(automaton, parameters, grid, last);
+	}
+	engine->destroy(engine);
+	destroyGrid(last);
+	destroyGrid(grid);
+	return result;
+}
@@ -0,0 +1,104 @@
+#ifndef SIMULATION_HEADER
+#define SIMULATION_HEADER
+
+#include "../../shared/Environment.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "Automaton.h"
+#include "BitPackedEngine.h"
+#include "BytecodeEngine.h"
+#include "Engine.h"
+#include "Grid.h"
+#include "HashLifeEngine.h"
+#include "LookupEngine.h"
+#include "NativeEngine.h"
+#include "Recorder.h"
+#include "ReferenceEngine.h"
+#include "SparseEngine.h"
+#include "VectorEngine.h"
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+/** Initialize module's internal state. */
+void initializeSimulationModule();
+
+/** Shutdown module's internal state. */
+void shutdownSimulationModule();
+
+/**
+ * The parameters of a simulation, taken from the environment:
+ *
+ *	- SIMULATION_GENERATIONS: the amount of generations (0 by default, that
+ *	  is, no simulation at all).
+ *	- SIMULATION_SEED: the seed of the initial (random) grid.
+ *	- SIMULATION_ENGINE: the engine to use ("auto" by default, that is, the
+ *	  fastest one that supports the automaton).
+ *	- SIMULATION_VALIDATE: if "true", the last generation is compared with
+ *	  the one of the reference engine.
+ *	- SIMULATION_THREADS: the amount of threads of an engine (0 by default,
+ *	  that is, one per processor). The reference engine is always
+ *	  single-threaded.
+ *	- SIMULATION_DENSITY: the fraction of cells of the initial grid that
+ *	  aren't in the background state (1 by default).
+ *	- SIMULATION_UNBOUNDED: if "true", an open universe grows past the
+ *	  declared grid (on the sparse engine, the only one that supports it).
+ *	- SIMULATION_OUTPUT_INTERVAL: the generations from a recorded frame to
+ *	  the next one (1 by default), if the simulation is recorded (see
+ *	  "getRecordingOutput"). The engine advances them at once, so the
+ *	  generations in between are never stored.
+ *	- SIMULATION_KEYFRAME_INTERVAL: the recorded frames from a keyframe to
+ *	  the next one (see DEFAULT_RECORDING_KEYFRAME_INTERVAL).
+ *	- SIMULATION_OUTPUT_QUEUE: the recorded frames that can wait to be
+ *	  encoded and written (see DEFAULT_RECORDING_QUEUE), before the
+ *	  simulation waits for them. There is a single encoder thread (and its
+ *	  amount is not configurable), since every delta is encoded against the
+ *	  previous frame, so the frames are encoded one after another, in order.
+ *	- SIMULATION_OUTPUT_DROP: if "true", the simulation never waits for the
+ *	  recording, and drops the frames while the queue is full instead (but
+ *	  never the last generation).
+ *
+ * The path of the recording ("output") is not taken from the environment,
+ * since it depends on the program (NULL by default, that is, nothing is
+ * recorded).
+ */
+typedef struct {
+	uint64_t generations;
+	uint64_t seed;
+	const char * engine;
+	boolean validate;
+	unsigned int threads;
+	double density;
+	boolean unbounded;
+	const char * output;
+	uint64_t outputInterval;
+	unsigned int keyframeInterval;
+	unsigned int outputQueue;
+	boolean outputDrops;
+} SimulationParameters;
+
+/**
+ * The outcome of a simulation.
+ */
+typedef struct {
+	boolean succeed;
+	uint64_t generations;
+	double seconds;
+	uint64_t hash;
+} SimulationResult;
+
+/**
+ * Reads the parameters of a simulation from the environment.
+ */
+SimulationParameters getSimulationParameters();
+
+/**
+ * Runs an automaton for the specified amount of generations, on the selected
+ * engine, recording them if there is an output. Reports the throughput in
+ * generations per second, and the hash of the last generation. The
+ * simulation fails if the validation against the reference engine (or the
+ * recording) fails.
+ */
+SimulationResult simulate(const Automaton * automaton, const SimulationParameters parameters);
+
+#endif
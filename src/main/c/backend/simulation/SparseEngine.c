@@ -0,0 +1,321 @@
+#include "SparseEngine.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeSparseEngineModule() {
+	_logger = createLogger("SparseEngine");
+}
+
+void shutdownSparseEngineModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/**
+ * The key of an empty slot: the packed coordinates of (INT32_MAX,
+ * INT32_MAX), that no cell can reach.
+ */
+#define SPARSE_EMPTY_KEY UINT64_MAX
+
+/**
+ * Flips the sign bit of both coordinates, so (-1, -1) isn't the empty key.
+ */
+#define SPARSE_KEY_BIAS UINT64_C(0x8000000080000000)
+
+/**
+ * The minimum amount of slots of a map (a power of two).
+ */
+#define SPARSE_MINIMUM_CAPACITY 64
+
+/**
+ * A hash map from the packed coordinates of a cell to a value (its state,
+ * or its amount of alive neighbors), with open addressing and linear
+ * probing. It's kept at most half full.
+ */
+typedef struct {
+	uint64_t * keys;
+	uint32_t * values;
+	size_t capacity;
+	size_t size;
+} SparseMap;
+
+/**
+ * The state of a sparse engine: the cells that aren't dead, the counters of
+ * the cells with alive neighbors, and the cells of the next generation.
+ */
+typedef struct {
+	const Automaton * automaton;
+	boolean isUnbounded;
+	SparseMap cells;
+	SparseMap counts;
+	SparseMap next;
+	uint64_t generation;
+} SparseEngine;
+
+/* PRIVATE FUNCTIONS */
+
+static void _addToMap(SparseMap * map, const uint64_t key, const uint32_t value);
+static void _advance(Engine * engine, const uint64_t generations);
+static void _clearMap(SparseMap * map, const size_t expected);
+static void _destroy(Engine * engine);
+static void _destroyMap(SparseMap * map);
+static size_t _findSlot(const SparseMap * map, const uint64_t key);
+static uint32_t _getFromMap(const SparseMap * map, const uint64_t key, const uint32_t defaultValue);
+static void _growMap(SparseMap * map, const size_t capacity);
+static size_t _hash(const uint64_t key);
+static boolean _isInside(const SparseEngine * sparse, const int64_t x, const int64_t y);
+static void _load(Engine * engine, const Grid * grid);
+static uint64_t _pack(const int64_t x, const int64_t y);
+static void _step(SparseEngine * sparse);
+static void _store(Engine * engine, Grid * grid);
+static void _unpack(const uint64_t key, int64_t * x, int64_t * y);
+
+/**
+ * Adds a value to the one of a key (or inserts it, if it's not in the map).
+ */
+static void _addToMap(SparseMap * map, const uint64_t key, const uint32_t value) {
+	if (map->capacity <= 2 * (map->size + 1)) {
+		_growMap(map, 2 * map->capacity);
+	}
+	const size_t slot = _findSlot(map, key);
+	if (map->keys[slot] == SPARSE_EMPTY_KEY) {
+		map->keys[slot] = key;
+		map->values[slot] = value;
+		++map->size;
+	}
+	else {
+		map->values[slot] += value;
+	}
+}
+
+static void _advance(Engine * engine, const uint64_t generations) {
+	SparseEngine * sparse = engine->data;
+	for (uint64_t generation = 0; generation < generations; ++generation) {
+		_step(sparse);
+	}
+}
+
+/**
+ * Empties a map, resizing it for an expected amount of keys (it still grows
+ * if there are more), so its memory follows the amount of cells.
+ */
+static void _clearMap(SparseMap * map, const size_t expected) {
+	size_t capacity = SPARSE_MINIMUM_CAPACITY;
+	while (capacity <= 2 * expected) {
+		capacity *= 2;
+	}
+	if (map->capacity < capacity || 4 * capacity < map->capacity) {
+		free(map->keys);
+		free(map->values);
+		map->keys = malloc(capacity * sizeof(uint64_t));
+		map->values = malloc(capacity * sizeof(uint32_t));
+		map->capacity = capacity;
+	}
+	memset(map->keys, 0xFF, map->capacity * sizeof(uint64_t));
+	map->size = 0;
+}
+
+static void _destroy(Engine * engine) {
+	SparseEngine * sparse = engine->data;
+	_destroyMap(&sparse->cells);
+	_destroyMap(&sparse->counts);
+	_destroyMap(&sparse->next);
+	free(sparse);
+	free(engine);
+}
+
+static void _destroyMap(SparseMap * map) {
+	free(map->keys);
+	free(map->values);
+}
+
+/**
+ * The slot of a key, or the empty slot where it would be inserted.
+ */
+static size_t _findSlot(const SparseMap * map, const uint64_t key) {
+	const size_t mask = map->capacity - 1;
+	size_t slot = _hash(key) & mask;
+	while (map->keys[slot] != key && map->keys[slot] != SPARSE_EMPTY_KEY) {
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+static uint32_t _getFromMap(const SparseMap * map, const uint64_t key, const uint32_t defaultValue) {
+	const size_t slot = _findSlot(map, key);
+	return map->keys[slot] == SPARSE_EMPTY_KEY ? defaultValue : map->values[slot];
+}
+
+/**
+ * Moves the keys of a map into a bigger one.
+ */
+static void _growMap(SparseMap * map, const size_t capacity) {
+	SparseMap grown = {
+		.keys = malloc(capacity * sizeof(uint64_t)),
+		.values = malloc(capacity * sizeof(uint32_t)),
+		.capacity = capacity,
+		.size = map->size
+	};
+	memset(grown.keys, 0xFF, capacity * sizeof(uint64_t));
+	for (size_t slot = 0; slot < map->capacity; ++slot) {
+		if (map->keys[slot] != SPARSE_EMPTY_KEY) {
+			const size_t grownSlot = _findSlot(&grown, map->keys[slot]);
+			grown.keys[grownSlot] = map->keys[slot];
+			grown.values[grownSlot] = map->values[slot];
+		}
+	}
+	_destroyMap(map);
+	*map = grown;
+}
+
+/**
+ * The finalizer of SplitMix64 (see "Grid.c"), since the coordinates of
+ * nearby cells only differ in their lowest bits.
+ */
+static size_t _hash(const uint64_t key) {
+	uint64_t hash = (key ^ (key >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+	hash = (hash ^ (hash >> 27)) * UINT64_C(0x94D049BB133111EB);
+	return (size_t) (hash ^ (hash >> 31));
+}
+
+static boolean _isInside(const SparseEngine * sparse, const int64_t x, const int64_t y) {
+	return 0 <= x && x < sparse->automaton->width && 0 <= y && y < sparse->automaton->height;
+}
+
+static void _load(Engine * engine, const Grid * grid) {
+	SparseEngine * sparse = engine->data;
+	_clearMap(&sparse->cells, grid->width * (size_t) grid->height - countCells(grid, DEAD_STATE));
+	for (unsigned int y = 0; y < grid->height; ++y) {
+		for (unsigned int x = 0; x < grid->width; ++x) {
+			const uint8_t state = grid->cells[(size_t) y * grid->width + x];
+			if (state != DEAD_STATE) {
+				_addToMap(&sparse->cells, _pack(x, y), state);
+			}
+		}
+	}
+	sparse->generation = 0;
+	logDebugging(_logger, "Loaded %zu cells (a density of %.4f%%).",
+		sparse->cells.size, 100.0 * sparse->cells.size / ((double) grid->width * grid->height));
+}
+
+static uint64_t _pack(const int64_t x, const int64_t y) {
+	return (((uint64_t) (uint32_t) x << 32) | (uint32_t) y) ^ SPARSE_KEY_BIAS;
+}
+
+/**
+ * Computes the next generation. Every cell that isn't dead is counted (with
+ * zero alive neighbors, at least), and every alive one adds itself to the
+ * cells that read it (i.e., the ones at minus its neighbor offsets).
+ */
+static void _step(SparseEngine * sparse) {
+	const Automaton * automaton = sparse->automaton;
+	SparseMap * cells = &sparse->cells;
+	SparseMap * counts = &sparse->counts;
+	_clearMap(counts, 4 * cells->size);
+	for (size_t slot = 0; slot < cells->capacity; ++slot) {
+		const uint64_t key = cells->keys[slot];
+		if (key == SPARSE_EMPTY_KEY) {
+			continue;
+		}
+		_addToMap(counts, key, 0);
+		if (cells->values[slot] == ALIVE_STATE) {
+			int64_t x;
+			int64_t y;
+			_unpack(key, &x, &y);
+			for (unsigned int k = 0; k < automaton->neighborCount; ++k) {
+				_addToMap(counts, _pack(x - automaton->neighbors[k].x, y - automaton->neighbors[k].y), 1);
+			}
+		}
+	}
+	SparseMap * next = &sparse->next;
+	_clearMap(next, cells->size);
+	for (size_t slot = 0; slot < counts->capacity; ++slot) {
+		const uint64_t key = counts->keys[slot];
+		if (key == SPARSE_EMPTY_KEY) {
+			continue;
+		}
+		if (!sparse->isUnbounded) {
+			int64_t x;
+			int64_t y;
+			_unpack(key, &x, &y);
+			if (!_isInside(sparse, x, y)) {
+				continue;
+			}
+		}
+		const uint8_t state = evolve(automaton, (uint8_t) _getFromMap(cells, key, DEAD_STATE), counts->values[slot]);
+		if (state != DEAD_STATE) {
+			_addToMap(next, key, state);
+		}
+	}
+	SparseMap swap = *cells;
+	*cells = *next;
+	*next = swap;
+	logDebugging(_logger, "Generation %llu: %zu cells, from %zu counted.",
+		(unsigned long long) ++sparse->generation, cells->size, counts->size);
+}
+
+static void _store(Engine * engine, Grid * grid) {
+	SparseEngine * sparse = engine->data;
+	memset(grid->cells, DEAD_STATE, (size_t) grid->width * grid->height);
+	size_t outside = 0;
+	for (size_t slot = 0; slot < sparse->cells.capacity; ++slot) {
+		const uint64_t key = sparse->cells.keys[slot];
+		if (key == SPARSE_EMPTY_KEY) {
+			continue;
+		}
+		int64_t x;
+		int64_t y;
+		_unpack(key, &x, &y);
+		if (_isInside(sparse, x, y)) {
+			grid->cells[(size_t) y * grid->width + x] = (uint8_t) sparse->cells.values[slot];
+		}
+		else {
+			++outside;
+		}
+	}
+	if (0 < outside) {
+		logInformation(_logger, "%zu of %zu cells are outside the grid.", outside, sparse->cells.size);
+	}
+}
+
+static void _unpack(const uint64_t key, int64_t * x, int64_t * y) {
+	const uint64_t coordinates = key ^ SPARSE_KEY_BIAS;
+	*x = (int32_t) (uint32_t) (coordinates >> 32);
+	*y = (int32_t) (uint32_t) coordinates;
+}
+
+/* PUBLIC FUNCTIONS */
+
+boolean isSparse(const Automaton * automaton) {
+	return automaton->rule == EVOLUTION_RULE
+		&& automaton->frontier == OPEN
+		&& automaton->neighborhoodProgram == NULL
+		&& (automaton->ruleSize == 0 || !automaton->born[0]);
+}
+
+double getSparseDensityThreshold() {
+	return getDoubleOrDefault("SPARSE_DENSITY_THRESHOLD", DEFAULT_SPARSE_DENSITY_THRESHOLD);
+}
+
+Engine * createSparseEngine(const Automaton * automaton, const boolean isUnbounded) {
+	SparseEngine * sparse = calloc(1, sizeof(SparseEngine));
+	sparse->automaton = automaton;
+	sparse->isUnbounded = isUnbounded;
+	_clearMap(&sparse->cells, 0);
+	_clearMap(&sparse->counts, 0);
+	_clearMap(&sparse->next, 0);
+	logDebugging(_logger, "Simulating %s universe.", isUnbounded ? "an unbounded" : "a bounded");
+	Engine * engine = calloc(1, sizeof(Engine));
+	engine->name = "sparse";
+	engine->automaton = automaton;
+	engine->data = sparse;
+	engine->tiles = NULL;
+	engine->load = _load;
+	engine->advance = _advance;
+	engine->store = _store;
+	engine->destroy = _destroy;
+	return engine;
+}
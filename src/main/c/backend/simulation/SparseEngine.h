@@ -0,0 +1,50 @@
+#ifndef SPARSE_ENGINE_HEADER
+#define SPARSE_ENGINE_HEADER
+
+#include "../../shared/Environment.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "Automaton.h"
+#include "Engine.h"
+#include "Grid.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeSparseEngineModule();
+
+/** Shutdown module's internal state. */
+void shutdownSparseEngineModule();
+
+/**
+ * The default density (the fraction of cells that aren't in the background
+ * state) below which the "auto" engine prefers the sparse engine,
+ * overridable with the "SPARSE_DENSITY_THRESHOLD" environment variable.
+ */
+#define DEFAULT_SPARSE_DENSITY_THRESHOLD 0.003
+
+/**
+ * Whether an automaton can run on the sparse engine: an evolution on an
+ * open frontier, with a fixed neighborhood (i.e., not computed by a
+ * program), where a dead cell without alive neighbors stays dead.
+ */
+boolean isSparse(const Automaton * automaton);
+
+/**
+ * The density threshold of the sparse engine, from the environment.
+ */
+double getSparseDensityThreshold();
+
+/**
+ * Creates an engine that only stores the cells that aren't dead, in an
+ * open-addressing hash map keyed by their packed coordinates, so its memory
+ * and time scale with the alive cells instead of the grid. Every generation,
+ * the alive cells add themselves to the counters of their neighbors, and
+ * only the counted cells are evolved. If unbounded, the cells can leave the
+ * declared grid (which is just the window that is loaded and stored);
+ * otherwise, they are clipped to it, like on any other engine.
+ */
+Engine * createSparseEngine(const Automaton * automaton, const boolean isUnbounded);
+
+#endif
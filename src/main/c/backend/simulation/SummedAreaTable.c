@@ -0,0 +1,69 @@
+#include "SummedAreaTable.h"
+
+/* PRIVATE FUNCTIONS */
+
+static void _sumRow(SummedAreaTable * table, const int y);
+static void _sumRows(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow);
+
+/**
+ * Sums the cells in the state of a row of the grid (from the halo on the
+ * left), into the next row of the table.
+ */
+static void _sumRow(SummedAreaTable * table, const int y) {
+	const int halo = (int) table->halo;
+	const uint8_t * cells = table->grid->cells + (ptrdiff_t) y * (ptrdiff_t) table->grid->stride - halo;
+	uint32_t * sums = table->origin + (ptrdiff_t) (y + 1) * (ptrdiff_t) table->stride - halo;
+	const size_t width = table->grid->stride;
+	uint32_t sum = 0;
+	for (size_t x = 0; x < width; ++x) {
+		sum += cells[x] == table->state;
+		sums[x + 1] = sum;
+	}
+}
+
+/**
+ * Sums the rows of a band (and the rows of the halo above or below the
+ * grid, on the first and the last band).
+ */
+static void _sumRows(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow) {
+	SummedAreaTable * table = context;
+	const int halo = (int) table->halo;
+	const int first = firstRow == 0 ? -halo : (int) firstRow;
+	const int last = lastRow == table->height ? (int) lastRow + halo : (int) lastRow;
+	for (int y = first; y < last; ++y) {
+		_sumRow(table, y);
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+SummedAreaTable * createSummedAreaTable(const PaddedGrid * grid, const uint8_t state) {
+	SummedAreaTable * table = calloc(1, sizeof(SummedAreaTable));
+	table->state = state;
+	table->height = grid->height;
+	table->halo = grid->halo;
+	table->stride = SUMMED_AREA_STRIDE(grid->stride);
+	table->buffer = calloc((grid->height + 2 * (size_t) grid->halo + 1) * table->stride, sizeof(uint32_t));
+	table->origin = table->buffer + grid->halo * table->stride + grid->halo;
+	return table;
+}
+
+void destroySummedAreaTable(SummedAreaTable * table) {
+	if (table != NULL) {
+		free(table->buffer);
+		free(table);
+	}
+}
+
+void sumPaddedGrid(Bands * bands, SummedAreaTable * table, const PaddedGrid * grid) {
+	table->grid = grid;
+	runBands(bands, _sumRows, table);
+	const size_t rows = grid->height + 2 * (size_t) grid->halo + 1;
+	for (size_t k = 2; k < rows; ++k) {
+		uint32_t * restrict row = table->buffer + k * table->stride;
+		const uint32_t * restrict above = row - table->stride;
+		for (size_t x = 0; x < table->stride; ++x) {
+			row[x] += above[x];
+		}
+	}
+}
@@ -0,0 +1,61 @@
+#ifndef SUMMED_AREA_TABLE_HEADER
+#define SUMMED_AREA_TABLE_HEADER
+
+#include "../../shared/Type.h"
+#include "Bands.h"
+#include "PaddedGrid.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The stride of the rows of the summed-area table of a padded grid with the
+ * specified stride.
+ */
+#define SUMMED_AREA_STRIDE(stride) ((stride) + 1)
+
+/**
+ * The amount of cells in a state above and to the left of every cell of a
+ * padded grid (including its halo), so the amount in any rectangle of it is
+ * read from its four corners, no matter its size:
+ *
+ *	T(x1 + 1, y1 + 1) - T(x0, y1 + 1) - T(x1 + 1, y0) + T(x0, y0)
+ *
+ * for the rectangle [x0, x1] x [y0, y1], where T(x, y) is the entry at
+ * "origin[y * stride + x]". The sums wrap around (as unsigned integers), so
+ * the differences are exact on any grid.
+ */
+typedef struct {
+	uint8_t state;
+	unsigned int height;
+	unsigned int halo;
+	size_t stride;
+
+	// The whole buffer, and its entry at (0, 0) (the amount of cells in the
+	// halo above and to the left of the grid is always zero).
+	uint32_t * buffer;
+	uint32_t * origin;
+
+	// The grid being summed.
+	const PaddedGrid * grid;
+} SummedAreaTable;
+
+/**
+ * Creates the summed-area table of the cells in a state of a padded grid
+ * (or any other one with the same size and halo).
+ */
+SummedAreaTable * createSummedAreaTable(const PaddedGrid * grid, const uint8_t state);
+
+/**
+ * Destroys a summed-area table.
+ */
+void destroySummedAreaTable(SummedAreaTable * table);
+
+/**
+ * Rebuilds a summed-area table from a padded grid (whose halo must be
+ * filled). Every worker sums the rows of its band, and then the rows are
+ * accumulated downwards, in order.
+ */
+void sumPaddedGrid(Bands * bands, SummedAreaTable * table, const PaddedGrid * grid);
+
+#endif
@@ -0,0 +1,150 @@
+#include "VectorEngine.h"
+
+/**
+ * The state of a vector engine: the vector program, a register file per
+ * worker, the current generation and the buffer of the next one, padded
+ * with a halo as wide as the bounding box of the static offsets of the
+ * program (that is also used to skip the quiescent tiles, if the program
+ * reads no cell outside of it), and the summed-area tables of the current
+ * generation that the program reads.
+ */
+typedef struct {
+	const Automaton * automaton;
+	VectorProgram * program;
+	Bands * bands;
+	ActiveTiles * tiles;
+	int32_t ** registers;
+	PaddedGrid * current;
+	PaddedGrid * next;
+	SummedAreaTable ** tables;
+} VectorEngine;
+
+/* PRIVATE FUNCTIONS */
+
+static void _advance(Engine * engine, const uint64_t generations);
+static void _destroy(Engine * engine);
+static void _load(Engine * engine, const Grid * grid);
+static void _stepBand(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow);
+static boolean _stepTile(void * context, const unsigned int worker,
+	const unsigned int firstColumn, const unsigned int lastColumn, const unsigned int firstRow, const unsigned int lastRow);
+static void _store(Engine * engine, Grid * grid);
+
+static void _advance(Engine * engine, const uint64_t generations) {
+	VectorEngine * vector = engine->data;
+	for (uint64_t generation = 0; generation < generations; ++generation) {
+		if (vector->tiles != NULL) {
+			prepareActiveTiles(vector->tiles);
+		}
+		fillHalo(vector->bands, vector->current);
+		for (unsigned int k = 0; k < vector->program->tableCount; ++k) {
+			sumPaddedGrid(vector->bands, vector->tables[k], vector->current);
+		}
+		runBands(vector->bands, _stepBand, vector);
+		PaddedGrid * swap = vector->current;
+		vector->current = vector->next;
+		vector->next = swap;
+	}
+}
+
+static void _destroy(Engine * engine) {
+	VectorEngine * vector = engine->data;
+	for (unsigned int k = 0; k < vector->bands->workers; ++k) {
+		free(vector->registers[k]);
+	}
+	free(vector->registers);
+	for (unsigned int k = 0; k < vector->program->tableCount; ++k) {
+		destroySummedAreaTable(vector->tables[k]);
+	}
+	free(vector->tables);
+	destroyVectorProgram(vector->program);
+	destroyBands(vector->bands);
+	destroyActiveTiles(vector->tiles);
+	destroyPaddedGrid(vector->current);
+	destroyPaddedGrid(vector->next);
+	free(vector);
+	free(engine);
+}
+
+static void _load(Engine * engine, const Grid * grid) {
+	VectorEngine * vector = engine->data;
+	loadPaddedGrid(vector->bands, vector->current, grid);
+	if (vector->tiles != NULL) {
+		resetActiveTiles(vector->tiles);
+	}
+}
+
+/**
+ * Computes the next generation of the rows of a band (only in the active
+ * tiles, if they are tracked).
+ */
+static void _stepBand(void * context, const unsigned int worker, const unsigned int firstRow, const unsigned int lastRow) {
+	VectorEngine * vector = context;
+	if (vector->tiles == NULL) {
+		_stepTile(vector, worker, 0, vector->current->width, firstRow, lastRow);
+	}
+	else {
+		runActiveTiles(vector->tiles, _stepTile, vector, worker, firstRow, lastRow);
+	}
+}
+
+/**
+ * Computes the next generation of a rectangle of cells, a slice of a row at
+ * a time.
+ */
+static boolean _stepTile(void * context, const unsigned int worker,
+		const unsigned int firstColumn, const unsigned int lastColumn, const unsigned int firstRow, const unsigned int lastRow) {
+	VectorEngine * vector = context;
+	const PaddedGrid * current = vector->current;
+	int32_t * registers = vector->registers[worker];
+	boolean changed = false;
+	for (unsigned int y = firstRow; y < lastRow; ++y) {
+		const uint8_t * cells = current->cells + (size_t) y * current->stride;
+		uint8_t * output = vector->next->cells + (size_t) y * current->stride;
+		for (unsigned int x = firstColumn; x < lastColumn; x += VECTOR_LANES) {
+			const unsigned int count = lastColumn - x < VECTOR_LANES ? lastColumn - x : VECTOR_LANES;
+			runVectorProgram(vector->program, registers, current, vector->tables, vector->automaton->states, (int) x, (int) y, count, output + x);
+			changed |= memcmp(output + x, cells + x, count) != 0;
+		}
+	}
+	return changed;
+}
+
+static void _store(Engine * engine, Grid * grid) {
+	VectorEngine * vector = engine->data;
+	storePaddedGrid(vector->bands, vector->current, grid);
+}
+
+/* PUBLIC FUNCTIONS */
+
+Engine * createVectorEngine(const Automaton * automaton, VectorProgram * program, const unsigned int threads) {
+	VectorEngine * vector = calloc(1, sizeof(VectorEngine));
+	vector->automaton = automaton;
+	vector->program = program;
+	const unsigned int tileSize = getActiveTileSize();
+	if (!program->isDynamic && 0 < tileSize) {
+		vector->tiles = createActiveTiles(automaton, tileSize, tileSize, program->minimum, program->maximum);
+	}
+	vector->bands = createBands(automaton->height, vector->tiles == NULL ? 1 : tileSize, threads);
+	vector->registers = calloc(vector->bands->workers, sizeof(int32_t *));
+	for (unsigned int k = 0; k < vector->bands->workers; ++k) {
+		vector->registers[k] = createVectorRegisters(program);
+	}
+	const unsigned int halo = getHaloWidth(program->minimum, program->maximum);
+	vector->current = createPaddedGrid(automaton, halo);
+	vector->next = createPaddedGrid(automaton, halo);
+	vector->tables = calloc(program->tableCount + 1, sizeof(SummedAreaTable *));
+	for (unsigned int k = 0; k < program->tableCount; ++k) {
+		vector->tables[k] = createSummedAreaTable(vector->current, (uint8_t) program->tableStates[k]);
+	}
+	setVectorProgramStride(program, vector->current->stride);
+	Engine * engine = calloc(1, sizeof(Engine));
+	engine->name = "vector";
+	engine->automaton = automaton;
+	engine->data = vector;
+	engine->tiles = vector->tiles;
+	engine->load = _load;
+	engine->advance = _advance;
+	engine->store = _store;
+	engine->destroy = _destroy;
+	return engine;
+}
@@ -0,0 +1,25 @@
+#ifndef VECTOR_ENGINE_HEADER
+#define VECTOR_ENGINE_HEADER
+
+#include "ActiveTiles.h"
+#include "Automaton.h"
+#include "Bands.h"
+#include "Engine.h"
+#include "Grid.h"
+#include "PaddedGrid.h"
+#include "SummedAreaTable.h"
+#include "VectorProgram.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Creates an engine that runs the rule of the automaton, lowered into a
+ * vector program (see "compileVectorProgram"), on slices of up to
+ * VECTOR_LANES cells of a row at once. The engine takes ownership of
+ * the program. The rows are split into bands, for the specified amount of
+ * threads (see "createBands").
+ */
+Engine * createVectorEngine(const Automaton * automaton, VectorProgram * program, const unsigned int threads);
+
+#endif
@@ -0,0 +1,927 @@
+#include "VectorProgram.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeVectorProgramModule() {
+	_logger = createLogger("VectorProgram");
+}
+
+void shutdownVectorProgramModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/**
+ * No register: an absent mask (i.e., every lane), or no value yet.
+ */
+#define NO_REGISTER (-1)
+
+/**
+ * An expression on the work stack of the compiler, that resumes at its next
+ * stage once an operand is compiled (keeping the reference to the first
+ * one in "operand").
+ */
+typedef struct {
+	ArithmeticExpression * expression;
+	unsigned int stage;
+	int32_t operand;
+} VectorFrame;
+
+/**
+ * The state of a compilation. Every register has the amount of references
+ * to its value (from the variables, the masks and the expressions being
+ * compiled), and it's free again when it has none, unless it's a constant
+ * or a static cell (which are loaded before the program runs).
+ */
+typedef struct {
+	const Automaton * automaton;
+	VectorProgram * program;
+
+	// The register of every symbol (the value of a variable).
+	int32_t * variables;
+
+	unsigned int * references;
+	boolean * isLoaded;
+	unsigned int registerCapacity;
+	int32_t * free;
+	unsigned int freeCount;
+
+	// The lanes that didn't return yet (NO_REGISTER if every lane), and
+	// whether every lane returned.
+	int32_t pending;
+	boolean isDone;
+
+	boolean isVectorizable;
+
+	VectorFrame * frames;
+	unsigned int frameCount;
+	unsigned int frameCapacity;
+} VectorCompiler;
+
+/* PRIVATE FUNCTIONS */
+
+static int32_t _active(VectorCompiler * compiler, const int32_t guard);
+static int32_t _allocate(VectorCompiler * compiler);
+static void _assign(VectorCompiler * compiler, int32_t * target, const int32_t value, const int32_t guard);
+static int _compareOffsets(const void * offset, const void * otherOffset);
+static int32_t _compileCell(VectorCompiler * compiler, Cell * cell);
+static int32_t _compileConstant(VectorCompiler * compiler, Constant * constant);
+static void _compileEvolution(VectorCompiler * compiler);
+static int32_t _compileExpression(VectorCompiler * compiler, ArithmeticExpression * expression);
+static void _compileLoop(VectorCompiler * compiler, TransitionExpression * expression, const int32_t guard);
+static int32_t _compileQuantifier(VectorCompiler * compiler, ArithmeticExpression * expression);
+static int32_t _compileRule(VectorCompiler * compiler, const int32_t alive, const boolean * rule);
+static void _compileSequence(VectorCompiler * compiler, TransitionSequence * sequence, const int32_t guard);
+static int32_t _constant(VectorCompiler * compiler, const int32_t value);
+static boolean _constantValue(VectorCompiler * compiler, Constant * constant, int * value);
+static int32_t _count(VectorCompiler * compiler, Offset * offsets, const unsigned int offsetCount, const int32_t state);
+static int32_t _emit(VectorCompiler * compiler, const VectorOpcode opcode, const int32_t a, const int32_t b, const int32_t c);
+static void _extend(VectorProgram * program, const Offset offset);
+static int32_t _newRegister(VectorCompiler * compiler, const boolean isLoaded);
+static void _pushFrame(VectorCompiler * compiler, ArithmeticExpression * expression);
+static void _release(VectorCompiler * compiler, const int32_t index);
+static void _retain(VectorCompiler * compiler, const int32_t index);
+static void _splitRectangles(VectorCounter * counter);
+static int32_t _staticCell(VectorCompiler * compiler, const Offset offset);
+static int32_t _table(VectorProgram * program, const int32_t state);
+
+/**
+ * The mask of the lanes where a statement runs: the ones of its guard that
+ * didn't return yet (or NO_REGISTER, if every lane). Returns a reference.
+ */
+static int32_t _active(VectorCompiler * compiler, const int32_t guard) {
+	if (guard == NO_REGISTER || compiler->pending == NO_REGISTER) {
+		const int32_t active = guard == NO_REGISTER ? compiler->pending : guard;
+		_retain(compiler, active);
+		return active;
+	}
+	return _emit(compiler, VECTOR_AND_OP, guard, compiler->pending, NO_REGISTER);
+}
+
+/**
+ * Allocates a temporary register, with a reference.
+ */
+static int32_t _allocate(VectorCompiler * compiler) {
+	const int32_t index = 0 < compiler->freeCount
+		? compiler->free[--compiler->freeCount]
+		: _newRegister(compiler, false);
+	compiler->references[index] = 1;
+	return index;
+}
+
+/**
+ * Assigns a value (taking its reference) to a variable (or the result), in
+ * the active lanes of a guard.
+ */
+static void _assign(VectorCompiler * compiler, int32_t * target, const int32_t value, const int32_t guard) {
+	const int32_t active = _active(compiler, guard);
+	if (active == NO_REGISTER) {
+		_release(compiler, *target);
+		*target = value;
+		return;
+	}
+	const int32_t selected = _emit(compiler, VECTOR_SELECT_OP, active, value, *target);
+	_release(compiler, active);
+	_release(compiler, value);
+	_release(compiler, *target);
+	*target = selected;
+}
+
+/**
+ * Orders the offsets in memory-access order (by row, and then by column).
+ */
+static int _compareOffsets(const void * offset, const void * otherOffset) {
+	const Offset * first = offset;
+	const Offset * second = otherOffset;
+	if (first->y != second->y) {
+		return first->y < second->y ? -1 : 1;
+	}
+	return first->x < second->x ? -1 : first->x > second->x;
+}
+
+/**
+ * Compiles a read of a cell: the register of its static offset, or a load
+ * at the offset computed in every lane.
+ */
+static int32_t _compileCell(VectorCompiler * compiler, Cell * cell) {
+	Offset offset;
+	if (resolveStaticOffset(compiler->automaton, cell, &offset)) {
+		return _staticCell(compiler, offset);
+	}
+	compiler->program->isDynamic = true;
+	int32_t x = NO_REGISTER;
+	int32_t y = NO_REGISTER;
+	if (cell->isSingleCoordenate) {
+		const int32_t displacement = _compileConstant(compiler, cell->displacement);
+		const int32_t zero = _constant(compiler, 0);
+		switch (cell->displacementType) {
+			case HORIZONTAL_D:
+				x = displacement;
+				y = zero;
+				break;
+			case VERTICAL_D:
+				x = zero;
+				y = displacement;
+				break;
+			case DIAGONAL_ASC_D:
+				x = displacement;
+				y = _emit(compiler, VECTOR_SUBTRACT_OP, zero, displacement, NO_REGISTER);
+				break;
+			case DIAGONAL_DESC_D:
+			default:
+				x = displacement;
+				y = displacement;
+				_retain(compiler, displacement);
+				break;
+		}
+	}
+	else {
+		x = _compileConstant(compiler, cell->x);
+		y = _compileConstant(compiler, cell->y);
+	}
+	const int32_t state = _emit(compiler, VECTOR_LOAD_DYNAMIC_OP, x, y, NO_REGISTER);
+	_release(compiler, x);
+	_release(compiler, y);
+	return state;
+}
+
+/**
+ * Compiles a constant: an integer, a state (i.e., its index), a variable
+ * or a cell. Returns a reference.
+ */
+static int32_t _compileConstant(VectorCompiler * compiler, Constant * constant) {
+	int value = 0;
+	if (_constantValue(compiler, constant, &value)) {
+		return _constant(compiler, value);
+	}
+	if (constant->type == STRING_C) {
+		const int32_t variable = compiler->variables[constant->symbol];
+		_retain(compiler, variable);
+		return variable;
+	}
+	return _compileCell(compiler, constant->cell);
+}
+
+/**
+ * Compiles an evolution: the next state of a cell is alive if the amount of
+ * its alive neighbors is in the survival rule (if it's alive) or in the
+ * birth rule (otherwise), and dead otherwise (see "evolve").
+ */
+static void _compileEvolution(VectorCompiler * compiler) {
+	const Automaton * automaton = compiler->automaton;
+	VectorProgram * program = compiler->program;
+	Offset * neighbors = calloc(automaton->neighborCount + 1, sizeof(Offset));
+	memcpy(neighbors, automaton->neighbors, automaton->neighborCount * sizeof(Offset));
+	const int32_t alive = _count(compiler, neighbors, automaton->neighborCount, ALIVE_STATE);
+	const int32_t survives = _compileRule(compiler, alive, automaton->survives);
+	const int32_t born = _compileRule(compiler, alive, automaton->born);
+	const int32_t isAlive = _emit(compiler, VECTOR_EQUAL_OP, _staticCell(compiler, (Offset) {0, 0}), _constant(compiler, ALIVE_STATE), NO_REGISTER);
+	const int32_t isNextAlive = _emit(compiler, VECTOR_SELECT_OP, isAlive, survives, born);
+	_release(compiler, isAlive);
+	_release(compiler, survives);
+	_release(compiler, born);
+	program->result = _emit(compiler, VECTOR_SELECT_OP, isNextAlive, _constant(compiler, ALIVE_STATE), _constant(compiler, DEAD_STATE));
+	_release(compiler, isNextAlive);
+	program->hasResult = true;
+	compiler->isDone = true;
+}
+
+/**
+ * Compiles an expression, with the semantics of the interpreter. Both
+ * operands of a logical operator are evaluated (the expressions never have
+ * side effects). The operands are compiled from a work stack, so the
+ * expressions can nest arbitrarily deep. Returns a reference.
+ */
+static int32_t _compileExpression(VectorCompiler * compiler, ArithmeticExpression * expression) {
+	const unsigned int base = compiler->frameCount;
+	int32_t result = NO_REGISTER;
+	_pushFrame(compiler, expression);
+	while (base < compiler->frameCount) {
+		VectorFrame * frame = &compiler->frames[compiler->frameCount - 1];
+		expression = frame->expression;
+		VectorOpcode opcode;
+		switch (expression->type) {
+			case ADDITION: opcode = VECTOR_ADD_OP; break;
+			case SUBTRACTION: opcode = VECTOR_SUBTRACT_OP; break;
+			case MULTIPLICATION: opcode = VECTOR_MULTIPLY_OP; break;
+			case DIVISION: opcode = VECTOR_DIVIDE_OP; break;
+			case MODULE: opcode = VECTOR_MODULO_OP; break;
+			case EQUALS: opcode = VECTOR_EQUAL_OP; break;
+			case NOT_EQUALS: opcode = VECTOR_NOT_EQUAL_OP; break;
+			case LOWER_THAN: opcode = VECTOR_LOWER_OP; break;
+			case LOWER_THAN_OR_EQUAL: opcode = VECTOR_LOWER_OR_EQUAL_OP; break;
+			case GREATER_THAN: opcode = VECTOR_GREATER_OP; break;
+			case GREATER_THAN_OR_EQUAL: opcode = VECTOR_GREATER_OR_EQUAL_OP; break;
+			case LOGIC_AND: opcode = VECTOR_AND_OP; break;
+			case LOGIC_OR: opcode = VECTOR_OR_OP; break;
+			case LOGIC_NOT:
+				if (frame->stage++ == 0) {
+					_pushFrame(compiler, expression->expression);
+				}
+				else {
+					const int32_t operand = result;
+					result = _emit(compiler, VECTOR_NOT_OP, operand, NO_REGISTER, NO_REGISTER);
+					_release(compiler, operand);
+					--compiler->frameCount;
+				}
+				continue;
+			case ALL_ARE:
+			case ANY_ARE:
+			case AT_LEAST_ARE:
+				result = _compileQuantifier(compiler, expression);
+				--compiler->frameCount;
+				continue;
+			case FACTOR:
+				if (frame->stage++ == 0) {
+					_pushFrame(compiler, expression->expression);
+				}
+				else {
+					--compiler->frameCount;
+				}
+				continue;
+			case CONSTANT:
+			default:
+				result = _compileConstant(compiler, expression->constant);
+				--compiler->frameCount;
+				continue;
+		}
+		if (frame->stage == 0) {
+			frame->stage = 1;
+			_pushFrame(compiler, expression->leftExpression);
+		}
+		else if (frame->stage == 1) {
+			frame->stage = 2;
+			frame->operand = result;
+			_pushFrame(compiler, expression->rightExpression);
+		}
+		else {
+			const int32_t left = frame->operand;
+			const int32_t right = result;
+			result = _emit(compiler, opcode, left, right, NO_REGISTER);
+			_release(compiler, left);
+			_release(compiler, right);
+			--compiler->frameCount;
+		}
+	}
+	return result;
+}
+
+/**
+ * Unrolls a loop: an array, or an interval with constant bounds that isn't
+ * too long (otherwise, the program can't be vectorized).
+ */
+static void _compileLoop(VectorCompiler * compiler, TransitionExpression * expression, const int32_t guard) {
+	Range * range = expression->range;
+	int32_t * variable = &compiler->variables[expression->forVariable];
+	if (range->type == ARRAY) {
+		for (unsigned int k = 0; k < range->array->count && !compiler->isDone; ++k) {
+			_assign(compiler, variable, _compileConstant(compiler, range->array->values[k]), guard);
+			_compileSequence(compiler, expression->forBody, guard);
+		}
+		return;
+	}
+	int start = 0;
+	int end = 0;
+	if (!_constantValue(compiler, range->start, &start) || !_constantValue(compiler, range->end, &end)
+			|| VECTOR_MAXIMUM_UNROLLED_ITERATIONS <= (start <= end ? (long) end - start : (long) start - end)) {
+		compiler->isVectorizable = false;
+		return;
+	}
+	const int step = start <= end ? 1 : -1;
+	for (int value = start; compiler->isVectorizable && !compiler->isDone; value += step) {
+		_assign(compiler, variable, _constant(compiler, value), guard);
+		_compileSequence(compiler, expression->forBody, guard);
+		if (value == end) {
+			break;
+		}
+	}
+}
+
+/**
+ * Compiles an "all", "any" or "at_least" predicate: from the counter of its
+ * cells, if they are at static offsets, or as a sum of comparisons.
+ */
+static int32_t _compileQuantifier(VectorCompiler * compiler, ArithmeticExpression * expression) {
+	const int32_t value = compiler->automaton->symbolStates[expression->state];
+	int32_t count = _constant(compiler, 0);
+	Offset * offsets = calloc(expression->cellList->count + 1, sizeof(Offset));
+	boolean isStatic = true;
+	for (unsigned int k = 0; k < expression->cellList->count && isStatic; ++k) {
+		isStatic = resolveStaticOffset(compiler->automaton, expression->cellList->cells[k], &offsets[k]);
+	}
+	if (isStatic) {
+		count = _count(compiler, offsets, expression->cellList->count, value);
+	}
+	else {
+		free(offsets);
+	}
+	const int32_t state = _constant(compiler, value);
+	for (unsigned int k = 0; k < expression->cellList->count && !isStatic; ++k) {
+		const int32_t cell = _compileCell(compiler, expression->cellList->cells[k]);
+		const int32_t isEqual = _emit(compiler, VECTOR_EQUAL_OP, cell, state, NO_REGISTER);
+		_release(compiler, cell);
+		if (k == 0) {
+			count = isEqual;
+			continue;
+		}
+		const int32_t sum = _emit(compiler, VECTOR_ADD_OP, count, isEqual, NO_REGISTER);
+		_release(compiler, count);
+		_release(compiler, isEqual);
+		count = sum;
+	}
+	const int32_t result = expression->type == ALL_ARE
+		? _emit(compiler, VECTOR_EQUAL_OP, count, _constant(compiler, (int32_t) expression->cellList->count), NO_REGISTER)
+		: _emit(compiler, VECTOR_GREATER_OR_EQUAL_OP, count, _constant(compiler, expression->count), NO_REGISTER);
+	_release(compiler, count);
+	return result;
+}
+
+/**
+ * Compiles the mask of the amounts of alive neighbors in a rule of an
+ * evolution, as the intervals of consecutive amounts in it.
+ */
+static int32_t _compileRule(VectorCompiler * compiler, const int32_t alive, const boolean * rule) {
+	const unsigned int size = compiler->automaton->ruleSize;
+	int32_t mask = NO_REGISTER;
+	for (unsigned int k = 0; k < size; ++k) {
+		if (!rule[k]) {
+			continue;
+		}
+		const unsigned int first = k;
+		while (k + 1 < size && rule[k + 1]) {
+			++k;
+		}
+		int32_t isInside;
+		if (first == k) {
+			isInside = _emit(compiler, VECTOR_EQUAL_OP, alive, _constant(compiler, (int32_t) k), NO_REGISTER);
+		}
+		else {
+			const int32_t isAbove = _emit(compiler, VECTOR_GREATER_OR_EQUAL_OP, alive, _constant(compiler, (int32_t) first), NO_REGISTER);
+			const int32_t isBelow = _emit(compiler, VECTOR_LOWER_OR_EQUAL_OP, alive, _constant(compiler, (int32_t) k), NO_REGISTER);
+			isInside = _emit(compiler, VECTOR_AND_OP, isAbove, isBelow, NO_REGISTER);
+			_release(compiler, isAbove);
+			_release(compiler, isBelow);
+		}
+		if (mask == NO_REGISTER) {
+			mask = isInside;
+			continue;
+		}
+		const int32_t isEither = _emit(compiler, VECTOR_OR_OP, mask, isInside, NO_REGISTER);
+		_release(compiler, mask);
+		_release(compiler, isInside);
+		mask = isEither;
+	}
+	return mask == NO_REGISTER ? _constant(compiler, 0) : mask;
+}
+
+/**
+ * Compiles a sequence in the lanes of a guard (or in every lane, if it's
+ * NO_REGISTER): conditionals narrow the guard, and returns remove their
+ * lanes from the pending ones.
+ */
+static void _compileSequence(VectorCompiler * compiler, TransitionSequence * sequence, const int32_t guard) {
+	for (unsigned int k = 0; k < sequence->count && compiler->isVectorizable && !compiler->isDone; ++k) {
+		TransitionExpression * expression = sequence->expressions[k];
+		int32_t condition;
+		int32_t thenGuard;
+		int32_t elseGuard;
+		switch (expression->type) {
+			case TRANSITION_ASSIGNMENT:
+				_assign(compiler, &compiler->variables[expression->variable], _compileExpression(compiler, expression->assignment), guard);
+				break;
+			case TRANSITION_FOR_LOOP:
+				_compileLoop(compiler, expression, guard);
+				break;
+			case TRANSITION_IF:
+				condition = _compileExpression(compiler, expression->ifCondition);
+				thenGuard = condition;
+				if (guard != NO_REGISTER) {
+					thenGuard = _emit(compiler, VECTOR_AND_OP, guard, condition, NO_REGISTER);
+					_release(compiler, condition);
+				}
+				_compileSequence(compiler, expression->ifBody, thenGuard);
+				_release(compiler, thenGuard);
+				break;
+			case TRANSITION_IF_ELSE:
+				condition = _compileExpression(compiler, expression->ifElseCondition);
+				if (guard == NO_REGISTER) {
+					thenGuard = condition;
+					elseGuard = _emit(compiler, VECTOR_NOT_OP, condition, NO_REGISTER, NO_REGISTER);
+				}
+				else {
+					thenGuard = _emit(compiler, VECTOR_AND_OP, guard, condition, NO_REGISTER);
+					elseGuard = _emit(compiler, VECTOR_AND_NOT_OP, guard, condition, NO_REGISTER);
+					_release(compiler, condition);
+				}
+				_compileSequence(compiler, expression->ifElseIfBody, thenGuard);
+				_release(compiler, thenGuard);
+				_compileSequence(compiler, expression->ifElseElseBody, elseGuard);
+				_release(compiler, elseGuard);
+				break;
+			case RETURN_VALUE:
+				_assign(compiler, &compiler->program->result, _compileExpression(compiler, expression->returnValue), guard);
+				compiler->program->hasResult = true;
+				if (guard == NO_REGISTER) {
+					compiler->isDone = true;
+				}
+				else {
+					const int32_t pending = compiler->pending == NO_REGISTER
+						? _emit(compiler, VECTOR_NOT_OP, guard, NO_REGISTER, NO_REGISTER)
+						: _emit(compiler, VECTOR_AND_NOT_OP, compiler->pending, guard, NO_REGISTER);
+					_release(compiler, compiler->pending);
+					compiler->pending = pending;
+				}
+				break;
+		}
+	}
+}
+
+/**
+ * The register of a constant, loaded once per register file.
+ */
+static int32_t _constant(VectorCompiler * compiler, const int32_t value) {
+	VectorProgram * program = compiler->program;
+	for (unsigned int k = 0; k < program->constantCount; ++k) {
+		if (program->constants[k].value == value) {
+			return program->constants[k].index;
+		}
+	}
+	if (program->constantCount == program->constantCapacity) {
+		program->constantCapacity = program->constantCapacity == 0 ? 16 : 2 * program->constantCapacity;
+		program->constants = realloc(program->constants, program->constantCapacity * sizeof(VectorConstant));
+	}
+	const int32_t index = _newRegister(compiler, true);
+	program->constants[program->constantCount++] = (VectorConstant) {index, value};
+	return index;
+}
+
+/**
+ * Whether a constant is known at compile time (an integer or a state).
+ */
+static boolean _constantValue(VectorCompiler * compiler, Constant * constant, int * value) {
+	if (constant->type == INTEGER_C) {
+		*value = constant->value;
+		return true;
+	}
+	if (constant->type == STRING_C && compiler->automaton->symbolStates[constant->symbol] != NO_STATE) {
+		*value = compiler->automaton->symbolStates[constant->symbol];
+		return true;
+	}
+	return false;
+}
+
+/**
+ * The register of the amount of cells in a state at some static offsets
+ * (whose array is owned by the counter, or freed). The offsets are sorted,
+ * so every list of the same cells shares its counter.
+ */
+static int32_t _count(VectorCompiler * compiler, Offset * offsets, const unsigned int offsetCount, const int32_t state) {
+	VectorProgram * program = compiler->program;
+	qsort(offsets, offsetCount, sizeof(Offset), _compareOffsets);
+	VectorCounter * counter = NULL;
+	for (unsigned int k = 0; k < program->counterCount && counter == NULL; ++k) {
+		if (program->counters[k].offsetCount == offsetCount
+				&& memcmp(program->counters[k].offsets, offsets, offsetCount * sizeof(Offset)) == 0) {
+			counter = &program->counters[k];
+			free(offsets);
+		}
+	}
+	if (counter == NULL) {
+		if (program->counterCount == program->counterCapacity) {
+			program->counterCapacity = program->counterCapacity == 0 ? 4 : 2 * program->counterCapacity;
+			program->counters = realloc(program->counters, program->counterCapacity * sizeof(VectorCounter));
+		}
+		counter = &program->counters[program->counterCount++];
+		*counter = (VectorCounter) {
+			.offsets = offsets,
+			.displacements = calloc(offsetCount + 1, sizeof(ptrdiff_t)),
+			.offsetCount = offsetCount
+		};
+		for (unsigned int k = 0; k < offsetCount; ++k) {
+			counter->displacements[k] = (ptrdiff_t) offsets[k].y * compiler->automaton->width + offsets[k].x;
+			_extend(program, offsets[k]);
+		}
+		_splitRectangles(counter);
+	}
+	for (unsigned int k = 0; k < counter->stateCount; ++k) {
+		if (counter->states[k] == state) {
+			return counter->indices[k];
+		}
+	}
+	if (counter->stateCount == counter->stateCapacity) {
+		counter->stateCapacity = counter->stateCapacity == 0 ? 4 : 2 * counter->stateCapacity;
+		counter->states = realloc(counter->states, counter->stateCapacity * sizeof(int32_t));
+		counter->indices = realloc(counter->indices, counter->stateCapacity * sizeof(int32_t));
+		counter->tables = realloc(counter->tables, counter->stateCapacity * sizeof(int32_t));
+	}
+	const int32_t index = _newRegister(compiler, true);
+	counter->states[counter->stateCount] = state;
+	counter->indices[counter->stateCount] = index;
+	counter->tables[counter->stateCount++] = counter->rectangleCount == 0 ? -1 : _table(program, state);
+	return index;
+}
+
+/**
+ * Appends an instruction into a new temporary. The operands are still
+ * referenced, so the destination is never one of them.
+ */
+static int32_t _emit(VectorCompiler * compiler, const VectorOpcode opcode, const int32_t a, const int32_t b, const int32_t c) {
+	VectorProgram * program = compiler->program;
+	const int32_t destination = _allocate(compiler);
+	if (program->count == program->capacity) {
+		program->capacity = program->capacity == 0 ? 64 : 2 * program->capacity;
+		program->code = realloc(program->code, program->capacity * sizeof(VectorInstruction));
+	}
+	program->code[program->count++] = (VectorInstruction) {opcode, destination, a, b, c};
+	return destination;
+}
+
+/**
+ * Extends the bounding box of the static offsets of a program.
+ */
+static void _extend(VectorProgram * program, const Offset offset) {
+	program->minimum.x = offset.x < program->minimum.x ? offset.x : program->minimum.x;
+	program->minimum.y = offset.y < program->minimum.y ? offset.y : program->minimum.y;
+	program->maximum.x = program->maximum.x < offset.x ? offset.x : program->maximum.x;
+	program->maximum.y = program->maximum.y < offset.y ? offset.y : program->maximum.y;
+}
+
+/**
+ * Adds a register to the program (loaded before it runs, or a temporary).
+ */
+static int32_t _newRegister(VectorCompiler * compiler, const boolean isLoaded) {
+	const unsigned int index = compiler->program->registers++;
+	if (index == compiler->registerCapacity) {
+		compiler->registerCapacity = compiler->registerCapacity == 0 ? 64 : 2 * compiler->registerCapacity;
+		compiler->references = realloc(compiler->references, compiler->registerCapacity * sizeof(unsigned int));
+		compiler->isLoaded = realloc(compiler->isLoaded, compiler->registerCapacity * sizeof(boolean));
+		compiler->free = realloc(compiler->free, compiler->registerCapacity * sizeof(int32_t));
+	}
+	compiler->references[index] = 0;
+	compiler->isLoaded[index] = isLoaded;
+	return (int32_t) index;
+}
+
+/**
+ * Pushes an expression onto the work stack of the compiler.
+ */
+static void _pushFrame(VectorCompiler * compiler, ArithmeticExpression * expression) {
+	if (compiler->frameCount == compiler->frameCapacity) {
+		compiler->frameCapacity = compiler->frameCapacity == 0 ? 64 : 2 * compiler->frameCapacity;
+		compiler->frames = realloc(compiler->frames, compiler->frameCapacity * sizeof(VectorFrame));
+	}
+	compiler->frames[compiler->frameCount++] = (VectorFrame) {
+		.expression = expression,
+		.stage = 0,
+		.operand = NO_REGISTER
+	};
+}
+
+static void _release(VectorCompiler * compiler, const int32_t index) {
+	if (index != NO_REGISTER && !compiler->isLoaded[index] && --compiler->references[index] == 0) {
+		compiler->free[compiler->freeCount++] = index;
+	}
+}
+
+static void _retain(VectorCompiler * compiler, const int32_t index) {
+	if (index != NO_REGISTER && !compiler->isLoaded[index]) {
+		++compiler->references[index];
+	}
+}
+
+/**
+ * Splits the (sorted) offsets of a counter into disjoint rectangles: the
+ * runs of consecutive offsets of every row, merged with the ones of the
+ * same columns in the row above. The rectangles are kept only if counting
+ * them is cheaper than counting the cells (see VECTOR_RECTANGLE_COST), and
+ * the offsets have no duplicates.
+ */
+static void _splitRectangles(VectorCounter * counter) {
+	VectorRectangle * rectangles = calloc(counter->offsetCount + 1, sizeof(VectorRectangle));
+	unsigned int count = 0;
+	boolean isSplittable = 0 < counter->offsetCount;
+	for (unsigned int k = 0; k < counter->offsetCount && isSplittable; ++k) {
+		const Offset first = counter->offsets[k];
+		while (k + 1 < counter->offsetCount && counter->offsets[k + 1].y == first.y
+				&& counter->offsets[k + 1].x == counter->offsets[k].x + 1) {
+			++k;
+		}
+		const Offset last = counter->offsets[k];
+		isSplittable = k + 1 == counter->offsetCount
+			|| counter->offsets[k + 1].y != last.y || counter->offsets[k + 1].x != last.x;
+		VectorRectangle * rectangle = NULL;
+		for (unsigned int j = 0; j < count && rectangle == NULL; ++j) {
+			if (rectangles[j].minimum.x == first.x && rectangles[j].maximum.x == last.x && rectangles[j].maximum.y == first.y - 1) {
+				rectangle = &rectangles[j];
+			}
+		}
+		if (rectangle == NULL) {
+			rectangles[count++] = (VectorRectangle) {.minimum = first, .maximum = last};
+		}
+		else {
+			rectangle->maximum.y = first.y;
+		}
+	}
+	if (isSplittable && VECTOR_RECTANGLE_COST * count < counter->offsetCount) {
+		counter->rectangles = rectangles;
+		counter->rectangleCount = count;
+	}
+	else {
+		free(rectangles);
+	}
+}
+
+/**
+ * The register of the cells at a static offset, loaded before the program
+ * runs.
+ */
+static int32_t _staticCell(VectorCompiler * compiler, const Offset offset) {
+	VectorProgram * program = compiler->program;
+	for (unsigned int k = 0; k < program->readCount; ++k) {
+		if (program->reads[k].offset.x == offset.x && program->reads[k].offset.y == offset.y) {
+			return program->reads[k].index;
+		}
+	}
+	if (program->readCount == program->readCapacity) {
+		program->readCapacity = program->readCapacity == 0 ? 16 : 2 * program->readCapacity;
+		program->reads = realloc(program->reads, program->readCapacity * sizeof(VectorRead));
+	}
+	const int32_t index = _newRegister(compiler, true);
+	program->reads[program->readCount++] = (VectorRead) {index, offset, (ptrdiff_t) offset.y * compiler->automaton->width + offset.x};
+	_extend(program, offset);
+	return index;
+}
+
+/**
+ * The index of the summed-area table of a state.
+ */
+static int32_t _table(VectorProgram * program, const int32_t state) {
+	for (unsigned int k = 0; k < program->tableCount; ++k) {
+		if (program->tableStates[k] == state) {
+			return (int32_t) k;
+		}
+	}
+	if (program->tableCount == program->tableCapacity) {
+		program->tableCapacity = program->tableCapacity == 0 ? 4 : 2 * program->tableCapacity;
+		program->tableStates = realloc(program->tableStates, program->tableCapacity * sizeof(int32_t));
+	}
+	program->tableStates[program->tableCount] = state;
+	return (int32_t) program->tableCount++;
+}
+
+/* PUBLIC FUNCTIONS */
+
+VectorProgram * compileVectorProgram(const Automaton * automaton) {
+	if (automaton->rule == STATIC_RULE || (automaton->rule == EVOLUTION_RULE && automaton->neighborhoodProgram != NULL)) {
+		return NULL;
+	}
+	VectorProgram * program = calloc(1, sizeof(VectorProgram));
+	VectorCompiler compiler = {
+		.automaton = automaton,
+		.program = program,
+		.variables = calloc(automaton->symbols, sizeof(int32_t)),
+		.pending = NO_REGISTER,
+		.isDone = false,
+		.isVectorizable = true
+	};
+	// Every variable (and the result) starts at zero.
+	const int32_t zero = _constant(&compiler, 0);
+	for (unsigned int k = 0; k < automaton->symbols; ++k) {
+		compiler.variables[k] = zero;
+	}
+	program->result = zero;
+	if (automaton->rule == EVOLUTION_RULE) {
+		_compileEvolution(&compiler);
+	}
+	else {
+		_compileSequence(&compiler, automaton->transitionProgram, NO_REGISTER);
+	}
+	program->pending = compiler.isDone ? NO_REGISTER : compiler.pending;
+	free(compiler.variables);
+	free(compiler.references);
+	free(compiler.isLoaded);
+	free(compiler.free);
+	free(compiler.frames);
+	if (!compiler.isVectorizable) {
+		logDebugging(_logger, "The transition program has a loop that can't be unrolled, so it can't be vectorized.");
+		destroyVectorProgram(program);
+		return NULL;
+	}
+	logDebugging(_logger, "Lowered the rule into %u vector instructions, on %u registers, with %u counters (and %u summed-area tables).",
+		program->count, program->registers, program->counterCount, program->tableCount);
+	return program;
+}
+
+void destroyVectorProgram(VectorProgram * program) {
+	if (program != NULL) {
+		free(program->code);
+		free(program->reads);
+		free(program->constants);
+		for (unsigned int k = 0; k < program->counterCount; ++k) {
+			free(program->counters[k].offsets);
+			free(program->counters[k].displacements);
+			free(program->counters[k].states);
+			free(program->counters[k].indices);
+			free(program->counters[k].tables);
+			free(program->counters[k].rectangles);
+		}
+		free(program->counters);
+		free(program->tableStates);
+		free(program);
+	}
+}
+
+int32_t * createVectorRegisters(const VectorProgram * program) {
+	int32_t * registers = calloc((size_t) program->registers * VECTOR_LANES, sizeof(int32_t));
+	for (unsigned int k = 0; k < program->constantCount; ++k) {
+		int32_t * lanes = registers + (size_t) program->constants[k].index * VECTOR_LANES;
+		for (unsigned int lane = 0; lane < VECTOR_LANES; ++lane) {
+			lanes[lane] = program->constants[k].value;
+		}
+	}
+	return registers;
+}
+
+/**
+ * Runs an operation on every lane. The destination never aliases the
+ * operands (see "_emit"), so every loop is vectorized.
+ */
+#define LANES(operation)										\
+	for (unsigned int lane = 0; lane < count; ++lane) {			\
+		d[lane] = (operation);									\
+	}															\
+	break
+
+#define A a[lane]
+#define B b[lane]
+#define C c[lane]
+
+void runVectorProgram(const VectorProgram * program, int32_t * registers, const PaddedGrid * grid, SummedAreaTable * const * tables,
+		const unsigned int states, const int x, const int y, const unsigned int count, uint8_t * output) {
+	const uint8_t * cells = grid->cells + (ptrdiff_t) y * (ptrdiff_t) grid->stride + x;
+	for (unsigned int k = 0; k < program->readCount; ++k) {
+		int32_t * restrict d = registers + (size_t) program->reads[k].index * VECTOR_LANES;
+		const uint8_t * restrict source = cells + program->reads[k].displacement;
+		for (unsigned int lane = 0; lane < count; ++lane) {
+			d[lane] = PADDED_VALUE(source[lane]);
+		}
+	}
+	for (unsigned int k = 0; k < program->counterCount; ++k) {
+		const VectorCounter * counter = &program->counters[k];
+		for (unsigned int j = 0; j < counter->stateCount; ++j) {
+			memset(registers + (size_t) counter->indices[j] * VECTOR_LANES, 0, count * sizeof(int32_t));
+		}
+		for (unsigned int j = 0; j < counter->stateCount && 0 < counter->rectangleCount; ++j) {
+			const SummedAreaTable * table = tables[counter->tables[j]];
+			const uint32_t * origin = table->origin + (ptrdiff_t) y * (ptrdiff_t) table->stride + x;
+			int32_t * restrict d = registers + (size_t) counter->indices[j] * VECTOR_LANES;
+			for (unsigned int i = 0; i < counter->rectangleCount; ++i) {
+				const ptrdiff_t * corners = counter->rectangles[i].corners;
+				const uint32_t * restrict bottomRight = origin + corners[0];
+				const uint32_t * restrict bottomLeft = origin + corners[1];
+				const uint32_t * restrict topRight = origin + corners[2];
+				const uint32_t * restrict topLeft = origin + corners[3];
+				for (unsigned int lane = 0; lane < count; ++lane) {
+					d[lane] += (int32_t) (bottomRight[lane] - bottomLeft[lane] - topRight[lane] + topLeft[lane]);
+				}
+			}
+		}
+		if (0 < counter->rectangleCount) {
+			continue;
+		}
+		for (unsigned int i = 0; i < counter->offsetCount; ++i) {
+			const uint8_t * restrict source = cells + counter->displacements[i];
+			for (unsigned int j = 0; j < counter->stateCount; ++j) {
+				int32_t * restrict d = registers + (size_t) counter->indices[j] * VECTOR_LANES;
+				const uint8_t state = (uint8_t) counter->states[j];
+				for (unsigned int lane = 0; lane < count; ++lane) {
+					d[lane] += source[lane] == state;
+				}
+			}
+		}
+	}
+	for (unsigned int k = 0; k < program->count; ++k) {
+		const VectorInstruction * instruction = &program->code[k];
+		int32_t * restrict d = registers + (size_t) instruction->destination * VECTOR_LANES;
+		const int32_t * restrict a = registers + (size_t) instruction->a * VECTOR_LANES;
+		const int32_t * restrict b = registers + (size_t) (instruction->b < 0 ? instruction->a : instruction->b) * VECTOR_LANES;
+		const int32_t * restrict c = registers + (size_t) (instruction->c < 0 ? instruction->a : instruction->c) * VECTOR_LANES;
+		switch (instruction->opcode) {
+			case VECTOR_LOAD_DYNAMIC_OP:
+				LANES(readPaddedCell(grid, x + (int) lane + A, y + B));
+			case VECTOR_ADD_OP:
+				LANES((int32_t) ((uint32_t) A + (uint32_t) B));
+			case VECTOR_SUBTRACT_OP:
+				LANES((int32_t) ((uint32_t) A - (uint32_t) B));
+			case VECTOR_MULTIPLY_OP:
+				LANES((int32_t) ((uint32_t) A * (uint32_t) B));
+			case VECTOR_DIVIDE_OP:
+				LANES(B == 0 ? 0 : B == -1 ? (int32_t) (0u - (uint32_t) A) : A / B);
+			case VECTOR_MODULO_OP:
+				LANES(B == 0 || B == -1 ? 0 : A % B);
+			case VECTOR_EQUAL_OP:
+				LANES(A == B);
+			case VECTOR_NOT_EQUAL_OP:
+				LANES(A != B);
+			case VECTOR_LOWER_OP:
+				LANES(A < B);
+			case VECTOR_LOWER_OR_EQUAL_OP:
+				LANES(A <= B);
+			case VECTOR_GREATER_OP:
+				LANES(A > B);
+			case VECTOR_GREATER_OR_EQUAL_OP:
+				LANES(A >= B);
+			case VECTOR_AND_OP:
+				LANES((A != 0) & (B != 0));
+			case VECTOR_OR_OP:
+				LANES((A != 0) | (B != 0));
+			case VECTOR_AND_NOT_OP:
+				LANES((A != 0) & (B == 0));
+			case VECTOR_NOT_OP:
+				LANES(A == 0);
+			case VECTOR_SELECT_OP:
+				LANES(A != 0 ? B : C);
+		}
+	}
+	if (!program->hasResult) {
+		memcpy(output, cells, count);
+		return;
+	}
+	const int32_t * result = registers + (size_t) program->result * VECTOR_LANES;
+	const int32_t * pending = program->pending < 0 ? NULL : registers + (size_t) program->pending * VECTOR_LANES;
+	for (unsigned int lane = 0; lane < count; ++lane) {
+		const boolean isValid = (pending == NULL || pending[lane] == 0) && 0 <= result[lane] && result[lane] < (int32_t) states;
+		output[lane] = isValid ? (uint8_t) result[lane] : cells[lane];
+	}
+}
+
+#undef A
+#undef B
+#undef C
+#undef LANES
+
+void setVectorProgramStride(VectorProgram * program, const size_t stride) {
+	for (unsigned int k = 0; k < program->readCount; ++k) {
+		const Offset offset = program->reads[k].offset;
+		program->reads[k].displacement = (ptrdiff_t) offset.y * (ptrdiff_t) stride + offset.x;
+	}
+	for (unsigned int k = 0; k < program->counterCount; ++k) {
+		const VectorCounter * counter = &program->counters[k];
+		for (unsigned int j = 0; j < counter->offsetCount; ++j) {
+			counter->displacements[j] = (ptrdiff_t) counter->offsets[j].y * (ptrdiff_t) stride + counter->offsets[j].x;
+		}
+		const ptrdiff_t tableStride = (ptrdiff_t) SUMMED_AREA_STRIDE(stride);
+		for (unsigned int j = 0; j < counter->rectangleCount; ++j) {
+			VectorRectangle * rectangle = &counter->rectangles[j];
+			const Offset minimum = rectangle->minimum;
+			const Offset maximum = rectangle->maximum;
+			rectangle->corners[0] = (maximum.y + 1) * tableStride + maximum.x + 1;
+			rectangle->corners[1] = (maximum.y + 1) * tableStride + minimum.x;
+			rectangle->corners[2] = minimum.y * tableStride + maximum.x + 1;
+			rectangle->corners[3] = minimum.y * tableStride + minimum.x;
+		}
+	}
+}
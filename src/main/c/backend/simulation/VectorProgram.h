@@ -0,0 +1,232 @@
+#ifndef VECTOR_PROGRAM_HEADER
+#define VECTOR_PROGRAM_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "Automaton.h"
+#include "PaddedGrid.h"
+#include "SummedAreaTable.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeVectorProgramModule();
+
+/** Shutdown module's internal state. */
+void shutdownVectorProgramModule();
+
+/**
+ * The amount of consecutive cells of a row (i.e., lanes) that every
+ * instruction computes at once.
+ */
+#define VECTOR_LANES 256
+
+/**
+ * The most iterations of a loop with constant bounds that are unrolled. A
+ * program with a longer loop (or one whose bounds aren't constant) can't be
+ * vectorized.
+ */
+#define VECTOR_MAXIMUM_UNROLLED_ITERATIONS 64
+
+/**
+ * The cost of counting the cells of a rectangle from a summed-area table
+ * (i.e., reading its four corners, and rebuilding the table every
+ * generation), in cells counted one by one. A counter whose cells are split
+ * into fewer rectangles than its cells over this cost counts them from the
+ * tables.
+ */
+#define VECTOR_RECTANGLE_COST 8
+
+/**
+ * The instructions of a vector program. Every instruction computes a
+ * register (i.e., a value per lane) from up to three registers "a", "b" and
+ * "c", lane by lane:
+ *
+ *	- VECTOR_LOAD_DYNAMIC_OP: loads the state of the cell at the offset in
+ *	  registers "a" and "b".
+ *	- VECTOR_ADD_OP to VECTOR_GREATER_OR_EQUAL_OP: binary operations on
+ *	  registers "a" and "b".
+ *	- VECTOR_AND_OP, VECTOR_OR_OP: 1 if both (either) of registers "a" and
+ *	  "b" are not zero.
+ *	- VECTOR_AND_NOT_OP: 1 if register "a" is not zero, and "b" is zero.
+ *	- VECTOR_NOT_OP: 1 if register "a" is zero.
+ *	- VECTOR_SELECT_OP: register "b" where register "a" is not zero, and
+ *	  register "c" elsewhere.
+ */
+typedef enum {
+	VECTOR_LOAD_DYNAMIC_OP,
+	VECTOR_ADD_OP,
+	VECTOR_SUBTRACT_OP,
+	VECTOR_MULTIPLY_OP,
+	VECTOR_DIVIDE_OP,
+	VECTOR_MODULO_OP,
+	VECTOR_EQUAL_OP,
+	VECTOR_NOT_EQUAL_OP,
+	VECTOR_LOWER_OP,
+	VECTOR_LOWER_OR_EQUAL_OP,
+	VECTOR_GREATER_OP,
+	VECTOR_GREATER_OR_EQUAL_OP,
+	VECTOR_AND_OP,
+	VECTOR_OR_OP,
+	VECTOR_AND_NOT_OP,
+	VECTOR_NOT_OP,
+	VECTOR_SELECT_OP
+} VectorOpcode;
+
+typedef struct {
+	VectorOpcode opcode;
+	int32_t destination;
+	int32_t a;
+	int32_t b;
+	int32_t c;
+} VectorInstruction;
+
+/**
+ * A register of a vector program that holds an integer in every lane.
+ */
+typedef struct {
+	int32_t index;
+	int32_t value;
+} VectorConstant;
+
+/**
+ * A register of a vector program that holds the cells at a static offset:
+ * a slice of a row, shifted by the displacement of the offset (in cells, in
+ * row-major order, with the stride of the grid).
+ */
+typedef struct {
+	int32_t index;
+	Offset offset;
+	ptrdiff_t displacement;
+} VectorRead;
+
+/**
+ * A rectangle of offsets, and the displacements of the entries of a
+ * summed-area table at its corners (see "SummedAreaTable"): past its
+ * bottom-right one, and then the bottom-left, top-right and top-left ones.
+ */
+typedef struct {
+	Offset minimum;
+	Offset maximum;
+	ptrdiff_t corners[4];
+} VectorRectangle;
+
+/**
+ * The amount of cells in some states among a list of static offsets (in
+ * any order, so the lists that only differ in their order share their
+ * counts), counted before the program runs in a single pass over the
+ * list. Every counted state has its register. If the offsets are a few
+ * disjoint rectangles (e.g., a big Moore or cross-shaped neighborhood), the
+ * cells of each one are counted from the summed-area table of the state
+ * instead, in constant time no matter the size of the rectangles.
+ */
+typedef struct {
+	Offset * offsets;
+	ptrdiff_t * displacements;
+	unsigned int offsetCount;
+
+	VectorRectangle * rectangles;
+	unsigned int rectangleCount;
+
+	int32_t * states;
+	int32_t * indices;
+	int32_t * tables;
+	unsigned int stateCount;
+	unsigned int stateCapacity;
+} VectorCounter;
+
+/**
+ * A transition program lowered into straight-line code over rows of cells:
+ * every conditional becomes a mask (of the lanes where it holds), and every
+ * assignment and return a masked select, so the program never branches,
+ * and every instruction is a loop over the lanes that the C compiler
+ * vectorizes. The cells read at static offsets are loaded before the
+ * program runs, and the constants once per register file. The "all", "any"
+ * and "at_least" predicates over static offsets (and the amount of alive
+ * neighbors of an evolution) are answered from the counters, so a
+ * (outer-)totalistic rule reads every neighbor once, no matter how many
+ * predicates count it. A variable is
+ * just the register of its last assignment, so the registers of the
+ * temporaries are reused as soon as they are dead (and an instruction never
+ * writes a register that it reads).
+ */
+typedef struct {
+	VectorInstruction * code;
+	unsigned int count;
+	unsigned int capacity;
+
+	unsigned int registers;
+
+	VectorRead * reads;
+	unsigned int readCount;
+	unsigned int readCapacity;
+
+	VectorConstant * constants;
+	unsigned int constantCount;
+	unsigned int constantCapacity;
+
+	VectorCounter * counters;
+	unsigned int counterCount;
+	unsigned int counterCapacity;
+
+	// The states of the summed-area tables read by the counters.
+	int32_t * tableStates;
+	unsigned int tableCount;
+	unsigned int tableCapacity;
+
+	// The register of the returned state, and the one of the lanes that
+	// didn't return yet (or -1, if every lane returned).
+	int32_t result;
+	int32_t pending;
+
+	// Whether the program returns a state in some lane.
+	boolean hasResult;
+
+	// The bounding box of the static offsets (including the cell itself).
+	Offset minimum;
+	Offset maximum;
+
+	// Whether the program reads cells at offsets computed while it runs.
+	boolean isDynamic;
+} VectorProgram;
+
+/**
+ * Lowers the rule of an automaton into a vector program: its transition
+ * program, or its evolution (by the amount of alive neighbors). Returns NULL
+ * if it can't be lowered (i.e., the transition program has a loop that can't
+ * be unrolled, or the neighborhood of the evolution is computed by its
+ * program).
+ */
+VectorProgram * compileVectorProgram(const Automaton * automaton);
+
+/**
+ * Destroys a vector program.
+ */
+void destroyVectorProgram(VectorProgram * program);
+
+/**
+ * Creates the registers of a vector program, with its constants loaded.
+ */
+int32_t * createVectorRegisters(const VectorProgram * program);
+
+/**
+ * Runs a vector program on the "count" (up to VECTOR_LANES) cells of a row
+ * that start at (x, y), and writes their next states (the current ones,
+ * where the program doesn't return a valid state). The halo of the grid
+ * must cover the static offsets of the program, and the summed-area tables
+ * (of the states in "tableStates", in order) must be built from the grid.
+ */
+void runVectorProgram(const VectorProgram * program, int32_t * registers, const PaddedGrid * grid, SummedAreaTable * const * tables,
+	const unsigned int states, const int x, const int y, const unsigned int count, uint8_t * output);
+
+/**
+ * Recomputes the displacements of the static offsets (and the counters) for
+ * the rows of a grid with the specified stride (and its summed-area
+ * tables).
+ */
+void setVectorProgramStride(VectorProgram * program, const size_t stride);
+
+#endif
@@ -0,0 +1,243 @@
+#include "VirtualMachine.h"
+
+/* PRIVATE FUNCTIONS */
+
+static void _addNeighbor(VirtualMachine * machine, const Offset offset);
+static void _removeNeighbor(VirtualMachine * machine, const Offset offset);
+
+/**
+ * Adds a neighbor, unless it's already in the neighborhood.
+ */
+static void _addNeighbor(VirtualMachine * machine, const Offset offset) {
+	for (unsigned int k = 0; k < machine->neighborCount; ++k) {
+		if (machine->neighbors[k].x == offset.x && machine->neighbors[k].y == offset.y) {
+			return;
+		}
+	}
+	if (machine->neighborCount == machine->neighborCapacity) {
+		machine->neighborCapacity = machine->neighborCapacity == 0 ? 16 : 2 * machine->neighborCapacity;
+		machine->neighbors = realloc(machine->neighbors, machine->neighborCapacity * sizeof(Offset));
+	}
+	machine->neighbors[machine->neighborCount++] = offset;
+}
+
+/**
+ * Removes a neighbor, if it's in the neighborhood (keeping the order of the
+ * rest).
+ */
+static void _removeNeighbor(VirtualMachine * machine, const Offset offset) {
+	for (unsigned int k = 0; k < machine->neighborCount; ++k) {
+		if (machine->neighbors[k].x == offset.x && machine->neighbors[k].y == offset.y) {
+			memmove(&machine->neighbors[k], &machine->neighbors[k + 1], (machine->neighborCount - k - 1) * sizeof(Offset));
+			--machine->neighborCount;
+			return;
+		}
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+VirtualMachine * createVirtualMachine(const Automaton * automaton, const Bytecode * bytecode, const Bytecode * otherBytecode) {
+	VirtualMachine * machine = calloc(1, sizeof(VirtualMachine));
+	machine->automaton = automaton;
+	machine->registerCount = 1;
+	if (bytecode != NULL && machine->registerCount < bytecode->registers) {
+		machine->registerCount = bytecode->registers;
+	}
+	if (otherBytecode != NULL && machine->registerCount < otherBytecode->registers) {
+		machine->registerCount = otherBytecode->registers;
+	}
+	machine->registers = calloc(machine->registerCount, sizeof(int));
+	return machine;
+}
+
+void destroyVirtualMachine(VirtualMachine * machine) {
+	if (machine != NULL) {
+		free(machine->registers);
+		free(machine->neighbors);
+		free(machine);
+	}
+}
+
+/**
+ * The operands of the current instruction, and the reads of its cells.
+ */
+#define D (registers[instruction->destination])
+#define A (registers[instruction->a])
+#define B (registers[instruction->b])
+#define STATIC_CELL(index) PADDED_VALUE(cell[displacements[index]])
+
+#if defined(__GNUC__)
+	#define DISPATCH() goto * labels[instruction->opcode]
+	#define INSTRUCTION(opcode) opcode##_LABEL:
+#else
+	#define DISPATCH() goto dispatch
+	#define INSTRUCTION(opcode) case opcode:
+#endif
+#define NEXT() ++instruction; DISPATCH()
+
+int runBytecode(VirtualMachine * machine, const Bytecode * bytecode, const PaddedGrid * grid, const int x, const int y) {
+	const Offset * offsets = bytecode->offsets;
+	const ptrdiff_t * displacements = bytecode->displacements;
+	const uint8_t * cell = grid->cells + (size_t) y * grid->stride + x;
+	const Instruction * code = bytecode->code;
+	const Instruction * instruction = code;
+	int * registers = machine->registers;
+	memset(registers, 0, bytecode->variables * sizeof(int));
+	machine->neighborCount = 0;
+#if defined(__GNUC__)
+	static const void * labels[OPCODES] = {
+		[HALT_OP] = &&HALT_OP_LABEL,
+		[RETURN_OP] = &&RETURN_OP_LABEL,
+		[JUMP_OP] = &&JUMP_OP_LABEL,
+		[JUMP_IF_ZERO_OP] = &&JUMP_IF_ZERO_OP_LABEL,
+		[JUMP_IF_NOT_ZERO_OP] = &&JUMP_IF_NOT_ZERO_OP_LABEL,
+		[JUMP_IF_CELL_EQUAL_OP] = &&JUMP_IF_CELL_EQUAL_OP_LABEL,
+		[JUMP_IF_CELL_NOT_EQUAL_OP] = &&JUMP_IF_CELL_NOT_EQUAL_OP_LABEL,
+		[JUMP_IF_EQUAL_IMMEDIATE_OP] = &&JUMP_IF_EQUAL_IMMEDIATE_OP_LABEL,
+		[JUMP_IF_NOT_EQUAL_IMMEDIATE_OP] = &&JUMP_IF_NOT_EQUAL_IMMEDIATE_OP_LABEL,
+		[LOAD_INTEGER_OP] = &&LOAD_INTEGER_OP_LABEL,
+		[MOVE_OP] = &&MOVE_OP_LABEL,
+		[LOAD_CELL_OP] = &&LOAD_CELL_OP_LABEL,
+		[LOAD_CELL_DYNAMIC_OP] = &&LOAD_CELL_DYNAMIC_OP_LABEL,
+		[CELL_EQUAL_OP] = &&CELL_EQUAL_OP_LABEL,
+		[COUNT_CELL_OP] = &&COUNT_CELL_OP_LABEL,
+		[COUNT_EQUAL_IMMEDIATE_OP] = &&COUNT_EQUAL_IMMEDIATE_OP_LABEL,
+		[ADD_OP] = &&ADD_OP_LABEL,
+		[SUBTRACT_OP] = &&SUBTRACT_OP_LABEL,
+		[MULTIPLY_OP] = &&MULTIPLY_OP_LABEL,
+		[DIVIDE_OP] = &&DIVIDE_OP_LABEL,
+		[MODULO_OP] = &&MODULO_OP_LABEL,
+		[EQUAL_OP] = &&EQUAL_OP_LABEL,
+		[NOT_EQUAL_OP] = &&NOT_EQUAL_OP_LABEL,
+		[LOWER_OP] = &&LOWER_OP_LABEL,
+		[LOWER_OR_EQUAL_OP] = &&LOWER_OR_EQUAL_OP_LABEL,
+		[GREATER_OP] = &&GREATER_OP_LABEL,
+		[GREATER_OR_EQUAL_OP] = &&GREATER_OR_EQUAL_OP_LABEL,
+		[ADD_IMMEDIATE_OP] = &&ADD_IMMEDIATE_OP_LABEL,
+		[EQUAL_IMMEDIATE_OP] = &&EQUAL_IMMEDIATE_OP_LABEL,
+		[NOT_EQUAL_IMMEDIATE_OP] = &&NOT_EQUAL_IMMEDIATE_OP_LABEL,
+		[NOT_OP] = &&NOT_OP_LABEL,
+		[TEST_OP] = &&TEST_OP_LABEL,
+		[ADD_NEIGHBOR_OP] = &&ADD_NEIGHBOR_OP_LABEL,
+		[REMOVE_NEIGHBOR_OP] = &&REMOVE_NEIGHBOR_OP_LABEL,
+		[ADD_NEIGHBOR_DYNAMIC_OP] = &&ADD_NEIGHBOR_DYNAMIC_OP_LABEL,
+		[REMOVE_NEIGHBOR_DYNAMIC_OP] = &&REMOVE_NEIGHBOR_DYNAMIC_OP_LABEL
+	};
+	DISPATCH();
+#else
+dispatch:
+	switch (instruction->opcode) {
+#endif
+	INSTRUCTION(HALT_OP)
+		return OUTSIDE_STATE;
+	INSTRUCTION(RETURN_OP)
+		return A;
+	INSTRUCTION(JUMP_OP)
+		instruction = code + instruction->destination;
+		DISPATCH();
+	INSTRUCTION(JUMP_IF_ZERO_OP)
+		instruction = A == 0 ? code + instruction->destination : instruction + 1;
+		DISPATCH();
+	INSTRUCTION(JUMP_IF_NOT_ZERO_OP)
+		instruction = A != 0 ? code + instruction->destination : instruction + 1;
+		DISPATCH();
+	INSTRUCTION(JUMP_IF_CELL_EQUAL_OP)
+		instruction = STATIC_CELL(instruction->a) == instruction->b ? code + instruction->destination : instruction + 1;
+		DISPATCH();
+	INSTRUCTION(JUMP_IF_CELL_NOT_EQUAL_OP)
+		instruction = STATIC_CELL(instruction->a) != instruction->b ? code + instruction->destination : instruction + 1;
+		DISPATCH();
+	INSTRUCTION(JUMP_IF_EQUAL_IMMEDIATE_OP)
+		instruction = A == instruction->b ? code + instruction->destination : instruction + 1;
+		DISPATCH();
+	INSTRUCTION(JUMP_IF_NOT_EQUAL_IMMEDIATE_OP)
+		instruction = A != instruction->b ? code + instruction->destination : instruction + 1;
+		DISPATCH();
+	INSTRUCTION(LOAD_INTEGER_OP)
+		D = instruction->a;
+		NEXT();
+	INSTRUCTION(MOVE_OP)
+		D = A;
+		NEXT();
+	INSTRUCTION(LOAD_CELL_OP)
+		D = STATIC_CELL(instruction->a);
+		NEXT();
+	INSTRUCTION(LOAD_CELL_DYNAMIC_OP)
+		D = readPaddedCell(grid, x + A, y + B);
+		NEXT();
+	INSTRUCTION(CELL_EQUAL_OP)
+		D = STATIC_CELL(instruction->a) == instruction->b;
+		NEXT();
+	INSTRUCTION(COUNT_CELL_OP)
+		D += STATIC_CELL(instruction->a) == instruction->b;
+		NEXT();
+	INSTRUCTION(COUNT_EQUAL_IMMEDIATE_OP)
+		D += A == instruction->b;
+		NEXT();
+	INSTRUCTION(ADD_OP)
+		D = A + B;
+		NEXT();
+	INSTRUCTION(SUBTRACT_OP)
+		D = A - B;
+		NEXT();
+	INSTRUCTION(MULTIPLY_OP)
+		D = A * B;
+		NEXT();
+	INSTRUCTION(DIVIDE_OP)
+		D = B == 0 ? 0 : A / B;
+		NEXT();
+	INSTRUCTION(MODULO_OP)
+		D = B == 0 ? 0 : A % B;
+		NEXT();
+	INSTRUCTION(EQUAL_OP)
+		D = A == B;
+		NEXT();
+	INSTRUCTION(NOT_EQUAL_OP)
+		D = A != B;
+		NEXT();
+	INSTRUCTION(LOWER_OP)
+		D = A < B;
+		NEXT();
+	INSTRUCTION(LOWER_OR_EQUAL_OP)
+		D = A <= B;
+		NEXT();
+	INSTRUCTION(GREATER_OP)
+		D = A > B;
+		NEXT();
+	INSTRUCTION(GREATER_OR_EQUAL_OP)
+		D = A >= B;
+		NEXT();
+	INSTRUCTION(ADD_IMMEDIATE_OP)
+		D = A + instruction->b;
+		NEXT();
+	INSTRUCTION(EQUAL_IMMEDIATE_OP)
+		D = A == instruction->b;
+		NEXT();
+	INSTRUCTION(NOT_EQUAL_IMMEDIATE_OP)
+		D = A != instruction->b;
+		NEXT();
+	INSTRUCTION(NOT_OP)
+		D = A == 0;
+		NEXT();
+	INSTRUCTION(TEST_OP)
+		D = A != 0;
+		NEXT();
+	INSTRUCTION(ADD_NEIGHBOR_OP)
+		_addNeighbor(machine, offsets[instruction->a]);
+		NEXT();
+	INSTRUCTION(REMOVE_NEIGHBOR_OP)
+		_removeNeighbor(machine, offsets[instruction->a]);
+		NEXT();
+	INSTRUCTION(ADD_NEIGHBOR_DYNAMIC_OP)
+		_addNeighbor(machine, (Offset) {A, B});
+		NEXT();
+	INSTRUCTION(REMOVE_NEIGHBOR_DYNAMIC_OP)
+		_removeNeighbor(machine, (Offset) {A, B});
+		NEXT();
+#if !defined(__GNUC__)
+	default:
+		return OUTSIDE_STATE;
+	}
+#endif
+}
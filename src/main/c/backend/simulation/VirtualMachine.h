@@ -0,0 +1,54 @@
+#ifndef VIRTUAL_MACHINE_HEADER
+#define VIRTUAL_MACHINE_HEADER
+
+#include "../../shared/Type.h"
+#include "Automaton.h"
+#include "Bytecode.h"
+#include "Grid.h"
+#include "Interpreter.h"
+#include "PaddedGrid.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * A register machine that runs the bytecode of the programs of an automaton
+ * on a single cell at a time, with the same semantics of the interpreter.
+ * The dispatch is threaded (i.e., every instruction jumps directly to the
+ * next one) with GCC computed gotos, or a switch otherwise.
+ *
+ * A virtual machine is not thread-safe (i.e., use one per thread).
+ */
+typedef struct {
+	const Automaton * automaton;
+	int * registers;
+	unsigned int registerCount;
+
+	// The neighborhood built by a neighborhood program.
+	Offset * neighbors;
+	unsigned int neighborCount;
+	unsigned int neighborCapacity;
+} VirtualMachine;
+
+/**
+ * Creates a virtual machine with enough registers for the specified
+ * programs (any of them can be NULL).
+ */
+VirtualMachine * createVirtualMachine(const Automaton * automaton, const Bytecode * bytecode, const Bytecode * otherBytecode);
+
+/**
+ * Destroys a virtual machine.
+ */
+void destroyVirtualMachine(VirtualMachine * machine);
+
+/**
+ * Runs a program on the cell at (x, y) of a padded grid, whose halo must
+ * hold every static offset of the program (with its displacements computed
+ * for the stride of the grid), so they are read without resolving the
+ * frontier. Returns the value of the first "->", or OUTSIDE_STATE if there
+ * is none (e.g., in a neighborhood program, which builds the neighborhood
+ * in the machine instead).
+ */
+int runBytecode(VirtualMachine * machine, const Bytecode * bytecode, const PaddedGrid * grid, const int x, const int y);
+
+#endif
@@ -24,10 +24,15 @@ void shutdownFlexActionsModule()
 static void _logLexicalAnalyzerContext(const char *functionName, LexicalAnalyzerContext *lexicalAnalyzerContext);
 
 /**
- * Logs a lexical-analyzer context in DEBUGGING level.
+ * Logs a lexical-analyzer context in DEBUGGING level. The lexeme is only
+ * escaped (which requires heap-memory) if the log would be visible.
  */
 static void _logLexicalAnalyzerContext(const char *functionName, LexicalAnalyzerContext *lexicalAnalyzerContext)
 {
+	if (!isLoggingLevelEnabled(_logger, DEBUGGING))
+	{
+		return;
+	}
 	char *escapedLexeme = escape(lexicalAnalyzerContext->lexeme);
 	logDebugging(_logger, "%s: %s (context = %d, length = %d, line = %d)",
 				 functionName,
@@ -87,8 +92,8 @@ Token ColorLexemeAction(LexicalAnalyzerContext *lexicalAnalyzerContext)
 
 Token StringLexemeAction(LexicalAnalyzerContext *lexicalAnalyzerContext) {
 	_logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
-	lexicalAnalyzerContext->semanticValue->string = malloc(strlen(lexicalAnalyzerContext->lexeme) + 1);
-	strcpy(lexicalAnalyzerContext->semanticValue->string, lexicalAnalyzerContext->lexeme);
+	lexicalAnalyzerContext->semanticValue->symbol = internSymbol(lexicalAnalyzerContext->compilerState->symbolTable,
+		lexicalAnalyzerContext->lexeme, lexicalAnalyzerContext->length, lexicalAnalyzerContext->line)->id;
 	return STRING;
 }
 
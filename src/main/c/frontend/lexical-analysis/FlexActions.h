@@ -1,6 +1,8 @@
 #ifndef FLEX_ACTIONS_HEADER
 #define FLEX_ACTIONS_HEADER
 
+#include "../../shared/Arena.h"
+#include "../../shared/CompilerState.h"
 #include "../../shared/Environment.h"
 #include "../../shared/Logger.h"
 #include "../../shared/String.h"
@@ -4,10 +4,30 @@
 /**
  * Hook that allows to export a static function or variable from the inside of
  * Flex infrastructure, in this case, the current context (a.k.a. start
- * condition).
+ * condition) of a reentrant scanner.
  */
-unsigned int flexCurrentContext(void) {
+unsigned int flexCurrentContext(yyscan_t yyscanner) {
+	struct yyguts_t * yyg = (struct yyguts_t *) yyscanner;
 	return YY_START;
 }
 
+/**
+ * Hook that prepares a scanner to scan an in-memory buffer in place, without
+ * copying it. The last two bytes of the buffer must be null characters.
+ * Returns false if the buffer is not properly terminated.
+ *
+ * @see https://westes.github.io/flex/manual/Multiple-Input-Buffers.html
+ */
+int flexBeginBuffer(char * buffer, const size_t size, yyscan_t yyscanner) {
+	return yy_scan_buffer(buffer, size, yyscanner) != NULL;
+}
+
+/**
+ * Hook that prepares a scanner to scan an stream incrementally, through its
+ * own buffers.
+ */
+void flexBeginStream(FILE * stream, yyscan_t yyscanner) {
+	yyrestart(stream, yyscanner);
+}
+
 #endif
@@ -1,30 +1,34 @@
 #ifndef LEXICAL_ANALYZER_CONTEXT_HEADER
 #define LEXICAL_ANALYZER_CONTEXT_HEADER
 
+#include "../../shared/CompilerState.h"
 #include <stdlib.h>
 #include <string.h>
 
 /**
- * The state of a lexical-analyzer context.
+ * The state of a lexical-analyzer context. The lexeme is a slice of the
+ * buffer of Flex (it isn't owned by the context), so it's only valid while
+ * the current lexeme action runs. Flex keeps it null-terminated meanwhile.
+ *
+ * Every reentrant scanner owns one context (its "extra" data), which also
+ * carries the compiler state of the program being scanned.
  */
 typedef struct {
+	CompilerState * compilerState;
 	unsigned int currentContext;
 	unsigned int length;
-	char * lexeme;
+	const char * lexeme;
 	unsigned int line;
 	union SemanticValue * semanticValue;
 } LexicalAnalyzerContext;
 
 /**
- * Creates a new context with the current state of the lexical-analyzer over
- * the lexeme just consumed. The lexeme is a deep-copy of the original,
- * allocated in heap-memory.
+ * Updates the context of the specified scanner with the current state of the
+ * lexical-analyzer over the lexeme just consumed, and returns it. The same
+ * context is reused for every lexeme, so this function never allocates
+ * memory: any payload that must outlive the lexeme action has to be copied
+ * explicitly.
  */
-LexicalAnalyzerContext * createLexicalAnalyzerContext();
-
-/**
- * Destroy a lexical-analyzer context and its resources.
- */
-void destroyLexicalAnalyzerContext(LexicalAnalyzerContext * lexicalAnalyzerContext);
+LexicalAnalyzerContext * currentLexicalAnalyzerContext(void * scanner);
 
 #endif
@@ -0,0 +1,149 @@
+#include "SourceCode.h"
+
+#if defined (_WIN32)
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeSourceCodeModule() {
+	_logger = createLogger("SourceCode");
+}
+
+void shutdownSourceCodeModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static SourceCode * _createSourceCode(const char * path);
+static boolean _mapFile(SourceCode * sourceCode);
+static boolean _readFile(SourceCode * sourceCode);
+
+/**
+ * Creates an empty source-code for the specified path.
+ */
+static SourceCode * _createSourceCode(const char * path) {
+	SourceCode * sourceCode = calloc(1, sizeof(SourceCode));
+	sourceCode->path = path;
+	return sourceCode;
+}
+
+/**
+ * Maps a regular file in memory. The mapping reserves, at least, two extra
+ * bytes of anonymous (thus, zeroed) memory after the content of the file,
+ * which act as the end-of-buffer marks of Flex. If the file is not regular
+ * (e.g., a named pipe), it's streamed instead.
+ *
+ * @see https://man7.org/linux/man-pages/man2/mmap.2.html
+ */
+static boolean _mapFile(SourceCode * sourceCode) {
+#if defined (_WIN32)
+	return _readFile(sourceCode);
+#else
+	const int descriptor = open(sourceCode->path, O_RDONLY);
+	if (descriptor < 0) {
+		return false;
+	}
+	struct stat status;
+	if (fstat(descriptor, &status) != 0 || !S_ISREG(status.st_mode)) {
+		close(descriptor);
+		sourceCode->stream = fopen(sourceCode->path, "r");
+		return sourceCode->stream != NULL;
+	}
+	const size_t length = (size_t) status.st_size;
+	const size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+	const size_t mappedSize = ((length + 2 + pageSize - 1) / pageSize) * pageSize;
+	char * region = mmap(NULL, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (region == MAP_FAILED) {
+		close(descriptor);
+		return false;
+	}
+	if (0 < length) {
+		void * content = mmap(region, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, descriptor, 0);
+		if (content == MAP_FAILED) {
+			// Some file-systems cannot map files (e.g., procfs).
+			munmap(region, mappedSize);
+			close(descriptor);
+			return _readFile(sourceCode);
+		}
+		madvise(region, length, MADV_SEQUENTIAL);
+	}
+	close(descriptor);
+	sourceCode->buffer = region;
+	sourceCode->size = length + 2;
+	sourceCode->mappedSize = mappedSize;
+	return true;
+#endif
+}
+
+/**
+ * Reads an entire file in heap-memory, followed by two null characters. Used
+ * where memory-mapped files are not available.
+ */
+static boolean _readFile(SourceCode * sourceCode) {
+	FILE * file = fopen(sourceCode->path, "rb");
+	if (file == NULL) {
+		return false;
+	}
+	struct stat status;
+	if (stat(sourceCode->path, &status) != 0) {
+		fclose(file);
+		return false;
+	}
+	const size_t length = (size_t) status.st_size;
+	sourceCode->buffer = calloc(length + 2, sizeof(char));
+	sourceCode->size = fread(sourceCode->buffer, sizeof(char), length, file) + 2;
+	fclose(file);
+	return true;
+}
+
+/* PUBLIC FUNCTIONS */
+
+SourceCode * openSourceCode(const char * path) {
+	SourceCode * sourceCode = _createSourceCode(path);
+	if (strcmp(path, STANDARD_INPUT_PATH) == 0) {
+		logDebugging(_logger, "Streaming the standard input...");
+		sourceCode->stream = stdin;
+		return sourceCode;
+	}
+	if (_mapFile(sourceCode)) {
+		logDebugging(_logger, "Opened \"%s\" (%zu bytes%s).", path,
+			sourceCode->buffer == NULL ? 0 : sourceCode->size - 2,
+			sourceCode->buffer == NULL ? ", streamed" : "");
+		return sourceCode;
+	}
+	logError(_logger, "Cannot open the source-code: \"%s\".", path);
+	free(sourceCode);
+	return NULL;
+}
+
+void closeSourceCode(SourceCode * sourceCode) {
+	if (sourceCode != NULL) {
+		if (sourceCode->stream != NULL && sourceCode->stream != stdin) {
+			fclose(sourceCode->stream);
+		}
+		if (sourceCode->buffer != NULL) {
+#if defined (_WIN32)
+			free(sourceCode->buffer);
+#else
+			if (0 < sourceCode->mappedSize) {
+				munmap(sourceCode->buffer, sourceCode->mappedSize);
+			}
+			else {
+				free(sourceCode->buffer);
+			}
+#endif
+		}
+		free(sourceCode);
+	}
+}
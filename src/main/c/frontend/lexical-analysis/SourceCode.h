@@ -0,0 +1,54 @@
+#ifndef SOURCE_CODE_HEADER
+#define SOURCE_CODE_HEADER
+
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The path that selects the standard input as the source-code.
+ */
+#define STANDARD_INPUT_PATH "-"
+
+/** Initialize module's internal state. */
+void initializeSourceCodeModule();
+
+/** Shutdown module's internal state. */
+void shutdownSourceCodeModule();
+
+/**
+ * The input of a compilation. A file is exposed as an in-memory buffer,
+ * followed by the two null characters that Flex requires to scan it in place
+ * (i.e., without copying it into its own buffers). A pipe, instead, is
+ * exposed as a stream, and Flex reads it incrementally.
+ */
+typedef struct {
+	const char * path;
+
+	// The content (or NULL, when streaming), and its size in bytes, including
+	// the two trailing null characters.
+	char * buffer;
+	size_t size;
+
+	// The length of the mapped region (zero, if it was read into the heap).
+	size_t mappedSize;
+
+	// The stream to read incrementally (or NULL, when buffered).
+	FILE * stream;
+} SourceCode;
+
+/**
+ * Opens the source-code at the specified path. Regular files are memory
+ * mapped (copy-on-write, so Flex can modify the buffer while scanning), and
+ * the standard input is streamed. Returns NULL if the file cannot be opened.
+ */
+SourceCode * openSourceCode(const char * path);
+
+/**
+ * Closes a source-code and releases its resources.
+ */
+void closeSourceCode(SourceCode * sourceCode);
+
+#endif
@@ -48,6 +48,11 @@ typedef struct Range Range;
 
 /**
  * Node types for the Abstract Syntax Tree (AST).
+ *
+ * Every list (i.e., arrays, cell-lists, configurations and sequences) is a
+ * contiguous vector allocated from the arena, with the amount of elements
+ * and the capacity reserved for them. An empty list has no elements, but
+ * it's never NULL.
  */
 
 enum ProgramType {
@@ -141,6 +146,8 @@ struct ArithmeticExpression {
 		struct {
 			CellList * cellList;
 			int count;
+			// The symbol of the state compared against.
+			unsigned int state;
 		};
 		Constant * constant;
 	};
@@ -170,15 +177,9 @@ struct Evolution {
 };
 
 struct Configuration {
-	boolean isLast;
-	union {
-		Option * lastOption;
-		struct {
-			Option * option;
-			Configuration * next;
-		};
-		
-	};	
+	Option ** options;
+	unsigned int count;
+	unsigned int capacity;
 };
 
 struct Constant {
@@ -186,42 +187,28 @@ struct Constant {
 	union 
 	{
 		int value;
-		char * string;
+		// The identifier of a state or variable (see "SymbolTable.h").
+		unsigned int symbol;
 		Cell * cell;
 	};
 };
 
 struct IntArray {
-	boolean isLast;
-	union {
-		int lastValue;
-		struct {
-			int value;
-			IntArray * next;
-		};
-	};
+	int * values;
+	unsigned int count;
+	unsigned int capacity;
 };
 
 struct StringArray {
-	boolean isLast;
-	union {
-		char * lastValue;
-		struct {
-			char * value;
-			StringArray * next;
-		};
-	};
+	unsigned int * values;
+	unsigned int count;
+	unsigned int capacity;
 };
 
 struct ConstantArray {
-	boolean isLast;
-	union {
-		Constant * lastValue;
-		struct {
-			Constant * value;
-			ConstantArray * next;
-		};
-	};
+	Constant ** values;
+	unsigned int count;
+	unsigned int capacity;
 };
 
 struct Cell {
@@ -239,14 +226,9 @@ struct Cell {
 };
 
 struct CellList {
-	boolean isLast;
-	union {
-		Cell * last;
-		struct {
-			Cell * cell;
-			CellList * next;
-		};
-	};
+	Cell ** cells;
+	unsigned int count;
+	unsigned int capacity;
 };
 
 struct Range {
@@ -261,25 +243,15 @@ struct Range {
 };
 
 struct TransitionSequence {
-	boolean binary;
-	union {
-		TransitionExpression * expression;
-		struct {
-			TransitionSequence * sequence;
-			TransitionExpression *rightExpression;
-		};
-	};
+	TransitionExpression ** expressions;
+	unsigned int count;
+	unsigned int capacity;
 };
 
 struct NeighborhoodSequence {
-	boolean binary;
-	union {
-		NeighborhoodExpression * expression;
-		struct {
-			NeighborhoodSequence * sequence;
-			NeighborhoodExpression * rightExpression;
-		};
-	};
+	NeighborhoodExpression ** expressions;
+	unsigned int count;
+	unsigned int capacity;
 };
 
 struct TransitionExpression {
@@ -287,10 +259,10 @@ struct TransitionExpression {
 	union {
 		struct {
 			ArithmeticExpression * assignment;
-			char * variable;
+			unsigned int variable;
 		};
 		struct {
-			char * forVariable;
+			unsigned int forVariable;
 			Range * range;
 			TransitionSequence * forBody;
 		};
@@ -312,10 +284,10 @@ struct NeighborhoodExpression {
 	union {
 		struct {
 			ArithmeticExpression * assignment;
-			char * variable;
+			unsigned int variable;
 		};
 		struct {
-			char * forVariable;
+			unsigned int forVariable;
 			Range * range;
 			NeighborhoodSequence * forBody;
 		};
@@ -333,24 +305,4 @@ struct NeighborhoodExpression {
 	};
 };
 
-/**
- * Node recursive destructors.
- */
-void releaseConstant(Constant * constant);
-void releaseArithmeticExpression(ArithmeticExpression * expression);
-void releaseProgram(Program * program);
-void releaseTransitionSequence(TransitionSequence * transitionSequence);
-void releaseNeighborhoodSequence(NeighborhoodSequence * neighborhoodSequence);
-void releaseTransitionExpression(TransitionExpression * transitionExpression);
-void releaseNeighborhoodExpression(NeighborhoodExpression * neighborhoodExpression);
-void releaseOption(Option * option);
-void releaseEvolution(Evolution * evolution);
-void releaseConfiguration(Configuration * configuration);
-void releaseIntArray(IntArray * array);
-void releaseStringArray(StringArray * array);
-void releaseConstantArray(ConstantArray * array);
-void releaseCell(Cell * cell);
-void releaseCellList(CellList * list);
-void releaseRange(Range * range);
-
 #endif
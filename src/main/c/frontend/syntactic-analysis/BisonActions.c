@@ -14,13 +14,55 @@ void shutdownBisonActionsModule() {
 	}
 }
 
-/** IMPORTED FUNCTIONS */
-
-extern unsigned int flexCurrentContext(void);
-
 /* PRIVATE FUNCTIONS */
 
+static void _declareStates(CompilerState * compilerState, StringArray * states);
+static void _declareVariable(CompilerState * compilerState, const unsigned int variable);
+static void * _growVector(CompilerState * compilerState, void * values, unsigned int * capacity, const size_t size);
 static void _logSyntacticAnalyzerAction(const char * functionName);
+static void _useAsState(CompilerState * compilerState, const unsigned int state);
+
+/**
+ * Assigns to every state its index in the "States" option, in order of
+ * declaration.
+ */
+static void _declareStates(CompilerState * compilerState, StringArray * states) {
+	SymbolTable * symbolTable = compilerState->symbolTable;
+	for (unsigned int k = 0; k < states->count; ++k) {
+		Symbol * symbol = getSymbol(symbolTable, states->values[k]);
+		if (symbol->state != NO_STATE) {
+			logError(_logger, "The state \"%s\" is declared more than once (on line %u).", symbol->name, symbol->line);
+			++compilerState->errors;
+		}
+		else {
+			symbol->state = symbolTable->states++;
+		}
+	}
+}
+
+/**
+ * Marks an assigned (or loop-bound) symbol as a variable. A state cannot be
+ * used as a variable.
+ */
+static void _declareVariable(CompilerState * compilerState, const unsigned int variable) {
+	Symbol * symbol = getSymbol(compilerState->symbolTable, variable);
+	if (symbol->state != NO_STATE) {
+		logError(_logger, "The state \"%s\" cannot be used as a variable.", symbol->name);
+		++compilerState->errors;
+	}
+	symbol->isVariable = true;
+}
+
+/**
+ * Doubles the capacity of the elements of a list (of the specified size),
+ * inside the arena.
+ */
+static void * _growVector(CompilerState * compilerState, void * values, unsigned int * capacity, const size_t size) {
+	const unsigned int newCapacity = *capacity == 0 ? 4 : 2 * *capacity;
+	void * newValues = reallocateInArena(compilerState->arena, values, *capacity * size, newCapacity * size);
+	*capacity = newCapacity;
+	return newValues;
+}
 
 /**
  * Logs a syntactic-analyzer action in DEBUGGING level.
@@ -29,22 +71,37 @@ static void _logSyntacticAnalyzerAction(const char * functionName) {
 	logDebugging(_logger, "%s", functionName);
 }
 
+/**
+ * Checks that a symbol is a state. Since the configuration precedes the
+ * transition, every state is already declared.
+ */
+static void _useAsState(CompilerState * compilerState, const unsigned int state) {
+	Symbol * symbol = getSymbol(compilerState->symbolTable, state);
+	if (symbol->state == NO_STATE) {
+		logError(_logger, "Expected a state, but found \"%s\" (on line %u).", symbol->name, symbol->line);
+		++compilerState->errors;
+	}
+}
+
 /* PUBLIC FUNCTIONS */
 
 void compilerStateCheck(CompilerState * compilerState, Program * program) {
-	compilerState->abstractSyntaxtTree = program;
-	if (0 < flexCurrentContext()) {
-		logError(_logger, "The final context is not the default (0): %d", flexCurrentContext());
-		compilerState->succeed = false;
-	}
-	else {
-		compilerState->succeed = true;
+	// Every symbol must be resolved to a state or to a variable.
+	SymbolTable * symbolTable = compilerState->symbolTable;
+	for (unsigned int k = 0; k < symbolTable->count; ++k) {
+		Symbol * symbol = getSymbol(symbolTable, k);
+		if (symbol->state == NO_STATE && !symbol->isVariable) {
+			logError(_logger, "Unknown state or variable \"%s\" (on line %u).", symbol->name, symbol->line);
+			++compilerState->errors;
+		}
 	}
+	compilerState->abstractSyntaxtTree = program;
+	compilerState->succeed = compilerState->errors == 0;
 }
 
 Program * DefaultProgramSemanticAction(CompilerState * compilerState, Configuration * justConfiguration) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Program * program = calloc(1, sizeof(Program));
+	Program * program = allocateFromArena(compilerState->arena, sizeof(Program));
 	program->justConfiguration = justConfiguration;
 	program->type = DEFAULT;
 	compilerStateCheck(compilerState, program);
@@ -53,7 +110,7 @@ Program * DefaultProgramSemanticAction(CompilerState * compilerState, Configurat
 
 Program * TransitionProgramSemanticAction(CompilerState * compilerState, Configuration * configuration, TransitionSequence * transitionSequence) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Program * program = calloc(1, sizeof(Program));
+	Program * program = allocateFromArena(compilerState->arena, sizeof(Program));
 	program->configuration = configuration;
 	program->transitionSequence = transitionSequence;
 	program->type = TRANSITION;
@@ -63,7 +120,7 @@ Program * TransitionProgramSemanticAction(CompilerState * compilerState, Configu
 
 Program * NeighborhoodProgramSemanticAction(CompilerState * compilerState, Configuration * configuration, NeighborhoodSequence * neigborhoodSequence) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Program * program = calloc(1, sizeof(Program));
+	Program * program = allocateFromArena(compilerState->arena, sizeof(Program));
 	program->configuration = configuration;
 	program->neighborhoodSequence = neigborhoodSequence;
 	program->type = NEIGHBORHOOD_PROGRAM;
@@ -71,131 +128,129 @@ Program * NeighborhoodProgramSemanticAction(CompilerState * compilerState, Confi
 	return program;
 }
 
-Configuration * ConfigurationSemanticAction(Option * option, Configuration * config) {
+Configuration * ConfigurationSemanticAction(CompilerState * compilerState, Configuration * configuration, Option * option) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Configuration * configuration = calloc(1, sizeof(Configuration));
-	if (config == NULL) {
-		configuration->isLast = 1;
-		configuration->lastOption = option;
-	} else {
-		configuration->isLast = 0;
-		configuration->option = option;
-		configuration->next = config;
+	if (configuration == NULL) {
+		configuration = allocateFromArena(compilerState->arena, sizeof(Configuration));
+	}
+	if (configuration->count == configuration->capacity) {
+		configuration->options = _growVector(compilerState, configuration->options, &configuration->capacity, sizeof(Option *));
 	}
+	configuration->options[configuration->count++] = option;
 	return configuration;
 }
 
-TransitionSequence * TransitionUnarySequenceSemanticAction(TransitionExpression * expression) {
+TransitionSequence * TransitionSequenceSemanticAction(CompilerState * compilerState, TransitionSequence * sequence, TransitionExpression * expression) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	TransitionSequence * rta = calloc(1, sizeof(TransitionSequence));
-	rta->binary = false;
-	rta->expression = expression;
-	return rta;
-}
-TransitionSequence * TransitionBinarySequenceSemanticAction(TransitionSequence * sequence, TransitionExpression * expression) {
-	_logSyntacticAnalyzerAction(__FUNCTION__);
-	TransitionSequence * rta = calloc(1, sizeof(TransitionSequence));
-	rta->binary = true;
-	rta->sequence = sequence;
-	rta->rightExpression = expression;
-	return rta;
+	if (sequence == NULL) {
+		sequence = allocateFromArena(compilerState->arena, sizeof(TransitionSequence));
+	}
+	if (expression != NULL) {
+		if (sequence->count == sequence->capacity) {
+			sequence->expressions = _growVector(compilerState, sequence->expressions, &sequence->capacity, sizeof(TransitionExpression *));
+		}
+		sequence->expressions[sequence->count++] = expression;
+	}
+	return sequence;
 }
 
-TransitionExpression * TransitionAssignmentExpressionSemanticAction(char * variable, ArithmeticExpression * arithmeticExpression) {
+TransitionExpression * TransitionAssignmentExpressionSemanticAction(CompilerState * compilerState, const unsigned int variable, ArithmeticExpression * arithmeticExpression) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	TransitionExpression * expression = calloc(1, sizeof(TransitionExpression));
+	TransitionExpression * expression = allocateFromArena(compilerState->arena, sizeof(TransitionExpression));
 	expression->type = TRANSITION_ASSIGNMENT;
 	expression->variable = variable;
+	_declareVariable(compilerState, variable);
 	expression->assignment = arithmeticExpression;
 	return expression;
 }
-TransitionExpression * TransitionForLoopExpressionSemanticAction(char * variable, Range * range, TransitionSequence * transitionExpression) {
+TransitionExpression * TransitionForLoopExpressionSemanticAction(CompilerState * compilerState, const unsigned int variable, Range * range, TransitionSequence * transitionExpression) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	TransitionExpression * expression = calloc(1, sizeof(TransitionExpression));
+	TransitionExpression * expression = allocateFromArena(compilerState->arena, sizeof(TransitionExpression));
 	expression->type = TRANSITION_FOR_LOOP;
 	expression->forVariable = variable;
+	_declareVariable(compilerState, variable);
 	expression->range = range;
 	expression->forBody = transitionExpression;
 	return expression;
 }
-TransitionExpression * TransitionIfExpressionSemanticAction(ArithmeticExpression * arithmeticExpression, TransitionSequence * transitionExpression) {
+TransitionExpression * TransitionIfExpressionSemanticAction(CompilerState * compilerState, ArithmeticExpression * arithmeticExpression, TransitionSequence * transitionExpression) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	TransitionExpression * expression = calloc(1, sizeof(TransitionExpression));
+	TransitionExpression * expression = allocateFromArena(compilerState->arena, sizeof(TransitionExpression));
 	expression->type = TRANSITION_IF;
 	expression->ifCondition = arithmeticExpression;
 	expression->ifBody = transitionExpression;
 	return expression;
 }
-TransitionExpression * TransitionIfElseExpressionSemanticAction(ArithmeticExpression * arithmeticExpression, TransitionSequence * ifTransitionExpression, TransitionSequence * elseTransitionExpression) {
+TransitionExpression * TransitionIfElseExpressionSemanticAction(CompilerState * compilerState, ArithmeticExpression * arithmeticExpression, TransitionSequence * ifTransitionExpression, TransitionSequence * elseTransitionExpression) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	TransitionExpression * expression = calloc(1, sizeof(TransitionExpression));
+	TransitionExpression * expression = allocateFromArena(compilerState->arena, sizeof(TransitionExpression));
 	expression->type = TRANSITION_IF_ELSE;
 	expression->ifElseCondition = arithmeticExpression;
 	expression->ifElseIfBody = ifTransitionExpression;
 	expression->ifElseElseBody = elseTransitionExpression;
 	return expression;
 }
-TransitionExpression * TransitionReturnExpressionSemanticAction(ArithmeticExpression * arithmeticExpression) {
+TransitionExpression * TransitionReturnExpressionSemanticAction(CompilerState * compilerState, ArithmeticExpression * arithmeticExpression) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	TransitionExpression * expression = calloc(1, sizeof(TransitionExpression));
+	TransitionExpression * expression = allocateFromArena(compilerState->arena, sizeof(TransitionExpression));
 	expression->type = RETURN_VALUE;
 	expression->returnValue = arithmeticExpression;
 	return expression;
 }
 
-NeighborhoodSequence * NeighborhoodUnarySequenceSemanticAction(NeighborhoodExpression * expression) {
-	_logSyntacticAnalyzerAction(__FUNCTION__);
-	NeighborhoodSequence * rta = calloc(1, sizeof(NeighborhoodSequence));
-	rta->binary = false;
-	rta->expression = expression;
-	return rta;
-}
-NeighborhoodSequence * NeighborhoodBinarySequenceSemanticAction(NeighborhoodSequence * sequence, NeighborhoodExpression * expression) {
+NeighborhoodSequence * NeighborhoodSequenceSemanticAction(CompilerState * compilerState, NeighborhoodSequence * sequence, NeighborhoodExpression * expression) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	NeighborhoodSequence * rta = calloc(1, sizeof(NeighborhoodSequence));
-	rta->binary = true;
-	rta->sequence = sequence;
-	rta->rightExpression = expression;
-	return rta;
+	if (sequence == NULL) {
+		sequence = allocateFromArena(compilerState->arena, sizeof(NeighborhoodSequence));
+	}
+	if (expression != NULL) {
+		if (sequence->count == sequence->capacity) {
+			sequence->expressions = _growVector(compilerState, sequence->expressions, &sequence->capacity, sizeof(NeighborhoodExpression *));
+		}
+		sequence->expressions[sequence->count++] = expression;
+	}
+	return sequence;
 }
 
-NeighborhoodExpression * NeighborhoodAssignmentExpressionSemanticAction(char * variable, ArithmeticExpression * arithmeticExpression) {
+NeighborhoodExpression * NeighborhoodAssignmentExpressionSemanticAction(CompilerState * compilerState, const unsigned int variable, ArithmeticExpression * arithmeticExpression) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	NeighborhoodExpression * expression = calloc(1, sizeof(NeighborhoodExpression));
+	NeighborhoodExpression * expression = allocateFromArena(compilerState->arena, sizeof(NeighborhoodExpression));
 	expression->type = NEIGHBORHOOD_ASSIGNMENT;
 	expression->variable = variable;
+	_declareVariable(compilerState, variable);
 	expression->assignment = arithmeticExpression;
 	return expression;
 }
-NeighborhoodExpression * NeighborhoodForLoopExpressionSemanticAction(char * variable, Range * range, NeighborhoodSequence * neighborhoodExpression) {
+NeighborhoodExpression * NeighborhoodForLoopExpressionSemanticAction(CompilerState * compilerState, const unsigned int variable, Range * range, NeighborhoodSequence * neighborhoodExpression) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	NeighborhoodExpression * expression = calloc(1, sizeof(NeighborhoodExpression));
+	NeighborhoodExpression * expression = allocateFromArena(compilerState->arena, sizeof(NeighborhoodExpression));
 	expression->type = NEIGHBORHOOD_FOR_LOOP;
 	expression->forVariable = variable;
+	_declareVariable(compilerState, variable);
 	expression->range = range;
 	expression->forBody = neighborhoodExpression;
 	return expression;
 }
-NeighborhoodExpression * NeighborhoodIfExpressionSemanticAction(ArithmeticExpression * arithmeticExpression, NeighborhoodSequence * neighborhoodExpression) {
+NeighborhoodExpression * NeighborhoodIfExpressionSemanticAction(CompilerState * compilerState, ArithmeticExpression * arithmeticExpression, NeighborhoodSequence * neighborhoodExpression) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	NeighborhoodExpression * expression = calloc(1, sizeof(NeighborhoodExpression));
+	NeighborhoodExpression * expression = allocateFromArena(compilerState->arena, sizeof(NeighborhoodExpression));
 	expression->type = NEIGHBORHOOD_IF;
 	expression->ifCondition = arithmeticExpression;
 	expression->ifBody = neighborhoodExpression;
 	return expression;
 }
-NeighborhoodExpression * NeighborhoodIfElseExpressionSemanticAction(ArithmeticExpression * arithmeticExpression, NeighborhoodSequence * ifNeighborhoodExpression, NeighborhoodSequence * elseNeighborhoodExpression) {
+NeighborhoodExpression * NeighborhoodIfElseExpressionSemanticAction(CompilerState * compilerState, ArithmeticExpression * arithmeticExpression, NeighborhoodSequence * ifNeighborhoodExpression, NeighborhoodSequence * elseNeighborhoodExpression) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	NeighborhoodExpression * expression = calloc(1, sizeof(NeighborhoodExpression));
+	NeighborhoodExpression * expression = allocateFromArena(compilerState->arena, sizeof(NeighborhoodExpression));
 	expression->type = NEIGHBORHOOD_IF_ELSE;
 	expression->ifElseCondition = arithmeticExpression;
 	expression->ifElseIfBody = ifNeighborhoodExpression;
 	expression->ifElseElseBody = elseNeighborhoodExpression;
 	return expression;
 }
-NeighborhoodExpression * NeighborhoodCellExpressionSemanticAction(boolean add, CellList * cellList) {
+NeighborhoodExpression * NeighborhoodCellExpressionSemanticAction(CompilerState * compilerState, boolean add, CellList * cellList) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	NeighborhoodExpression * expression = calloc(1, sizeof(NeighborhoodExpression));
+	NeighborhoodExpression * expression = allocateFromArena(compilerState->arena, sizeof(NeighborhoodExpression));
 	if (add) {
 		expression->type = ADD_CELL_EXP;
 		expression->toAddList = cellList;
@@ -207,52 +262,53 @@ NeighborhoodExpression * NeighborhoodCellExpressionSemanticAction(boolean add, C
 	return expression;
 }
 
-Option * IntValuedOptionSemanticAction(const int value, OptionType type) {
+Option * IntValuedOptionSemanticAction(CompilerState * compilerState, const int value, OptionType type) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Option * option = calloc(1, sizeof(Option));
+	Option * option = allocateFromArena(compilerState->arena, sizeof(Option));
 	option->type = type;
 	option->value = value;
 	return option;
 }
-Option * IntArrayValuedOptionSemanticAction(IntArray * value) {
+Option * IntArrayValuedOptionSemanticAction(CompilerState * compilerState, IntArray * value) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Option * option = calloc(1, sizeof(Option));
+	Option * option = allocateFromArena(compilerState->arena, sizeof(Option));
 	option->type = COLORS_OPTION;
 	option->colors = value;
 	return option;
 }
-Option * StringArrayValuedOptionSemanticAction(StringArray * value) {
+Option * StringArrayValuedOptionSemanticAction(CompilerState * compilerState, StringArray * value) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Option * option = calloc(1, sizeof(Option));
+	Option * option = allocateFromArena(compilerState->arena, sizeof(Option));
 	option->type = STATES_OPTION;
 	option->states = value;
+	_declareStates(compilerState, value);
 	return option;
 }
-Option * FrontierOptionSemanticAction(const FrontierEnum value) {
+Option * FrontierOptionSemanticAction(CompilerState * compilerState, const FrontierEnum value) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Option * option = calloc(1, sizeof(Option));
+	Option * option = allocateFromArena(compilerState->arena, sizeof(Option));
 	option->type = FRONTIER_OPTION;
 	option->frontierType = value;
 	return option;
 }
-Option * NeighborhoodOptionSemanticAction(const NeighborhoodEnum value) {
+Option * NeighborhoodOptionSemanticAction(CompilerState * compilerState, const NeighborhoodEnum value) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Option * option = calloc(1, sizeof(Option));
+	Option * option = allocateFromArena(compilerState->arena, sizeof(Option));
 	option->type = NEIGHBORHOOD_OPTION;
 	option->neighborhoodEnum = value;
 	return option;
 }
-Option * EvolutionOptionSemanticAction(Evolution * value) {
+Option * EvolutionOptionSemanticAction(CompilerState * compilerState, Evolution * value) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Option * option = calloc(1, sizeof(Option));
+	Option * option = allocateFromArena(compilerState->arena, sizeof(Option));
 	option->type = EVOLUTION_OPTION;
 	option->evolution = value;
 	return option;
 }
 
-Evolution * EvolutionSemanticAction(IntArray * array, const int value, const EvolutionEnum type) {
+Evolution * EvolutionSemanticAction(CompilerState * compilerState, IntArray * array, const int value, const EvolutionEnum type) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Evolution * evolution = calloc(1, sizeof(Evolution));
+	Evolution * evolution = allocateFromArena(compilerState->arena, sizeof(Evolution));
 	if (array != NULL) {
 		evolution->isDefault = false;
 		evolution->array = array;
@@ -266,146 +322,135 @@ Evolution * EvolutionSemanticAction(IntArray * array, const int value, const Evo
 
 
 
-Cell * SingleCoordinateCellSemanticAction(Constant * c, DisplacementType type) {
+Cell * SingleCoordinateCellSemanticAction(CompilerState * compilerState, Constant * c, DisplacementType type) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Cell * cell = calloc(1, sizeof(Cell));
+	Cell * cell = allocateFromArena(compilerState->arena, sizeof(Cell));
 	cell->isSingleCoordenate = true;
 	cell->displacement = c;
 	cell->displacementType = type;
 	return cell;
 }
 
-Cell * DoubleCoordinateCellSemanticAction(Constant * x, Constant * y) {
+Cell * DoubleCoordinateCellSemanticAction(CompilerState * compilerState, Constant * x, Constant * y) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Cell * cell = calloc(1, sizeof(Cell));
+	Cell * cell = allocateFromArena(compilerState->arena, sizeof(Cell));
 	cell->isSingleCoordenate = false;
 	cell->x = x;
 	cell->y = y;
 	return cell;
 }
 
-CellList * CellListSemanticAction(Cell * cell, CellList * list) {
+CellList * CellListSemanticAction(CompilerState * compilerState, CellList * cellList, Cell * cell) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	CellList * cellList = calloc(1, sizeof(CellList));
-	if (list == NULL) {
-		cellList->isLast = true;
-		cellList->last = cell;
-	} else {
-		cellList->isLast = false;
-		cellList->cell = cell;
-		cellList->next = list;
+	if (cellList == NULL) {
+		cellList = allocateFromArena(compilerState->arena, sizeof(CellList));
 	}
-	
+	if (cellList->count == cellList->capacity) {
+		cellList->cells = _growVector(compilerState, cellList->cells, &cellList->capacity, sizeof(Cell *));
+	}
+	cellList->cells[cellList->count++] = cell;
 	return cellList;
 }
 
-Constant * IntegerConstantSemanticAction(const int value) {
+Constant * IntegerConstantSemanticAction(CompilerState * compilerState, const int value) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Constant * constant = calloc(1, sizeof(Constant));
+	Constant * constant = allocateFromArena(compilerState->arena, sizeof(Constant));
 	constant->value = value;
 	constant->type = INTEGER_C;
 	return constant;
 }
 
-Constant * StringConstantSemanticAction(char * value) {
+Constant * StringConstantSemanticAction(CompilerState * compilerState, const unsigned int symbol) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Constant * constant = calloc(1, sizeof(Constant));
-	char * string = malloc(strlen(value) + 1);
-	strcpy(string, value);
-	constant->string = string;
+	Constant * constant = allocateFromArena(compilerState->arena, sizeof(Constant));
+	constant->symbol = symbol;
 	constant->type = STRING_C;
 	return constant;
 }
 
-Constant * CellConstantSemanticAction(Cell * cell) {
+Constant * CellConstantSemanticAction(CompilerState * compilerState, Cell * cell) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Constant * constant = calloc(1, sizeof(Constant));
+	Constant * constant = allocateFromArena(compilerState->arena, sizeof(Constant));
 	constant->cell = cell;
 	constant->type = CELL_C;
 	return constant;
 }
 
-ArithmeticExpression * BinaryArithmeticExpressionSemanticAction(ArithmeticExpression * leftExpression, ArithmeticExpression * rightExpression, ArithmeticExpressionType type) {
+ArithmeticExpression * BinaryArithmeticExpressionSemanticAction(CompilerState * compilerState, ArithmeticExpression * leftExpression, ArithmeticExpression * rightExpression, ArithmeticExpressionType type) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	ArithmeticExpression * expression = calloc(1, sizeof(ArithmeticExpression));
+	ArithmeticExpression * expression = allocateFromArena(compilerState->arena, sizeof(ArithmeticExpression));
 	expression->leftExpression = leftExpression;
 	expression->rightExpression = rightExpression;
 	expression->type = type;
 	return expression;
 }
 
-ArithmeticExpression * UnaryArithmeticExpressionSemanticAction(ArithmeticExpression * innerExpression, ArithmeticExpressionType type) {
+ArithmeticExpression * UnaryArithmeticExpressionSemanticAction(CompilerState * compilerState, ArithmeticExpression * innerExpression, ArithmeticExpressionType type) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	ArithmeticExpression * expression = calloc(1, sizeof(ArithmeticExpression));
+	ArithmeticExpression * expression = allocateFromArena(compilerState->arena, sizeof(ArithmeticExpression));
 	expression->expression = innerExpression;
 	expression->type = type;
 	return expression;
 }
 
-ArithmeticExpression * CellListArithmeticExpressionSemanticAction(CellList * cellList, ArithmeticExpressionType type, int count) {
+ArithmeticExpression * CellListArithmeticExpressionSemanticAction(CompilerState * compilerState, CellList * cellList, ArithmeticExpressionType type, int count, const unsigned int state) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	ArithmeticExpression * expression = calloc(1, sizeof(ArithmeticExpression));
+	ArithmeticExpression * expression = allocateFromArena(compilerState->arena, sizeof(ArithmeticExpression));
 	expression->cellList = cellList;
 	expression->count = count;
+	expression->state = state;
+	_useAsState(compilerState, state);
 	expression->type = type;
 	return expression;
 }
 
-ArithmeticExpression * ConstantArithmeticExpressionSemanticAction(Constant * constant) {
+ArithmeticExpression * ConstantArithmeticExpressionSemanticAction(CompilerState * compilerState, Constant * constant) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	ArithmeticExpression * expression = calloc(1, sizeof(ArithmeticExpression));
+	ArithmeticExpression * expression = allocateFromArena(compilerState->arena, sizeof(ArithmeticExpression));
 	expression->constant = constant;
 	expression->type = CONSTANT;
 	return expression;
 }
 
-IntArray * IntArraySemanticAction(const int value, IntArray * arr) {
+IntArray * IntArraySemanticAction(CompilerState * compilerState, IntArray * array, const int value) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	IntArray * intArray = calloc(1, sizeof(IntArray));
-	if (arr == NULL) {
-		intArray->isLast = 1;
-		intArray->lastValue = value;
-	} else {
-		intArray->isLast = 0;
-		intArray->value = value;
-		intArray->next = arr;
+	if (array == NULL) {
+		array = allocateFromArena(compilerState->arena, sizeof(IntArray));
+	}
+	if (array->count == array->capacity) {
+		array->values = _growVector(compilerState, array->values, &array->capacity, sizeof(int));
 	}
-	return intArray;
+	array->values[array->count++] = value;
+	return array;
 }
 
-StringArray * StringArraySemanticAction(char * value, StringArray * arr) {
+StringArray * StringArraySemanticAction(CompilerState * compilerState, StringArray * array, const unsigned int value) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	StringArray * stringArray = calloc(1, sizeof(StringArray));
-	char * string = malloc(strlen(value) + 1);
-	strcpy(string, value);
-	if (arr == NULL) {
-		stringArray->isLast = 1;
-		stringArray->lastValue = string;
-	} else {
-		stringArray->isLast = 0;
-		stringArray->value = string;
-		stringArray->next = arr;
+	if (array == NULL) {
+		array = allocateFromArena(compilerState->arena, sizeof(StringArray));
+	}
+	if (array->count == array->capacity) {
+		array->values = _growVector(compilerState, array->values, &array->capacity, sizeof(unsigned int));
 	}
-	return stringArray;
+	array->values[array->count++] = value;
+	return array;
 }
 
-ConstantArray * ConstantArraySemanticAction(Constant * value, ConstantArray * arr) {
+ConstantArray * ConstantArraySemanticAction(CompilerState * compilerState, ConstantArray * array, Constant * value) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	ConstantArray * constantArray = calloc(1, sizeof(ConstantArray));
-	if (arr == NULL) {
-		constantArray->isLast = 1;
-		constantArray->lastValue = value;
-	} else {
-		constantArray->isLast = 0;
-		constantArray->value = value;
-		constantArray->next = arr;
+	if (array == NULL) {
+		array = allocateFromArena(compilerState->arena, sizeof(ConstantArray));
+	}
+	if (array->count == array->capacity) {
+		array->values = _growVector(compilerState, array->values, &array->capacity, sizeof(Constant *));
 	}
-	return constantArray;
+	array->values[array->count++] = value;
+	return array;
 }
 
-Range * RangeSemanticAction(ConstantArray * array, Constant * start, Constant * end) {
+Range * RangeSemanticAction(CompilerState * compilerState, ConstantArray * array, Constant * start, Constant * end) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Range * range = calloc(1, sizeof(Range));
+	Range * range = allocateFromArena(compilerState->arena, sizeof(Range));
 	if (array == NULL) {
 		range->type = INTERVAL;
 		range->start = start;
@@ -15,59 +15,59 @@ void initializeBisonActionsModule();
 void shutdownBisonActionsModule();
 
 /**
- * Bison semantic actions.
+ * Bison semantic actions. The actions of lists append an element to a list,
+ * or create it if the list is NULL (i.e., the first element of a
+ * left-recursive rule).
  */
 
 Program * DefaultProgramSemanticAction(CompilerState * compilerState, Configuration * justConfiguration);
 Program * TransitionProgramSemanticAction(CompilerState * compilerState, Configuration * configuration, TransitionSequence * transitionSequence);
 Program * NeighborhoodProgramSemanticAction(CompilerState * compilerState, Configuration * configuration, NeighborhoodSequence * neigborhoodSequence);
 
-Configuration * ConfigurationSemanticAction(Option * option, Configuration * config);
+Configuration * ConfigurationSemanticAction(CompilerState * compilerState, Configuration * configuration, Option * option);
 
-Option * IntValuedOptionSemanticAction(const int value, OptionType type);
-Option * IntArrayValuedOptionSemanticAction(IntArray * value);
-Option * StringArrayValuedOptionSemanticAction(StringArray * value);
-Option * FrontierOptionSemanticAction(const FrontierEnum value);
-Option * NeighborhoodOptionSemanticAction(const NeighborhoodEnum value);
-Option * EvolutionOptionSemanticAction(Evolution * value);
+Option * IntValuedOptionSemanticAction(CompilerState * compilerState, const int value, OptionType type);
+Option * IntArrayValuedOptionSemanticAction(CompilerState * compilerState, IntArray * value);
+Option * StringArrayValuedOptionSemanticAction(CompilerState * compilerState, StringArray * value);
+Option * FrontierOptionSemanticAction(CompilerState * compilerState, const FrontierEnum value);
+Option * NeighborhoodOptionSemanticAction(CompilerState * compilerState, const NeighborhoodEnum value);
+Option * EvolutionOptionSemanticAction(CompilerState * compilerState, Evolution * value);
 
-Evolution * EvolutionSemanticAction(IntArray * array, const int value, const EvolutionEnum type);
+Evolution * EvolutionSemanticAction(CompilerState * compilerState, IntArray * array, const int value, const EvolutionEnum type);
 
-TransitionSequence * TransitionUnarySequenceSemanticAction(TransitionExpression * expression);
-TransitionSequence * TransitionBinarySequenceSemanticAction(TransitionSequence * sequence, TransitionExpression * expression);
+TransitionSequence * TransitionSequenceSemanticAction(CompilerState * compilerState, TransitionSequence * sequence, TransitionExpression * expression);
 
-TransitionExpression * TransitionAssignmentExpressionSemanticAction(char * variable, ArithmeticExpression * arithmeticExpression);
-TransitionExpression * TransitionForLoopExpressionSemanticAction(char * variable, Range * range, TransitionSequence * transitionExpression);
-TransitionExpression * TransitionIfExpressionSemanticAction(ArithmeticExpression * arithmeticExpression, TransitionSequence * transitionExpression);
-TransitionExpression * TransitionIfElseExpressionSemanticAction(ArithmeticExpression * arithmeticExpression, TransitionSequence * ifTransitionExpression, TransitionSequence * elseTransitionExpression);
-TransitionExpression * TransitionReturnExpressionSemanticAction(ArithmeticExpression * arithmeticExpression);
+TransitionExpression * TransitionAssignmentExpressionSemanticAction(CompilerState * compilerState, const unsigned int variable, ArithmeticExpression * arithmeticExpression);
+TransitionExpression * TransitionForLoopExpressionSemanticAction(CompilerState * compilerState, const unsigned int variable, Range * range, TransitionSequence * transitionExpression);
+TransitionExpression * TransitionIfExpressionSemanticAction(CompilerState * compilerState, ArithmeticExpression * arithmeticExpression, TransitionSequence * transitionExpression);
+TransitionExpression * TransitionIfElseExpressionSemanticAction(CompilerState * compilerState, ArithmeticExpression * arithmeticExpression, TransitionSequence * ifTransitionExpression, TransitionSequence * elseTransitionExpression);
+TransitionExpression * TransitionReturnExpressionSemanticAction(CompilerState * compilerState, ArithmeticExpression * arithmeticExpression);
 
-NeighborhoodSequence * NeighborhoodUnarySequenceSemanticAction(NeighborhoodExpression * expression);
-NeighborhoodSequence * NeighborhoodBinarySequenceSemanticAction(NeighborhoodSequence * sequence, NeighborhoodExpression * expression);
+NeighborhoodSequence * NeighborhoodSequenceSemanticAction(CompilerState * compilerState, NeighborhoodSequence * sequence, NeighborhoodExpression * expression);
 
-NeighborhoodExpression * NeighborhoodAssignmentExpressionSemanticAction(char * variable, ArithmeticExpression * arithmeticExpression);
-NeighborhoodExpression * NeighborhoodForLoopExpressionSemanticAction(char * variable, Range * range, NeighborhoodSequence * neighborhoodExpression);
-NeighborhoodExpression * NeighborhoodIfExpressionSemanticAction(ArithmeticExpression * arithmeticExpression, NeighborhoodSequence * neighborhoodExpression);
-NeighborhoodExpression * NeighborhoodIfElseExpressionSemanticAction(ArithmeticExpression * arithmeticExpression, NeighborhoodSequence * ifNeighborhoodExpression, NeighborhoodSequence * elseNeighborhoodExpression);
-NeighborhoodExpression * NeighborhoodCellExpressionSemanticAction(boolean add, CellList * cellList);
+NeighborhoodExpression * NeighborhoodAssignmentExpressionSemanticAction(CompilerState * compilerState, const unsigned int variable, ArithmeticExpression * arithmeticExpression);
+NeighborhoodExpression * NeighborhoodForLoopExpressionSemanticAction(CompilerState * compilerState, const unsigned int variable, Range * range, NeighborhoodSequence * neighborhoodExpression);
+NeighborhoodExpression * NeighborhoodIfExpressionSemanticAction(CompilerState * compilerState, ArithmeticExpression * arithmeticExpression, NeighborhoodSequence * neighborhoodExpression);
+NeighborhoodExpression * NeighborhoodIfElseExpressionSemanticAction(CompilerState * compilerState, ArithmeticExpression * arithmeticExpression, NeighborhoodSequence * ifNeighborhoodExpression, NeighborhoodSequence * elseNeighborhoodExpression);
+NeighborhoodExpression * NeighborhoodCellExpressionSemanticAction(CompilerState * compilerState, boolean add, CellList * cellList);
 
 
-Cell * SingleCoordinateCellSemanticAction(Constant * c, DisplacementType type);
-Cell * DoubleCoordinateCellSemanticAction(Constant * x, Constant * y);
-CellList * CellListSemanticAction(Cell * cell, CellList * list);
+Cell * SingleCoordinateCellSemanticAction(CompilerState * compilerState, Constant * c, DisplacementType type);
+Cell * DoubleCoordinateCellSemanticAction(CompilerState * compilerState, Constant * x, Constant * y);
+CellList * CellListSemanticAction(CompilerState * compilerState, CellList * cellList, Cell * cell);
 
-ArithmeticExpression * BinaryArithmeticExpressionSemanticAction(ArithmeticExpression * leftExpression, ArithmeticExpression * rightExpression, ArithmeticExpressionType type);
-ArithmeticExpression * UnaryArithmeticExpressionSemanticAction(ArithmeticExpression * expression, ArithmeticExpressionType type);
-ArithmeticExpression * CellListArithmeticExpressionSemanticAction(CellList * cellList, ArithmeticExpressionType type, int count);
-ArithmeticExpression * ConstantArithmeticExpressionSemanticAction(Constant * cellList);
+ArithmeticExpression * BinaryArithmeticExpressionSemanticAction(CompilerState * compilerState, ArithmeticExpression * leftExpression, ArithmeticExpression * rightExpression, ArithmeticExpressionType type);
+ArithmeticExpression * UnaryArithmeticExpressionSemanticAction(CompilerState * compilerState, ArithmeticExpression * expression, ArithmeticExpressionType type);
+ArithmeticExpression * CellListArithmeticExpressionSemanticAction(CompilerState * compilerState, CellList * cellList, ArithmeticExpressionType type, int count, const unsigned int state);
+ArithmeticExpression * ConstantArithmeticExpressionSemanticAction(CompilerState * compilerState, Constant * cellList);
 
-Constant * IntegerConstantSemanticAction(const int value);
-Constant * StringConstantSemanticAction(char * value);
-Constant * CellConstantSemanticAction(Cell * cell);
+Constant * IntegerConstantSemanticAction(CompilerState * compilerState, const int value);
+Constant * StringConstantSemanticAction(CompilerState * compilerState, const unsigned int symbol);
+Constant * CellConstantSemanticAction(CompilerState * compilerState, Cell * cell);
 
-IntArray * IntArraySemanticAction(const int value, IntArray * arr);
-StringArray * StringArraySemanticAction(char * value, StringArray * arr);
-ConstantArray * ConstantArraySemanticAction(Constant * value, ConstantArray * arr);
-Range * RangeSemanticAction(ConstantArray * array, Constant * start, Constant * end);
+IntArray * IntArraySemanticAction(CompilerState * compilerState, IntArray * array, const int value);
+StringArray * StringArraySemanticAction(CompilerState * compilerState, StringArray * array, const unsigned int value);
+ConstantArray * ConstantArraySemanticAction(CompilerState * compilerState, ConstantArray * array, Constant * value);
+Range * RangeSemanticAction(CompilerState * compilerState, ConstantArray * array, Constant * start, Constant * end);
 
 #endif
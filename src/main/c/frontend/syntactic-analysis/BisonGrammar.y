@@ -7,6 +7,19 @@
 // You touch this, and you die.
 %define api.value.union.name SemanticValue
 
+/**
+ * A pure (reentrant) parser: the semantic value of the lookahead symbol is a
+ * local variable of "yyparse", and the compiler state and the reentrant
+ * scanner are threaded explicitly, so many programs can be parsed at the
+ * same time.
+ *
+ * @see https://www.gnu.org/software/bison/manual/html_node/Pure-Decl.html
+ * @see https://www.gnu.org/software/bison/manual/html_node/Parser-Function.html
+ */
+%define api.pure full
+%parse-param {CompilerState * compilerState}
+%param {void * scanner}
+
 %union {
 	/** Terminals. */
 
@@ -15,7 +28,7 @@
 	NeighborhoodEnum neighborhood;
 	EvolutionEnum evolution;
 	DisplacementType displacement;
-	char * string;
+	unsigned int symbol;
 	Token token;
 
 	/** Non-terminals. */
@@ -42,35 +55,18 @@
 }
 
 /**
- * Destructors. This functions are executed after the parsing ends, so if the
- * AST must be used in the following phases of the compiler you shouldn't used
- * this approach. To use this mechanism, the AST must be translated into
- * another structure.
+ * Destructors. Every node of the AST (and every identifier) is allocated from
+ * the arena of the compiler state, so the symbols discarded during error
+ * recovery don't need one: the whole tree is released at once, with a reset
+ * of that arena, whether the parsing succeeds or not.
  *
  * @see https://www.gnu.org/software/bison/manual/html_node/Destructor-Decl.html
  */
 
-%destructor { releaseProgram($$); } <program>
-%destructor { releaseTransitionSequence($$); } <transition_sequence>
-%destructor { releaseNeighborhoodSequence($$); } <neighborhood_sequence>
-%destructor { releaseTransitionExpression($$); } <transition_expression>
-%destructor { releaseNeighborhoodExpression($$); } <neighborhood_expression>
-%destructor { releaseArithmeticExpression($$); } <arithmetic_expression>
-%destructor { releaseConstant($$); } <constant>
-%destructor { releaseConfiguration($$); } <config>
-%destructor { releaseOption($$); } <option>
-%destructor { releaseEvolution($$); } <evolution_t>
-%destructor { releaseIntArray($$); } <int_array>
-%destructor { releaseStringArray($$); } <string_array>
-%destructor { releaseConstantArray($$); } <constant_array>
-%destructor { releaseCell($$); } <cell>
-%destructor { releaseCellList($$); } <cell_list>
-%destructor { releaseRange($$); } <range>
-
 
 /** Terminals. */
 %token <integer> INTEGER
-%token <string> STRING
+%token <symbol> STRING
 %token <frontier> FRONTIER_ENUM
 %token <neighborhood> NEIGHBORHOOD_ENUM
 %token <evolution> EVOLUTION_ENUM
@@ -179,98 +175,98 @@
 
 // IMPORTANT: To use λ in the following grammar, use the %empty symbol.
 
-program: CONFIGURATION COLON config[options] TRANSITION_FUNCTION COLON transition_sequence[exp]	{ $$ = TransitionProgramSemanticAction(currentCompilerState(), $options, $exp); }
-	| CONFIGURATION COLON config[options] NEIGHBORHOOD_FUNCTION COLON neighborhood_sequence[exp]	{ $$ = NeighborhoodProgramSemanticAction(currentCompilerState(), $options, $exp); }
-	| CONFIGURATION COLON config[options]														{ $$ = DefaultProgramSemanticAction(currentCompilerState(), $options); }
+program: CONFIGURATION COLON config[options] TRANSITION_FUNCTION COLON transition_sequence[exp]	{ $$ = TransitionProgramSemanticAction(compilerState, $options, $exp); }
+	| CONFIGURATION COLON config[options] NEIGHBORHOOD_FUNCTION COLON neighborhood_sequence[exp]	{ $$ = NeighborhoodProgramSemanticAction(compilerState, $options, $exp); }
+	| CONFIGURATION COLON config[options]														{ $$ = DefaultProgramSemanticAction(compilerState, $options); }
 	;
 
-config: option																			{ $$ = ConfigurationSemanticAction($1, NULL); }
-	| option config																		{ $$ = ConfigurationSemanticAction($1, $2); }
+config: option																			{ $$ = ConfigurationSemanticAction(compilerState, NULL, $1); }
+	| config option																		{ $$ = ConfigurationSemanticAction(compilerState, $1, $2); }
 	;
 
-option: HEIGHT COLON INTEGER SEMICOLON														{ $$ = IntValuedOptionSemanticAction($3, HEIGHT_OPTION); }
-    | WIDTH COLON INTEGER SEMICOLON															{ $$ = IntValuedOptionSemanticAction($3, WIDTH_OPTION); }
-    | FRONTIER COLON FRONTIER_ENUM SEMICOLON													{ $$ = FrontierOptionSemanticAction($3); }
-    | COLORS COLON OPEN_BRACE int_array CLOSE_BRACE SEMICOLON									{ $$ = IntArrayValuedOptionSemanticAction($4); }
-    | STATES COLON OPEN_BRACE string_array CLOSE_BRACE SEMICOLON											{ $$ = StringArrayValuedOptionSemanticAction($4); }
-    | NEIGHBORHOOD COLON NEIGHBORHOOD_ENUM SEMICOLON											{ $$ = NeighborhoodOptionSemanticAction($3); }
-    | EVOLUTION COLON evolution[ev] SEMICOLON														{ $$ = EvolutionOptionSemanticAction($ev); }
+option: HEIGHT COLON INTEGER SEMICOLON														{ $$ = IntValuedOptionSemanticAction(compilerState, $3, HEIGHT_OPTION); }
+    | WIDTH COLON INTEGER SEMICOLON															{ $$ = IntValuedOptionSemanticAction(compilerState, $3, WIDTH_OPTION); }
+    | FRONTIER COLON FRONTIER_ENUM SEMICOLON													{ $$ = FrontierOptionSemanticAction(compilerState, $3); }
+    | COLORS COLON OPEN_BRACE int_array CLOSE_BRACE SEMICOLON									{ $$ = IntArrayValuedOptionSemanticAction(compilerState, $4); }
+    | STATES COLON OPEN_BRACE string_array CLOSE_BRACE SEMICOLON											{ $$ = StringArrayValuedOptionSemanticAction(compilerState, $4); }
+    | NEIGHBORHOOD COLON NEIGHBORHOOD_ENUM SEMICOLON											{ $$ = NeighborhoodOptionSemanticAction(compilerState, $3); }
+    | EVOLUTION COLON evolution[ev] SEMICOLON														{ $$ = EvolutionOptionSemanticAction(compilerState, $ev); }
 	;
 
-evolution: EVOLUTION_ENUM																{ $$ = EvolutionSemanticAction(NULL, 0, $1); }
-	| int_array DIV INTEGER																{ $$ = EvolutionSemanticAction($1, $3, 0); }
+evolution: EVOLUTION_ENUM																{ $$ = EvolutionSemanticAction(compilerState, NULL, 0, $1); }
+	| int_array DIV INTEGER																{ $$ = EvolutionSemanticAction(compilerState, $1, $3, 0); }
 
-int_array: INTEGER																		{ $$ = IntArraySemanticAction($1, NULL); }
-	| INTEGER COMMA int_array[arr]														{ $$ = IntArraySemanticAction($1, $arr); }
+int_array: INTEGER																		{ $$ = IntArraySemanticAction(compilerState, NULL, $1); }
+	| int_array[arr] COMMA INTEGER														{ $$ = IntArraySemanticAction(compilerState, $arr, $3); }
 	;
 
-string_array: STRING																	{ $$ = StringArraySemanticAction($1, NULL); }
-	| STRING COMMA string_array[arr]													{ $$ = StringArraySemanticAction($1, $arr); }
+string_array: STRING																	{ $$ = StringArraySemanticAction(compilerState, NULL, $1); }
+	| string_array[arr] COMMA STRING													{ $$ = StringArraySemanticAction(compilerState, $arr, $3); }
 	;
 
-constant_array: constant																{ $$ = ConstantArraySemanticAction($1, NULL); }
-	| constant COMMA constant_array[arr]												{ $$ = ConstantArraySemanticAction($1, $arr); }
+constant_array: constant																{ $$ = ConstantArraySemanticAction(compilerState, NULL, $1); }
+	| constant_array[arr] COMMA constant												{ $$ = ConstantArraySemanticAction(compilerState, $arr, $3); }
 	;
 
-transition_sequence: transition_expression	transition_sequence 						{ $$ = TransitionBinarySequenceSemanticAction($2, $1); }
-	| %empty																			{ $$ = NULL; }
+transition_sequence: transition_sequence transition_expression 						{ $$ = TransitionSequenceSemanticAction(compilerState, $1, $2); }
+	| %empty																			{ $$ = TransitionSequenceSemanticAction(compilerState, NULL, NULL); }
 	;
 
-transition_expression: STRING ASSIGNMENT arithmetic_expression SEMICOLON						{ $$ = TransitionAssignmentExpressionSemanticAction($1, $3); }
-	| FOR STRING IN range DO transition_sequence END									{ $$ = TransitionForLoopExpressionSemanticAction($2, $4, $6); }
-	| IF arithmetic_expression THEN transition_sequence END								{ $$ = TransitionIfExpressionSemanticAction($2, $4); }
-	| IF arithmetic_expression THEN transition_sequence ELSE transition_sequence END 	{ $$ = TransitionIfElseExpressionSemanticAction($2, $4, $6); }
-	| RETURN arithmetic_expression														{ $$ = TransitionReturnExpressionSemanticAction($2); }
+transition_expression: STRING ASSIGNMENT arithmetic_expression SEMICOLON						{ $$ = TransitionAssignmentExpressionSemanticAction(compilerState, $1, $3); }
+	| FOR STRING IN range DO transition_sequence END									{ $$ = TransitionForLoopExpressionSemanticAction(compilerState, $2, $4, $6); }
+	| IF arithmetic_expression THEN transition_sequence END								{ $$ = TransitionIfExpressionSemanticAction(compilerState, $2, $4); }
+	| IF arithmetic_expression THEN transition_sequence ELSE transition_sequence END 	{ $$ = TransitionIfElseExpressionSemanticAction(compilerState, $2, $4, $6); }
+	| RETURN arithmetic_expression														{ $$ = TransitionReturnExpressionSemanticAction(compilerState, $2); }
 	;
 
-neighborhood_sequence: neighborhood_expression neighborhood_sequence					{ $$ = NeighborhoodBinarySequenceSemanticAction($2, $1); }
-	| %empty																			{ $$ = NULL; }
+neighborhood_sequence: neighborhood_sequence neighborhood_expression					{ $$ = NeighborhoodSequenceSemanticAction(compilerState, $1, $2); }
+	| %empty																			{ $$ = NeighborhoodSequenceSemanticAction(compilerState, NULL, NULL); }
 	;
 
-neighborhood_expression: STRING ASSIGNMENT arithmetic_expression SEMICOLON						{ $$ = NeighborhoodAssignmentExpressionSemanticAction($1, $3); }
-	| FOR STRING IN range DO neighborhood_sequence END								{ $$ = NeighborhoodForLoopExpressionSemanticAction($2, $4, $6); }
-	| IF arithmetic_expression THEN neighborhood_sequence END							{ $$ = NeighborhoodIfExpressionSemanticAction($2, $4); }
-	| IF arithmetic_expression THEN neighborhood_sequence ELSE neighborhood_sequence END { $$ = NeighborhoodIfElseExpressionSemanticAction($2, $4, $6); }
-	| ADD_CELL OPEN_PARENTHESIS cell_list CLOSE_PARENTHESIS	SEMICOLON					{ $$ = NeighborhoodCellExpressionSemanticAction(true, $3); }
-	| REMOVE_CELL OPEN_PARENTHESIS cell_list CLOSE_PARENTHESIS	SEMICOLON				{ $$ = NeighborhoodCellExpressionSemanticAction(false, $3); }
+neighborhood_expression: STRING ASSIGNMENT arithmetic_expression SEMICOLON						{ $$ = NeighborhoodAssignmentExpressionSemanticAction(compilerState, $1, $3); }
+	| FOR STRING IN range DO neighborhood_sequence END								{ $$ = NeighborhoodForLoopExpressionSemanticAction(compilerState, $2, $4, $6); }
+	| IF arithmetic_expression THEN neighborhood_sequence END							{ $$ = NeighborhoodIfExpressionSemanticAction(compilerState, $2, $4); }
+	| IF arithmetic_expression THEN neighborhood_sequence ELSE neighborhood_sequence END { $$ = NeighborhoodIfElseExpressionSemanticAction(compilerState, $2, $4, $6); }
+	| ADD_CELL OPEN_PARENTHESIS cell_list CLOSE_PARENTHESIS	SEMICOLON					{ $$ = NeighborhoodCellExpressionSemanticAction(compilerState, true, $3); }
+	| REMOVE_CELL OPEN_PARENTHESIS cell_list CLOSE_PARENTHESIS	SEMICOLON				{ $$ = NeighborhoodCellExpressionSemanticAction(compilerState, false, $3); }
 	;
 
-cell: OPEN_PARENTHESIS constant[x] COMMA constant[y] CLOSE_PARENTHESIS									{ $$ = DoubleCoordinateCellSemanticAction($x, $y); }
-	| DISPLACEMENT_TYPE OPEN_PARENTHESIS constant CLOSE_PARENTHESIS										{ $$ = SingleCoordinateCellSemanticAction($3, $1); }
+cell: OPEN_PARENTHESIS constant[x] COMMA constant[y] CLOSE_PARENTHESIS									{ $$ = DoubleCoordinateCellSemanticAction(compilerState, $x, $y); }
+	| DISPLACEMENT_TYPE OPEN_PARENTHESIS constant CLOSE_PARENTHESIS										{ $$ = SingleCoordinateCellSemanticAction(compilerState, $3, $1); }
 	;
 
-cell_list: cell																						{ $$ = CellListSemanticAction($1, NULL); }
-	| cell COMMA cell_list																			{ $$ = CellListSemanticAction($1, $3); }
+cell_list: cell																						{ $$ = CellListSemanticAction(compilerState, NULL, $1); }
+	| cell_list COMMA cell																			{ $$ = CellListSemanticAction(compilerState, $1, $3); }
 	;
 
-range: OPEN_BRACE constant_array[array] CLOSE_BRACE														{ $$ = RangeSemanticAction($array, NULL, NULL); }
-	| OPEN_BRACKET constant[c1] COMMA constant[c2] CLOSE_BRACKET										{ $$ = RangeSemanticAction(NULL, $c1, $c2); }
+range: OPEN_BRACE constant_array[array] CLOSE_BRACE														{ $$ = RangeSemanticAction(compilerState, $array, NULL, NULL); }
+	| OPEN_BRACKET constant[c1] COMMA constant[c2] CLOSE_BRACKET										{ $$ = RangeSemanticAction(compilerState, NULL, $c1, $c2); }
 	;
 
-arithmetic_expression: arithmetic_expression[left] ADD arithmetic_expression[right]					{ $$ = BinaryArithmeticExpressionSemanticAction($left, $right, ADDITION); }
-	| arithmetic_expression[left] DIV arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction($left, $right, DIVISION); }
-	| arithmetic_expression[left] MUL arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction($left, $right, MULTIPLICATION); }
-	| arithmetic_expression[left] SUB arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction($left, $right, SUBTRACTION); }
-	| arithmetic_expression[left] MOD arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction($left, $right, MODULE); }
-	| arithmetic_expression[left] AND arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction($left, $right, LOGIC_AND); }
-	| arithmetic_expression[left] OR arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction($left, $right, LOGIC_OR); }
-	| NOT arithmetic_expression[single]																{ $$ = UnaryArithmeticExpressionSemanticAction($single, FACTOR); }
-	| arithmetic_expression[left] EQ arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction($left, $right, EQUALS); }
-	| arithmetic_expression[left] NEQ arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction($left, $right, NOT_EQUALS); }
-	| arithmetic_expression[left] LT arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction($left, $right, LOWER_THAN); }
-	| arithmetic_expression[left] LTE arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction($left, $right, LOWER_THAN_OR_EQUAL); }
-	| arithmetic_expression[left] GT arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction($left, $right, GREATER_THAN); }
-	| arithmetic_expression[left] GTE arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction($left, $right, GREATER_THAN_OR_EQUAL); }
-	| ALL_OPERAND OPEN_BRACE cell_list[single] CLOSE_BRACE ARE STRING								{ $$ = CellListArithmeticExpressionSemanticAction($single, ALL_ARE, -1); }
-	| ANY OPEN_BRACE cell_list[single] CLOSE_BRACE ARE STRING										{ $$ = CellListArithmeticExpressionSemanticAction($single, ANY_ARE, 1); }
-	| AT_LEAST INTEGER OPEN_BRACE cell_list[single] CLOSE_BRACE ARE STRING							{ $$ = CellListArithmeticExpressionSemanticAction($single, AT_LEAST_ARE, $2); }
-	| OPEN_PARENTHESIS arithmetic_expression[single] CLOSE_PARENTHESIS								{ $$ = UnaryArithmeticExpressionSemanticAction($single, FACTOR); }
-	| constant[single]																				{ $$ = ConstantArithmeticExpressionSemanticAction($single); }
+arithmetic_expression: arithmetic_expression[left] ADD arithmetic_expression[right]					{ $$ = BinaryArithmeticExpressionSemanticAction(compilerState, $left, $right, ADDITION); }
+	| arithmetic_expression[left] DIV arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction(compilerState, $left, $right, DIVISION); }
+	| arithmetic_expression[left] MUL arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction(compilerState, $left, $right, MULTIPLICATION); }
+	| arithmetic_expression[left] SUB arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction(compilerState, $left, $right, SUBTRACTION); }
+	| arithmetic_expression[left] MOD arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction(compilerState, $left, $right, MODULE); }
+	| arithmetic_expression[left] AND arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction(compilerState, $left, $right, LOGIC_AND); }
+	| arithmetic_expression[left] OR arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction(compilerState, $left, $right, LOGIC_OR); }
+	| NOT arithmetic_expression[single]																{ $$ = UnaryArithmeticExpressionSemanticAction(compilerState, $single, LOGIC_NOT); }
+	| arithmetic_expression[left] EQ arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction(compilerState, $left, $right, EQUALS); }
+	| arithmetic_expression[left] NEQ arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction(compilerState, $left, $right, NOT_EQUALS); }
+	| arithmetic_expression[left] LT arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction(compilerState, $left, $right, LOWER_THAN); }
+	| arithmetic_expression[left] LTE arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction(compilerState, $left, $right, LOWER_THAN_OR_EQUAL); }
+	| arithmetic_expression[left] GT arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction(compilerState, $left, $right, GREATER_THAN); }
+	| arithmetic_expression[left] GTE arithmetic_expression[right]									{ $$ = BinaryArithmeticExpressionSemanticAction(compilerState, $left, $right, GREATER_THAN_OR_EQUAL); }
+	| ALL_OPERAND OPEN_BRACE cell_list[single] CLOSE_BRACE ARE STRING[state]						{ $$ = CellListArithmeticExpressionSemanticAction(compilerState, $single, ALL_ARE, -1, $state); }
+	| ANY OPEN_BRACE cell_list[single] CLOSE_BRACE ARE STRING[state]								{ $$ = CellListArithmeticExpressionSemanticAction(compilerState, $single, ANY_ARE, 1, $state); }
+	| AT_LEAST INTEGER OPEN_BRACE cell_list[single] CLOSE_BRACE ARE STRING[state]					{ $$ = CellListArithmeticExpressionSemanticAction(compilerState, $single, AT_LEAST_ARE, $2, $state); }
+	| OPEN_PARENTHESIS arithmetic_expression[single] CLOSE_PARENTHESIS								{ $$ = UnaryArithmeticExpressionSemanticAction(compilerState, $single, FACTOR); }
+	| constant[single]																				{ $$ = ConstantArithmeticExpressionSemanticAction(compilerState, $single); }
 	;
 
-constant: INTEGER																					{ $$ = IntegerConstantSemanticAction($1); }
-	| STRING																						{ $$ = StringConstantSemanticAction($1); }
-	| cell																				 			{ $$ = CellConstantSemanticAction($1); }
+constant: INTEGER																					{ $$ = IntegerConstantSemanticAction(compilerState, $1); }
+	| STRING																						{ $$ = StringConstantSemanticAction(compilerState, $1); }
+	| cell																				 			{ $$ = CellConstantSemanticAction(compilerState, $1); }
 	;
 
 
@@ -1,9 +1,7 @@
 #include "SyntacticAnalyzer.h"
-#include "../lexical-analysis/LexicalAnalyzerContext.h"
 
 /* MODULE INTERNAL STATE */
 
-static CompilerState * _currentCompilerState = NULL;
 static Logger * _logger = NULL;
 
 void initializeSyntacticAnalyzerModule() {
@@ -18,7 +16,20 @@ void shutdownSyntacticAnalyzerModule() {
 
 /** IMPORTED FUNCTIONS */
 
-extern LexicalAnalyzerContext * createLexicalAnalyzerContext();
+/**
+ * Flex exported functions (see "FlexExport.h").
+ */
+extern unsigned int flexCurrentContext(void * scanner);
+extern int flexBeginBuffer(char * buffer, const size_t size, void * scanner);
+extern void flexBeginStream(FILE * stream, void * scanner);
+
+/**
+ * Flex reentrant scanner life-cycle.
+ *
+ * @see https://westes.github.io/flex/manual/Init-and-Destroy-Functions.html
+ */
+extern int yylex_init_extra(LexicalAnalyzerContext * lexicalAnalyzerContext, void ** scanner);
+extern int yylex_destroy(void * scanner);
 
 /**
  * Bison exported functions.
@@ -31,25 +42,48 @@ extern LexicalAnalyzerContext * createLexicalAnalyzerContext();
  *
  * @see https://www.gnu.org/software/bison/manual/html_node/Parser-Function.html
  */
-extern int yyparse(void);
+extern int yyparse(CompilerState * compilerState, void * scanner);
 
 // Bison error-reporting function.
-void yyerror(const char * string) {
-	LexicalAnalyzerContext * lexicalAnalyzerContext = createLexicalAnalyzerContext();
+void yyerror(CompilerState * compilerState, void * scanner, const char * string) {
+	LexicalAnalyzerContext * lexicalAnalyzerContext = currentLexicalAnalyzerContext(scanner);
 	logError(_logger, "Syntax error (on line %d).", lexicalAnalyzerContext->line);
 }
 
 /* PUBLIC FUNCTIONS */
 
-CompilerState * currentCompilerState() {
-	return _currentCompilerState;
-}
-
-SyntacticAnalysisStatus parse(CompilerState * compilerState) {
-	logDebugging(_logger, "Parsing...");
-	_currentCompilerState = compilerState;
-	const int code = yyparse();
-	_currentCompilerState = NULL;
+SyntacticAnalysisStatus parse(CompilerState * compilerState, SourceCode * sourceCode) {
+	logDebugging(_logger, "Parsing \"%s\"...", sourceCode->path);
+	LexicalAnalyzerContext lexicalAnalyzerContext = {
+		.compilerState = compilerState,
+		.currentContext = 0,
+		.length = 0,
+		.lexeme = "",
+		.line = 0,
+		.semanticValue = NULL
+	};
+	void * scanner = NULL;
+	if (yylex_init_extra(&lexicalAnalyzerContext, &scanner) != 0) {
+		logError(_logger, "Cannot create the scanner.");
+		compilerState->succeed = false;
+		return OUT_OF_MEMORY;
+	}
+	if (sourceCode->buffer == NULL) {
+		flexBeginStream(sourceCode->stream, scanner);
+	}
+	else if (!flexBeginBuffer(sourceCode->buffer, sourceCode->size, scanner)) {
+		logError(_logger, "The buffer of \"%s\" is not null-terminated.", sourceCode->path);
+		yylex_destroy(scanner);
+		compilerState->succeed = false;
+		return UNKNOWN_ERROR;
+	}
+	const int code = yyparse(compilerState, scanner);
+	const unsigned int finalContext = flexCurrentContext(scanner);
+	yylex_destroy(scanner);
+	if (code == 0 && 0 < finalContext) {
+		logError(_logger, "The final context is not the default (0): %d", finalContext);
+		compilerState->succeed = false;
+	}
 	SyntacticAnalysisStatus syntacticAnalysisStatus;
 	logDebugging(_logger, "Parsing is done.");
 	switch (code) {
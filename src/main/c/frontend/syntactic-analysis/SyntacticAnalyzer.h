@@ -3,11 +3,15 @@
 
 #include "../../shared/CompilerState.h"
 #include "../../shared/Logger.h"
+#include "../lexical-analysis/LexicalAnalyzerContext.h"
+#include "../lexical-analysis/SourceCode.h"
 
 /** Bison imported functions. */
 
-int yylex(void);
-void yyerror(const char * string);
+union SemanticValue;
+
+int yylex(union SemanticValue * semanticValue, void * scanner);
+void yyerror(CompilerState * compilerState, void * scanner, const char * string);
 
 /** Initialize module's internal state. */
 void initializeSyntacticAnalyzerModule();
@@ -23,15 +27,10 @@ typedef enum {
 } SyntacticAnalysisStatus;
 
 /**
- * Retrieves the current compiler state. The state must be accessed during the
- * parsing phase (i.e., during a call to the "parse" function). Outside of the
- * parse, the state is set to NULL.
- */
-CompilerState * currentCompilerState();
-
-/**
- * Executes the parsing phase of the compiler.
+ * Executes the parsing phase of the compiler over the specified source-code.
+ * Every call uses its own reentrant scanner and parser, so many programs can
+ * be parsed concurrently, as long as each one has its own compiler state.
  */
-SyntacticAnalysisStatus parse(CompilerState * compilerState);
+SyntacticAnalysisStatus parse(CompilerState * compilerState, SourceCode * sourceCode);
 
 #endif
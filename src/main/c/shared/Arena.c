@@ -0,0 +1,97 @@
+#include "Arena.h"
+
+/* PRIVATE FUNCTIONS */
+
+static size_t _align(const size_t size);
+static ArenaChunk * _createChunk(const size_t capacity);
+
+/**
+ * Rounds the size up to the next multiple of the arena alignment.
+ */
+static size_t _align(const size_t size) {
+	return (size + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1);
+}
+
+/**
+ * Creates an empty chunk with the specified capacity (in bytes).
+ */
+static ArenaChunk * _createChunk(const size_t capacity) {
+	ArenaChunk * chunk = malloc(sizeof(ArenaChunk) + capacity);
+	chunk->next = NULL;
+	chunk->capacity = capacity;
+	chunk->used = 0;
+	return chunk;
+}
+
+/* PUBLIC FUNCTIONS */
+
+Arena * createArena(const size_t chunkSize) {
+	Arena * arena = calloc(1, sizeof(Arena));
+	arena->chunkSize = _align(chunkSize == 0 ? ARENA_DEFAULT_CHUNK_SIZE : chunkSize);
+	arena->first = _createChunk(arena->chunkSize);
+	arena->current = arena->first;
+	return arena;
+}
+
+void destroyArena(Arena * arena) {
+	if (arena != NULL) {
+		ArenaChunk * chunk = arena->first;
+		while (chunk != NULL) {
+			ArenaChunk * next = chunk->next;
+			free(chunk);
+			chunk = next;
+		}
+		free(arena);
+	}
+}
+
+void * allocateFromArena(Arena * arena, const size_t size) {
+	const size_t alignedSize = _align(size == 0 ? 1 : size);
+	ArenaChunk * chunk = arena->current;
+	while (chunk->capacity - chunk->used < alignedSize) {
+		if (chunk->next == NULL || chunk->next->capacity < alignedSize) {
+			// Blocks bigger than a chunk get a dedicated one, linked right
+			// after the current chunk to keep the rest reusable.
+			const size_t capacity = alignedSize < arena->chunkSize ? arena->chunkSize : alignedSize;
+			ArenaChunk * next = _createChunk(capacity);
+			next->next = chunk->next;
+			chunk->next = next;
+		}
+		chunk = chunk->next;
+		chunk->used = 0;
+	}
+	arena->current = chunk;
+	void * block = chunk->memory + chunk->used;
+	chunk->used += alignedSize;
+	memset(block, 0, size);
+	return block;
+}
+
+void * reallocateInArena(Arena * arena, void * block, const size_t size, const size_t newSize) {
+	if (block == NULL) {
+		return allocateFromArena(arena, newSize);
+	}
+	ArenaChunk * chunk = arena->current;
+	const size_t alignedSize = _align(size == 0 ? 1 : size);
+	const size_t alignedNewSize = _align(newSize == 0 ? 1 : newSize);
+	unsigned char * end = (unsigned char *) block + alignedSize;
+	if (end == chunk->memory + chunk->used && alignedNewSize - alignedSize <= chunk->capacity - chunk->used) {
+		chunk->used += alignedNewSize - alignedSize;
+		memset((unsigned char *) block + size, 0, newSize - size);
+		return block;
+	}
+	void * copy = allocateFromArena(arena, newSize);
+	memcpy(copy, block, size);
+	return copy;
+}
+
+char * duplicateInArena(Arena * arena, const char * string, const size_t length) {
+	char * copy = allocateFromArena(arena, 1 + length);
+	memcpy(copy, string, length);
+	return copy;
+}
+
+void resetArena(Arena * arena) {
+	arena->first->used = 0;
+	arena->current = arena->first;
+}
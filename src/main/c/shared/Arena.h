@@ -0,0 +1,85 @@
+#ifndef ARENA_HEADER
+#define ARENA_HEADER
+
+#include "Type.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The alignment of every block returned by an arena. It's large enough for
+ * any scalar or pointer type used by the compiler. The memory of a chunk
+ * starts at this alignment (relative to the chunk, which malloc aligns for
+ * any standard type), and every block size is rounded up to it.
+ */
+#define ARENA_ALIGNMENT 16
+
+/**
+ * The default size of a chunk, in bytes.
+ */
+#define ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+typedef struct ArenaChunk ArenaChunk;
+
+/**
+ * A contiguous block of memory owned by an arena. Chunks are linked, so the
+ * arena can grow without moving the blocks already handed out.
+ */
+struct ArenaChunk {
+	ArenaChunk * next;
+	size_t capacity;
+	size_t used;
+	unsigned char memory[] __attribute__((aligned(ARENA_ALIGNMENT)));
+};
+
+/**
+ * A bump allocator. Every allocation is a pointer increment inside the
+ * current chunk, and every block is released at once with a reset. The
+ * chunks are kept after a reset, so they can be reused by the next
+ * compilation without touching the heap.
+ */
+typedef struct {
+	ArenaChunk * first;
+	ArenaChunk * current;
+	size_t chunkSize;
+} Arena;
+
+/**
+ * Creates a new arena whose chunks hold, at least, the specified amount of
+ * bytes. A chunk size of zero selects the default size.
+ */
+Arena * createArena(const size_t chunkSize);
+
+/**
+ * Destroy an arena, its chunks and every block allocated from it.
+ */
+void destroyArena(Arena * arena);
+
+/**
+ * Allocates a zero-initialized block of the specified size. The block lives
+ * until the next reset (or destruction) of the arena.
+ */
+void * allocateFromArena(Arena * arena, const size_t size);
+
+/**
+ * Grows a block allocated from the arena to a new (bigger) size, preserving
+ * its content and zeroing the rest. If the block is the last allocation of
+ * the arena, and there is room after it, it grows in place; otherwise, it's
+ * copied into a new block (and the old one is left unused until the reset).
+ * A NULL block is just allocated.
+ */
+void * reallocateInArena(Arena * arena, void * block, const size_t size, const size_t newSize);
+
+/**
+ * Copies the first "length" characters of a string inside the arena, and
+ * appends the null terminator.
+ */
+char * duplicateInArena(Arena * arena, const char * string, const size_t length);
+
+/**
+ * Releases every block allocated from the arena in O(1), by rewinding it to
+ * its first chunk.
+ */
+void resetArena(Arena * arena);
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef COMPILER_STATE_HEADER
 #define COMPILER_STATE_HEADER
 
+#include "Arena.h"
+#include "SymbolTable.h"
 #include "Type.h"
 
 /**
@@ -19,11 +21,19 @@ typedef struct {
 	// The root node of the AST.
 	void * abstractSyntaxtTree;
 
+	// The allocator of every AST node and identifier of the compilation.
+	Arena * arena;
+
+	// The states and variables of the program, interned during the parsing.
+	SymbolTable * symbolTable;
+
 	// A flag that indicates the current state of the compilation so far.
 	boolean succeed;
 
+	// The amount of semantic errors found so far.
+	unsigned int errors;
+
 	// TODO: Add an stack to handle nested scopes.
-	// TODO: Add a symbol table.
 	// TODO: Add configuration.
 	// TODO: ...
 
@@ -15,6 +15,46 @@ const boolean getBooleanOrDefault(const char * name, const boolean defaultValue)
 	}
 }
 
+const double getDoubleOrDefault(const char * name, const double defaultValue) {
+	const char * value = getStringOrDefault(name, NULL);
+	if (value == NULL) {
+		return defaultValue;
+	}
+	char * end = NULL;
+	const double number = strtod(value, &end);
+	if (end == value || *end != '\0') {
+		return defaultValue;
+	}
+	return number;
+}
+
+const int getIntegerOrDefault(const char * name, const int defaultValue) {
+	const char * value = getStringOrDefault(name, NULL);
+	if (value == NULL) {
+		return defaultValue;
+	}
+	char * end = NULL;
+	const long integer = strtol(value, &end, 10);
+	if (end == value || *end != '\0' || integer < INT_MIN || INT_MAX < integer) {
+		return defaultValue;
+	}
+	return (int) integer;
+}
+
+const uint64_t getUnsignedLongOrDefault(const char * name, const uint64_t defaultValue) {
+	const char * value = getStringOrDefault(name, NULL);
+	if (value == NULL || value[0] < '0' || '9' < value[0]) {
+		return defaultValue;
+	}
+	char * end = NULL;
+	errno = 0;
+	const unsigned long long integer = strtoull(value, &end, 10);
+	if (*end != '\0' || errno == ERANGE) {
+		return defaultValue;
+	}
+	return (uint64_t) integer;
+}
+
 const char * getStringOrDefault(const char * name, const char * defaultValue) {
 	const char * value = getenv(name);
 	if (value == NULL) {
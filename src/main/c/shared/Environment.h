@@ -2,6 +2,9 @@
 #define ENVIRONMENT_HEADER
 
 #include "Type.h"
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -12,6 +15,24 @@
  */
 const boolean getBooleanOrDefault(const char * name, const boolean defaultValue);
 
+/**
+ * Analog to "getStringOrDefault", but parsing the value as a floating-point
+ * number. The default value is also used when the value is not a number.
+ */
+const double getDoubleOrDefault(const char * name, const double defaultValue);
+
+/**
+ * Analog to "getStringOrDefault", but parsing the value as a decimal integer.
+ * The default value is also used when the value is not a valid integer.
+ */
+const int getIntegerOrDefault(const char * name, const int defaultValue);
+
+/**
+ * Analog to "getIntegerOrDefault", but for unsigned 64-bit integers (e.g.,
+ * an amount of generations beyond 2^31).
+ */
+const uint64_t getUnsignedLongOrDefault(const char * name, const uint64_t defaultValue);
+
 /**
  * Gets the value of an environment variable by name, or returns a default
  * value if the variable is undefined.
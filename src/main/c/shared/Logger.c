@@ -11,7 +11,7 @@ static const char * _toContextString(const LoggingLevel loggingLevel);
  * Logs a new message at the specified level, using a format string.
  */
 static void _log(const Logger * logger, const LoggingLevel loggingLevel, const char * const format, va_list arguments) {
-	if (logger->loggingLevel <= loggingLevel) {
+	if (isLoggingLevelEnabled(logger, loggingLevel)) {
 		const char * context = _toContextString(loggingLevel);
 		char * effectiveFormat = concatenate(6, context, "[", logger->name, "] ", format, "\n");
 		if (ERROR <= loggingLevel) {
@@ -85,6 +85,10 @@ void destroyLogger(Logger * logger) {
 	}
 }
 
+const boolean isLoggingLevelEnabled(const Logger * logger, const LoggingLevel loggingLevel) {
+	return logger->loggingLevel <= loggingLevel;
+}
+
 void logCritical(const Logger * logger, const char * const format, ...) {
 	va_list arguments;
 	va_start(arguments, format);
@@ -86,6 +86,12 @@ Logger * createLogger(char * name);
  */
 void destroyLogger(Logger * logger);
 
+/**
+ * Returns true if a log at the specified level would be visible. Useful to
+ * skip the construction of expensive arguments that would be discarded.
+ */
+const boolean isLoggingLevelEnabled(const Logger * logger, const LoggingLevel loggingLevel);
+
 /** Logs at CRITICAL level. */
 void logCritical(const Logger * logger, const char * const format, ...);
 
@@ -0,0 +1,90 @@
+#include "RingBuffer.h"
+
+/* PRIVATE FUNCTIONS */
+
+static void _wait(unsigned int * attempts);
+
+/**
+ * Backs off after a failed attempt: yields the processor, and after
+ * RING_BUFFER_YIELDS attempts sleeps, twice as long each time.
+ */
+static void _wait(unsigned int * attempts) {
+	if (*attempts < RING_BUFFER_YIELDS) {
+		++*attempts;
+		sched_yield();
+		return;
+	}
+#if defined (_WIN32)
+	sched_yield();
+#else
+	const unsigned int doublings = *attempts - RING_BUFFER_YIELDS;
+	long nanoseconds = 1000L << (doublings < 10 ? doublings : 10);
+	if (RING_BUFFER_MAXIMUM_SLEEP < nanoseconds) {
+		nanoseconds = RING_BUFFER_MAXIMUM_SLEEP;
+	}
+	else {
+		++*attempts;
+	}
+	const struct timespec duration = {
+		.tv_sec = 0,
+		.tv_nsec = nanoseconds
+	};
+	nanosleep(&duration, NULL);
+#endif
+}
+
+/* PUBLIC FUNCTIONS */
+
+RingBuffer * createRingBuffer(const size_t capacity) {
+	RingBuffer * ring = calloc(1, sizeof(RingBuffer));
+	ring->capacity = 1;
+	while (ring->capacity < capacity) {
+		ring->capacity *= 2;
+	}
+	ring->mask = ring->capacity - 1;
+	ring->items = calloc(ring->capacity, sizeof(void *));
+	return ring;
+}
+
+void destroyRingBuffer(RingBuffer * ring) {
+	if (ring != NULL) {
+		free(ring->items);
+		free(ring);
+	}
+}
+
+void * popRingBuffer(RingBuffer * ring) {
+	void * item;
+	unsigned int attempts = 0;
+	while (!tryPopRingBuffer(ring, &item)) {
+		_wait(&attempts);
+	}
+	return item;
+}
+
+void pushRingBuffer(RingBuffer * ring, void * item) {
+	unsigned int attempts = 0;
+	while (!tryPushRingBuffer(ring, item)) {
+		_wait(&attempts);
+	}
+}
+
+boolean tryPopRingBuffer(RingBuffer * ring, void ** item) {
+	const size_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+	if (head == __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE)) {
+		return false;
+	}
+	*item = ring->items[head & ring->mask];
+	__atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+	return true;
+}
+
+boolean tryPushRingBuffer(RingBuffer * ring, void * item) {
+	const size_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+	if (tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == ring->capacity) {
+		return false;
+	}
+	ring->items[tail & ring->mask] = item;
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+	return true;
+}
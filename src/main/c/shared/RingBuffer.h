@@ -0,0 +1,79 @@
+#ifndef RING_BUFFER_HEADER
+#define RING_BUFFER_HEADER
+
+#include "Type.h"
+#include <sched.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <time.h>
+
+/**
+ * The size of the padding that keeps the indices of a ring buffer in
+ * different cache lines, so the producer and the consumer never invalidate
+ * the line of each other.
+ */
+#define RING_BUFFER_CACHE_LINE 64
+
+/**
+ * The failed attempts of a blocked producer (or consumer) that yield the
+ * processor, before it starts to sleep (up to RING_BUFFER_MAXIMUM_SLEEP
+ * nanoseconds at a time).
+ */
+#define RING_BUFFER_YIELDS 64
+#define RING_BUFFER_MAXIMUM_SLEEP 1000000
+
+/**
+ * A lock-free bounded queue of pointers between exactly one producer thread
+ * and one consumer thread. The producer only writes the tail, and the
+ * consumer only writes the head, so neither takes a lock: each one publishes
+ * its index with release semantics, and reads the other one with acquire
+ * semantics (that also orders the accesses to the slots). A blocked thread
+ * (i.e., pushing to a full ring, or popping from an empty one) polls the
+ * other index, yielding at first and then sleeping for longer and longer.
+ */
+typedef struct {
+	void ** items;
+	size_t capacity;
+	size_t mask;
+
+	char producerPadding[RING_BUFFER_CACHE_LINE];
+	size_t tail;
+	char consumerPadding[RING_BUFFER_CACHE_LINE];
+	size_t head;
+	char endPadding[RING_BUFFER_CACHE_LINE];
+} RingBuffer;
+
+/**
+ * Creates an empty ring with room for the specified amount of items (at
+ * least, since it's rounded up to a power of 2).
+ */
+RingBuffer * createRingBuffer(const size_t capacity);
+
+/**
+ * Destroys a ring (but not its items).
+ */
+void destroyRingBuffer(RingBuffer * ring);
+
+/**
+ * Takes the oldest item (consumer only), blocking while the ring is empty.
+ */
+void * popRingBuffer(RingBuffer * ring);
+
+/**
+ * Appends an item (producer only), blocking while the ring is full.
+ */
+void pushRingBuffer(RingBuffer * ring, void * item);
+
+/**
+ * Takes the oldest item into "item" (consumer only), if the ring is not
+ * empty. Returns whether it took one.
+ */
+boolean tryPopRingBuffer(RingBuffer * ring, void ** item);
+
+/**
+ * Appends an item (producer only), if the ring is not full. Returns whether
+ * it was appended.
+ */
+boolean tryPushRingBuffer(RingBuffer * ring, void * item);
+
+#endif
@@ -0,0 +1,101 @@
+#include "SymbolTable.h"
+
+/* PRIVATE FUNCTIONS */
+
+static unsigned int _hash(const char * name, const unsigned int length);
+static void _rehash(SymbolTable * symbolTable);
+
+/**
+ * The 32-bit FNV-1a hash of a name.
+ *
+ * @see http://www.isthe.com/chongo/tech/comp/fnv/
+ */
+static unsigned int _hash(const char * name, const unsigned int length) {
+	unsigned int hash = 2166136261u;
+	for (unsigned int k = 0; k < length; ++k) {
+		hash ^= (unsigned char) name[k];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * Doubles the amount of slots of the hash index, and re-inserts every symbol.
+ */
+static void _rehash(SymbolTable * symbolTable) {
+	free(symbolTable->slots);
+	symbolTable->capacity *= 2;
+	symbolTable->slots = calloc(symbolTable->capacity, sizeof(Symbol *));
+	const unsigned int mask = symbolTable->capacity - 1;
+	for (unsigned int k = 0; k < symbolTable->count; ++k) {
+		Symbol * symbol = symbolTable->symbols[k];
+		unsigned int slot = symbol->hash & mask;
+		while (symbolTable->slots[slot] != NULL) {
+			slot = (slot + 1) & mask;
+		}
+		symbolTable->slots[slot] = symbol;
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+SymbolTable * createSymbolTable(Arena * arena) {
+	SymbolTable * symbolTable = calloc(1, sizeof(SymbolTable));
+	symbolTable->arena = arena;
+	symbolTable->capacity = 64;
+	symbolTable->slots = calloc(symbolTable->capacity, sizeof(Symbol *));
+	symbolTable->symbolsCapacity = 32;
+	symbolTable->symbols = calloc(symbolTable->symbolsCapacity, sizeof(Symbol *));
+	symbolTable->count = 0;
+	symbolTable->states = 0;
+	return symbolTable;
+}
+
+void destroySymbolTable(SymbolTable * symbolTable) {
+	if (symbolTable != NULL) {
+		free(symbolTable->slots);
+		free(symbolTable->symbols);
+		free(symbolTable);
+	}
+}
+
+void resetSymbolTable(SymbolTable * symbolTable) {
+	memset(symbolTable->slots, 0, symbolTable->capacity * sizeof(Symbol *));
+	symbolTable->count = 0;
+	symbolTable->states = 0;
+}
+
+Symbol * internSymbol(SymbolTable * symbolTable, const char * name, const unsigned int length, const unsigned int line) {
+	const unsigned int hash = _hash(name, length);
+	const unsigned int mask = symbolTable->capacity - 1;
+	unsigned int slot = hash & mask;
+	while (symbolTable->slots[slot] != NULL) {
+		Symbol * symbol = symbolTable->slots[slot];
+		if (symbol->hash == hash && symbol->length == length && memcmp(symbol->name, name, length) == 0) {
+			return symbol;
+		}
+		slot = (slot + 1) & mask;
+	}
+	Symbol * symbol = allocateFromArena(symbolTable->arena, sizeof(Symbol));
+	symbol->name = duplicateInArena(symbolTable->arena, name, length);
+	symbol->length = length;
+	symbol->hash = hash;
+	symbol->id = symbolTable->count;
+	symbol->line = line;
+	symbol->state = NO_STATE;
+	symbol->isVariable = false;
+	if (symbolTable->count == symbolTable->symbolsCapacity) {
+		symbolTable->symbolsCapacity *= 2;
+		symbolTable->symbols = realloc(symbolTable->symbols, symbolTable->symbolsCapacity * sizeof(Symbol *));
+	}
+	symbolTable->symbols[symbolTable->count++] = symbol;
+	symbolTable->slots[slot] = symbol;
+	if (symbolTable->capacity < 2 * symbolTable->count) {
+		_rehash(symbolTable);
+	}
+	return symbol;
+}
+
+Symbol * getSymbol(const SymbolTable * symbolTable, const unsigned int id) {
+	return id < symbolTable->count ? symbolTable->symbols[id] : NULL;
+}
@@ -0,0 +1,91 @@
+#ifndef SYMBOL_TABLE_HEADER
+#define SYMBOL_TABLE_HEADER
+
+#include "Arena.h"
+#include "Type.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The identifier of a symbol that does not exist.
+ */
+#define NO_SYMBOL ((unsigned int) -1)
+
+/**
+ * The state of a symbol that is not a declared state.
+ */
+#define NO_STATE (-1)
+
+/**
+ * An interned identifier (i.e., a state or a variable). Every occurrence of
+ * the same name shares the same symbol, so names are compared by identifier
+ * instead of by content.
+ */
+typedef struct {
+	// The name (allocated from the arena of the table), and its length.
+	const char * name;
+	unsigned int length;
+	unsigned int hash;
+
+	// A dense identifier, in order of first occurrence (from zero).
+	unsigned int id;
+
+	// The line of the first occurrence.
+	unsigned int line;
+
+	// The index of the state in the "States" option, or NO_STATE.
+	int state;
+
+	// Whether the name is assigned, or bound by a for-loop.
+	boolean isVariable;
+} Symbol;
+
+/**
+ * An interning table, with open addressing and linear probing. The symbols
+ * and their names live in the arena of the compilation, while the indexes
+ * are kept in the heap, so they can be reused after a reset.
+ */
+typedef struct {
+	Arena * arena;
+
+	// The hash index (a power of 2 of slots, at most half full).
+	Symbol ** slots;
+	unsigned int capacity;
+
+	// Every symbol, by identifier.
+	Symbol ** symbols;
+	unsigned int count;
+	unsigned int symbolsCapacity;
+
+	// The amount of declared states.
+	unsigned int states;
+} SymbolTable;
+
+/**
+ * Creates an empty symbol table, that allocates its symbols from the
+ * specified arena.
+ */
+SymbolTable * createSymbolTable(Arena * arena);
+
+/**
+ * Destroys a symbol table (but not its arena).
+ */
+void destroySymbolTable(SymbolTable * symbolTable);
+
+/**
+ * Forgets every symbol. Must be called whenever the arena is reset.
+ */
+void resetSymbolTable(SymbolTable * symbolTable);
+
+/**
+ * Returns the symbol with the specified name (the first "length" characters
+ * of it), creating it if it's the first occurrence.
+ */
+Symbol * internSymbol(SymbolTable * symbolTable, const char * name, const unsigned int length, const unsigned int line);
+
+/**
+ * Returns the symbol with the specified identifier, or NULL.
+ */
+Symbol * getSymbol(const SymbolTable * symbolTable, const unsigned int id);
+
+#endif
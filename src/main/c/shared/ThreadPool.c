@@ -0,0 +1,157 @@
+#include "ThreadPool.h"
+
+#if !defined (_WIN32)
+#include <unistd.h>
+#endif
+
+/* PRIVATE FUNCTIONS */
+
+typedef struct {
+	ThreadPool * threadPool;
+	unsigned int worker;
+} ThreadPoolWorker;
+
+static void * _work(void * argument);
+
+/**
+ * The main loop of every worker thread: runs every new broadcast, or takes
+ * the next job from the queue and runs it, until the pool is shutdown and
+ * the queue is empty.
+ */
+static void * _work(void * argument) {
+	ThreadPoolWorker * threadPoolWorker = argument;
+	ThreadPool * threadPool = threadPoolWorker->threadPool;
+	const unsigned int worker = threadPoolWorker->worker;
+	free(threadPoolWorker);
+	pthread_mutex_lock(&threadPool->mutex);
+	// The broadcasts run by this worker (it can start after the first one).
+	unsigned long broadcasts = 0;
+	while (true) {
+		while (threadPool->pending == 0 && broadcasts == threadPool->broadcasts && !threadPool->shutdown) {
+			pthread_cond_wait(&threadPool->workAvailable, &threadPool->mutex);
+		}
+		if (broadcasts != threadPool->broadcasts) {
+			const ThreadPoolJob broadcast = threadPool->broadcast;
+			broadcasts = threadPool->broadcasts;
+			pthread_mutex_unlock(&threadPool->mutex);
+			broadcast.task(broadcast.argument, worker);
+			pthread_mutex_lock(&threadPool->mutex);
+			if (--threadPool->broadcastPending == 0) {
+				pthread_cond_broadcast(&threadPool->broadcastDone);
+			}
+			continue;
+		}
+		if (threadPool->pending == 0) {
+			break;
+		}
+		const ThreadPoolJob job = threadPool->jobs[threadPool->head];
+		threadPool->head = (threadPool->head + 1) % threadPool->capacity;
+		--threadPool->pending;
+		++threadPool->running;
+		pthread_mutex_unlock(&threadPool->mutex);
+		job.task(job.argument, worker);
+		pthread_mutex_lock(&threadPool->mutex);
+		--threadPool->running;
+		if (threadPool->pending == 0 && threadPool->running == 0) {
+			pthread_cond_broadcast(&threadPool->workDone);
+		}
+	}
+	pthread_mutex_unlock(&threadPool->mutex);
+	return NULL;
+}
+
+/* PUBLIC FUNCTIONS */
+
+unsigned int availableProcessors() {
+#if defined (_WIN32)
+	return 1;
+#else
+	const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+	return processors < 1 ? 1 : (unsigned int) processors;
+#endif
+}
+
+void broadcastToThreadPool(ThreadPool * threadPool, ThreadPoolTask task, void * argument) {
+	pthread_mutex_lock(&threadPool->mutex);
+	while (0 < threadPool->broadcastPending) {
+		pthread_cond_wait(&threadPool->broadcastDone, &threadPool->mutex);
+	}
+	threadPool->broadcast.task = task;
+	threadPool->broadcast.argument = argument;
+	threadPool->broadcastPending = threadPool->size;
+	++threadPool->broadcasts;
+	pthread_cond_broadcast(&threadPool->workAvailable);
+	while (0 < threadPool->broadcastPending) {
+		pthread_cond_wait(&threadPool->broadcastDone, &threadPool->mutex);
+	}
+	pthread_mutex_unlock(&threadPool->mutex);
+}
+
+ThreadPool * createThreadPool(const unsigned int size) {
+	ThreadPool * threadPool = calloc(1, sizeof(ThreadPool));
+	threadPool->size = size < 1 ? 1 : size;
+	threadPool->capacity = 64;
+	threadPool->jobs = calloc(threadPool->capacity, sizeof(ThreadPoolJob));
+	threadPool->shutdown = false;
+	pthread_mutex_init(&threadPool->mutex, NULL);
+	pthread_cond_init(&threadPool->workAvailable, NULL);
+	pthread_cond_init(&threadPool->workDone, NULL);
+	pthread_cond_init(&threadPool->broadcastDone, NULL);
+	threadPool->threads = calloc(threadPool->size, sizeof(pthread_t));
+	for (unsigned int k = 0; k < threadPool->size; ++k) {
+		ThreadPoolWorker * threadPoolWorker = calloc(1, sizeof(ThreadPoolWorker));
+		threadPoolWorker->threadPool = threadPool;
+		threadPoolWorker->worker = k;
+		pthread_create(&threadPool->threads[k], NULL, _work, threadPoolWorker);
+	}
+	return threadPool;
+}
+
+void destroyThreadPool(ThreadPool * threadPool) {
+	if (threadPool != NULL) {
+		pthread_mutex_lock(&threadPool->mutex);
+		threadPool->shutdown = true;
+		pthread_cond_broadcast(&threadPool->workAvailable);
+		pthread_mutex_unlock(&threadPool->mutex);
+		for (unsigned int k = 0; k < threadPool->size; ++k) {
+			pthread_join(threadPool->threads[k], NULL);
+		}
+		pthread_cond_destroy(&threadPool->broadcastDone);
+		pthread_cond_destroy(&threadPool->workDone);
+		pthread_cond_destroy(&threadPool->workAvailable);
+		pthread_mutex_destroy(&threadPool->mutex);
+		free(threadPool->threads);
+		free(threadPool->jobs);
+		free(threadPool);
+	}
+}
+
+void submitToThreadPool(ThreadPool * threadPool, ThreadPoolTask task, void * argument) {
+	pthread_mutex_lock(&threadPool->mutex);
+	if (threadPool->pending == threadPool->capacity) {
+		// Unrolls the circular queue into a bigger one.
+		const unsigned int capacity = 2 * threadPool->capacity;
+		ThreadPoolJob * jobs = calloc(capacity, sizeof(ThreadPoolJob));
+		for (unsigned int k = 0; k < threadPool->pending; ++k) {
+			jobs[k] = threadPool->jobs[(threadPool->head + k) % threadPool->capacity];
+		}
+		free(threadPool->jobs);
+		threadPool->jobs = jobs;
+		threadPool->capacity = capacity;
+		threadPool->head = 0;
+	}
+	const unsigned int tail = (threadPool->head + threadPool->pending) % threadPool->capacity;
+	threadPool->jobs[tail].task = task;
+	threadPool->jobs[tail].argument = argument;
+	++threadPool->pending;
+	pthread_cond_signal(&threadPool->workAvailable);
+	pthread_mutex_unlock(&threadPool->mutex);
+}
+
+void waitForThreadPool(ThreadPool * threadPool) {
+	pthread_mutex_lock(&threadPool->mutex);
+	while (0 < threadPool->pending || 0 < threadPool->running) {
+		pthread_cond_wait(&threadPool->workDone, &threadPool->mutex);
+	}
+	pthread_mutex_unlock(&threadPool->mutex);
+}
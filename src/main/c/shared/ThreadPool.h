@@ -0,0 +1,90 @@
+#ifndef THREAD_POOL_HEADER
+#define THREAD_POOL_HEADER
+
+#include "Type.h"
+#include <pthread.h>
+#include <stdlib.h>
+
+/**
+ * A unit of work. The worker is the index of the thread that runs the task
+ * (from zero to the size of the pool, exclusive), so tasks can use per-worker
+ * resources without any synchronization.
+ */
+typedef void (*ThreadPoolTask)(void * argument, const unsigned int worker);
+
+typedef struct ThreadPoolJob ThreadPoolJob;
+
+/**
+ * A pending task, and the argument to run it with.
+ */
+struct ThreadPoolJob {
+	ThreadPoolTask task;
+	void * argument;
+};
+
+/**
+ * A fixed set of persistent worker threads, that run the tasks of a shared
+ * queue in submission order, or a single task on every worker at once (a
+ * broadcast).
+ */
+typedef struct {
+	pthread_t * threads;
+	unsigned int size;
+
+	// The circular queue of pending jobs.
+	ThreadPoolJob * jobs;
+	unsigned int capacity;
+	unsigned int head;
+	unsigned int pending;
+
+	// The amount of jobs being run right now.
+	unsigned int running;
+
+	// The current broadcast (every worker runs it once), the amount of
+	// broadcasts so far, and the workers that didn't finish it yet.
+	ThreadPoolJob broadcast;
+	unsigned long broadcasts;
+	unsigned int broadcastPending;
+
+	boolean shutdown;
+	pthread_mutex_t mutex;
+	pthread_cond_t workAvailable;
+	pthread_cond_t workDone;
+	pthread_cond_t broadcastDone;
+} ThreadPool;
+
+/**
+ * Returns the amount of processors available to the application, or 1 if it
+ * cannot be determined.
+ */
+unsigned int availableProcessors();
+
+/**
+ * Runs a task once on every worker (each one with its own index), and blocks
+ * until all of them are done. Unlike the submitted tasks, the same worker
+ * always runs the same share of the work, so it's a barrier for data-parallel
+ * loops (e.g., to keep the memory of every worker local to its processor).
+ */
+void broadcastToThreadPool(ThreadPool * threadPool, ThreadPoolTask task, void * argument);
+
+/**
+ * Creates a pool with the specified amount of worker threads (at least one).
+ */
+ThreadPool * createThreadPool(const unsigned int size);
+
+/**
+ * Stops the workers, after every pending task is done, and destroys the pool.
+ */
+void destroyThreadPool(ThreadPool * threadPool);
+
+/**
+ * Enqueues a task, that will be run by the first available worker.
+ */
+void submitToThreadPool(ThreadPool * threadPool, ThreadPoolTask task, void * argument);
+
+/**
+ * Blocks until every submitted task is done.
+ */
+void waitForThreadPool(ThreadPool * threadPool);
+
+#endif